@@ -22,6 +22,7 @@ enum class ADF : uint32_t {
    VOL_RAMPING = 0x00000010,
    AUTO_SAVE = 0x00000020,
    SYSTEM_WIDE = 0x00000040,
+   MIXER_THREAD = 0x00000080,
 };
 
 DEFINE_ENUM_FLAG_OPERATORS(ADF)
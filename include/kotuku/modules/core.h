@@ -365,6 +365,7 @@ enum class JTYPE : uint32_t {
    DBL_CLICK = 0x00000200,
    REPEATED = 0x00000400,
    DRAG_ITEM = 0x00000800,
+   HISTORY = 0x00001000,
 };
 
 DEFINE_ENUM_FLAG_OPERATORS(JTYPE)
@@ -268,6 +268,7 @@ enum class BMF : uint32_t {
    X11_DGA = 0x00002000,
    FIXED_DEPTH = 0x00004000,
    PREMUL = 0x00008000,
+   TILED = 0x00010000,
 };
 
 DEFINE_ENUM_FLAG_OPERATORS(BMF)
@@ -468,6 +469,15 @@ struct CursorInfo {
    int16_t BitsPerPixel;    // Preferred bits-per-pixel setting for custom cursors
 };
 
+struct FrameStats {
+   int64_t Frames;          // Total number of frames drawn by the frame scheduler.
+   int64_t DroppedFrames;   // Total number of frame intervals that were missed while damage was pending.
+   double  FrameRate;       // The rate at which frames are scheduled, measured in Hz.
+   double  FrameTime;       // Average time taken to draw a frame, in milliseconds.
+   double  MaxFrameTime;    // Longest time taken to draw a frame, in milliseconds.
+   int64_t PresentStalls;   // Total number of times that presentation waited for the display server to release a buffer.
+};
+
 #define VER_BITMAPSURFACE 2.000000
 
 typedef struct BitmapSurfaceV2 {
@@ -1725,6 +1735,7 @@ struct DisplayBase {
    ERR (*_GetCursorPos)(double *X, double *Y);
    ERR (*_GetDisplayInfo)(OBJECTID Display, struct DisplayInfoV3 **Info);
    DT (*_GetDisplayType)(void);
+   ERR (*_GetFrameStats)(struct FrameStats *Stats, int Size);
    CSTRING (*_GetInputTypeName)(JET Type);
    OBJECTID (*_GetModalSurface)(void);
    ERR (*_GetRelativeCursorPos)(OBJECTID Surface, double *X, double *Y);
@@ -1772,6 +1783,7 @@ inline ERR GetCursorInfo(struct CursorInfo *Info, int Size) { return DisplayBase
 inline ERR GetCursorPos(double *X, double *Y) { return DisplayBase->_GetCursorPos(X,Y); }
 inline ERR GetDisplayInfo(OBJECTID Display, struct DisplayInfoV3 **Info) { return DisplayBase->_GetDisplayInfo(Display,Info); }
 inline DT GetDisplayType(void) { return DisplayBase->_GetDisplayType(); }
+inline ERR GetFrameStats(struct FrameStats *Stats, int Size) { return DisplayBase->_GetFrameStats(Stats,Size); }
 inline CSTRING GetInputTypeName(JET Type) { return DisplayBase->_GetInputTypeName(Type); }
 inline OBJECTID GetModalSurface(void) { return DisplayBase->_GetModalSurface(); }
 inline ERR GetRelativeCursorPos(OBJECTID Surface, double *X, double *Y) { return DisplayBase->_GetRelativeCursorPos(Surface,X,Y); }
@@ -1816,6 +1828,7 @@ extern ERR GetCursorInfo(struct CursorInfo *Info, int Size);
 extern ERR GetCursorPos(double *X, double *Y);
 extern ERR GetDisplayInfo(OBJECTID Display, struct DisplayInfoV3 **Info);
 extern DT GetDisplayType(void);
+extern ERR GetFrameStats(struct FrameStats *Stats, int Size);
 extern CSTRING GetInputTypeName(JET Type);
 extern OBJECTID GetModalSurface(void);
 extern ERR GetRelativeCursorPos(OBJECTID Surface, double *X, double *Y);
@@ -427,6 +427,7 @@ enum class VPF : uint32_t {
    RENDER_TIME = 0x00000002,
    RESIZE = 0x00000004,
    OUTLINE_VIEWPORTS = 0x00000008,
+   TRILINEAR = 0x00000010,
 };
 
 DEFINE_ENUM_FLAG_OPERATORS(VPF)
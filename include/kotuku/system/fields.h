@@ -1011,4 +1011,5 @@
 #define FID_SSLCertificate 0xed7f1f1aLL
 #define FID_SSLPrivateKey 0xc4dc305bLL
 #define FID_SSLKeyPassword 0xc5cb4293LL
+#define FID_Underruns 0xb8edd8abLL
 
@@ -88,6 +88,7 @@ For optimal results, choose the appropriate interface based on application requi
   #include <sys/kd.h>
  #endif
  #include <unistd.h>
+ #include <pthread.h>
  #ifdef ALSA_ENABLED
   #include <alsa/asoundlib.h> // Requires libasound2-dev
  #endif
@@ -123,6 +124,7 @@ static ERR set_channel_volume(extAudio *, struct AudioChannel *);
 static void load_config(extAudio *);
 static ERR init_audio(extAudio *);
 static ERR audio_timer(extAudio *, int64_t, int64_t);
+static void stop_mixer_thread(extAudio *);
 
 #include "audio.h"
 
@@ -2,7 +2,11 @@
 using namespace pf;
 
 #include <variant>
+#include <atomic>
+#include <mutex>
+#include <thread>
 #include "mixer_dispatch.h"
+#include "spsc_ring.h"
 
 #ifdef _WIN32
 #define MIX_INTERVAL 0.1
@@ -141,11 +145,16 @@ struct AudioCommand {
    CMD  CommandID;    // Command ID
    int Handle;       // Channel handle
    std::variant<double,int,bool> Data; // Special data related to the command ID
+   bool Buffered;     // Mixer thread only.  True if the command belongs to a sequence, otherwise it executes on receipt
 
-   AudioCommand(CMD pCommandID, int pHandle, double pData = 0) :
-      CommandID(pCommandID), Handle(pHandle), Data(pData) { }
+   AudioCommand(CMD pCommandID, int pHandle, double pData = 0, bool pBuffered = true) :
+      CommandID(pCommandID), Handle(pHandle), Data(pData), Buffered(pBuffered) { }
 
    AudioCommand() = default;
+
+   template <class T> T get() const {
+      return std::visit([](auto Value) { return T(Value); }, Data);
+   }
 };
 
 struct AudioChannel {
@@ -219,14 +228,25 @@ struct MixTimer {
    int64_t Time;
    int  SampleHandle;
    MixTimer(int64_t pTime, int pHandle) : Time(pTime), SampleHandle(pHandle) { }
+   MixTimer() = default;
 };
 
+static thread_local bool tlMixerThread = false; // True for the mixer thread
+static thread_local bool tlExecuting = false;   // True while a received or sequenced command is being executed
+
 class extAudio : public objAudio {
    public:
    std::vector<ChannelSet> Sets; // Channels are grouped into sets.  Index 0 is a dummy entry.
    std::vector<AudioSample> Samples; // Buffered samples loaded into the audio object.
    std::vector<VolumeCtl> Volumes;
    std::vector<MixTimer> MixTimers;
+   SPSCRing<AudioCommand, 1024> CommandRing; // Commands sent to the mixer thread
+   SPSCRing<MixTimer, 256> StopRing;         // Stop notifications returned from the mixer thread
+   std::mutex CommandLock;                   // Serialises clients that send to CommandRing
+   std::recursive_mutex MixLock;             // Held while mixing on the mixer thread; changes to Sets and Samples require it
+   std::jthread MixerThread;
+   std::atomic<int> Underruns;
+   std::atomic<bool> MixerFailed;
    AudioConfig MixConfig;
    APTR  MixBuffer;
    APTR  TaskRemovedHandle;
@@ -267,6 +287,14 @@ class extAudio : public objAudio {
 
    inline double MixerLag();
 
+   // Returns true if a mix command for Channel must be queued rather than executed immediately.  Commands are queued
+   // while a sequence is being buffered, or at all times if the mixer thread is running.
+
+   inline bool queueCommand(AudioChannel &Channel) {
+      if (tlExecuting) return false;
+      return Channel.Buffering or MixerThread.joinable();
+   }
+
    inline void finish(AudioChannel &Channel, bool Notify);
 
    extAudio() = default;
@@ -8,6 +8,7 @@ static const struct FieldDef clAudioFlags[] = {
    { "VolRamping", 0x00000010 },
    { "AutoSave", 0x00000020 },
    { "SystemWide", 0x00000040 },
+   { "MixerThread", 0x00000080 },
    { nullptr, 0 }
 };
 
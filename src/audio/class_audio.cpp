@@ -58,7 +58,13 @@ inline void extAudio::finish(AudioChannel &Channel, bool Notify) {
       Channel.State = CHS::FINISHED;
       if ((Channel.SampleHandle) and (Notify)) {
          #ifdef ALSA_ENABLED
-            if ((Channel.EndTime) and (PreciseTime() < Channel.EndTime)) {
+            if (tlMixerThread) { // Client callbacks are made from the main thread by audio_timer()
+               if (!this->StopRing.push(MixTimer(Channel.EndTime, Channel.SampleHandle))) {
+                  pf::Log(__FUNCTION__).warning("Stop event for sample %d was dropped.", Channel.SampleHandle);
+               }
+               Channel.EndTime = 0;
+            }
+            else if ((Channel.EndTime) and (PreciseTime() < Channel.EndTime)) {
                this->MixTimers.emplace_back(Channel.EndTime, Channel.SampleHandle);
                Channel.EndTime = 0;
             }
@@ -160,8 +166,8 @@ static ERR AUDIO_Activate(extAudio *Self)
          }
       #endif
 
-      // Note: The audio feed is managed by audio_timer() and is not started until an audio playback command
-      // is executed by the client.
+      // Note: The audio feed is managed by audio_timer(), or the mixer thread if MIXER_THREAD is set, and is not
+      // started until an audio playback command is executed by the client.
 
       Self->Initialising = false;
       return ERR::Okay;
@@ -231,6 +237,7 @@ ERR AUDIO_AddSample(extAudio *Self, struct snd::AddSample *Args)
 
    // Find an unused sample block.  If there is none, increase the size of the sample management area.
 
+   const std::lock_guard lock(Self->MixLock);
    int idx;
    for (idx=1; idx < std::ssize(Self->Samples); idx++) {
       if (!Self->Samples[idx].Data) break;
@@ -291,6 +298,9 @@ The `Offset` reflects the retrieval point of the decoded data and is measured in
 `BufferSize` reflect the target for the decoded data.  The function must return the total number of bytes that were
 written to the `Buffer`. If an error occurs, return zero.
 
+If the `MIXER_THREAD` flag is set, the `Callback` is called from the mixer thread and must be a C function that is
+safe to run concurrently with the client.  Script callbacks are not supported in this mode.
+
 When creating a new stream, pay attention to the audio format that is being used for the sample data.
 It is important to differentiate between 8-bit, 16-bit, mono and stereo, but also be aware of whether or not the data
 is little or big endian, and if the sample data consists of signed or unsigned values.  Because of the possible
@@ -329,6 +339,7 @@ Okay: Stream successfully configured and added to the audio system.
 Args: Invalid argument values provided.
 NullArgs: Required parameters are null or missing.
 AllocMemory: Failed to allocate the stream buffer.
+NoSupport: The `Callback` is a script function and the `MIXER_THREAD` flag is set.
 -END-
 
 *********************************************************************************************************************/
@@ -342,10 +353,18 @@ static ERR AUDIO_AddStream(extAudio *Self, struct snd::AddStream *Args)
    if ((!Args) or (Args->SampleFormat IS SFM::NIL)) return log.warning(ERR::NullArgs);
    if (Args->Callback.Type IS CALL::NIL) return log.warning(ERR::NullArgs);
 
+   // Scripts can only run on their own thread, so they cannot service a stream from the mixer thread.
+
+   if ((Args->Callback.isScript()) and ((Self->Flags & ADF::MIXER_THREAD) != ADF::NIL)) {
+      log.warning("Script callbacks are not supported for streams when MIXER_THREAD is set.");
+      return ERR::NoSupport;
+   }
+
    log.branch("Length: %d", Args->SampleLength);
 
    // Find an unused sample block.  If there is none, increase the size of the sample management area.
 
+   const std::lock_guard lock(Self->MixLock);
    int idx;
    for (idx=1; idx < std::ssize(Self->Samples); idx++) {
       if (!Self->Samples[idx].Data) break;
@@ -470,6 +489,7 @@ static ERR AUDIO_CloseChannels(extAudio *Self, struct snd::CloseChannels *Args)
    int index = Args->Handle>>16;
    if ((index < 0) or (index >= std::ssize(Self->Sets))) log.warning(ERR::Args);
 
+   const std::lock_guard lock(Self->MixLock);
    Self->Sets[index].clear(); // We can't erase because that would mess up other channel handles.
    return ERR::Okay;
 }
@@ -494,6 +514,8 @@ static ERR AUDIO_Deactivate(extAudio *Self)
       return ERR::Okay;
    }
 
+   stop_mixer_thread(Self);
+
    acClear(Self);
 
 #ifdef ALSA_ENABLED
@@ -635,6 +657,7 @@ static ERR AUDIO_OpenChannels(extAudio *Self, struct snd::OpenChannels *Args)
 
    // Bear in mind that the +1 is for channel set 0 being a dummy entry.
 
+   const std::lock_guard lock(Self->MixLock);
    int index = std::ssize(Self->Sets) + 1;
    Self->Sets.resize(index+1);
 
@@ -683,6 +706,7 @@ static ERR AUDIO_RemoveSample(extAudio *Self, struct snd::RemoveSample *Args)
 
    if ((Args->Handle < 1) or (Args->Handle >= std::ssize(Self->Samples))) return log.warning(ERR::OutOfRange);
 
+   const std::lock_guard lock(Self->MixLock);
    Self->Samples[Args->Handle].clear();
 
    return ERR::Okay;
@@ -1367,6 +1391,23 @@ static ERR SET_Stereo(extAudio *Self, int Value)
    return ERR::Okay;
 }
 
+/*********************************************************************************************************************
+
+-FIELD-
+Underruns: The number of buffer underruns that have occurred during playback.
+
+An underrun occurs when the audio device exhausts its buffer before the mixer can provide more data, and is heard as
+a click or gap in playback.  The count is cumulative for the life of the Audio object.  Frequent underruns indicate
+that the main thread is too busy to keep the device supplied, in which case the `MIXER_THREAD` flag may help.
+
+*********************************************************************************************************************/
+
+static ERR GET_Underruns(extAudio *Self, int *Value)
+{
+   *Value = Self->Underruns;
+   return ERR::Okay;
+}
+
 //********************************************************************************************************************
 
 static void load_config(extAudio *Self)
@@ -1457,6 +1498,7 @@ static const FieldArray clAudioFields[] = {
    { "MasterVolume",  FDF_DOUBLE|FDF_RW,  GET_MasterVolume, SET_MasterVolume },
    { "Mute",          FDF_INT|FDF_RW,    GET_Mute, SET_Mute },
    { "Stereo",        FDF_INT|FDF_RW,    GET_Stereo, SET_Stereo },
+   { "Underruns",     FDF_INT|FDF_R,     GET_Underruns },
    END_FIELD
 };
 
@@ -97,11 +97,24 @@ static void sound_stopped_event(extSound *Self)
 
 //********************************************************************************************************************
 
+// If the Audio object has a mixer thread then this function is called from that thread, and the Sound must be locked
+// so that the seek and read cannot interleave with the client's use of the object.  The owner may itself be waiting on
+// the mixer (e.g. to remove the stream), so the lock is time limited.  If it cannot be acquired, silence is returned
+// in place of the data and the stream resumes from its current position on the next refill.
+
 #ifndef USE_WIN32_PLAYBACK
+static constexpr int STREAM_LOCK_TIMEOUT = 5; // Milliseconds
+
 static int read_stream(int Handle, int Offset, APTR Buffer, int Length)
 {
    auto Self = (extSound *)CurrentContext();
 
+   pf::ScopedObjectLock lock(Self, tlMixerThread ? STREAM_LOCK_TIMEOUT : 3000);
+   if (!lock.granted()) {
+      if (Length > 0) clearmem(Buffer, Length);
+      return (Length > 0) ? Length : 0;
+   }
+
    if ((Offset >= 0) and (Self->Position != Offset)) Self->seekStart(Offset);
 
    if (Length > 0) {
@@ -22,7 +22,6 @@ static ERR add_command(objAudio* Audio, CMD Command, int Handle, tArgs&&... pArg
    pf::Log log(__FUNCTION__);
    if ((index < 1) or (index >= int(ea->Sets.size()))) return log.warning(ERR::OutOfRange);
    if (ea->Sets[index].Commands.capacity() == 0) return log.warning(ERR::OutOfRange);
-   if (ea->Sets[index].Commands.size() > 1024) return log.warning(ERR::BufferOverflow);
 
    double data = 0.0;
    if constexpr (sizeof...(pArgs) > 0) {
@@ -30,6 +29,17 @@ static ERR add_command(objAudio* Audio, CMD Command, int Handle, tArgs&&... pArg
       data = extract_data_parameter(std::forward<tArgs>(pArgs)...);
    }
 
+   if (ea->MixerThread.joinable()) {
+      // The mixer thread owns the command buffers, so the command is sent to it.  Commands that are not part of a
+      // sequence are executed as soon as they are received.
+
+      const bool buffered = (Command IS CMD::END_SEQUENCE) or ea->GetChannel(Handle)->Buffering;
+      const std::lock_guard lock(ea->CommandLock);
+      if (!ea->CommandRing.push(AudioCommand(Command, Handle, data, buffered))) return log.warning(ERR::BufferOverflow);
+      return ERR::Okay;
+   }
+
+   if (ea->Sets[index].Commands.size() > 1024) return log.warning(ERR::BufferOverflow);
    ea->Sets[index].Commands.emplace_back(Command, Handle, data);
    return ERR::Okay;
 }
@@ -188,7 +198,7 @@ ERR MixContinue(objAudio *Audio, int Handle)
 
    auto channel = ((extAudio *)Audio)->GetChannel(Handle);
 
-   if (channel->Buffering) {
+   if (((extAudio *)Audio)->queueCommand(*channel)) {
       add_command(Audio, CMD::CONTINUE, Handle);
       return ERR::Okay;
    }
@@ -211,11 +221,7 @@ ERR MixContinue(objAudio *Audio, int Handle)
       shadow->State = CHS::PLAYING;
    }
 
-   pf::SwitchContext context(Audio);
-
-   if (((extAudio *)Audio)->Timer) UpdateTimer(((extAudio *)Audio)->Timer, -MIX_INTERVAL);
-   else SubscribeTimer(MIX_INTERVAL, C_FUNCTION(audio_timer), &((extAudio *)Audio)->Timer);
-
+   start_mixing((extAudio *)Audio);
    return ERR::Okay;
 }
 
@@ -248,7 +254,7 @@ ERR MixMute(objAudio *Audio, int Handle, int Mute)
 
    auto channel = ((extAudio *)Audio)->GetChannel(Handle);
 
-   if (channel->Buffering) {
+   if (((extAudio *)Audio)->queueCommand(*channel)) {
       add_command(Audio, CMD::MUTE, Handle, bool(Mute));
       return ERR::Okay;
    }
@@ -288,7 +294,7 @@ ERR MixFrequency(objAudio *Audio, int Handle, int Frequency)
 
    auto channel = ((extAudio *)Audio)->GetChannel(Handle);
 
-   if (channel->Buffering) {
+   if (((extAudio *)Audio)->queueCommand(*channel)) {
       add_command(Audio, CMD::FREQUENCY, Handle, Frequency);
       return ERR::Okay;
    }
@@ -326,7 +332,7 @@ ERR MixPan(objAudio *Audio, int Handle, double Pan)
 
    auto channel = ((extAudio *)Audio)->GetChannel(Handle);
 
-   if (channel->Buffering) {
+   if (((extAudio *)Audio)->queueCommand(*channel)) {
       add_command(Audio, CMD::PAN, Handle, Pan);
       return ERR::Okay;
    }
@@ -373,7 +379,7 @@ ERR MixPlay(objAudio *Audio, int Handle, int Position)
 
    log.traceBranch("Audio: #%d, Channel: $%.8x, Position: %d", Audio->UID, Handle, Position);
 
-   if (channel->Buffering) {
+   if (((extAudio *)Audio)->queueCommand(*channel)) {
       add_command(Audio, CMD::PLAY, Handle, Position);
       return ERR::Okay;
    }
@@ -523,11 +529,7 @@ ERR MixPlay(objAudio *Audio, int Handle, int Position)
 
    fade_in((extAudio *)Audio, channel);
 
-   if (channel->State IS CHS::PLAYING) {
-      pf::SwitchContext context(Audio);
-      if (((extAudio *)Audio)->Timer) UpdateTimer(((extAudio *)Audio)->Timer, -MIX_INTERVAL);
-      else SubscribeTimer(MIX_INTERVAL, C_FUNCTION(audio_timer), &((extAudio *)Audio)->Timer);
-   }
+   if (channel->State IS CHS::PLAYING) start_mixing((extAudio *)Audio);
 
    return ERR::Okay;
 }
@@ -564,7 +566,7 @@ ERR MixRate(objAudio *Audio, int Handle, int Rate)
 
    auto channel = ((extAudio *)Audio)->GetChannel(Handle);
 
-   if (channel->Buffering) {
+   if (((extAudio *)Audio)->queueCommand(*channel)) {
       add_command(Audio, CMD::RATE, Handle, Rate);
       return ERR::Okay;
    }
@@ -624,7 +626,7 @@ ERR MixSample(objAudio *Audio, int Handle, int SampleIndex)
 
    auto channel = ((extAudio *)Audio)->GetChannel(Handle);
 
-   if (channel->Buffering) {
+   if (((extAudio *)Audio)->queueCommand(*channel)) {
       add_command(Audio, CMD::SAMPLE, Handle, SampleIndex);
       return ERR::Okay;
    }
@@ -678,7 +680,7 @@ ERR MixStop(objAudio *Audio, int Handle)
 
    auto channel = ((extAudio *)Audio)->GetChannel(Handle);
 
-   if (channel->Buffering) {
+   if (((extAudio *)Audio)->queueCommand(*channel)) {
       add_command(Audio, CMD::STOP, Handle);
       return ERR::Okay;
    }
@@ -723,7 +725,7 @@ ERR MixStopLoop(objAudio *Audio, int Handle)
 
    auto channel = ((extAudio *)Audio)->GetChannel(Handle);
 
-   if (channel->Buffering) {
+   if (((extAudio *)Audio)->queueCommand(*channel)) {
       add_command(Audio, CMD::STOP_LOOPING, Handle);
       return ERR::Okay;
    }
@@ -769,8 +771,8 @@ ERR MixVolume(objAudio *Audio, int Handle, double Volume)
 
    auto channel = ((extAudio *)Audio)->GetChannel(Handle);
 
-   if (channel->Buffering) {
-      add_command(Audio, CMD::VOLUME, Volume);
+   if (((extAudio *)Audio)->queueCommand(*channel)) {
+      add_command(Audio, CMD::VOLUME, Handle, Volume);
       return ERR::Okay;
    }
 
@@ -190,7 +190,7 @@ static BYTELEN fill_stream_buffer(int Handle, AudioSample &Sample, int Offset)
       auto routine = (BYTELEN (*)(int, int, uint8_t *, int, APTR))Sample.Callback.Routine;
       return routine(Handle, Offset, Sample.Data, Sample.SampleLength<<sample_shift(Sample.SampleType), Sample.Callback.Meta);
    }
-   else if (Sample.Callback.isScript()) {
+   else if ((Sample.Callback.isScript()) and (!tlMixerThread)) { // AddStream() rejects scripts if there is a mixer thread
       const auto args = std::to_array<ScriptArg>({
          { "Handle", Handle },
          { "Offset", Offset },
@@ -320,12 +320,38 @@ static ERR set_channel_volume(extAudio *Self, AudioChannel *Channel)
    return ERR::Okay;
 }
 
+//********************************************************************************************************************
+// Executes a command that was buffered or sent to the mixer thread.
+
+static void execute_command(extAudio *Self, const AudioCommand &Command)
+{
+   pf::Log log(__FUNCTION__);
+
+   tlExecuting = true;
+   switch(Command.CommandID) {
+      case CMD::CONTINUE:     snd::MixContinue(Self, Command.Handle); break;
+      case CMD::MUTE:         snd::MixMute(Self, Command.Handle, Command.get<bool>()); break;
+      case CMD::PLAY:         snd::MixPlay(Self, Command.Handle, Command.get<int>()); break;
+      case CMD::FREQUENCY:    snd::MixFrequency(Self, Command.Handle, Command.get<int>()); break;
+      case CMD::PAN:          snd::MixPan(Self, Command.Handle, Command.get<double>()); break;
+      case CMD::RATE:         snd::MixRate(Self, Command.Handle, Command.get<int>()); break;
+      case CMD::SAMPLE:       snd::MixSample(Self, Command.Handle, Command.get<int>()); break;
+      case CMD::VOLUME:       snd::MixVolume(Self, Command.Handle, Command.get<double>()); break;
+      case CMD::STOP:         snd::MixStop(Self, Command.Handle); break;
+      case CMD::STOP_LOOPING: snd::MixStopLoop(Self, Command.Handle); break;
+
+      default:
+         log.warning("Unrecognised command ID #%d.", int(Command.CommandID));
+         break;
+   }
+   tlExecuting = false;
+}
+
 //********************************************************************************************************************
 // Process as many command batches as possible that will fit within MixLeft.
 
 ERR process_commands(extAudio *Self, SAMPLE Elements)
 {
-   pf::Log log(__FUNCTION__);
 
    for (int index=1; index < (int)Self->Sets.size(); index++) {
       Self->Sets[index].MixLeft -= Elements;
@@ -340,23 +366,8 @@ ERR process_commands(extAudio *Self, SAMPLE Elements)
          bool stop = false;
          auto &cmds = Self->Sets[index].Commands;
          for (i=0; (i < (int)cmds.size()) and (!stop); i++) {
-            switch(cmds[i].CommandID) {
-               case CMD::CONTINUE:     snd::MixContinue(Self, cmds[i].Handle); break;
-               case CMD::MUTE:         snd::MixMute(Self, cmds[i].Handle,  std::get<bool>(cmds[i].Data)); break;
-               case CMD::PLAY:         snd::MixPlay(Self, cmds[i].Handle, std::get<int>(cmds[i].Data)); break;
-               case CMD::FREQUENCY:    snd::MixFrequency(Self, cmds[i].Handle, std::get<int>(cmds[i].Data)); break;
-               case CMD::PAN:          snd::MixPan(Self, cmds[i].Handle, std::get<double>(cmds[i].Data)); break;
-               case CMD::RATE:         snd::MixRate(Self, cmds[i].Handle, std::get<int>(cmds[i].Data)); break;
-               case CMD::SAMPLE:       snd::MixSample(Self, cmds[i].Handle, std::get<int>(cmds[i].Data)); break;
-               case CMD::VOLUME:       snd::MixVolume(Self, cmds[i].Handle, std::get<double>(cmds[i].Data)); break;
-               case CMD::STOP:         snd::MixStop(Self, cmds[i].Handle); break;
-               case CMD::STOP_LOOPING: snd::MixStopLoop(Self, cmds[i].Handle); break;
-               case CMD::END_SEQUENCE: stop = true; break;
-
-               default:
-                  log.warning("Unrecognised command ID #%d at index %d.", int(cmds[i].CommandID), i);
-                  break;
-            }
+            if (cmds[i].CommandID IS CMD::END_SEQUENCE) stop = true;
+            else execute_command(Self, cmds[i]);
          }
 
          if (i IS (int)cmds.size()) cmds.clear();
@@ -367,31 +378,31 @@ ERR process_commands(extAudio *Self, SAMPLE Elements)
    return ERR::Okay;
 }
 
+#ifdef ALSA_ENABLED
+
 //********************************************************************************************************************
+// Mixes as much audio as the device buffer will accept and writes it to ALSA.  Returns ERR::Failed if the device is in
+// a bad state.
 
-static ERR audio_timer(extAudio *Self, int64_t Elapsed, int64_t CurrentTime)
+static ERR alsa_feed(extAudio *Self)
 {
-#ifdef ALSA_ENABLED
-
    pf::Log log(__FUNCTION__);
-   static int16_t errcount = 0;
-
-   // Check if we need to send out any OnStop events
-
-   for (auto it=Self->MixTimers.begin(); it != Self->MixTimers.end(); ) {
-      auto &mt = *it;
-      if (CurrentTime > mt.Time) {
-         audio_stopped_event(*Self, mt.SampleHandle);
-         it = Self->MixTimers.erase(it);
-      }
-      else it++;
-   }
 
    // Get the amount of bytes available for output
 
    SAMPLE space_left;
    if (Self->Handle) {
       space_left = SAMPLE(snd_pcm_avail_update(Self->Handle)); // Returns available space measured in samples
+
+      if (space_left IS -EPIPE) { // The device is in an underrun state and must be prepared before writing resumes
+         Self->Underruns++;
+         if (snd_pcm_prepare(Self->Handle) >= 0) space_left = SAMPLE(snd_pcm_avail_update(Self->Handle));
+      }
+
+      if (space_left < 0) {
+         log.warning("avail_update() %s", snd_strerror(space_left));
+         return ERR::Failed;
+      }
    }
    else if (Self->AudioBufferSize) { // Run in dummy mode - samples will be processed but not played
       space_left = SAMPLE(Self->AudioBufferSize / Self->DriverBitSize);
@@ -401,27 +412,6 @@ static ERR audio_timer(extAudio *Self, int64_t Elapsed, int64_t CurrentTime)
       return ERR::Terminate;
    }
 
-   // If the audio system is inactive or in a bad state, try to fix it.
-
-   if (space_left < 0) {
-      log.warning("avail_update() %s", snd_strerror(space_left));
-
-      errcount++;
-      if (!(errcount % 50)) {
-         log.warning("Broken audio - attempting fix...");
-
-         Self->deactivate();
-
-         if (Self->activate() != ERR::Okay) {
-            log.warning("Audio error is terminal, self-destructing...");
-            SendMessage(MSGID::FREE, MSF::NIL, &Self->UID, sizeof(OBJECTID));
-            return ERR::Failed;
-         }
-      }
-
-      return ERR::Okay;
-   }
-
    if (space_left > SAMPLE(Self->AudioBufferSize / Self->DriverBitSize)) {
       space_left = SAMPLE(Self->AudioBufferSize / Self->DriverBitSize);
    }
@@ -452,13 +442,14 @@ static ERR audio_timer(extAudio *Self, int64_t Elapsed, int64_t CurrentTime)
 
    // Write the audio to alsa
 
-   if (Self->Handle) {
+   if ((Self->Handle) and (space > 0)) {
       int err;
       if ((err = snd_pcm_writei(Self->Handle, Self->AudioBuffer, space)) < 0) {
          // If an EPIPE error is returned, a buffer underrun has probably occurred
 
          if (err IS -EPIPE) {
             log.msg("A buffer underrun has occurred.");
+            Self->Underruns++;
 
             snd_pcm_status_t *status;
             snd_pcm_status_alloca(&status);
@@ -485,6 +476,178 @@ static ERR audio_timer(extAudio *Self, int64_t Elapsed, int64_t CurrentTime)
       }
    }
 
+   return ERR::Okay;
+}
+
+//********************************************************************************************************************
+// Drains the commands sent to the mixer thread.  Commands that belong to a sequence are passed to their channel set for
+// process_commands() to execute on schedule.
+
+static void receive_commands(extAudio *Self)
+{
+   AudioCommand cmd;
+   while (Self->CommandRing.pop(cmd)) {
+      if (cmd.Buffered) {
+         auto index = cmd.Handle>>16;
+         if ((index > 0) and (index < std::ssize(Self->Sets))) Self->Sets[index].Commands.push_back(cmd);
+      }
+      else execute_command(Self, cmd);
+   }
+}
+
+//********************************************************************************************************************
+// The mixer thread writes to ALSA as soon as the device has space, independently of the main thread's message loop.
+// Client callbacks for stop events are returned to the main thread via StopRing, while stream callbacks are made
+// from this thread.
+
+static void mixer_thread(std::stop_token Stop, extAudio *Self)
+{
+   pf::Log log("MixerThread");
+
+   tlMixerThread = true;
+
+   // Real-time scheduling is a privilege that the host may not grant, in which case we run at normal priority.
+
+   sched_param param = {};
+   param.sched_priority = sched_get_priority_min(SCHED_FIFO) + 10;
+   if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param)) log.msg("Real-time scheduling is unavailable.");
+
+   const int timeout = F2I(MIX_INTERVAL * 1000.0); // In milliseconds; commands are received at least this often
+   int errcount = 0;
+
+   while (!Stop.stop_requested()) {
+      if (Self->Handle) {
+         auto err = snd_pcm_wait(Self->Handle, timeout);
+         if ((err < 0) and (err != -EPIPE) and (err != -ESTRPIPE)) {
+            // Errors are resolved by alsa_feed(), but a short pause prevents spinning on a broken device.
+            std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
+         }
+      }
+      else std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
+
+      const std::lock_guard lock(Self->MixLock);
+
+      receive_commands(Self);
+
+      auto error = alsa_feed(Self);
+      if (error IS ERR::Okay) errcount = 0;
+      else if ((error IS ERR::Terminate) or (++errcount >= 50)) {
+         Self->MixerFailed = true; // audio_timer() will attempt recovery
+         break;
+      }
+   }
+}
+
+//********************************************************************************************************************
+
+static void start_mixer_thread(extAudio *Self)
+{
+   pf::Log log(__FUNCTION__);
+
+   if (Self->MixerThread.joinable()) return;
+
+   log.branch("Starting the mixer thread.");
+
+   Self->MixerFailed = false;
+   Self->MixerThread = std::jthread(mixer_thread, Self);
+}
+
+#endif
+
+//********************************************************************************************************************
+// Stops the mixer thread if it is running.  Commands still in transit are executed on the caller's thread.
+
+static void stop_mixer_thread(extAudio *Self)
+{
+   if (!Self->MixerThread.joinable()) return;
+
+   Self->MixerThread.request_stop();
+   Self->MixerThread.join();
+
+#ifdef ALSA_ENABLED
+   receive_commands(Self);
+
+   MixTimer mt;
+   while (Self->StopRing.pop(mt)) Self->MixTimers.push_back(mt);
+#endif
+}
+
+//********************************************************************************************************************
+// Reinitialises the device after repeated write failures.
+
+#ifdef ALSA_ENABLED
+static ERR recover_alsa(extAudio *Self)
+{
+   pf::Log log(__FUNCTION__);
+
+   log.warning("Broken audio - attempting fix...");
+
+   Self->deactivate();
+
+   if (Self->activate() != ERR::Okay) {
+      log.warning("Audio error is terminal, self-destructing...");
+      SendMessage(MSGID::FREE, MSF::NIL, &Self->UID, sizeof(OBJECTID));
+      return ERR::Failed;
+   }
+
+   if ((Self->Flags & ADF::MIXER_THREAD) != ADF::NIL) start_mixer_thread(Self);
+   return ERR::Okay;
+}
+#endif
+
+//********************************************************************************************************************
+// Ensures that the mixer is running.  This is called from the main thread when a channel starts playback.
+
+static void start_mixing(extAudio *Self)
+{
+   if (tlMixerThread) return; // The mixer is evidently running
+
+   pf::SwitchContext context(Self);
+
+   if (Self->Timer) UpdateTimer(Self->Timer, -MIX_INTERVAL);
+   else SubscribeTimer(MIX_INTERVAL, C_FUNCTION(audio_timer), &Self->Timer);
+
+#ifdef ALSA_ENABLED
+   if ((Self->Flags & ADF::MIXER_THREAD) != ADF::NIL) start_mixer_thread(Self);
+#endif
+}
+
+//********************************************************************************************************************
+// If the mixer thread is running then the timer only delivers stop events and monitors the thread.  Otherwise mixing
+// is performed here.
+
+static ERR audio_timer(extAudio *Self, int64_t Elapsed, int64_t CurrentTime)
+{
+#ifdef ALSA_ENABLED
+
+   static int16_t errcount = 0;
+
+   // Check if we need to send out any OnStop events
+
+   MixTimer notice;
+   while (Self->StopRing.pop(notice)) Self->MixTimers.push_back(notice);
+
+   for (auto it=Self->MixTimers.begin(); it != Self->MixTimers.end(); ) {
+      auto &mt = *it;
+      if (CurrentTime > mt.Time) {
+         audio_stopped_event(*Self, mt.SampleHandle);
+         it = Self->MixTimers.erase(it);
+      }
+      else it++;
+   }
+
+   if (Self->MixerThread.joinable()) {
+      if (!Self->MixerFailed) return ERR::Okay;
+      stop_mixer_thread(Self); // The thread has already retried, so recovery is attempted immediately
+      return recover_alsa(Self);
+   }
+
+   // If the audio system is inactive or in a bad state, try to fix it.
+
+   auto error = alsa_feed(Self);
+   if (error IS ERR::Terminate) return ERR::Terminate;
+   else if ((error != ERR::Okay) and (!(++errcount % 50))) return recover_alsa(Self);
+
    return ERR::Okay;
 
 #elif _WIN32
@@ -3,21 +3,29 @@
 // Main dispatch function that replaces the MixRoutines arrays
 int AudioMixer::dispatch_mix(const AudioConfig& config, SFM sample_format, const MixingParams& params)
 {
-   // Try SIMD optimization first for supported mono-to-stereo cases
-   if (config.stereo_output and !config.use_interpolation and params.total_samples >= 8) {
-      if (sample_format IS SFM::U8_BIT_MONO) {
-#ifdef __AVX2__
-         return mix_vectorized_mono_to_stereo<uint8_t>(
-            params.src, params.src_pos, params.total_samples,
-            params.left_vol, params.right_vol, params.mix_dest);
-#endif
-      }
-      else if (sample_format IS SFM::S16_BIT_MONO) {
-#ifdef __AVX2__
-         return mix_vectorized_mono_to_stereo<int16_t>(
-            params.src, params.src_pos, params.total_samples,
-            params.left_vol, params.right_vol, params.mix_dest);
-#endif
+   // Stereo output is vectorised for all sample formats.  Short runs and those with a non-contiguous next sample
+   // (loop boundaries) are left to the scalar templates.
+
+   if (config.stereo_output and (params.next_sample_offset IS 1) and (params.total_samples >= 8)) {
+      static const auto isa = mixer_simd::best_isa();
+      if (isa != mixer_simd::ISA::SCALAR) {
+         const bool interp = config.use_interpolation;
+         switch (sample_format) {
+            case SFM::U8_BIT_MONO:
+               return interp ? mix_stereo_simd<uint8_t, false, true>(isa, params.src, params.src_pos, params.total_samples, params.left_vol, params.right_vol, params.mix_dest)
+                             : mix_stereo_simd<uint8_t, false, false>(isa, params.src, params.src_pos, params.total_samples, params.left_vol, params.right_vol, params.mix_dest);
+            case SFM::U8_BIT_STEREO:
+               return interp ? mix_stereo_simd<uint8_t, true, true>(isa, params.src, params.src_pos, params.total_samples, params.left_vol, params.right_vol, params.mix_dest)
+                             : mix_stereo_simd<uint8_t, true, false>(isa, params.src, params.src_pos, params.total_samples, params.left_vol, params.right_vol, params.mix_dest);
+            case SFM::S16_BIT_MONO:
+               return interp ? mix_stereo_simd<int16_t, false, true>(isa, params.src, params.src_pos, params.total_samples, params.left_vol, params.right_vol, params.mix_dest)
+                             : mix_stereo_simd<int16_t, false, false>(isa, params.src, params.src_pos, params.total_samples, params.left_vol, params.right_vol, params.mix_dest);
+            case SFM::S16_BIT_STEREO:
+               return interp ? mix_stereo_simd<int16_t, true, true>(isa, params.src, params.src_pos, params.total_samples, params.left_vol, params.right_vol, params.mix_dest)
+                             : mix_stereo_simd<int16_t, true, false>(isa, params.src, params.src_pos, params.total_samples, params.left_vol, params.right_vol, params.mix_dest);
+            default:
+               break;
+         }
       }
    }
 
@@ -0,0 +1,398 @@
+// SIMD kernels for mixing 8 and 16 bit samples into the floating point stereo mix buffer.  The scalar mix_template()
+// in mixers.cpp remains the reference implementation; these kernels follow the same arithmetic in single precision, so
+// results agree with the reference to within rounding.
+//
+// The playback position advances in 16.16 fixed point.  Provided that the step does not exceed 8/7 (AVX2) or 4/3 (SSE2
+// and NEON), a block of output frames is drawn from no more source frames than the block is wide, so those frames are
+// loaded as a single vector and permuted into place.  Blocks that do not qualify, such as those at the end of the
+// run and all backward or high pitched playback, fetch each frame individually.  Gather instructions are avoided as
+// they would read past the end of the sample buffer.
+//
+// SSE2 is the baseline on x64 and an AVX2 variant is selected at runtime if the CPU supports it (GCC and Clang only, as
+// the AVX2 code is compiled with a target attribute).  AArch64 targets use NEON, and all other targets fall back to the
+// scalar implementation.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) or defined(_M_X64) or defined(_M_AMD64)
+   #include <emmintrin.h>
+   #define MIXER_SSE2
+   #if defined(__GNUC__) and (defined(__x86_64__) or defined(__i386__))
+      #include <immintrin.h>
+      #define MIXER_AVX2
+   #endif
+#elif defined(__aarch64__)
+   #include <arm_neon.h>
+   #define MIXER_NEON
+#endif
+
+namespace mixer_simd {
+
+enum class ISA : uint8_t { SCALAR, SSE2, AVX2, NEON };
+
+// Frames are held in 32-bit lanes in their raw form.  Mono samples are extended to 32 bits and stereo frames are packed
+// with the left channel in the low half.  The left and right channels are separated once the frames are in place.
+
+template <class T, bool STEREO>
+inline int32_t frame(const T *Src, int Index) noexcept
+{
+   if constexpr (!STEREO) return Src[Index];
+   else if constexpr (sizeof(T) IS 1) { uint16_t v; memcpy(&v, Src + Index * 2, sizeof(v)); return v; }
+   else { int32_t v; memcpy(&v, Src + Index * 2, sizeof(v)); return v; }
+}
+
+// Returns true if the N frames from Pos can be read as a block and permuted into place.  The frames that follow are
+// also read for interpolation, so the block may not extend beyond Last, the final frame index read by the run.
+
+template <int N>
+inline bool contiguous(int Pos, int Step, int Last) noexcept
+{
+   return (Step > 0) and ((Pos & 0xffff) + (N - 1) * Step < (N << 16)) and ((Pos >> 16) + N - 1 <= Last);
+}
+
+inline int last_frame(int Pos, int Step, int Total) noexcept
+{
+   return (Step > 0) ? (Pos + (Total - 1) * Step) >> 16 : -1;
+}
+
+//********************************************************************************************************************
+// Each kernel mixes whole blocks of frames and returns the updated source position.  Total is reduced by the number
+// of frames mixed and Dest is advanced past them; the caller mixes any remainder with the scalar routine.
+
+#ifdef MIXER_SSE2
+
+template <class T, bool STEREO>
+inline __m128i load_frames_sse2(const T *Src) noexcept
+{
+   const __m128i zero = _mm_setzero_si128();
+   if constexpr (sizeof(T) IS 1) {
+      if constexpr (STEREO) return _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *)Src), zero);
+      else {
+         int32_t v;
+         memcpy(&v, Src, sizeof(v));
+         return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(v), zero), zero);
+      }
+   }
+   else if constexpr (STEREO) return _mm_loadu_si128((const __m128i *)Src);
+   else {
+      const __m128i v = _mm_loadl_epi64((const __m128i *)Src);
+      return _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+   }
+}
+
+// Normalises the frames to the 16 bit range, matching SampleTraits<>::normalize().
+
+template <class T, bool STEREO>
+inline void split_sse2(__m128i Frames, __m128 &Left, __m128 &Right) noexcept
+{
+   if constexpr (sizeof(T) IS 1) {
+      const __m128i bias = _mm_set1_epi32(128);
+      if constexpr (STEREO) {
+         Left  = _mm_cvtepi32_ps(_mm_slli_epi32(_mm_sub_epi32(_mm_and_si128(Frames, _mm_set1_epi32(0xff)), bias), 8));
+         Right = _mm_cvtepi32_ps(_mm_slli_epi32(_mm_sub_epi32(_mm_srli_epi32(Frames, 8), bias), 8));
+      }
+      else Left = Right = _mm_cvtepi32_ps(_mm_slli_epi32(_mm_sub_epi32(Frames, bias), 8));
+   }
+   else if constexpr (STEREO) {
+      Left  = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(Frames, 16), 16));
+      Right = _mm_cvtepi32_ps(_mm_srai_epi32(Frames, 16));
+   }
+   else Left = Right = _mm_cvtepi32_ps(Frames);
+}
+
+template <class T, bool STEREO, bool INTERP>
+int mix_sse2(const T *Src, int Pos, int Step, int &Total, float LeftVol, float RightVol, float *&Dest) noexcept
+{
+   const __m128 lvol  = _mm_set1_ps(LeftVol);
+   const __m128 rvol  = _mm_set1_ps(RightVol);
+   const __m128 scale = _mm_set1_ps(1.0f / 65536.0f);
+   const __m128i offsets = _mm_setr_epi32(0, Step, Step * 2, Step * 3);
+   const int last = last_frame(Pos, Step, Total);
+   constexpr int CH = STEREO ? 2 : 1;
+
+   for (; Total >= 4; Total -= 4) {
+      const __m128i pos = _mm_add_epi32(_mm_set1_epi32(Pos), offsets); // Pos + lane * Step
+      const int index = Pos >> 16;
+
+      __m128i a, b;
+      if (contiguous<4>(Pos, Step, last)) {
+         // The relative frame index of each lane selects from the block with a compare for each frame.
+
+         const __m128i rel = _mm_sub_epi32(_mm_srai_epi32(pos, 16), _mm_set1_epi32(index));
+         const __m128i m1 = _mm_cmpeq_epi32(rel, _mm_set1_epi32(1));
+         const __m128i m2 = _mm_cmpeq_epi32(rel, _mm_set1_epi32(2));
+         const __m128i m3 = _mm_cmpeq_epi32(rel, _mm_set1_epi32(3));
+         const __m128i m0 = _mm_cmpeq_epi32(rel, _mm_setzero_si128());
+         auto select = [&](__m128i W) {
+            return _mm_or_si128(_mm_or_si128(_mm_and_si128(m0, _mm_shuffle_epi32(W, 0x00)), _mm_and_si128(m1, _mm_shuffle_epi32(W, 0x55))),
+                                _mm_or_si128(_mm_and_si128(m2, _mm_shuffle_epi32(W, 0xaa)), _mm_and_si128(m3, _mm_shuffle_epi32(W, 0xff))));
+         };
+         a = select(load_frames_sse2<T, STEREO>(Src + index * CH));
+         if constexpr (INTERP) b = select(load_frames_sse2<T, STEREO>(Src + (index + 1) * CH));
+      }
+      else {
+         const int p1 = Pos + Step, p2 = p1 + Step, p3 = p2 + Step;
+         a = _mm_setr_epi32(frame<T, STEREO>(Src, index), frame<T, STEREO>(Src, p1 >> 16), frame<T, STEREO>(Src, p2 >> 16), frame<T, STEREO>(Src, p3 >> 16));
+         if constexpr (INTERP) {
+            b = _mm_setr_epi32(frame<T, STEREO>(Src, index + 1), frame<T, STEREO>(Src, (p1 >> 16) + 1),
+               frame<T, STEREO>(Src, (p2 >> 16) + 1), frame<T, STEREO>(Src, (p3 >> 16) + 1));
+         }
+      }
+      Pos += Step * 4;
+
+      __m128 left, right;
+      split_sse2<T, STEREO>(a, left, right);
+      if constexpr (INTERP) {
+         __m128 next_left, next_right;
+         split_sse2<T, STEREO>(b, next_left, next_right);
+         const __m128 weight = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(pos, _mm_set1_epi32(0xffff))), scale);
+         left = _mm_add_ps(left, _mm_mul_ps(_mm_sub_ps(next_left, left), weight));
+         right = STEREO ? _mm_add_ps(right, _mm_mul_ps(_mm_sub_ps(next_right, right), weight)) : left;
+      }
+      left  = _mm_mul_ps(left, lvol);
+      right = _mm_mul_ps(right, rvol);
+
+      _mm_storeu_ps(Dest, _mm_add_ps(_mm_loadu_ps(Dest), _mm_unpacklo_ps(left, right)));
+      _mm_storeu_ps(Dest + 4, _mm_add_ps(_mm_loadu_ps(Dest + 4), _mm_unpackhi_ps(left, right)));
+      Dest += 8;
+   }
+   return Pos;
+}
+
+#endif
+
+#ifdef MIXER_AVX2
+
+template <class T, bool STEREO>
+__attribute__((target("avx2"))) inline __m256i load_frames_avx2(const T *Src) noexcept
+{
+   if constexpr (sizeof(T) IS 1) {
+      if constexpr (STEREO) return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)Src));
+      else return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)Src));
+   }
+   else if constexpr (STEREO) return _mm256_loadu_si256((const __m256i *)Src);
+   else return _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)Src));
+}
+
+template <class T, bool STEREO>
+__attribute__((target("avx2"))) inline void split_avx2(__m256i Frames, __m256 &Left, __m256 &Right) noexcept
+{
+   if constexpr (sizeof(T) IS 1) {
+      const __m256i bias = _mm256_set1_epi32(128);
+      if constexpr (STEREO) {
+         Left  = _mm256_cvtepi32_ps(_mm256_slli_epi32(_mm256_sub_epi32(_mm256_and_si256(Frames, _mm256_set1_epi32(0xff)), bias), 8));
+         Right = _mm256_cvtepi32_ps(_mm256_slli_epi32(_mm256_sub_epi32(_mm256_srli_epi32(Frames, 8), bias), 8));
+      }
+      else Left = Right = _mm256_cvtepi32_ps(_mm256_slli_epi32(_mm256_sub_epi32(Frames, bias), 8));
+   }
+   else if constexpr (STEREO) {
+      Left  = _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(Frames, 16), 16));
+      Right = _mm256_cvtepi32_ps(_mm256_srai_epi32(Frames, 16));
+   }
+   else Left = Right = _mm256_cvtepi32_ps(Frames);
+}
+
+template <class T, bool STEREO, bool INTERP>
+__attribute__((target("avx2"))) int mix_avx2(const T *Src, int Pos, int Step, int &Total, float LeftVol, float RightVol, float *&Dest) noexcept
+{
+   const __m256 lvol  = _mm256_set1_ps(LeftVol);
+   const __m256 rvol  = _mm256_set1_ps(RightVol);
+   const __m256 scale = _mm256_set1_ps(1.0f / 65536.0f);
+   const __m256i offsets = _mm256_setr_epi32(0, Step, Step * 2, Step * 3, Step * 4, Step * 5, Step * 6, Step * 7);
+   const int last = last_frame(Pos, Step, Total);
+   constexpr int CH = STEREO ? 2 : 1;
+
+   for (; Total >= 8; Total -= 8) {
+      const __m256i pos = _mm256_add_epi32(_mm256_set1_epi32(Pos), offsets);
+      const int index = Pos >> 16;
+
+      __m256i a, b;
+      if (contiguous<8>(Pos, Step, last)) {
+         const __m256i rel = _mm256_sub_epi32(_mm256_srai_epi32(pos, 16), _mm256_set1_epi32(index));
+         a = _mm256_permutevar8x32_epi32(load_frames_avx2<T, STEREO>(Src + index * CH), rel);
+         if constexpr (INTERP) b = _mm256_permutevar8x32_epi32(load_frames_avx2<T, STEREO>(Src + (index + 1) * CH), rel);
+      }
+      else {
+         alignas(32) int32_t idx[8];
+         _mm256_store_si256((__m256i *)idx, _mm256_srai_epi32(pos, 16));
+         auto fetch = [&](int Offset) __attribute__((target("avx2"))) {
+            return _mm256_setr_epi32(frame<T, STEREO>(Src, idx[0] + Offset), frame<T, STEREO>(Src, idx[1] + Offset),
+               frame<T, STEREO>(Src, idx[2] + Offset), frame<T, STEREO>(Src, idx[3] + Offset),
+               frame<T, STEREO>(Src, idx[4] + Offset), frame<T, STEREO>(Src, idx[5] + Offset),
+               frame<T, STEREO>(Src, idx[6] + Offset), frame<T, STEREO>(Src, idx[7] + Offset));
+         };
+         a = fetch(0);
+         if constexpr (INTERP) b = fetch(1);
+      }
+      Pos += Step * 8;
+
+      __m256 left, right;
+      split_avx2<T, STEREO>(a, left, right);
+      if constexpr (INTERP) {
+         __m256 next_left, next_right;
+         split_avx2<T, STEREO>(b, next_left, next_right);
+         const __m256 weight = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(pos, _mm256_set1_epi32(0xffff))), scale);
+         left = _mm256_add_ps(left, _mm256_mul_ps(_mm256_sub_ps(next_left, left), weight));
+         right = STEREO ? _mm256_add_ps(right, _mm256_mul_ps(_mm256_sub_ps(next_right, right), weight)) : left;
+      }
+      left  = _mm256_mul_ps(left, lvol);
+      right = _mm256_mul_ps(right, rvol);
+
+      // Unpacking operates within 128-bit lanes, producing frames 0,1,4,5 and 2,3,6,7.
+
+      const __m256 lo = _mm256_unpacklo_ps(left, right);
+      const __m256 hi = _mm256_unpackhi_ps(left, right);
+      _mm256_storeu_ps(Dest, _mm256_add_ps(_mm256_loadu_ps(Dest), _mm256_permute2f128_ps(lo, hi, 0x20)));
+      _mm256_storeu_ps(Dest + 8, _mm256_add_ps(_mm256_loadu_ps(Dest + 8), _mm256_permute2f128_ps(lo, hi, 0x31)));
+      Dest += 16;
+   }
+   return Pos;
+}
+
+#endif
+
+#ifdef MIXER_NEON
+
+template <class T, bool STEREO>
+inline int32x4_t load_frames_neon(const T *Src) noexcept
+{
+   if constexpr (sizeof(T) IS 1) {
+      if constexpr (STEREO) return vreinterpretq_s32_u32(vmovl_u16(vld1_u16((const uint16_t *)Src)));
+      else {
+         uint32_t v;
+         memcpy(&v, Src, sizeof(v));
+         return vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(vmovl_u8(vcreate_u8(v)))));
+      }
+   }
+   else if constexpr (STEREO) return vld1q_s32((const int32_t *)Src);
+   else return vmovl_s16(vld1_s16(Src));
+}
+
+template <class T, bool STEREO>
+inline void split_neon(int32x4_t Frames, float32x4_t &Left, float32x4_t &Right) noexcept
+{
+   if constexpr (sizeof(T) IS 1) {
+      const int32x4_t bias = vdupq_n_s32(128);
+      if constexpr (STEREO) {
+         Left  = vcvtq_f32_s32(vshlq_n_s32(vsubq_s32(vandq_s32(Frames, vdupq_n_s32(0xff)), bias), 8));
+         Right = vcvtq_f32_s32(vshlq_n_s32(vsubq_s32(vshrq_n_s32(Frames, 8), bias), 8));
+      }
+      else Left = Right = vcvtq_f32_s32(vshlq_n_s32(vsubq_s32(Frames, bias), 8));
+   }
+   else if constexpr (STEREO) {
+      Left  = vcvtq_f32_s32(vshrq_n_s32(vshlq_n_s32(Frames, 16), 16));
+      Right = vcvtq_f32_s32(vshrq_n_s32(Frames, 16));
+   }
+   else Left = Right = vcvtq_f32_s32(Frames);
+}
+
+template <class T, bool STEREO, bool INTERP>
+int mix_neon(const T *Src, int Pos, int Step, int &Total, float LeftVol, float RightVol, float *&Dest) noexcept
+{
+   const int32_t lane_offsets[4] = { 0, Step, Step * 2, Step * 3 };
+   const float32x4_t scale = vdupq_n_f32(1.0f / 65536.0f);
+   const int32x4_t offsets = vld1q_s32(lane_offsets);
+   const int last = last_frame(Pos, Step, Total);
+   constexpr int CH = STEREO ? 2 : 1;
+
+   for (; Total >= 4; Total -= 4) {
+      const int32x4_t pos = vaddq_s32(vdupq_n_s32(Pos), offsets);
+      const int index = Pos >> 16;
+
+      int32x4_t a, b;
+      if (contiguous<4>(Pos, Step, last)) {
+         // The table lookup selects the four bytes of each lane's frame from the block.
+
+         const uint32x4_t rel = vreinterpretq_u32_s32(vsubq_s32(vshrq_n_s32(pos, 16), vdupq_n_s32(index)));
+         const uint8x16_t bytes = vreinterpretq_u8_u32(vmlaq_n_u32(vdupq_n_u32(0x03020100), rel, 0x04040404));
+         a = vreinterpretq_s32_u8(vqtbl1q_u8(vreinterpretq_u8_s32(load_frames_neon<T, STEREO>(Src + index * CH)), bytes));
+         if constexpr (INTERP) b = vreinterpretq_s32_u8(vqtbl1q_u8(vreinterpretq_u8_s32(load_frames_neon<T, STEREO>(Src + (index + 1) * CH)), bytes));
+      }
+      else {
+         const int p1 = Pos + Step, p2 = p1 + Step, p3 = p2 + Step;
+         const int32_t frames_a[4] = { frame<T, STEREO>(Src, index), frame<T, STEREO>(Src, p1 >> 16), frame<T, STEREO>(Src, p2 >> 16), frame<T, STEREO>(Src, p3 >> 16) };
+         a = vld1q_s32(frames_a);
+         if constexpr (INTERP) {
+            const int32_t frames_b[4] = { frame<T, STEREO>(Src, index + 1), frame<T, STEREO>(Src, (p1 >> 16) + 1),
+               frame<T, STEREO>(Src, (p2 >> 16) + 1), frame<T, STEREO>(Src, (p3 >> 16) + 1) };
+            b = vld1q_s32(frames_b);
+         }
+      }
+      Pos += Step * 4;
+
+      float32x4_t left, right;
+      split_neon<T, STEREO>(a, left, right);
+      if constexpr (INTERP) {
+         float32x4_t next_left, next_right;
+         split_neon<T, STEREO>(b, next_left, next_right);
+         const float32x4_t weight = vmulq_f32(vcvtq_f32_s32(vandq_s32(pos, vdupq_n_s32(0xffff))), scale);
+         left = vaddq_f32(left, vmulq_f32(vsubq_f32(next_left, left), weight));
+         right = STEREO ? vaddq_f32(right, vmulq_f32(vsubq_f32(next_right, right), weight)) : left;
+      }
+
+      // The interleaved load and store separate the left and right channels of the mix buffer.
+
+      float32x4x2_t mix = vld2q_f32(Dest);
+      mix.val[0] = vaddq_f32(mix.val[0], vmulq_n_f32(left, LeftVol));
+      mix.val[1] = vaddq_f32(mix.val[1], vmulq_n_f32(right, RightVol));
+      vst2q_f32(Dest, mix);
+      Dest += 8;
+   }
+   return Pos;
+}
+
+#endif
+
+//********************************************************************************************************************
+
+inline bool isa_supported(ISA Isa) noexcept
+{
+   switch (Isa) {
+      case ISA::SCALAR: return true;
+#ifdef MIXER_SSE2
+      case ISA::SSE2: return true;
+#endif
+#ifdef MIXER_AVX2
+      case ISA::AVX2: return __builtin_cpu_supports("avx2");
+#endif
+#ifdef MIXER_NEON
+      case ISA::NEON: return true;
+#endif
+      default: return false;
+   }
+}
+
+inline ISA best_isa() noexcept
+{
+   static const ISA isa = []() {
+      if (isa_supported(ISA::AVX2)) return ISA::AVX2;
+      if (isa_supported(ISA::SSE2)) return ISA::SSE2;
+      if (isa_supported(ISA::NEON)) return ISA::NEON;
+      return ISA::SCALAR;
+   }();
+   return isa;
+}
+
+// Mixes as many whole blocks as the instruction set allows.  Nothing is mixed for ISA::SCALAR.
+
+template <class T, bool STEREO, bool INTERP>
+int mix_blocks(ISA Isa, const T *Src, int Pos, int Step, int &Total, float LeftVol, float RightVol, float *&Dest) noexcept
+{
+   switch (Isa) {
+#ifdef MIXER_SSE2
+      case ISA::SSE2: return mix_sse2<T, STEREO, INTERP>(Src, Pos, Step, Total, LeftVol, RightVol, Dest);
+#endif
+#ifdef MIXER_AVX2
+      case ISA::AVX2: return mix_avx2<T, STEREO, INTERP>(Src, Pos, Step, Total, LeftVol, RightVol, Dest);
+#endif
+#ifdef MIXER_NEON
+      case ISA::NEON: return mix_neon<T, STEREO, INTERP>(Src, Pos, Step, Total, LeftVol, RightVol, Dest);
+#endif
+      default: return Pos;
+   }
+}
+
+} // namespace mixer_simd
@@ -1,5 +1,5 @@
 
-#include <immintrin.h>  // For SIMD support where available
+#include "mixer_simd.h"
 
 // Thread-local step value for mixing (temporary solution)
 thread_local int MixStep = 1;
@@ -147,72 +147,18 @@ static int mix_template(APTR Src, int SrcPos, int TotalSamples, int nextSampleOf
 }
 
 //********************************************************************************************************************
-// Vectorized mixer for high-performance scenarios (when sample count is large)
+// Vectorised mixing into a stereo mix buffer.  The kernels in mixer_simd.h process whole blocks of frames and the
+// remainder is passed to the scalar template.  The next sample is always assumed to follow the current one, so callers
+// must use mix_template() when nextSampleOffset is not 1.
 
-#ifdef __AVX2__
-template<typename SampleType>
-static int mix_vectorized_mono_to_stereo(APTR Src, int SrcPos, int TotalSamples,
-                                         float LeftVol, float RightVol, float **MixDest)
+template<typename SampleType, bool IsStereoSample, bool UseInterpolation>
+static int mix_stereo_simd(mixer_simd::ISA Isa, APTR Src, int SrcPos, int TotalSamples, float LeftVol, float RightVol, float **MixDest)
 {
-   // Use vectorized version only for sufficiently large sample counts
-   if (TotalSamples < 8) {
-      return mix_template<SampleType, false, true, false>(Src, SrcPos, TotalSamples, 1, LeftVol, RightVol, MixDest);
-   }
-
-   auto dest = *MixDest;
-   auto sample = (SampleType *)Src;
-
-   const __m256 leftVol = _mm256_set1_ps(LeftVol);
-   const __m256 rightVol = _mm256_set1_ps(RightVol);
-
-   // Process 4 samples at a time (AVX can handle 8 floats, we need 2 per sample for stereo)
-   while (TotalSamples >= 4) {
-      // Load 4 samples
-      __m128i samples;
-      if constexpr (std::is_same_v<SampleType, uint8_t>) {
-         samples = _mm_set_epi32(sample[(SrcPos + 3*MixStep) >> 16],
-                                sample[(SrcPos + 2*MixStep) >> 16],
-                                sample[(SrcPos + MixStep) >> 16],
-                                sample[SrcPos >> 16]);
-      } else {
-         samples = _mm_set_epi32(sample[(SrcPos + 3*MixStep) >> 16],
-                                sample[(SrcPos + 2*MixStep) >> 16],
-                                sample[(SrcPos + MixStep) >> 16],
-                                sample[SrcPos >> 16]);
-      }
-
-      // Convert to float and apply normalization
-      __m256 normalized;
-      if constexpr (std::is_same_v<SampleType, uint8_t>) {
-         __m256 temp = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(samples));
-         normalized = _mm256_mul_ps(_mm256_sub_ps(temp, _mm256_set1_ps(128.0f)), _mm256_set1_ps(256.0f));
-      } else {
-         normalized = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(samples));
-      }
+   SrcPos = mixer_simd::mix_blocks<SampleType, IsStereoSample, UseInterpolation>(Isa, (const SampleType *)Src, SrcPos,
+      MixStep, TotalSamples, LeftVol, RightVol, *MixDest);
 
-      // Create left and right channels
-      __m256 left = _mm256_mul_ps(normalized, leftVol);
-      __m256 right = _mm256_mul_ps(normalized, rightVol);
-
-      // Interleave and store
-      __m256 destVec = _mm256_loadu_ps(dest);
-      __m256 interleaved_lo = _mm256_unpacklo_ps(left, right);
-      __m256 interleaved_hi = _mm256_unpackhi_ps(left, right);
-
-      _mm256_storeu_ps(dest, _mm256_add_ps(destVec, interleaved_lo));
-      _mm256_storeu_ps(dest + 4, _mm256_add_ps(_mm256_loadu_ps(dest + 4), interleaved_hi));
-
-      dest += 8;
-      SrcPos += 4 * MixStep;
-      TotalSamples -= 4;
-   }
-
-   // Handle remaining samples with scalar code
-   *MixDest = dest;
    if (TotalSamples > 0) {
-      return mix_template<SampleType, false, true, false>(Src, SrcPos, TotalSamples, 1, LeftVol, RightVol, MixDest);
+      return mix_template<SampleType, IsStereoSample, true, UseInterpolation>(Src, SrcPos, TotalSamples, 1, LeftVol, RightVol, MixDest);
    }
-
    return SrcPos;
 }
-#endif
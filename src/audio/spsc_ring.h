@@ -0,0 +1,33 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Bounded single-producer/single-consumer queue.  Neither side takes a lock, so the mixer thread can consume without
+// risk of waiting on a client.  Push() fails if the queue is full.
+
+template <class T, uint32_t SIZE> class SPSCRing {
+   static_assert((SIZE & (SIZE - 1)) IS 0, "The ring size must be a power of two.");
+
+   std::array<T, SIZE> buffer;
+   alignas(64) std::atomic<uint32_t> head = 0; // Next write position, advanced by the producer
+   alignas(64) std::atomic<uint32_t> tail = 0; // Next read position, advanced by the consumer
+
+   public:
+   bool push(const T &Item) {
+      const auto h = head.load(std::memory_order_relaxed);
+      if (h - tail.load(std::memory_order_acquire) >= SIZE) return false;
+      buffer[h & (SIZE - 1)] = Item;
+      head.store(h + 1, std::memory_order_release);
+      return true;
+   }
+
+   bool pop(T &Item) {
+      const auto t = tail.load(std::memory_order_relaxed);
+      if (t IS head.load(std::memory_order_acquire)) return false;
+      Item = buffer[t & (SIZE - 1)];
+      tail.store(t + 1, std::memory_order_release);
+      return true;
+   }
+};
@@ -10,6 +10,9 @@
 #include <iomanip>
 #include <algorithm>
 #include <cstdint>
+#include <chrono>
+#include <sstream>
+#include <string>
 #include <kotuku/main.h>
 
 #ifndef M_PI
@@ -358,7 +361,149 @@ public:
       test_result("Sample position advancement", passed);
    }
 
-   void run_all_tests() {
+   // Compares each SIMD kernel against the scalar template for every sample format, with forward, backward and
+   // resampled playback.  Kernels compute in single precision, so results must agree to within a small fraction of
+   // the 16 bit sample range rather than exactly.
+
+   template<typename SampleType, bool IsStereoSample, bool UseInterpolation>
+   double compare_kernel(mixer_simd::ISA isa, const std::vector<SampleType>& source, int step, int startPos, int frames) {
+      std::vector<float> reference(frames * 2 + 2), vectorised(frames * 2 + 2);
+      for (size_t i = 0; i < reference.size(); i++) reference[i] = vectorised[i] = float(int(i % 7) - 3) * 100.0f;
+
+      set_mix_step(step);
+      float* refDest = reference.data();
+      float* vecDest = vectorised.data();
+      const int refPos = mix_template<SampleType, IsStereoSample, true, UseInterpolation>(
+         (APTR)source.data(), startPos, frames, 1, 0.7f, 0.3f, &refDest);
+      const int vecPos = mix_stereo_simd<SampleType, IsStereoSample, UseInterpolation>(
+         isa, (APTR)source.data(), startPos, frames, 0.7f, 0.3f, &vecDest);
+      set_mix_step(65536);
+
+      if ((refPos != vecPos) or (refDest != reference.data() + frames * 2) or (vecDest != vectorised.data() + frames * 2)) {
+         std::cout << "Kernel position mismatch: expected " << refPos << ", got " << vecPos << std::endl;
+         return -1;
+      }
+
+      double maxError = 0;
+      for (size_t i = 0; i < reference.size(); i++) {
+         const double error = std::abs(double(reference[i]) - double(vectorised[i]));
+         if (error > 2e-6 * (32768.0 + std::abs(reference[i]))) {
+            std::cout << "Sample " << i << " expected " << reference[i] << ", got " << vectorised[i] << std::endl;
+            return -1;
+         }
+         maxError = std::max(maxError, error);
+      }
+      return maxError;
+   }
+
+   template<typename SampleType, bool IsStereoSample, bool UseInterpolation>
+   bool compare_format(mixer_simd::ISA isa, const std::vector<SampleType>& source, int sourceFrames, double& maxError) {
+      struct Run { int step, startPos; };
+      const Run runs[] = {
+         { 65536, 0 },                           // Native rate
+         { 60211, 3 << 16 },                     // 44.1 kHz played at 48 kHz
+         { 98304, 0x1234 },                      // 1.5x pitch with a fractional start
+         { -45000, (sourceFrames - 2) << 16 }    // Backward playback
+      };
+
+      for (auto& run : runs) {
+         for (int frames : { 8, 203 }) { // The second run count leaves a remainder for the scalar tail
+            const double error = compare_kernel<SampleType, IsStereoSample, UseInterpolation>(isa, source, run.step, run.startPos, frames);
+            if (error < 0) return false;
+            maxError = std::max(maxError, error);
+         }
+      }
+      return true;
+   }
+
+   void test_simd_kernels() {
+      const int frames = 512;
+      auto mono8 = SineWaveGenerator::generate8BitMono(frames, 7.0);
+      auto stereo8 = SineWaveGenerator::generate8BitStereo(frames, 7.0);
+      auto mono16 = SineWaveGenerator::generate16BitMono(frames, 7.0);
+      auto stereo16 = SineWaveGenerator::generate16BitStereo(frames, 7.0);
+
+      for (auto isa : { mixer_simd::ISA::SSE2, mixer_simd::ISA::AVX2, mixer_simd::ISA::NEON }) {
+         if (!mixer_simd::isa_supported(isa)) continue;
+
+         double maxError = 0;
+         bool passed = compare_format<uint8_t, false, false>(isa, mono8, frames, maxError) and
+                       compare_format<uint8_t, false, true>(isa, mono8, frames, maxError) and
+                       compare_format<uint8_t, true, false>(isa, stereo8, frames, maxError) and
+                       compare_format<uint8_t, true, true>(isa, stereo8, frames, maxError) and
+                       compare_format<int16_t, false, false>(isa, mono16, frames, maxError) and
+                       compare_format<int16_t, false, true>(isa, mono16, frames, maxError) and
+                       compare_format<int16_t, true, false>(isa, stereo16, frames, maxError) and
+                       compare_format<int16_t, true, true>(isa, stereo16, frames, maxError);
+
+         std::ostringstream name;
+         name << isa_name(isa) << " kernels match the scalar mixer (max error " << std::setprecision(3) << maxError << ")";
+         test_result(name.str(), passed);
+      }
+   }
+
+   static const char * isa_name(mixer_simd::ISA isa) {
+      switch (isa) {
+         case mixer_simd::ISA::SSE2: return "SSE2";
+         case mixer_simd::ISA::AVX2: return "AVX2";
+         case mixer_simd::ISA::NEON: return "NEON";
+         default: return "Scalar";
+      }
+   }
+
+   // Throughput is measured for 32 voices resampled from 44.1 kHz to 48 kHz, which is typical of audio-heavy
+   // applications.  The scalar figures are for the reference template.
+
+   template<typename SampleType, bool IsStereoSample, bool UseInterpolation>
+   void benchmark_format(const char* formatName, const std::vector<SampleType>& source) {
+      const int voices = 32, frames = 1024, step = 60211;
+      std::vector<float> mixBuffer(frames * 2, 0.0f);
+
+      std::cout << "  " << std::left << std::setw(22) << formatName << std::right;
+      for (auto isa : { mixer_simd::ISA::SCALAR, mixer_simd::ISA::SSE2, mixer_simd::ISA::AVX2, mixer_simd::ISA::NEON }) {
+         if (!mixer_simd::isa_supported(isa)) continue;
+
+         set_mix_step(step);
+         int64_t mixed = 0;
+         const auto start = std::chrono::steady_clock::now();
+         double elapsed;
+         do {
+            for (int voice = 0; voice < voices; voice++) {
+               float* dest = mixBuffer.data();
+               if (isa IS mixer_simd::ISA::SCALAR) {
+                  mix_template<SampleType, IsStereoSample, true, UseInterpolation>((APTR)source.data(), voice, frames, 1, 0.5f, 0.5f, &dest);
+               }
+               else mix_stereo_simd<SampleType, IsStereoSample, UseInterpolation>(isa, (APTR)source.data(), voice, frames, 0.5f, 0.5f, &dest);
+            }
+            mixed += voices * frames;
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+         } while (elapsed < 0.02);
+         set_mix_step(65536);
+
+         std::cout << "  " << isa_name(isa) << " " << std::fixed << std::setprecision(1) << std::setw(7) << (mixed / elapsed / 1000000.0) << " M/s";
+      }
+      std::cout << std::endl;
+   }
+
+   void benchmark_kernels() {
+      const int frames = 1200; // Sufficient for 1024 output frames at the benchmark step
+      auto mono8 = SineWaveGenerator::generate8BitMono(frames, 7.0);
+      auto stereo8 = SineWaveGenerator::generate8BitStereo(frames, 7.0);
+      auto mono16 = SineWaveGenerator::generate16BitMono(frames, 7.0);
+      auto stereo16 = SineWaveGenerator::generate16BitStereo(frames, 7.0);
+
+      std::cout << std::endl << "Mixing throughput into a stereo buffer (samples/sec):" << std::endl;
+      benchmark_format<uint8_t, false, false>("8-bit mono", mono8);
+      benchmark_format<uint8_t, false, true>("8-bit mono interp", mono8);
+      benchmark_format<uint8_t, true, false>("8-bit stereo", stereo8);
+      benchmark_format<uint8_t, true, true>("8-bit stereo interp", stereo8);
+      benchmark_format<int16_t, false, false>("16-bit mono", mono16);
+      benchmark_format<int16_t, false, true>("16-bit mono interp", mono16);
+      benchmark_format<int16_t, true, false>("16-bit stereo", stereo16);
+      benchmark_format<int16_t, true, true>("16-bit stereo interp", stereo16);
+   }
+
+   bool run_all_tests() {
       std::cout << "Running Audio Mixer Unit Tests..." << std::endl;
       std::cout << "=================================" << std::endl;
 
@@ -371,6 +516,7 @@ public:
       test_interpolation_accuracy();
       test_additive_mixing();
       test_sample_position_advancement();
+      test_simd_kernels();
 
       std::cout << std::endl;
       std::cout << "Test Results: " << testsPassed << "/" << testsTotal << " passed";
@@ -379,6 +525,9 @@ public:
       } else {
          std::cout << " ✗ " << (testsTotal - testsPassed) << " tests failed." << std::endl;
       }
+
+      if (testsPassed == testsTotal) benchmark_kernels();
+      return testsPassed == testsTotal;
    }
 };
 
@@ -387,6 +536,5 @@ public:
 
 int main() {
    MixerTests tests;
-   tests.run_all_tests();
-   return 0;
+   return tests.run_all_tests() ? 0 : -1;
 }
\ No newline at end of file
@@ -0,0 +1,97 @@
+//********************************************************************************************************************
+// Unit Tests for SPSCRing - the command queue between clients and the mixer thread
+//********************************************************************************************************************
+
+#include <iostream>
+#include <cstdint>
+#include <thread>
+#include <kotuku/main.h>
+
+#include "spsc_ring.h"
+
+static int glFailures = 0;
+
+static void check(bool Result, const char *Test)
+{
+   if (Result) std::cout << "✓ " << Test << "\n";
+   else {
+      std::cout << "✗ " << Test << "\n";
+      glFailures++;
+   }
+}
+
+//********************************************************************************************************************
+// A full ring rejects further pushes, and items are returned in the order that they were pushed.
+
+static void test_capacity()
+{
+   SPSCRing<int, 8> ring;
+   int value;
+
+   check(!ring.pop(value), "An empty ring returns nothing");
+
+   bool pushed = true;
+   for (int i=0; i < 8; i++) pushed &= ring.push(i);
+   check(pushed, "A ring accepts SIZE items");
+   check(!ring.push(8), "A full ring rejects a push");
+
+   bool ordered = true;
+   for (int i=0; i < 8; i++) ordered &= (ring.pop(value) and (value IS i));
+   check(ordered, "Items are popped in FIFO order");
+   check(!ring.pop(value), "A drained ring returns nothing");
+}
+
+//********************************************************************************************************************
+// The read and write positions wrap around the buffer many times without losing or repeating items.
+
+static void test_wrap()
+{
+   SPSCRing<int, 4> ring;
+   int next_push = 0, next_pop = 0, value;
+   bool ordered = true;
+
+   for (int round=0; round < 10000; round++) {
+      const int count = (round % 4) + 1;
+      for (int i=0; i < count; i++) ring.push(next_push++);
+      while (ring.pop(value)) ordered &= (value IS next_pop++);
+   }
+
+   check(ordered and (next_pop IS next_push), "Items survive repeated wrapping of the ring");
+}
+
+//********************************************************************************************************************
+// A producer and consumer on separate threads exchange a sequence.  The consumer must receive every item in order.
+
+static void test_threads()
+{
+   static SPSCRing<uint32_t, 1024> ring;
+   constexpr uint32_t TOTAL = 2000000;
+
+   std::thread producer([]() {
+      for (uint32_t i=0; i < TOTAL; i++) {
+         while (!ring.push(i)) std::this_thread::yield();
+      }
+   });
+
+   uint32_t expected = 0, value;
+   bool ordered = true;
+   while (expected < TOTAL) {
+      if (ring.pop(value)) ordered &= (value IS expected++);
+      else std::this_thread::yield();
+   }
+
+   producer.join();
+   check(ordered, "Items cross threads without loss, duplication or reordering");
+}
+
+//********************************************************************************************************************
+
+int main(int argc, char **argv)
+{
+   test_capacity();
+   test_wrap();
+   test_threads();
+
+   if (glFailures) std::cout << glFailures << " tests failed.\n";
+   return glFailures ? -1 : 0;
+}
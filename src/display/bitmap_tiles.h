@@ -0,0 +1,349 @@
+// Tiled storage for compressed bitmaps.  The Core module header must be included prior to inclusion.
+//
+// The image is divided into 64x64 tiles that are encoded independently, so that a draw or read operation only needs to
+// restore the tiles that it touches.  The encoding is designed for the content of document and interface bitmaps:
+// runs of a single pixel value, runs of transparent (zero) pixels and runs that repeat the row above are each stored as
+// a single control byte, while everything else is stored as literal pixels.  Encoding and decoding run close to memory
+// speed, which is not the case for zlib.
+//
+// Encoded tiles are immutable and shared by reference.  Identical tiles, of which blank areas are the common case, are
+// deduplicated through a process-wide cache that is keyed on a hash of the pixels.  A bitmap that writes to a restored
+// tile releases its reference, so new storage is only consumed when modified tiles are compressed again.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace bitmap_tiles {
+
+constexpr int TILE_SIZE = 64;
+
+// Control bytes store the operation in the top two bits and the pixel count minus one in the low six bits, which is
+// sufficient for a complete tile row.
+
+enum OP : uint8_t { OP_LITERAL = 0x00, OP_RUN = 0x40, OP_ABOVE = 0x80, OP_ZERO = 0xc0 };
+
+struct PackedTile {
+   std::vector<uint8_t> data;
+   uint64_t hash;
+   uint8_t  width, height; // Edge tiles are smaller than TILE_SIZE
+   uint8_t  bpp;           // Bytes per pixel
+   bool     raw;           // The pixels are stored as-is because they did not compress
+};
+
+template <int BPP> inline uint32_t load(const uint8_t *Pixel) noexcept
+{
+   uint32_t value = 0;
+   memcpy(&value, Pixel, BPP);
+   return value;
+}
+
+//********************************************************************************************************************
+// Encodes the pixels of a tile.  Runs of two or more pixels are preferred to literals, except for single byte pixels
+// where a two pixel run is no smaller than the literal.
+
+template <int BPP>
+void encode(const uint8_t *Src, int LineWidth, int Width, int Height, std::vector<uint8_t> &Out)
+{
+   constexpr int MIN_RUN = (BPP >= 3) ? 2 : 3;
+
+   for (int y=0; y < Height; y++) {
+      const uint8_t *row   = Src + (y * LineWidth);
+      const uint8_t *above = y ? row - LineWidth : nullptr;
+      int literal = 0; // Pending literal pixels, ending at x
+
+      auto flush = [&](int X) {
+         if (!literal) return;
+         Out.push_back(OP_LITERAL | (literal - 1));
+         Out.insert(Out.end(), row + ((X - literal) * BPP), row + (X * BPP));
+         literal = 0;
+      };
+
+      for (int x=0; x < Width; ) {
+         const uint32_t pixel = load<BPP>(row + (x * BPP));
+
+         int run = 1;
+         while ((x + run < Width) and (load<BPP>(row + ((x + run) * BPP)) IS pixel)) run++;
+
+         int up = 0;
+         if (above) {
+            while ((x + up < Width) and (load<BPP>(row + ((x + up) * BPP)) IS load<BPP>(above + ((x + up) * BPP)))) up++;
+         }
+
+         if ((up >= 2) and (up >= run)) {
+            flush(x);
+            Out.push_back(OP_ABOVE | (up - 1));
+            x += up;
+         }
+         else if ((run >= 2) and (!pixel)) {
+            flush(x);
+            Out.push_back(OP_ZERO | (run - 1));
+            x += run;
+         }
+         else if (run >= MIN_RUN) {
+            flush(x);
+            Out.push_back(OP_RUN | (run - 1));
+            Out.insert(Out.end(), row + (x * BPP), row + ((x + 1) * BPP));
+            x += run;
+         }
+         else {
+            literal++;
+            x++;
+         }
+      }
+
+      flush(Width);
+   }
+}
+
+//********************************************************************************************************************
+// Decodes a tile to its position in a bitmap.  Returns false if the encoded data is inconsistent with the tile size.
+
+template <int BPP>
+bool decode(const uint8_t *Src, const uint8_t *End, uint8_t *Dest, int LineWidth, int Width, int Height)
+{
+   for (int y=0; y < Height; y++) {
+      uint8_t *row = Dest + (y * LineWidth);
+      for (int x=0; x < Width; ) {
+         if (Src >= End) return false;
+         const uint8_t op = *Src & 0xc0;
+         const int count  = (*Src++ & 0x3f) + 1;
+         if (x + count > Width) return false;
+
+         uint8_t *out = row + (x * BPP);
+         if (op IS OP_LITERAL) {
+            if (End - Src < count * BPP) return false;
+            memcpy(out, Src, count * BPP);
+            Src += count * BPP;
+         }
+         else if (op IS OP_RUN) {
+            if (End - Src < BPP) return false;
+            for (int i=0; i < count; i++) memcpy(out + (i * BPP), Src, BPP);
+            Src += BPP;
+         }
+         else if (op IS OP_ABOVE) {
+            if (!y) return false;
+            memcpy(out, out - LineWidth, count * BPP);
+         }
+         else memset(out, 0, count * BPP);
+
+         x += count;
+      }
+   }
+   return Src IS End;
+}
+
+inline bool unpack(const PackedTile &Tile, uint8_t *Dest, int LineWidth)
+{
+   const uint8_t *src = Tile.data.data(), *end = src + Tile.data.size();
+
+   if (Tile.raw) {
+      const int row_bytes = Tile.width * Tile.bpp;
+      for (int y=0; y < Tile.height; y++) memcpy(Dest + (y * LineWidth), src + (y * row_bytes), row_bytes);
+      return true;
+   }
+
+   switch (Tile.bpp) {
+      case 1: return decode<1>(src, end, Dest, LineWidth, Tile.width, Tile.height);
+      case 2: return decode<2>(src, end, Dest, LineWidth, Tile.width, Tile.height);
+      case 3: return decode<3>(src, end, Dest, LineWidth, Tile.width, Tile.height);
+      case 4: return decode<4>(src, end, Dest, LineWidth, Tile.width, Tile.height);
+      default: return false;
+   }
+}
+
+//********************************************************************************************************************
+// Hash of a tile's pixels and dimensions, used to find duplicates before any encoding is performed.
+
+inline uint64_t hash_pixels(const uint8_t *Src, int LineWidth, int Width, int Height, int BPP) noexcept
+{
+   constexpr uint64_t MUL = 0xff51afd7ed558ccdull;
+   uint64_t hash = 0x9e3779b97f4a7c15ull ^ (uint64_t(Width) << 40) ^ (uint64_t(Height) << 24) ^ BPP;
+   const int row_bytes = Width * BPP;
+
+   for (int y=0; y < Height; y++) {
+      const uint8_t *row = Src + (y * LineWidth);
+      int i = 0;
+      for (; i + 8 <= row_bytes; i += 8) {
+         uint64_t v;
+         memcpy(&v, row + i, sizeof(v));
+         hash = (hash ^ v) * MUL;
+         hash ^= hash >> 29;
+      }
+      if (i < row_bytes) {
+         uint64_t v = 0;
+         memcpy(&v, row + i, row_bytes - i);
+         hash = (hash ^ v ^ (uint64_t(y) << 56)) * MUL;
+         hash ^= hash >> 29;
+      }
+   }
+   return hash;
+}
+
+//********************************************************************************************************************
+// Process-wide cache of encoded tiles.  Entries are weak so that a tile is freed as soon as no bitmap refers to it.
+
+class TileCache {
+   std::mutex lock;
+   ankerl::unordered_dense::map<uint64_t, std::weak_ptr<const PackedTile>> tiles;
+
+   void release(const PackedTile *Tile) {
+      std::lock_guard guard(lock);
+      if (auto it = tiles.find(Tile->hash); (it != tiles.end()) and (it->second.expired())) tiles.erase(it);
+   }
+
+   public:
+   static TileCache & instance() {
+      static TileCache cache;
+      return cache;
+   }
+
+   size_t size() {
+      std::lock_guard guard(lock);
+      return tiles.size();
+   }
+
+   // Returns the encoded form of an area of pixels, which will be shared with any identical tile.
+
+   std::shared_ptr<const PackedTile> pack(const uint8_t *Src, int LineWidth, int Width, int Height, int BPP) {
+      const uint64_t hash = hash_pixels(Src, LineWidth, Width, Height, BPP);
+
+      // References must be released outside of the lock, as the deleter of the last reference also acquires it.
+
+      std::shared_ptr<const PackedTile> existing;
+      {
+         std::lock_guard guard(lock);
+         if (auto it = tiles.find(hash); it != tiles.end()) existing = it->second.lock();
+      }
+
+      if ((existing) and (existing->width IS Width) and (existing->height IS Height) and (existing->bpp IS BPP)) {
+         // Confirm that the pixels are identical and that this is not a hash collision
+         thread_local std::vector<uint8_t> scratch(TILE_SIZE * TILE_SIZE * 4);
+         const int row_bytes = Width * BPP;
+         bool match = unpack(*existing, scratch.data(), row_bytes);
+         for (int y=0; (match) and (y < Height); y++) {
+            match = !memcmp(scratch.data() + (y * row_bytes), Src + (y * LineWidth), row_bytes);
+         }
+         if (match) return existing;
+      }
+
+      auto tile = new PackedTile { { }, hash, uint8_t(Width), uint8_t(Height), uint8_t(BPP), false };
+      tile->data.reserve(Width * Height * BPP);
+      switch (BPP) {
+         case 1: encode<1>(Src, LineWidth, Width, Height, tile->data); break;
+         case 2: encode<2>(Src, LineWidth, Width, Height, tile->data); break;
+         case 3: encode<3>(Src, LineWidth, Width, Height, tile->data); break;
+         default: encode<4>(Src, LineWidth, Width, Height, tile->data); break;
+      }
+
+      if (tile->data.size() >= size_t(Width * Height * BPP)) {
+         tile->raw = true;
+         tile->data.resize(Width * Height * BPP);
+         for (int y=0; y < Height; y++) memcpy(tile->data.data() + (y * Width * BPP), Src + (y * LineWidth), Width * BPP);
+      }
+      tile->data.shrink_to_fit();
+
+      std::shared_ptr<const PackedTile> result(tile, [](const PackedTile *Tile) {
+         TileCache::instance().release(Tile);
+         delete Tile;
+      });
+
+      {
+         std::lock_guard guard(lock);
+         auto &entry = tiles[hash];
+         if (entry.expired()) entry = result; // Collisions keep the original entry
+      }
+
+      return result;
+   }
+};
+
+//********************************************************************************************************************
+// The tiles of a single bitmap.  A tile is either resident in the bitmap's data buffer or held in packed form only.
+// Resident tiles keep their packed copy until they are written to, so that compressing a partially restored bitmap only
+// needs to encode the tiles that were modified.
+
+class TileStore {
+   struct Tile {
+      std::shared_ptr<const PackedTile> packed;
+      bool resident = true;
+   };
+
+   std::vector<Tile> tiles;
+   int columns, rows;
+
+   public:
+   const int Width, Height, BytesPerPixel, LineWidth;
+   int Packed = 0; // Count of tiles that are not resident
+
+   TileStore(int pWidth, int pHeight, int pBPP, int pLineWidth) :
+      columns((pWidth + TILE_SIZE - 1) / TILE_SIZE), rows((pHeight + TILE_SIZE - 1) / TILE_SIZE),
+      Width(pWidth), Height(pHeight), BytesPerPixel(pBPP), LineWidth(pLineWidth) {
+      tiles.resize(columns * rows);
+   }
+
+   // Pack all resident tiles and mark them as non-resident.  The bitmap's data buffer can be released afterwards.
+
+   void compress(const uint8_t *Data) {
+      auto &cache = TileCache::instance();
+      for (int row=0; row < rows; row++) {
+         const int y = row * TILE_SIZE, height = std::min(TILE_SIZE, Height - y);
+         for (int col=0; col < columns; col++) {
+            auto &tile = tiles[(row * columns) + col];
+            if (!tile.resident) continue;
+            if (!tile.packed) {
+               const int x = col * TILE_SIZE, width = std::min(TILE_SIZE, Width - x);
+               tile.packed = cache.pack(Data + (y * LineWidth) + (x * BytesPerPixel), LineWidth, width, height, BytesPerPixel);
+            }
+            tile.resident = false;
+         }
+      }
+      Packed = std::ssize(tiles);
+   }
+
+   // Restore the tiles that intersect an area.  If the area is to be written, the restored tiles release their packed
+   // copy.  Returns false if a tile could not be decoded.
+
+   bool restore(uint8_t *Data, int X, int Y, int AreaWidth, int AreaHeight, bool Write) {
+      const int left = std::max(0, X), top = std::max(0, Y);
+      const int right = std::min(Width, X + AreaWidth), bottom = std::min(Height, Y + AreaHeight);
+      if ((left >= right) or (top >= bottom)) return true;
+
+      bool result = true;
+      for (int row = top / TILE_SIZE; row <= (bottom - 1) / TILE_SIZE; row++) {
+         for (int col = left / TILE_SIZE; col <= (right - 1) / TILE_SIZE; col++) {
+            auto &tile = tiles[(row * columns) + col];
+            if (!tile.resident) {
+               if (!unpack(*tile.packed, Data + (row * TILE_SIZE * LineWidth) + (col * TILE_SIZE * BytesPerPixel), LineWidth)) {
+                  result = false;
+               }
+               tile.resident = true;
+               Packed--;
+            }
+            if (Write) tile.packed.reset();
+         }
+      }
+      return result;
+   }
+
+   // The number of bytes consumed by packed tiles, counting shared tiles once.
+
+   size_t packed_size() const {
+      size_t size = 0;
+      ankerl::unordered_dense::set<const PackedTile *> seen;
+      for (auto &tile : tiles) {
+         if ((tile.packed) and (seen.insert(tile.packed.get()).second)) size += tile.packed->data.size();
+      }
+      return size;
+   }
+
+   int count() const { return std::ssize(tiles); }
+};
+
+} // namespace
@@ -36,6 +36,8 @@ actions.
 *********************************************************************************************************************/
 
 #include "defs.h"
+#include "pixel_convert.h"
+#include "bitmap_tiles.h"
 
 #ifdef _WIN32
 using namespace display;
@@ -364,6 +366,36 @@ ERR unlock_surface(extBitmap *Bitmap)
 
 #endif
 
+//********************************************************************************************************************
+// Restores the tiles of a tile-compressed bitmap that intersect an area.  The data buffer is reallocated on the first
+// call, and the tile storage is released once every tile is resident.
+
+ERR restore_tiles(extBitmap *Bitmap, int X, int Y, int Width, int Height, bool Write)
+{
+   pf::Log log(__FUNCTION__);
+
+   auto tiles = Bitmap->prvTiles;
+   if (!tiles) return ERR::Okay;
+
+   if (!Bitmap->Data) {
+      if (AllocMemory(Bitmap->Size, MEM::NO_BLOCKING|MEM::NO_POOL|MEM::NO_CLEAR|Bitmap->DataFlags, &Bitmap->Data) IS ERR::Okay) {
+         Bitmap->prvAFlags |= BF_DATA;
+      }
+      else return log.warning(ERR::AllocMemory);
+   }
+
+   auto error = tiles->restore(Bitmap->Data, X, Y, Width, Height, Write) ? ERR::Okay : ERR::Decompression;
+   if (error != ERR::Okay) log.warning("Bitmap #%d has corrupt tile data.", Bitmap->UID);
+
+   if (!tiles->Packed) {
+      delete tiles;
+      Bitmap->prvTiles = nullptr;
+      Bitmap->Flags &= ~BMF::COMPRESSED;
+   }
+
+   return error;
+}
+
 //********************************************************************************************************************
 
 #ifdef __xwindows__
@@ -492,6 +524,13 @@ called to restore the bitmap to its original state.
 The `BMF::COMPRESSED` bit will be set in the #Flags field after a successful call to this function to indicate that the
 bitmap is compressed.
 
+If the `BMF::TILED` flag is set, the image is instead divided into 64x64 tiles that are compressed independently, and
+the `Level` is ignored.  The Bitmap's drawing functions (e.g. ~Display.CopyArea(), ~Display.DrawRectangle()) restore
+only the tiles that they read or write, and `BMF::COMPRESSED` is cleared once every tile has been restored.  Identical
+tiles are shared in memory, including those of other bitmaps, which makes blank areas practically free.  Compressing a
+partially restored bitmap only encodes the tiles that have been drawn to since the last call.  Direct access to the
+#Data of a tiled bitmap remains invalid until #Decompress() is called.
+
 -INPUT-
 int Level: Level of compression.  Zero uses a default setting (recommended), the maximum is 10.
 
@@ -520,6 +559,27 @@ static ERR BITMAP_Compress(extBitmap *Self, struct bmp::Compress *Args)
 
    log.traceBranch();
 
+   if (((Self->Flags & BMF::TILED) != BMF::NIL) and (Self->Type IS BMP::CHUNKY) and (!Self->prvCompress)) {
+      if (!Self->Data) return ERR::Okay; // Already compressed with no tiles restored
+
+      if (!Self->prvTiles) {
+         Self->prvTiles = new (std::nothrow) bitmap_tiles::TileStore(Self->Width, Self->Height, Self->BytesPerPixel, Self->LineWidth);
+         if (!Self->prvTiles) return log.warning(ERR::AllocMemory);
+      }
+
+      Self->prvTiles->compress(Self->Data);
+
+      log.detail("%d tiles compressed to %d bytes from %d.", Self->prvTiles->count(), int(Self->prvTiles->packed_size()), Self->Size);
+
+      if (Self->prvAFlags & BF_DATA) {
+         FreeResource(Self->Data);
+         Self->Data = nullptr;
+      }
+
+      Self->Flags |= BMF::COMPRESSED;
+      return ERR::Okay;
+   }
+
    if (Self->prvCompress) {
       // If the original compression object still exists, all we are going to do is free up the raw bitmap data.
 
@@ -597,43 +657,17 @@ ERR BITMAP_ConvertToLinear(extBitmap *Self)
 
    if (Self->Clip.Left + w > Self->Width) return log.warning(ERR::InvalidDimension);
    if (Self->Clip.Top + h > Self->Height) return log.warning(ERR::InvalidDimension);
+   if (auto error = restore_area(Self, Self->Clip.Left, Self->Clip.Top, w, h, true); error != ERR::Okay) return error;
 
-   if ((Self->Flags & BMF::ALPHA_CHANNEL) != BMF::NIL) {
-      const uint8_t R = Self->ColourFormat->RedPos>>3;
-      const uint8_t G = Self->ColourFormat->GreenPos>>3;
-      const uint8_t B = Self->ColourFormat->BluePos>>3;
-      const uint8_t A = Self->ColourFormat->AlphaPos>>3;
-
-      uint8_t *data = Self->Data + (Self->LineWidth * Self->Clip.Top) + (Self->Clip.Left * Self->BytesPerPixel);
-      for (int y=0; y < h; y++) {
-         uint8_t *pixel = data;
-         for (int x=0; x < w; x++) {
-            if (pixel[A]) {
-               pixel[R] = glLinearRGB.convert(pixel[R]);
-               pixel[G] = glLinearRGB.convert(pixel[G]);
-               pixel[B] = glLinearRGB.convert(pixel[B]);
-            }
-            pixel += Self->BytesPerPixel;
-         }
-         data += Self->LineWidth;
-      }
-   }
-   else {
-      const uint8_t R = Self->ColourFormat->RedPos>>3;
-      const uint8_t G = Self->ColourFormat->GreenPos>>3;
-      const uint8_t B = Self->ColourFormat->BluePos>>3;
-
-      uint8_t *data = Self->Data + (Self->LineWidth * Self->Clip.Top) + (Self->Clip.Left * Self->BytesPerPixel);
-      for (int y=0; y < h; y++) {
-         uint8_t *pixel = data;
-         for (int x=0; x < w; x++) {
-            pixel[R] = glLinearRGB.convert(pixel[R]);
-            pixel[G] = glLinearRGB.convert(pixel[G]);
-            pixel[B] = glLinearRGB.convert(pixel[B]);
-            pixel += Self->BytesPerPixel;
-         }
-         data += Self->LineWidth;
-      }
+   const uint8_t R = Self->ColourFormat->RedPos>>3;
+   const uint8_t G = Self->ColourFormat->GreenPos>>3;
+   const uint8_t B = Self->ColourFormat->BluePos>>3;
+   const uint8_t A = ((Self->Flags & BMF::ALPHA_CHANNEL) != BMF::NIL) ? Self->ColourFormat->AlphaPos>>3 : 0xff;
+
+   uint8_t *data = Self->Data + (Self->LineWidth * Self->Clip.Top) + (Self->Clip.Left * Self->BytesPerPixel);
+   for (int y=0; y < h; y++) {
+      glLinearRGB.convert_row(data, w, R, G, B, A);
+      data += Self->LineWidth;
    }
 
    Self->ColourSpace = CS::LINEAR_RGB;
@@ -673,43 +707,17 @@ ERR BITMAP_ConvertToRGB(extBitmap *Self)
 
    if (Self->Clip.Left + w > Self->Width) return log.warning(ERR::InvalidDimension);
    if (Self->Clip.Top + h > Self->Height) return log.warning(ERR::InvalidDimension);
+   if (auto error = restore_area(Self, Self->Clip.Left, Self->Clip.Top, w, h, true); error != ERR::Okay) return error;
 
-   if ((Self->Flags & BMF::ALPHA_CHANNEL) != BMF::NIL) {
-      const uint8_t R = Self->ColourFormat->RedPos>>3;
-      const uint8_t G = Self->ColourFormat->GreenPos>>3;
-      const uint8_t B = Self->ColourFormat->BluePos>>3;
-      const uint8_t A = Self->ColourFormat->AlphaPos>>3;
-
-      uint8_t *data = Self->Data + (Self->LineWidth * Self->Clip.Top) + (Self->Clip.Left * Self->BytesPerPixel);
-      for (int y=0; y < h; y++) {
-         uint8_t *pixel = data;
-         for (int x=0; x < w; x++) {
-            if (pixel[A]) {
-               pixel[R] = glLinearRGB.invert(pixel[R]);
-               pixel[G] = glLinearRGB.invert(pixel[G]);
-               pixel[B] = glLinearRGB.invert(pixel[B]);
-            }
-            pixel += Self->BytesPerPixel;
-         }
-         data += Self->LineWidth;
-      }
-   }
-   else {
-      const uint8_t R = Self->ColourFormat->RedPos>>3;
-      const uint8_t G = Self->ColourFormat->GreenPos>>3;
-      const uint8_t B = Self->ColourFormat->BluePos>>3;
-
-      uint8_t *data = Self->Data + (Self->LineWidth * Self->Clip.Top) + (Self->Clip.Left * Self->BytesPerPixel);
-      for (int y=0; y < h; y++) {
-         uint8_t *pixel = data;
-         for (int x=0; x < w; x++) {
-            pixel[R] = glLinearRGB.invert(pixel[R]);
-            pixel[G] = glLinearRGB.invert(pixel[G]);
-            pixel[B] = glLinearRGB.invert(pixel[B]);
-            pixel += Self->BytesPerPixel;
-         }
-         data += Self->LineWidth;
-      }
+   const uint8_t R = Self->ColourFormat->RedPos>>3;
+   const uint8_t G = Self->ColourFormat->GreenPos>>3;
+   const uint8_t B = Self->ColourFormat->BluePos>>3;
+   const uint8_t A = ((Self->Flags & BMF::ALPHA_CHANNEL) != BMF::NIL) ? Self->ColourFormat->AlphaPos>>3 : 0xff;
+
+   uint8_t *data = Self->Data + (Self->LineWidth * Self->Clip.Top) + (Self->Clip.Left * Self->BytesPerPixel);
+   for (int y=0; y < h; y++) {
+      glLinearRGB.invert_row(data, w, R, G, B, A);
+      data += Self->LineWidth;
    }
 
    Self->ColourSpace = CS::SRGB;
@@ -755,7 +763,8 @@ The Decompress() method is used to restore a compressed bitmap to its original s
 the method does nothing.
 
 The compressed data will be terminated unless `RetainData` is `true`.  Retaining the data will allow the client to
-repeatedly restore the content of the most recent #Compress() call.
+repeatedly restore the content of the most recent #Compress() call.  `RetainData` does not apply to bitmaps that were
+compressed with `BMF::TILED`.
 
 -INPUT-
 int RetainData: Retains the compression data if `true`.
@@ -770,6 +779,8 @@ static ERR BITMAP_Decompress(extBitmap *Self, struct bmp::Decompress *Args)
 {
    pf::Log log;
 
+   if (Self->prvTiles) return restore_tiles(Self, 0, 0, Self->Width, Self->Height, true);
+
    if (!Self->prvCompress) return ERR::Okay;
 
    log.msg(VLF::BRANCH|VLF::DETAIL, "Size: %d, Retain: %d", Self->Size, (Args) ? Args->RetainData : FALSE);
@@ -867,21 +878,6 @@ static ERR BITMAP_Demultiply(extBitmap *Self)
 {
    pf::Log log;
 
-   static std::mutex mutex;
-   if (!glDemultiply) {
-      const std::lock_guard<std::mutex> lock(mutex);
-      if (!glDemultiply) {
-         if (AllocMemory(256 * 256, MEM::NO_CLEAR|MEM::UNTRACKED, &glDemultiply) IS ERR::Okay) {
-            for (int a=1; a <= 255; a++) {
-               for (int i=0; i <= 255; i++) {
-                  glDemultiply[(a<<8) + i] = (i * 0xff) / a;
-               }
-            }
-         }
-         else return ERR::AllocMemory;
-      }
-   }
-
    if ((Self->Flags & BMF::PREMUL) IS BMF::NIL) return log.warning(ERR::NothingDone);
    if (Self->BitsPerPixel != 32) return log.warning(ERR::InvalidState);
    if ((Self->Flags & BMF::ALPHA_CHANNEL) IS BMF::NIL) return log.warning(ERR::InvalidState);
@@ -891,30 +887,13 @@ static ERR BITMAP_Demultiply(extBitmap *Self)
 
    if (Self->Clip.Left + w > Self->Width) return log.warning(ERR::InvalidDimension);
    if (Self->Clip.Top + h > Self->Height) return log.warning(ERR::InvalidDimension);
+   if (auto error = restore_area(Self, Self->Clip.Left, Self->Clip.Top, w, h, true); error != ERR::Okay) return error;
 
    const uint8_t A = Self->ColourFormat->AlphaPos>>3;
-   const uint8_t R = Self->ColourFormat->RedPos>>3;
-   const uint8_t G = Self->ColourFormat->GreenPos>>3;
-   const uint8_t B = Self->ColourFormat->BluePos>>3;
 
    uint8_t *data = Self->Data + (Self->Clip.Left * Self->BytesPerPixel) + (Self->Clip.Top * Self->LineWidth);
    for (int y=0; y < h; y++) {
-      uint8_t *pixel = data;
-      for (int x=0; x < w; x++) {
-         const uint8_t a = pixel[A];
-         if (a < 0xff) {
-            if (a == 0) pixel[R] = pixel[G] = pixel[B] = 0;
-            else {
-               uint32_t r = glDemultiply[(a<<8) + pixel[R]]; //(uint32_t(pixel[R]) * 0xff) / a;
-               uint32_t g = glDemultiply[(a<<8) + pixel[G]]; //(uint32_t(pixel[G]) * 0xff) / a;
-               uint32_t b = glDemultiply[(a<<8) + pixel[B]]; //(uint32_t(pixel[B]) * 0xff) / a;
-               pixel[R] = uint8_t((r > 0xff) ? 0xff : r);
-               pixel[G] = uint8_t((g > 0xff) ? 0xff : g);
-               pixel[B] = uint8_t((b > 0xff) ? 0xff : b);
-            }
-         }
-         pixel += 4;
-      }
+      pixel_convert::demultiply_row(data, data, w, A);
       data += Self->LineWidth;
    }
 
@@ -996,6 +975,8 @@ static ERR BITMAP_Flush(extBitmap *Self)
 static ERR BITMAP_Free(extBitmap *Self)
 {
    #ifdef __xwindows__
+      if ((Self->x11.drawable) and (XDisplay)) x11_free_presenter(Self->x11.drawable);
+
       if (Self->x11.XShmImage) {
          // Tell the X11 server to detach from the memory block
          XShmDetach(XDisplay, &Self->x11.ShmInfo);
@@ -1016,6 +997,7 @@ static ERR BITMAP_Free(extBitmap *Self)
    }
 
    if (Self->prvCompress) { FreeResource(Self->prvCompress); Self->prvCompress = nullptr; }
+   if (Self->prvTiles) { delete Self->prvTiles; Self->prvTiles = nullptr; }
 
    if (Self->ResolutionChangeHandle) {
       UnsubscribeEvent(Self->ResolutionChangeHandle);
@@ -1341,6 +1323,10 @@ Lock: Locks the bitmap surface for direct read/write access.
 
 static ERR BITMAP_Lock(extBitmap *Self)
 {
+   // Direct access is unrestricted, so every tile of a tile-compressed bitmap must be restored.
+
+   if (auto error = restore_area(Self, 0, 0, Self->Width, Self->Height, true); error != ERR::Okay) return error;
+
 #ifdef __xwindows__
    if (Self->x11.drawable) {
       int16_t alignment;
@@ -1503,27 +1489,13 @@ static ERR BITMAP_Premultiply(extBitmap *Self)
 
    if (Self->Clip.Left + w > Self->Width) return log.warning(ERR::InvalidDimension);
    if (Self->Clip.Top + h > Self->Height) return log.warning(ERR::InvalidDimension);
+   if (auto error = restore_area(Self, Self->Clip.Left, Self->Clip.Top, w, h, true); error != ERR::Okay) return error;
 
    const uint8_t A = Self->ColourFormat->AlphaPos>>3;
-   const uint8_t R = Self->ColourFormat->RedPos>>3;
-   const uint8_t G = Self->ColourFormat->GreenPos>>3;
-   const uint8_t B = Self->ColourFormat->BluePos>>3;
 
    uint8_t *data = Self->Data + (Self->Clip.Left * Self->BytesPerPixel) + (Self->Clip.Top * Self->LineWidth);
    for (int y=0; y < h; y++) {
-      uint8_t *pixel = data;
-      for (int x=0; x < w; x++) {
-         const uint8_t a = pixel[A];
-         if (a < 0xff) {
-             if (a == 0) pixel[R] = pixel[G] = pixel[B] = 0;
-             else {
-                pixel[R] = uint8_t((pixel[R] * a + 0xff) >> 8);
-                pixel[G] = uint8_t((pixel[G] * a + 0xff) >> 8);
-                pixel[B] = uint8_t((pixel[B] * a + 0xff) >> 8);
-             }
-         }
-         pixel += 4;
-      }
+      pixel_convert::premultiply_row(data, data, w, A);
       data += Self->LineWidth;
    }
 
@@ -1717,11 +1689,17 @@ Read: Reads raw image data from a bitmap object.
 
 static ERR BITMAP_Read(extBitmap *Self, struct acRead *Args)
 {
-   if (!Self->Data) return ERR::NoData;
    if ((!Args) or (!Args->Buffer)) return ERR::NullArgs;
 
    int len = Args->Length;
    if (Self->Position + len > Self->Size) len = Self->Size - Self->Position;
+
+   if (Self->prvTiles) {
+      const int top = Self->Position / Self->LineWidth;
+      if (auto error = restore_area(Self, 0, top, Self->Width, ((Self->Position + len) / Self->LineWidth) - top + 1, false); error != ERR::Okay) return error;
+   }
+
+   if (!Self->Data) return ERR::NoData;
    copymem(Self->Data + Self->Position, Args->Buffer, len);
    Self->Position += len;
    Args->Result = len;
@@ -1777,6 +1755,8 @@ static ERR BITMAP_Resize(extBitmap *Self, struct acResize *Args)
       return ERR::Okay|ERR::Notified;
    }
 
+   if (auto error = restore_area(Self, 0, 0, Self->Width, Self->Height, true); error != ERR::Okay) return error;
+
    // Calculate type-dependent values
 
    int16_t bytesperpixel;
@@ -1959,6 +1939,7 @@ static ERR BITMAP_SaveImage(extBitmap *Self, struct acSaveImage *Args)
    int i, j, p, size;
 
    if ((!Args) or (!Args->Dest)) return log.warning(ERR::NullArgs);
+   if (auto error = restore_area(Self, 0, 0, Self->Width, Self->Height, false); error != ERR::Okay) return error;
 
    log.branch("Save To #%d", Args->Dest->UID);
 
@@ -2172,7 +2153,6 @@ static ERR BITMAP_Write(extBitmap *Self, struct acWrite *Args)
 
    Args->Result = 0;
 
-   if (!Self->Data) return ERR::NoData;
    if (Args->Length <= 0) return ERR::Okay;
    if (!Args->Buffer) return ERR::NullArgs;
 
@@ -2180,6 +2160,13 @@ static ERR BITMAP_Write(extBitmap *Self, struct acWrite *Args)
    if (available <= 0) return ERR::OutOfSpace;
    if (Args->Length > available) return ERR::OutOfSpace;
 
+   if (Self->prvTiles) {
+      const int top = Self->Position / Self->LineWidth;
+      if (auto error = restore_area(Self, 0, top, Self->Width, ((Self->Position + Args->Length) / Self->LineWidth) - top + 1, true); error != ERR::Okay) return error;
+   }
+
+   if (!Self->Data) return ERR::NoData;
+
    copymem(Args->Buffer, Self->Data + Self->Position, Args->Length);
    Self->Position += Args->Length;
    Args->Result = Args->Length;
@@ -2823,6 +2810,7 @@ static ERR CalculatePixelRoutines(extBitmap *Self)
 
 #ifdef __xwindows__
 #include "x11/lib_pixels.cpp"
+#include "x11/present.cpp"
 #endif
 
 #ifdef _WIN32
@@ -50,6 +50,7 @@ static const struct FieldDef clBitmapFlags[] = {
    { "X11DGA", 0x00002000 },
    { "FixedDepth", 0x00004000 },
    { "Premul", 0x00008000 },
+   { "Tiled", 0x00010000 },
    { nullptr, 0 }
 };
 
@@ -346,6 +346,12 @@ static ERR DISPLAY_Free(extDisplay *Self)
 
    if (Self->WindowHandle IS (APTR)glDisplayWindow) glDisplayWindow = 0;
 
+   // Release the presentation buffers of the drawable before it is destroyed
+
+   if ((Self->Bitmap) and (((extBitmap *)Self->Bitmap)->x11.drawable)) {
+      x11_free_presenter(((extBitmap *)Self->Bitmap)->x11.drawable);
+   }
+
    if (Self->XPixmap) {
       XFreePixmap(XDisplay, Self->XPixmap);
       Self->XPixmap = 0;
@@ -1081,7 +1081,8 @@ static bool get_over_object(extPointer *Self)
       Self->SurfaceID = glSurfaces[0].SurfaceID;
       index = 0;
    }
-   else for (index=0; (index < glSurfaces.size()) and (glSurfaces[index].SurfaceID != Self->SurfaceID); index++);
+   else if (auto i = find_surface_list(Self->SurfaceID); i != -1) index = i;
+   else index = glSurfaces.size();
 
    auto i = examine_chain(Self, index, glSurfaces, glSurfaces.size());
 
@@ -46,7 +46,7 @@ static ERR SET_YOffset(extSurface *, Unit *);
 
 static ERR consume_input_events(const InputEvent *, int);
 static void draw_region(extSurface *, extSurface *, extBitmap *);
-static ERR redraw_timer(extSurface *, int64_t, int64_t);
+static ERR schedule_frame(extSurface *, const ClipRectangle &, bool);
 
 /*********************************************************************************************************************
 ** This call is used to refresh the pointer image when at least one layer has been rearranged.  The timer is used to
@@ -159,69 +159,14 @@ static bool check_volatile(const SURFACELIST &List, int Index)
 }
 
 //********************************************************************************************************************
+// Copies a single unobscured rectangle of a surface's buffer to the display.  Coordinates are absolute.
 
-static void expose_buffer(const SURFACELIST &list, int Limit, int Index, int ScanIndex, int Left, int Top,
-                   int Right, int Bottom, OBJECTID DisplayID, extBitmap *Bitmap)
+static void expose_rect(const SURFACELIST &list, int Index, int Left, int Top, int Right, int Bottom,
+   OBJECTID DisplayID, extBitmap *Bitmap)
 {
-   pf::Log log(__FUNCTION__);
-
-   // Scan for overlapping parent/sibling regions and avoid them
-
-   int i, j;
-   for (i=ScanIndex+1; (i < Limit) and (list[i].Level > 1); i++) {
-      if (list[i].invisible()) { // Skip past non-visible areas and their content
-         j = list[i].Level;
-         while ((i+1 < Limit) and (list[i+1].Level > j)) i++;
-         continue;
-      }
-      else if (list[i].isCursor()); // Skip the cursor
-      else {
-         auto listclip = list[i].area();
-
-         if (restrict_region_to_parents(list, i, listclip, false) IS -1); // Skip
-         else if ((listclip.Left < Right) and (listclip.Top < Bottom) and (listclip.Right > Left) and (listclip.Bottom > Top)) {
-            if (list[i].BitmapID IS list[Index].BitmapID) continue; // Ignore any children that overlap & form part of our bitmap space.  Children that do not overlap are skipped.
-
-            if (listclip.Left <= Left) listclip.Left = Left;
-            else expose_buffer(list, Limit, Index, ScanIndex, Left, Top, listclip.Left, Bottom, DisplayID, Bitmap); // left
-
-            if (listclip.Right >= Right) listclip.Right = Right;
-            else expose_buffer(list, Limit, Index, ScanIndex, listclip.Right, Top, Right, Bottom, DisplayID, Bitmap); // right
-
-            if (listclip.Top <= Top) listclip.Top = Top;
-            else expose_buffer(list, Limit, Index, ScanIndex, listclip.Left, Top, listclip.Right, listclip.Top, DisplayID, Bitmap); // top
-
-            if (listclip.Bottom < Bottom) expose_buffer(list, Limit, Index, ScanIndex, listclip.Left, listclip.Bottom, listclip.Right, Bottom, DisplayID, Bitmap); // bottom
-
-            if (list[i].transparent()) {
-               // In the case of invisible regions, we will have split the expose process as normal.  However,
-               // we also need to look deeper into the invisible region to discover if there is more that
-               // we can draw, depending on the content of the invisible region.
-
-               listclip = list[i].area();
+   pf::Log log("expose_buffer");
 
-               if (Left > listclip.Left)     listclip.Left   = Left;
-               if (Top > listclip.Top)       listclip.Top    = Top;
-               if (Right < listclip.Right)   listclip.Right  = Right;
-               if (Bottom < listclip.Bottom) listclip.Bottom = Bottom;
-
-               expose_buffer(list, Limit, Index, i, listclip.Left, listclip.Top, listclip.Right, listclip.Bottom, DisplayID, Bitmap);
-            }
-
-            return;
-         }
-      }
-
-      // Skip past any children of the non-overlapping object.  This ensures that we only look at immediate parents and siblings that are in our way.
-
-      j = i + 1;
-      while ((j < Limit) and (list[j].Level > list[i].Level)) j++;
-      i = j - 1;
-   }
-
-   log.traceBranch("[%d] %dx%d,%dx%d Bmp: %d, Idx: %d/%d", list[Index].SurfaceID, Left, Top, Right - Left, Bottom - Top, list[Index].BitmapID, Index, ScanIndex);
-
-   // The region is not obscured, so perform the redraw
+   log.traceBranch("[%d] %dx%d,%dx%d Bmp: %d, Idx: %d", list[Index].SurfaceID, Left, Top, Right - Left, Bottom - Top, list[Index].BitmapID, Index);
 
    int owner = find_bitmap_owner(list, Index);
 
@@ -311,6 +256,84 @@ static void expose_buffer(const SURFACELIST &list, int Limit, int Index, int Sca
    else log.warning("Unable to access display #%d.", DisplayID);
 }
 
+//********************************************************************************************************************
+// Splits an area of a surface around the parent and sibling surfaces that obscure it, and records the unobscured
+// fragments.
+
+static void split_expose(const SURFACELIST &list, int Limit, int Index, int ScanIndex, int Left, int Top,
+   int Right, int Bottom, std::vector<ClipRectangle> &Fragments)
+{
+   // Scan for overlapping parent/sibling regions and avoid them
+
+   int i, j;
+   for (i=ScanIndex+1; (i < Limit) and (list[i].Level > 1); i++) {
+      if (list[i].invisible()) { // Skip past non-visible areas and their content
+         j = list[i].Level;
+         while ((i+1 < Limit) and (list[i+1].Level > j)) i++;
+         continue;
+      }
+      else if (list[i].isCursor()); // Skip the cursor
+      else {
+         auto listclip = list[i].area();
+
+         if (restrict_region_to_parents(list, i, listclip, false) IS -1); // Skip
+         else if ((listclip.Left < Right) and (listclip.Top < Bottom) and (listclip.Right > Left) and (listclip.Bottom > Top)) {
+            if (list[i].BitmapID IS list[Index].BitmapID) continue; // Ignore any children that overlap & form part of our bitmap space.  Children that do not overlap are skipped.
+
+            if (listclip.Left <= Left) listclip.Left = Left;
+            else split_expose(list, Limit, Index, ScanIndex, Left, Top, listclip.Left, Bottom, Fragments); // left
+
+            if (listclip.Right >= Right) listclip.Right = Right;
+            else split_expose(list, Limit, Index, ScanIndex, listclip.Right, Top, Right, Bottom, Fragments); // right
+
+            if (listclip.Top <= Top) listclip.Top = Top;
+            else split_expose(list, Limit, Index, ScanIndex, listclip.Left, Top, listclip.Right, listclip.Top, Fragments); // top
+
+            if (listclip.Bottom < Bottom) split_expose(list, Limit, Index, ScanIndex, listclip.Left, listclip.Bottom, listclip.Right, Bottom, Fragments); // bottom
+
+            if (list[i].transparent()) {
+               // In the case of invisible regions, we will have split the expose process as normal.  However,
+               // we also need to look deeper into the invisible region to discover if there is more that
+               // we can draw, depending on the content of the invisible region.
+
+               listclip = list[i].area();
+
+               if (Left > listclip.Left)     listclip.Left   = Left;
+               if (Top > listclip.Top)       listclip.Top    = Top;
+               if (Right < listclip.Right)   listclip.Right  = Right;
+               if (Bottom < listclip.Bottom) listclip.Bottom = Bottom;
+
+               split_expose(list, Limit, Index, i, listclip.Left, listclip.Top, listclip.Right, listclip.Bottom, Fragments);
+            }
+
+            return;
+         }
+      }
+
+      // Skip past any children of the non-overlapping object.  This ensures that we only look at immediate parents and siblings that are in our way.
+
+      j = i + 1;
+      while ((j < Limit) and (list[j].Level > list[i].Level)) j++;
+      i = j - 1;
+   }
+
+   Fragments.emplace_back(Left, Top, Right, Bottom);
+}
+
+//********************************************************************************************************************
+// Copies the area of a surface's buffer that is not obscured by the surfaces in front of it to the display.  The
+// fragments are merged into banded form if there are enough of them to justify the cost.
+
+static void expose_buffer(const SURFACELIST &list, int Limit, int Index, int ScanIndex, int Left, int Top,
+                   int Right, int Bottom, OBJECTID DisplayID, extBitmap *Bitmap)
+{
+   std::vector<ClipRectangle> fragments;
+   split_expose(list, Limit, Index, ScanIndex, Left, Top, Right, Bottom, fragments);
+   merge_fragments(fragments);
+
+   for (auto &rect : fragments) expose_rect(list, Index, rect.Left, rect.Top, rect.Right, rect.Bottom, DisplayID, Bitmap);
+}
+
 /*********************************************************************************************************************
 ** Used by MoveToFront()
 **
@@ -472,9 +495,8 @@ static void notify_redimension_parent(OBJECTPTR Object, ACTIONID ActionID, ERR R
    if (Self->ParentID) {
       const std::lock_guard<std::recursive_mutex> lock(glSurfaceLock);
 
-      int i;
-      for (i=0; (i < int(glSurfaces.size())) and (glSurfaces[i].SurfaceID != Self->ParentID); i++);
-      if (i >= int(glSurfaces.size())) {
+      auto i = find_surface_list(Self->ParentID);
+      if (i IS -1) {
          log.warning(ERR::Search);
          return;
       }
@@ -910,8 +932,6 @@ static ERR SURFACE_Focus(extSurface *Self)
 
 static ERR SURFACE_Free(extSurface *Self)
 {
-   if (Self->RedrawTimer) { UpdateTimer(Self->RedrawTimer, 0); Self->RedrawTimer = 0; }
-
    if ((Self->Callback) and (Self->Callback != Self->CallbackCache)) {
       FreeResource(Self->Callback);
       Self->Callback = nullptr;
@@ -1832,6 +1852,7 @@ static ERR SURFACE_MoveToFront(extSurface *Self)
       auto tmp = SURFACELIST(glSurfaces.begin() + currentindex, glSurfaces.begin() + currentindex + total); // Copy the source entry into a buffer
       glSurfaces.erase(glSurfaces.begin() + currentindex, glSurfaces.begin() + currentindex + total);
       glSurfaces.insert(glSurfaces.begin() + i, tmp.begin(), tmp.end());
+      index_surfaces(currentindex);
    }
 
    auto cplist = glSurfaces;
@@ -2110,16 +2131,13 @@ static ERR SURFACE_ResetDimensions(extSurface *Self, struct drw::ResetDimensions
 -METHOD-
 ScheduleRedraw: Schedules a redraw operation for the next frame.
 
-Use ScheduleRedraw to indicate that a surface needs to be drawn to the display.  The surface and all child surfaces
-will be drawn on the next frame cycle (typically 1/60th of a second).  All manual draw operations for the target
-surface are ignored until the scheduled operation is completed.
+Use ScheduleRedraw to indicate that a surface needs to be drawn to the display.  The surface will be drawn on the next
+frame cycle, which is paced to the refresh rate of the display.  The outcome is identical to calling the Draw action
+with no arguments.
 
 Scheduling is ideal in situations where a cluster of redraw events may occur within a tight time period, and it
-would be inefficient to draw those changes to the display individually.
-
-Note that redraw schedules do not 'see each other', meaning if a surface and a child are both scheduled, this will
-trigger two redraw operations when one would suffice.  It is the client's responsibility to target the most
-relevant top-level surface for scheduling.
+would be inefficient to draw those changes to the display individually.  Schedules for a surface and its children are
+merged, so there is no need to target the top-level surface of a redraw cluster.
 
 -ERRORS-
 Okay
@@ -2129,22 +2147,8 @@ Okay
 
 static ERR SURFACE_ScheduleRedraw(extSurface *Self)
 {
-   // TODO Currently defaults to 60FPS, we should get the correct FPS from the Display object.
-   const double FPS = 60.0;
-
-   if (Self->RedrawScheduled) return ERR::Okay;
-
-   if (Self->RedrawTimer) {
-      Self->RedrawScheduled = true;
-      return ERR::Okay;
-   }
-
-   if (SubscribeTimer(1.0 / FPS, C_FUNCTION(redraw_timer), &Self->RedrawTimer) IS ERR::Okay) {
-      Self->RedrawCountdown = FPS * 30.0;
-      Self->RedrawScheduled = true;
-      return ERR::Okay;
-   }
-   else return ERR::Failed;
+   if (Self->invisible() or (Self->Width < 1) or (Self->Height < 1)) return ERR::Okay;
+   return schedule_frame(Self, ClipRectangle(0, 0, Self->Width, Self->Height), false);
 }
 
 /*********************************************************************************************************************
@@ -2322,28 +2326,6 @@ static ERR SURFACE_Show(extSurface *Self)
 
 //********************************************************************************************************************
 
-static ERR redraw_timer(extSurface *Self, int64_t Elapsed, int64_t CurrentTime)
-{
-   if (Self->RedrawScheduled) {
-      Self->RedrawScheduled = false; // Done before Draw() because it tests this field.
-      acDraw(Self);
-   }
-   else {
-      // Rather than unsubscribe from the timer immediately, we hold onto it until the countdown reaches zero.  This
-      // is because there is a noticeable performance penalty if you frequently subscribe and unsubscribe from the timer
-      // system.
-      if (Self->RedrawCountdown > 0) Self->RedrawCountdown--;
-      if (!Self->RedrawCountdown) {
-         Self->RedrawTimer = nullptr;
-         return ERR::Terminate;
-      }
-   }
-
-   return ERR::Okay;
-}
-
-//********************************************************************************************************************
-
 static void draw_region(extSurface *Self, extSurface *Parent, extBitmap *Bitmap)
 {
    // Only region objects can respond to draw messages
@@ -2505,6 +2487,7 @@ static ERR consume_input_events(const InputEvent *Events, int Handle)
 
 //********************************************************************************************************************
 
+#include "surface_frames.cpp"
 #include "surface_drawing.cpp"
 #include "surface_fields.cpp"
 #include "surface_dimensions.cpp"
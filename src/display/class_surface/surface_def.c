@@ -174,6 +174,7 @@ static const struct FieldDef clSurfaceJTYPE[] = {
    { "DblClick", 0x00000200 },
    { "Repeated", 0x00000400 },
    { "DragItem", 0x00000800 },
+   { "History", 0x00001000 },
    { nullptr, 0 }
 };
 
@@ -6,7 +6,6 @@ ERR _expose_surface(OBJECTID SurfaceID, const SURFACELIST &List, int index, int
    pf::Log log("expose_surface");
    int i, j;
    bool skip;
-   OBJECTID parent_id;
 
    if ((Width < 1) or (Height < 1)) return ERR::Okay;
    if (!SurfaceID) return log.warning(ERR::NullArgs);
@@ -41,12 +40,7 @@ ERR _expose_surface(OBJECTID SurfaceID, const SURFACELIST &List, int index, int
    if (List[index].transparent()) {
       log.trace("Surface is transparent; scan to solid starting from index %d.", index);
 
-      OBJECTID id = List[index].SurfaceID;
-      for (j=index; j > 0; j--) {
-         if (List[j].SurfaceID != id) continue;
-         if (List[j].transparent()) id = List[j].ParentID;
-         else break;
-      }
+      for (j=index; (j > 0) and (List[j].transparent()); j=std::max(List[j].ParentIndex, 0));
       Flags |= EXF::CHILDREN;
       index = j;
 
@@ -54,15 +48,12 @@ ERR _expose_surface(OBJECTID SurfaceID, const SURFACELIST &List, int index, int
    }
 
    // Check if the exposed dimensions are outside of our boundary and/or our parent(s) boundaries.  If so then we must
-   // restrict the exposed dimensions.  NOTE: This loop looks strange but is both correct & fast.  Don't alter it!
+   // restrict the exposed dimensions.
 
-   for (i=index, parent_id = SurfaceID; ;) {
+   for (i=index; i >= 0; i=List[i].ParentIndex) {
       if (List[i].invisible()) return ERR::Okay;
       auto area = List[i].area();
       clip_rectangle(abs, area);
-      if (!(parent_id = List[i].ParentID)) break;
-      i--;
-      while (List[i].SurfaceID != parent_id) i--;
    }
 
    if ((abs.Left >= abs.Right) or (abs.Top >= abs.Bottom)) return ERR::Okay;
@@ -115,34 +106,22 @@ ERR _expose_surface(OBJECTID SurfaceID, const SURFACELIST &List, int index, int
 
       // If this is not a root bitmap object, skip it (i.e. consider it like a region)
 
-      skip = false;
-      parent_id = List[i].ParentID;
-      for (j=i-1; j >= index; j--) {
-         if (List[j].SurfaceID IS parent_id) {
-            if (List[j].BitmapID IS List[i].BitmapID) skip = TRUE;
-            break;
-         }
-      }
-      if (skip) continue;
+      if (auto p = List[i].ParentIndex; (p >= index) and (List[p].BitmapID IS List[i].BitmapID)) continue;
 
       auto childexpose = abs;
 
       if (i != index) {
          // Check this child object and its parents to make sure they are visible
 
-         parent_id = List[i].SurfaceID;
-         for (j=i; (j >= index) and (parent_id); j--) {
-            if (List[j].SurfaceID IS parent_id) {
-               if (List[j].invisible()) {
-                  skip = TRUE;
-                  break;
-               }
-
-               auto area = List[j].area();
-               clip_rectangle(childexpose, area);
-
-               parent_id = List[j].ParentID;
+         skip = false;
+         for (j=i; j >= index; j=List[j].ParentIndex) {
+            if (List[j].invisible()) {
+               skip = true;
+               break;
             }
+
+            auto area = List[j].area();
+            clip_rectangle(childexpose, area);
          }
          if (skip) continue;
 
@@ -275,6 +254,9 @@ procedure is as follows:
 <li>The bitmap is copied to the video display buffer to complete the process.</li>
 </>
 
+The redraw does not occur immediately; it is merged with all other redraw requests that are received before the next
+frame, and drawn in a single pass that is paced to the refresh rate of the display.
+
 Please be aware that:
 
 <list>
@@ -300,72 +282,20 @@ ERR SURFACE_Draw(extSurface *Self, struct acDraw *Args)
       return ERR::Okay|ERR::Notified;
    }
 
-   // Do not perform manual redraws when a redraw is scheduled.
-
-   if (Self->RedrawScheduled) return ERR::Okay|ERR::Notified;
-
-   int x, y, width, height;
-   if (!Args) {
-      x = 0;
-      y = 0;
-      width  = Self->Width;
-      height = Self->Height;
-   }
-   else {
-      x      = Args->X;
-      y      = Args->Y;
-      width  = Args->Width;
-      height = Args->Height;
-      if (!width) width = Self->Width;
-      if (!height) height = Self->Height;
+   ClipRectangle area(0, 0, Self->Width, Self->Height);
+   if (Args) {
+      area.Left   = Args->X;
+      area.Top    = Args->Y;
+      area.Right  = Args->X + (Args->Width ? Args->Width : Self->Width);
+      area.Bottom = Args->Y + (Args->Height ? Args->Height : Self->Height);
    }
 
-   // Check if other draw messages are queued for this object - if so, do not do anything until the final message is reached.
-
-   uint8_t msgbuffer[sizeof(Message) + sizeof(ActionMessage) + sizeof(struct acDraw)];
-   int msgindex = 0;
-   while (ScanMessages(&msgindex, MSGID::ACTION, msgbuffer, sizeof(msgbuffer)) IS ERR::Okay) {
-      auto action = (ActionMessage *)(msgbuffer + sizeof(Message));
-
-      if ((action->ActionID IS drw::InvalidateRegion::id) and (action->ObjectID IS Self->UID)) {
-         if (!action->SendArgs) {
-            return ERR::Okay|ERR::Notified;
-         }
-      }
-      else if ((action->ActionID IS AC::Draw) and (action->ObjectID IS Self->UID)) {
-         if (action->SendArgs IS TRUE) {
-            auto msgdraw = (struct acDraw *)(action + 1);
-
-            if (!Args) { // Tell the next message to draw everything.
-               action->SendArgs = FALSE;
-            }
-            else {
-               double right  = msgdraw->X + msgdraw->Width;
-               double bottom = msgdraw->Y + msgdraw->Height;
-
-               if (x < msgdraw->X) msgdraw->X = x;
-               if (y < msgdraw->Y) msgdraw->Y = y;
-               if ((x + width) > right)   right  = x + width;
-               if ((y + height) > bottom) bottom = y + height;
-
-               msgdraw->Width  = right - msgdraw->X;
-               msgdraw->Height = bottom - msgdraw->Y;
-            }
-
-            UpdateMessage(((Message *)msgbuffer)->UID, MSGID::NIL, action, sizeof(ActionMessage) + sizeof(struct acDraw));
-         }
-         else {
-            // We do nothing here because the next draw message will draw everything.
-         }
-
-         return ERR::Okay|ERR::Notified;
-      }
+   if (schedule_frame(Self, area, false) != ERR::Okay) { // Draw immediately if scheduling is unavailable
+      log.traceBranch("%dx%d,%dx%d", area.Left, area.Top, area.width(), area.height());
+      RedrawSurface(Self->UID, area.Left, area.Top, area.width(), area.height(), IRF::RELATIVE|IRF::IGNORE_CHILDREN);
+      gfx::ExposeSurface(Self->UID, area.Left, area.Top, area.width(), area.height(), EXF::REDRAW_VOLATILE);
    }
 
-
-   log.traceBranch("%dx%d,%dx%d", x, y, width, height);
-   RedrawSurface(Self->UID, x, y, width, height, IRF::RELATIVE|IRF::IGNORE_CHILDREN);
-   gfx::ExposeSurface(Self->UID, x, y, width, height, EXF::REDRAW_VOLATILE);
    return ERR::Okay|ERR::Notified;
 }
 
@@ -485,52 +415,12 @@ static ERR SURFACE_InvalidateRegion(extSurface *Self, struct drw::InvalidateRegi
       return ERR::Okay|ERR::Notified;
    }
 
-   // Do not perform manual redraws when a redraw is scheduled.
-
-   if (Self->RedrawTimer) return ERR::Okay|ERR::Notified;
-
-   // Check if other draw messages are queued for this object - if so, do not do anything until the final message is reached.
-
-   int msgindex = 0;
-   uint8_t msgbuffer[sizeof(Message) + sizeof(ActionMessage) + sizeof(*Args)];
-   while (ScanMessages(&msgindex, MSGID::ACTION, msgbuffer, sizeof(msgbuffer)) IS ERR::Okay) {
-      auto action = (ActionMessage *)(msgbuffer + sizeof(Message));
-      if ((action->ActionID IS drw::InvalidateRegion::id) and (action->ObjectID IS Self->UID)) {
-         if (action->SendArgs IS TRUE) {
-            auto msginvalid = (struct drw::InvalidateRegion *)(action + 1);
-
-            if (!Args) { // Invalidate everything
-               action->SendArgs = FALSE;
-            }
-            else {
-               double right  = msginvalid->X + msginvalid->Width;
-               double bottom = msginvalid->Y + msginvalid->Height;
+   ClipRectangle area(0, 0, Self->Width, Self->Height);
+   if (Args) area = ClipRectangle(Args->X, Args->Y, Args->X + Args->Width, Args->Y + Args->Height);
 
-               if (Args->X < msginvalid->X) msginvalid->X = Args->X;
-               if (Args->Y < msginvalid->Y) msginvalid->Y = Args->Y;
-               if ((Args->X + Args->Width) > right)   right  = Args->X + Args->Width;
-               if ((Args->Y + Args->Height) > bottom) bottom = Args->Y + Args->Height;
-
-               msginvalid->Width  = right - msginvalid->X;
-               msginvalid->Height = bottom - msginvalid->Y;
-            }
-
-            UpdateMessage(((Message *)msgbuffer)->UID, MSGID::NIL, action, sizeof(ActionMessage) + sizeof(struct drw::InvalidateRegion));
-         }
-         else { } // We do nothing here because the next invalidation message will draw everything.
-
-         return ERR::Okay|ERR::Notified;
-      }
-   }
-
-
-   if (Args) {
-      RedrawSurface(Self->UID, Args->X, Args->Y, Args->Width, Args->Height, IRF::RELATIVE);
-      gfx::ExposeSurface(Self->UID, Args->X, Args->Y, Args->Width, Args->Height, EXF::CHILDREN|EXF::REDRAW_VOLATILE_OVERLAP);
-   }
-   else {
-      RedrawSurface(Self->UID, 0, 0, Self->Width, Self->Height, IRF::RELATIVE);
-      gfx::ExposeSurface(Self->UID, 0, 0, Self->Width, Self->Height, EXF::CHILDREN|EXF::REDRAW_VOLATILE_OVERLAP);
+   if (schedule_frame(Self, area, true) != ERR::Okay) { // Draw immediately if scheduling is unavailable
+      RedrawSurface(Self->UID, area.Left, area.Top, area.width(), area.height(), IRF::RELATIVE);
+      gfx::ExposeSurface(Self->UID, area.Left, area.Top, area.width(), area.height(), EXF::CHILDREN|EXF::REDRAW_VOLATILE_OVERLAP);
    }
 
    return ERR::Okay|ERR::Notified;
@@ -674,8 +564,7 @@ void prepare_background(extSurface *Self, const SURFACELIST &List, int Index, ex
    // Everything that gets in the way between the parent and the location of our surface is what will be copied across.
 
    if (!List[end].ParentID) return;
-   int parentindex = end;
-   while ((parentindex > 0) and (List[parentindex].SurfaceID != List[end].ParentID)) parentindex--;
+   int parentindex = std::max(List[end].ParentIndex, 0);
 
    // If the parent object is invisible, we need to scan back to a visible parent
 
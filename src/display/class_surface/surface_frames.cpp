@@ -0,0 +1,231 @@
+/*********************************************************************************************************************
+
+Frame scheduling.  Draw() and InvalidateRegion() requests are not processed immediately; the requested areas are
+accumulated as damage regions against each surface, and a single redraw and expose pass is made for all surfaces on
+each frame tick.  Damage that is covered by the invalidation of an ancestor is discarded, as the ancestor's redraw will
+also cover its children.
+
+Frames are clocked at the refresh rate of the display, or the configured FrameRate (60Hz by default) if the refresh
+rate is unknown or the display is headless.  The timer is retained for a short period after the last frame, as there
+is a noticeable penalty for frequent subscription to the timer system.
+
+*********************************************************************************************************************/
+
+struct FrameDamage {
+   ClipRegion Draw;       // Surface-relative areas to redraw, ignoring non-volatile children
+   ClipRegion Invalidate; // Surface-relative areas to redraw, including children
+};
+
+static ankerl::unordered_dense::map<OBJECTID, FrameDamage> glFrameDamage;
+static std::mutex glFrameLock;
+static FrameStats glFrameStats;
+static int64_t glFrameTotalTime = 0;  // Cumulative drawing time in microseconds
+static int glFrameIdle = 0;           // Count of consecutive ticks that had no damage
+static std::atomic<bool> glDrawingFrame = false;
+
+static ERR frame_timer(OBJECTPTR, int64_t, int64_t);
+
+//********************************************************************************************************************
+// Returns the rate at which frames should be drawn.  The refresh rate of the primary display takes precedence.  Must
+// not be called while glFrameLock is held, as the display lock can take some time to acquire.
+
+static double get_frame_rate(void)
+{
+   OBJECTID display_id = 0;
+   if (!glHeadless) {
+      const std::lock_guard lock(glSurfaceLock);
+      if (!glSurfaces.empty()) display_id = glSurfaces[0].DisplayID;
+   }
+
+   double rate = 0;
+   if (display_id) {
+      if (ScopedObjectLock<objDisplay> display(display_id, 1000); display.granted()) {
+         rate = display->RefreshRate;
+      }
+   }
+
+   if (rate <= 0) rate = glpFrameRate;
+   if (rate < 1) rate = 1;
+   else if (rate > 1000) rate = 1000;
+   return rate;
+}
+
+//********************************************************************************************************************
+// Returns the length of a frame in microseconds.  Input processing uses this to deliver pointer movement no more than
+// once per frame.
+
+int64_t frame_interval(void)
+{
+   const std::lock_guard lock(glFrameLock);
+   if ((glFrameTimer) and (glFrameStats.FrameRate > 0)) return int64_t(1000000.0 / glFrameStats.FrameRate);
+   return int64_t(1000000.0 / std::clamp(glpFrameRate, 1.0, 1000.0));
+}
+
+//********************************************************************************************************************
+// Add an area to the damage that will be drawn on the next frame.  The area is relative to the surface.  If Children
+// is true then intersecting child surfaces will also be redrawn, as per InvalidateRegion().
+
+static ERR schedule_frame(extSurface *Self, const ClipRectangle &Area, bool Children)
+{
+   pf::Log log(__FUNCTION__);
+
+   // The frame rate is only needed if the timer is to be started, and must be determined prior to taking glFrameLock.
+
+   bool running;
+   {
+      const std::lock_guard lock(glFrameLock);
+      running = glFrameTimer != nullptr;
+   }
+   const double rate = running ? 0 : get_frame_rate();
+
+   const std::lock_guard lock(glFrameLock);
+
+   auto &damage = glFrameDamage[Self->UID];
+   if (Children) damage.Invalidate |= Area;
+   else damage.Draw |= Area;
+
+   if (!glFrameTimer) {
+      pf::SwitchContext context(glModule);
+      glFrameStats.FrameRate = (rate > 0) ? rate : std::clamp(glpFrameRate, 1.0, 1000.0); // Timer expired in the interim
+      if (SubscribeTimer(1.0 / glFrameStats.FrameRate, C_FUNCTION(frame_timer), &glFrameTimer) != ERR::Okay) {
+         glFrameDamage.erase(Self->UID);
+         return log.warning(ERR::Failed);
+      }
+      log.trace("Frame timer started at %.2fHz", glFrameStats.FrameRate);
+   }
+
+   glFrameIdle = 0;
+   return ERR::Okay;
+}
+
+//********************************************************************************************************************
+// Draws and exposes all pending damage.  The surfaces are processed in list order so that parents are drawn before
+// their children, and all redraws are completed before any areas are exposed to the display.
+
+static void draw_frame(void)
+{
+   pf::Log log(__FUNCTION__);
+
+   if (tlNoDrawing) return;
+   if (glDrawingFrame.exchange(true)) return; // A frame is already being drawn
+
+   ankerl::unordered_dense::map<OBJECTID, FrameDamage> pending;
+   {
+      const std::lock_guard lock(glFrameLock);
+      if (glFrameDamage.empty()) {
+         glDrawingFrame = false;
+         return;
+      }
+      pending.swap(glFrameDamage);
+   }
+
+   auto start = PreciseTime();
+
+   struct FrameWork {
+      OBJECTID   SurfaceID;
+      ClipRegion Draw, Invalidate;
+   };
+
+   std::vector<FrameWork> work;
+   {
+      const std::lock_guard lock(glSurfaceLock);
+
+      std::vector<std::pair<int, FrameDamage *>> order;
+      order.reserve(pending.size());
+      for (auto &[id, damage] : pending) {
+         if (auto index = find_surface_list(id); index != -1) order.emplace_back(index, &damage);
+      }
+      std::sort(order.begin(), order.end(), [](const auto &A, const auto &B) { return A.first < B.first; });
+
+      // Areas invalidated by each surface, in absolute coordinates.  These are used to discard the damage of
+      // descendants that will be redrawn anyway.
+
+      ankerl::unordered_dense::map<OBJECTID, ClipRegion> invalidated;
+
+      for (auto &[index, damage] : order) {
+         auto &record = glSurfaces[index];
+         if (record.invisible()) continue;
+
+         damage->Draw -= damage->Invalidate;
+
+         for (auto i=record.ParentIndex; i >= 0; i=glSurfaces[i].ParentIndex) {
+            if (auto it = invalidated.find(glSurfaces[i].SurfaceID); it != invalidated.end()) {
+               auto covered = it->second;
+               covered.translate(-record.Left, -record.Top);
+               damage->Invalidate -= covered;
+               damage->Draw -= covered;
+            }
+         }
+
+         if ((damage->Draw.empty()) and (damage->Invalidate.empty())) continue;
+
+         if (!damage->Invalidate.empty()) {
+            auto absolute = damage->Invalidate;
+            absolute.translate(record.Left, record.Top);
+            invalidated[record.SurfaceID] = std::move(absolute);
+         }
+
+         work.push_back({ record.SurfaceID, std::move(damage->Draw), std::move(damage->Invalidate) });
+      }
+   }
+
+   for (auto &w : work) {
+      for (auto &r : w.Invalidate) RedrawSurface(w.SurfaceID, r.Left, r.Top, r.width(), r.height(), IRF::RELATIVE);
+      for (auto &r : w.Draw) RedrawSurface(w.SurfaceID, r.Left, r.Top, r.width(), r.height(), IRF::RELATIVE|IRF::IGNORE_CHILDREN);
+   }
+
+   for (auto &w : work) {
+      for (auto &r : w.Invalidate) gfx::ExposeSurface(w.SurfaceID, r.Left, r.Top, r.width(), r.height(), EXF::CHILDREN|EXF::REDRAW_VOLATILE_OVERLAP);
+      for (auto &r : w.Draw) gfx::ExposeSurface(w.SurfaceID, r.Left, r.Top, r.width(), r.height(), EXF::REDRAW_VOLATILE);
+   }
+
+   auto elapsed = PreciseTime() - start;
+   int64_t frame;
+   {
+      const std::lock_guard lock(glFrameLock);
+      frame = ++glFrameStats.Frames;
+      glFrameTotalTime += elapsed;
+      glFrameStats.FrameTime = double(glFrameTotalTime) / double(glFrameStats.Frames) / 1000.0;
+      if (elapsed / 1000.0 > glFrameStats.MaxFrameTime) glFrameStats.MaxFrameTime = elapsed / 1000.0;
+   }
+
+   log.trace("Frame %" PRId64 ": %d surfaces in %" PRId64 "us", frame, int(work.size()), elapsed);
+
+   glDrawingFrame = false;
+}
+
+//********************************************************************************************************************
+// Draws any damage that is pending immediately.  Used by operations that read surface graphics and therefore need
+// the buffers to be current.
+
+static void flush_frame(void)
+{
+   if (!glFrameTimer) return;
+   draw_frame();
+}
+
+//********************************************************************************************************************
+
+static ERR frame_timer(OBJECTPTR Subscriber, int64_t Elapsed, int64_t CurrentTime)
+{
+   {
+      const std::lock_guard lock(glFrameLock);
+
+      if (glFrameDamage.empty()) {
+         // Hold onto the timer for a while before unsubscribing, in case more damage is incoming.
+         if (++glFrameIdle >= glFrameStats.FrameRate * 30.0) {
+            glFrameTimer = nullptr;
+            return ERR::Terminate;
+         }
+         return ERR::Okay;
+      }
+
+      // If the timer fired late then one or more frame intervals were missed.  Elapsed is in microseconds.
+
+      auto interval = 1000000.0 / glFrameStats.FrameRate;
+      if (Elapsed > interval * 1.5) glFrameStats.DroppedFrames += int64_t(Elapsed / interval + 0.5) - 1;
+   }
+
+   draw_frame();
+   return ERR::Okay;
+}
@@ -23,6 +23,7 @@
 
 #include <unordered_set>
 #include <mutex>
+#include <atomic>
 #include <queue>
 #include <sstream>
 #include <array>
@@ -108,7 +109,9 @@
 #include <kotuku/modules/regex.h>
 #include <kotuku/strings.hpp>
 #include "../link/linear_rgb.h"
+#include "../link/simd_blend.h"
 #include "../link/unicode.h"
+#include "region.h"
 
 using namespace pf;
 class extBitmap;
@@ -124,6 +127,7 @@ struct SurfaceRecord {
    OBJECTID RootID;        // RootLayer
    OBJECTID PopOverID;
    RNF      Flags;         // Surface flags (RNF::VISIBLE etc)
+   int     ParentIndex;   // Cached list index of the parent, or -1 if there is no parent
    int     X;             // Horizontal coordinate
    int     Y;             // Vertical coordinate
    int     Width;         // Width
@@ -272,6 +276,7 @@ struct ClipRecord {
 //********************************************************************************************************************
 
 extern std::vector<SurfaceRecord> glSurfaces;
+extern ankerl::unordered_dense::map<OBJECTID, int> glSurfaceIndex; // Surface ID to glSurfaces index
 
 //********************************************************************************************************************
 
@@ -325,7 +330,6 @@ class extSurface : public objSurface {
    int     ListIndex;            // Last known list index
    int     InputHandle;          // Input handler for dragging of surfaces
    SWIN     WindowType;           // See SWIN constants
-   TIMER    RedrawTimer;          // For ScheduleRedraw()
    SurfaceCallback CallbackCache[4];
    int16_t     ScrollProgress;
    int16_t     Opacity;
@@ -335,8 +339,6 @@ class extSurface : public objSurface {
    uint16_t FixedX:1;
    uint16_t FixedY:1;
    uint16_t Document:1;
-   uint16_t RedrawScheduled:1;
-   uint16_t RedrawCountdown;      // Unsubscribe from the timer when this value reaches zero.
    int8_t     BitsPerPixel;         // Bitmap bits per pixel
    int8_t     BytesPerPixel;        // Bitmap bytes per pixel
    uint8_t    CallbackCount;
@@ -373,6 +375,7 @@ class extDisplay : public objDisplay {
 };
 
 extern void clean_clipboard(void);
+extern void free_row_pool(void);
 extern ERR  create_bitmap_class(void);
 extern ERR  create_clipboard_class(void);
 extern ERR  create_controller_class(void);
@@ -381,8 +384,10 @@ extern ERR  create_pointer_class(void);
 extern ERR  create_surface_class(void);
 extern ERR  get_surface_abs(OBJECTID, int *, int *, int *, int *);
 extern void input_event_loop(HOSTHANDLE, APTR);
+extern int64_t frame_interval(void);
 extern ERR  lock_surface(extBitmap *, int16_t);
 extern ERR  unlock_surface(extBitmap *);
+extern ERR  restore_tiles(extBitmap *, int, int, int, int, bool);
 extern ERR  get_display_info(OBJECTID, DISPLAYINFO *, int);
 extern void resize_feedback(FUNCTION *, OBJECTID, int X, int Y, int Width, int Height);
 extern void forbidDrawing(void);
@@ -394,6 +399,7 @@ extern ERR  load_styles(void);
 extern int find_bitmap_owner(const SURFACELIST &, int);
 extern void move_layer(extSurface *, int, int);
 extern void move_layer_pos(SURFACELIST &, int, int);
+extern void index_surfaces(int);
 extern void prepare_background(extSurface *, const SURFACELIST &, int, extBitmap *, const ClipRectangle &, int8_t);
 extern void process_surface_callbacks(extSurface *, extBitmap *);
 extern void refresh_pointer(extSurface *Self);
@@ -427,15 +433,14 @@ extern struct CoreBase *CoreBase;
 extern ColourFormat glColourFormat;
 extern bool glHeadless;
 extern FieldDef CursorLookup[];
-extern TIMER glRefreshPointerTimer;
+extern TIMER glRefreshPointerTimer, glFrameTimer, glInputTimer;
 extern extBitmap *glComposite;
-extern double glpRefreshRate, glpGammaRed, glpGammaGreen, glpGammaBlue;
+extern double glpRefreshRate, glpFrameRate, glpGammaRed, glpGammaGreen, glpGammaBlue;
 extern int glpDisplayWidth, glpDisplayHeight, glpDisplayX, glpDisplayY;
 extern int glpDisplayDepth; // If zero, the display depth will be based on the hosted desktop's bit depth.
 extern int glpMaximise, glpFullScreen;
 extern SWIN glpWindowType;
 extern char glpDPMS[20];
-extern uint8_t *glDemultiply;
 extern std::array<uint8_t, 256 * 256> glAlphaLookup;
 extern std::list<ClipRecord> glClips;
 extern int glLastPort;
@@ -510,6 +515,10 @@ extern void handle_stack_change(XCirculateEvent *);
 extern void init_xcursors(void);
 extern void free_xcursors(void);
 extern ERR resize_pixmap(extDisplay *, int, int);
+extern ERR x11_present(extBitmap *, extBitmap *, int, int, int, int, int, int);
+extern void x11_shm_completion(XShmCompletionEvent *);
+extern void x11_free_presenter(Drawable);
+extern void x11_free_presenters(void);
 extern ERR xr_set_display_mode(int *, int *);
 
 extern int16_t glDGAAvailable;
@@ -518,6 +527,8 @@ extern XVisualInfo glXInfoAlpha;
 extern X11Globals glX11;
 extern _XDisplay *XDisplay;
 extern bool glX11ShmImage;
+extern int glXShmCompletion;
+extern int64_t glPresentStalls;
 extern bool glXCompositeSupported;
 extern uint8_t KeyHeld[int(KEY::LIST_END)];
 extern KQ glKeyFlags;
@@ -536,19 +547,6 @@ extern bool glXRRAvailable;
 
 #include "prototypes.h"
 
-template <typename T>
-void UpdateSurfaceField(objSurface *Self, T SurfaceRecord::*LValue, T Value)
-{
-   if (Self->initialised()) {
-      for (auto &record : glSurfaces) {
-         if (record.SurfaceID IS Self->UID) {
-            record.*LValue = Value;
-            return;
-         }
-      }
-   }
-}
-
 inline void clip_rectangle(ClipRectangle &rect, ClipRectangle &clip)
 {
    if (rect.Left   < clip.Left)   rect.Left   = clip.Left;
@@ -563,9 +561,10 @@ inline int find_bitmap_owner(int Index)
 }
 
 //********************************************************************************************************************
-// Surface list lookup routines.
+// Surface list lookup routines.  These resolve against the glSurfaceIndex map, which is maintained by track_layer(),
+// untrack_layer() and move_layer_pos().
 
-inline int find_surface_list(extSurface *Surface, int Limit = -1)
+inline int find_surface_list(OBJECTID SurfaceID, int Limit = -1)
 {
    if (Limit IS -1) Limit = int(glSurfaces.size());
    else if (Limit > int(glSurfaces.size())) {
@@ -574,42 +573,41 @@ inline int find_surface_list(extSurface *Surface, int Limit = -1)
       Limit = int(glSurfaces.size());
    }
 
-   for (int i=0; i < Limit; i++) {
-      if (glSurfaces[i].SurfaceID IS Surface->UID) return i;
+   if (auto it = glSurfaceIndex.find(SurfaceID); (it != glSurfaceIndex.end()) and (it->second < Limit)) {
+      return it->second;
    }
 
    return -1;
 }
 
-inline int find_surface_list(OBJECTID SurfaceID, int Limit = -1)
+inline int find_surface_list(extSurface *Surface, int Limit = -1)
 {
-   if (Limit IS -1) Limit = int(glSurfaces.size());
-   else if (Limit > int(glSurfaces.size())) {
-      pf::Log log(__FUNCTION__);
-      log.warning("Invalid Limit parameter of %d (max %d)", Limit, int(glSurfaces.size()));
-      Limit = int(glSurfaces.size());
-   }
-
-   for (int i=0; i < Limit; i++) {
-      if (glSurfaces[i].SurfaceID IS SurfaceID) return i;
-   }
-
-   return -1;
+   return find_surface_list(Surface->UID, Limit);
 }
 
+// The list may be a snapshot of glSurfaces, in which case the cached parent index is used if it remains valid.
+
 inline int find_parent_list(const SURFACELIST &list, extSurface *Self)
 {
-   if ((Self->ListIndex < std::ssize(list)) and (list[Self->ListIndex].SurfaceID IS Self->UID)) {
-      for (int i=Self->ListIndex-1; i >= 0; i--) {
-         if (list[i].SurfaceID IS Self->ParentID) return i;
-      }
+   if (auto i = find_surface_list(Self); (i != -1) and (i < std::ssize(list)) and (list[i].SurfaceID IS Self->UID)) {
+      if (auto p = list[i].ParentIndex; (p >= 0) and (list[p].SurfaceID IS Self->ParentID)) return p;
    }
 
    return find_surface_list(Self->ParentID);
 }
 
+template <typename T>
+void UpdateSurfaceField(objSurface *Self, T SurfaceRecord::*LValue, T Value)
+{
+   if (Self->initialised()) {
+      if (auto i = find_surface_list(Self->UID); i != -1) glSurfaces[i].*LValue = Value;
+   }
+}
+
 //********************************************************************************************************************
 
+namespace bitmap_tiles { class TileStore; }
+
 class extBitmap : public objBitmap {
    public:
    using create = pf::Create<extBitmap>;
@@ -619,6 +617,7 @@ class extBitmap : public objBitmap {
    RGBPalette prvPaletteArray;
    struct ColourFormat prvColourFormat;
    uint8_t *prvCompress;
+   bitmap_tiles::TileStore *prvTiles; // Tile storage if the bitmap was compressed with BMF::TILED
    int   prvAFlags;                  // Private allocation flags
    #ifdef __xwindows__
       struct {
@@ -647,3 +646,11 @@ class extBitmap : public objBitmap {
       int prvGLFormat;
    #endif
 };
+
+// Restores the tiles of a tile-compressed bitmap that intersect an area that is about to be read or drawn.
+
+inline ERR restore_area(extBitmap *Bitmap, int X, int Y, int Width, int Height, bool Write)
+{
+   if (Bitmap->prvTiles) return restore_tiles(Bitmap, X, Y, Width, Height, Write);
+   else return ERR::Okay;
+}
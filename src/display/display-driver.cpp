@@ -188,16 +188,15 @@ OBJECTPTR clDisplay = nullptr, clPointer = nullptr, clBitmap = nullptr, clClipbo
 OBJECTID glPointerID = 0;
 DISPLAYINFO glDisplayInfo;
 bool glSixBitDisplay = false;
-TIMER glRefreshPointerTimer = 0;
+TIMER glRefreshPointerTimer = 0, glFrameTimer = 0, glInputTimer = 0;
 extBitmap *glComposite = nullptr;
 static auto glDisplayType = DT::NATIVE;
-double glpRefreshRate = -1, glpGammaRed = 1, glpGammaGreen = 1, glpGammaBlue = 1;
+double glpRefreshRate = -1, glpFrameRate = 60, glpGammaRed = 1, glpGammaGreen = 1, glpGammaBlue = 1;
 int glpDisplayWidth = 1024, glpDisplayHeight = 768, glpDisplayX = 0, glpDisplayY = 0;
 int glpDisplayDepth = 0; // If zero, the display depth will be based on the hosted desktop's bit depth.
 int glpMaximise = FALSE, glpFullScreen = FALSE;
 SWIN glpWindowType = SWIN::HOST;
 char glpDPMS[20] = "Standby";
-uint8_t *glDemultiply = nullptr;
 int glLastPort = -1;
 
 std::vector<OBJECTID> glFocusList;
@@ -563,7 +562,10 @@ extern ERR resize_pixmap(extDisplay *Self, int Width, int Height)
 
    if (auto pixmap = XCreatePixmap(XDisplay, Self->XWindowHandle, bmp->x11.pix_width, bmp->x11.pix_height, xbpp)) {
       XSetWindowBackgroundPixmap(XDisplay, Self->XWindowHandle, pixmap);
-      if (Self->XPixmap) XFreePixmap(XDisplay, Self->XPixmap);
+      if (Self->XPixmap) {
+         x11_free_presenter(Self->XPixmap);
+         XFreePixmap(XDisplay, Self->XPixmap);
+      }
       Self->XPixmap = pixmap;
       bmp->x11.drawable = pixmap;
       return ERR::Okay;
@@ -929,6 +931,7 @@ static ERR MODInit(OBJECTPTR argModule, struct CoreBase *argCoreBase)
          if (XShmQueryVersion(XDisplay, &shmmajor, &shmminor, &pixmaps)) {
             log.msg("X11 shared image extension is active.");
             glX11ShmImage = true;
+            glXShmCompletion = XShmGetEventBase(XDisplay) + ShmCompletion;
          }
       #endif
 
@@ -1120,6 +1123,7 @@ static ERR MODInit(OBJECTPTR argModule, struct CoreBase *argCoreBase)
       }
 
       config->read("DISPLAY", "RefreshRate", glpRefreshRate);
+      config->read("DISPLAY", "FrameRate", glpFrameRate);
       config->read("DISPLAY", "GammaRed", glpGammaRed);
       config->read("DISPLAY", "GammaGreen", glpGammaGreen);
       config->read("DISPLAY", "GammaBlue", glpGammaBlue);
@@ -1176,9 +1180,12 @@ static ERR MODExpunge(void)
    }
 
    if (glRefreshPointerTimer) { UpdateTimer(glRefreshPointerTimer, 0); glRefreshPointerTimer = 0; }
+   if (glFrameTimer)          { UpdateTimer(glFrameTimer, 0); glFrameTimer = 0; }
+   if (glInputTimer)          { UpdateTimer(glInputTimer, 0); glInputTimer = 0; }
    if (glComposite)           { FreeResource(glComposite); glComposite = nullptr; }
    if (glCompress)            { FreeResource(glCompress); glCompress = nullptr; }
-   if (glDemultiply)          { FreeResource(glDemultiply); glDemultiply = nullptr; }
+
+   free_row_pool();
 
    DeregisterFD((HOSTHANDLE)-2); // Disable input_event_loop()
 
@@ -1194,6 +1201,7 @@ static ERR MODExpunge(void)
 
       if (XDisplay) {
          free_xcursors();
+         x11_free_presenters();
 
          if (glXGC) { XFreeGC(XDisplay, glXGC); glXGC = 0; }
          if (glClipXGC) { XFreeGC(XDisplay, glClipXGC); glClipXGC = 0; }
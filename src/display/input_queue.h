@@ -0,0 +1,65 @@
+// Filtering of the input event queue for delivery to subscribers.  InputEvent must be declared prior to inclusion.
+//
+// Pointer movement is delivered no more than once per frame.  If only movement is queued and the last delivery was
+// within the current frame, the queue is held until the start of the next frame.  Any other type of input is delivered
+// immediately, along with the movement that precedes it.
+//
+// Consecutive movement events are coalesced to the most recent unless the subscriber's mask includes JTYPE::HISTORY.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace input_queue {
+
+inline bool is_movement(const InputEvent &Event)
+{
+   return ((Event.Flags & (JTYPE::MOVEMENT|JTYPE::ANCHORED)) != JTYPE::NIL) and
+          ((Event.Flags & (JTYPE::BUTTON|JTYPE::CROSSING)) IS JTYPE::NIL);
+}
+
+// Merges Event into Prev if they differ only in position and time.  Anchored movement is reported as a delta, so the
+// deltas are accumulated.
+
+inline bool coalesce(InputEvent &Prev, const InputEvent &Event)
+{
+   if ((!is_movement(Prev)) or (Prev.Flags != Event.Flags) or (Prev.Mask != Event.Mask) or (Prev.Type != Event.Type)) return false;
+   if ((Prev.RecipientID != Event.RecipientID) or (Prev.OverID != Event.OverID) or (Prev.DeviceID != Event.DeviceID)) return false;
+
+   if ((Event.Flags & JTYPE::ANCHORED) != JTYPE::NIL) {
+      const double x = Prev.X + Event.X, y = Prev.Y + Event.Y;
+      Prev = Event;
+      Prev.X = x;
+      Prev.Y = y;
+   }
+   else Prev = Event;
+   return true;
+}
+
+// Returns true if the queue is to be held until the next frame.
+
+inline bool hold(const std::vector<InputEvent> &Queue, int64_t Now, int64_t LastDelivery, int64_t Interval)
+{
+   return (Now - LastDelivery < Interval) and (std::all_of(Queue.begin(), Queue.end(), is_movement));
+}
+
+// Copies the events in Queue that match a subscription to Output, coalescing movement where permitted.  The Next
+// fields of Output are linked on return.
+
+inline void filter(const std::vector<InputEvent> &Queue, OBJECTID SurfaceFilter, JTYPE InputMask, std::vector<InputEvent> &Output)
+{
+   const bool history = (InputMask & JTYPE::HISTORY) != JTYPE::NIL;
+   for (auto &event : Queue) {
+      if (((event.RecipientID IS SurfaceFilter) or (!SurfaceFilter)) and ((event.Flags & InputMask) != JTYPE::NIL)) {
+         if ((history) or (Output.empty()) or (!coalesce(Output.back(), event))) Output.push_back(event);
+      }
+   }
+
+   for (size_t i=0; i < Output.size(); i++) {
+      Output[i].Next = (i + 1 < Output.size()) ? &Output[i + 1] : nullptr;
+   }
+}
+
+} // namespace input_queue
@@ -6,12 +6,91 @@ Name: Bitmap
 
 *********************************************************************************************************************/
 
+#include <bs_thread_pool.h> // Must precede the X11 headers, which define an 'index' macro
 #include "defs.h"
+#include "pixel_convert.h"
 
 #ifdef _WIN32
 using namespace display;
 #endif
 
+//********************************************************************************************************************
+// Calls Function(Start, End) for ranges of rows in an area.  Large areas are split over the threads of a pool that is
+// created on first use and retained until the module is expunged; small areas are processed on the caller's thread
+// because the cost of dispatching to the pool would outweigh the gain.
+
+static std::unique_ptr<BS::thread_pool<>> glRowPool;
+static std::mutex glRowPoolLock;
+
+template <class T> static void for_rows(int Width, int Height, T &&Function)
+{
+   int thread_count = std::thread::hardware_concurrency();
+   if (thread_count < 1) thread_count = 1;
+   if (int64_t(Width) * int64_t(Height) < 512 * 512) thread_count = 1;
+   if (thread_count > Height / 16) thread_count = std::max(1, Height / 16);
+
+   if (thread_count IS 1) {
+      Function(0, Height);
+      return;
+   }
+
+   {
+      const std::lock_guard lock(glRowPoolLock);
+      if (!glRowPool) glRowPool = std::make_unique<BS::thread_pool<>>(std::max(1u, std::thread::hardware_concurrency()));
+   }
+
+   // Waiting on the futures rather than the pool means that concurrent callers only wait for their own rows.
+
+   glRowPool->submit_blocks(0, Height, [&](int Start, int End) { Function(Start, End); }, thread_count).wait();
+}
+
+void free_row_pool(void)
+{
+   const std::lock_guard lock(glRowPoolLock);
+   glRowPool.reset();
+}
+
+//********************************************************************************************************************
+// Converts an area between bitmaps of differing bit depths with the row kernels in pixel_convert.h.  Returns false if
+// there is no kernel for the combination, in which case the caller must convert the pixels individually.
+
+static bool convert_area(extBitmap *Src, extBitmap *Dest, int X, int Y, int Width, int Height, int DestX, int DestY)
+{
+   using namespace pixel_convert;
+
+   using ROW_FN = void (*)(const uint8_t *, uint8_t *, int, const ColourFormat &, const ColourFormat &);
+
+   ROW_FN convert = nullptr;
+   if (Src->BytesPerPixel IS 4) {
+      if (Dest->BytesPerPixel IS 2) {
+         convert = [](const uint8_t *S, uint8_t *D, int W, const ColourFormat &SF, const ColourFormat &DF) {
+            row_32_to_16(S, D, W, SF, DF);
+         };
+      }
+      else if (Dest->BytesPerPixel IS 3) convert = row_32_to_24;
+   }
+   else if (Dest->BytesPerPixel IS 4) {
+      if (Src->BytesPerPixel IS 2) {
+         convert = [](const uint8_t *S, uint8_t *D, int W, const ColourFormat &SF, const ColourFormat &DF) {
+            row_16_to_32(S, D, W, SF, DF);
+         };
+      }
+      else if (Src->BytesPerPixel IS 3) convert = row_24_to_32;
+   }
+
+   if (!convert) return false;
+
+   const auto src  = Src->Data + (Y * Src->LineWidth) + (X * Src->BytesPerPixel);
+   const auto dest = Dest->Data + (DestY * Dest->LineWidth) + (DestX * Dest->BytesPerPixel);
+
+   for_rows(Width, Height, [&](int Start, int End) {
+      for (int y=Start; y < End; y++) {
+         convert(src + (y * Src->LineWidth), dest + (y * Dest->LineWidth), Width, Src->prvColourFormat, Dest->prvColourFormat);
+      }
+   });
+   return true;
+}
+
 //********************************************************************************************************************
 // NOTE: Please ensure that the Width and Height are already clipped to meet the restrictions of BOTH the source and
 // destination bitmaps.
@@ -43,6 +122,32 @@ static ERR dither(extBitmap *Bitmap, extBitmap *Dest, ColourFormat *Format, int
       return ERR::Okay;
    }
 
+   // 32-bit sources use an ordered dither, which has no dependencies between pixels and can be vectorised and split
+   // over multiple threads.  The dither matrix is aligned to the destination so that adjacent copies tile seamlessly.
+
+   if ((Bitmap->BytesPerPixel IS 4) and ((Dest->BytesPerPixel IS 2) or ((Dest->BytesPerPixel IS 4) and
+       (Dest->prvColourFormat.RedPos IS Bitmap->prvColourFormat.RedPos) and
+       (Dest->prvColourFormat.GreenPos IS Bitmap->prvColourFormat.GreenPos) and
+       (Dest->prvColourFormat.BluePos IS Bitmap->prvColourFormat.BluePos)))) {
+      const ColourFormat &quantise = Format ? *Format : Dest->prvColourFormat;
+
+      for_rows(Width, Height, [&](int Start, int End) {
+         std::vector<uint8_t> row((Dest->BytesPerPixel IS 2) ? Width * 4 : 0);
+         for (int y=Start; y < End; y++) {
+            auto src  = Bitmap->Data + ((SrcY + y) * Bitmap->LineWidth) + (SrcX<<2);
+            auto dest = Dest->Data + ((DestY + y) * Dest->LineWidth) + (DestX * Dest->BytesPerPixel);
+            if (Dest->BytesPerPixel IS 4) {
+               pixel_convert::dither_row(src, dest, Width, DestX, DestY + y, Bitmap->prvColourFormat, quantise);
+            }
+            else {
+               pixel_convert::dither_row(src, row.data(), Width, DestX, DestY + y, Bitmap->prvColourFormat, quantise);
+               pixel_convert::row_32_to_16(row.data(), dest, Width, Bitmap->prvColourFormat, Dest->prvColourFormat);
+            }
+         }
+      });
+      return ERR::Okay;
+   }
+
    auto DITHER_ERROR = [&]<typename T>(uint8_t Src, T RGB16::*Comp, int x, int y) {
       // Dither one colour component
       if (int dif = (buf1[x].*Comp>>3) - (Src<<3)) { // An eighth of the error
@@ -200,8 +305,9 @@ If the `TRANSPARENT` flag is set in the source object, all colours that match th
 ignored in the copy operation.
 
 To enable dithering, pass `BAF::DITHER` in the Flags parameter.  The drawing algorithm will use dithering if the source
-needs to be down-sampled to the target bitmap's bit depth.  To enable alpha blending, set `BAF::BLEND` (the source bitmap
-will also need to have the `BMF::ALPHA_CHANNEL` flag set to indicate that an alpha channel is available).
+needs to be down-sampled to the target bitmap's bit depth.  32-bit sources are dithered with an ordered 4x4 matrix,
+while other sources use error diffusion.  To enable alpha blending, set `BAF::BLEND` (the source bitmap will also need
+to have the `BMF::ALPHA_CHANNEL` flag set to indicate that an alpha channel is available).
 
 The quality of 32-bit alpha blending can be improved by selecting the `BAF::LINEAR` flag.  This enables an additional
 computation whereby each RGB value is converted to linear sRGB colour space before performing the blend.  The
@@ -409,6 +515,11 @@ ERR CopyArea(objBitmap *Source, objBitmap *Dest, BAF Flags, int X, int Y, int Wi
    if (Width < 1) return ERR::Okay;
    if (Height < 1) return ERR::Okay;
 
+   // Tile-compressed bitmaps only need the tiles within the copied areas to be restored.
+
+   if (auto error = restore_area(src, X, Y, Width, Height, false); error != ERR::Okay) return error;
+   if (auto error = restore_area(dest, DestX, DestY, Width, Height, true); error != ERR::Okay) return error;
+
 #ifdef _WIN32
    if (dest->win.Drawable) { // Destination is a window
 
@@ -542,6 +653,11 @@ ERR CopyArea(objBitmap *Source, objBitmap *Dest, BAF Flags, int X, int Y, int Wi
                Height--;
             }
          }
+         else if (x11_present(src, dest, X, Y, Width, Height, DestX, DestY) IS ERR::Okay) {
+            // Presented asynchronously from a shared memory segment; refer to x11/present.cpp
+            if ((src->Flags & BMF::ALPHA_CHANNEL) IS BMF::NIL) XClearWindow(XDisplay, dest->x11.window);
+            XFlush(XDisplay);
+         }
          else { // Source is an ximage, destination is a pixmap
             if ((src->Flags & BMF::ALPHA_CHANNEL) != BMF::NIL) src->premultiply();
 
@@ -652,7 +768,29 @@ ERR CopyArea(objBitmap *Source, objBitmap *Dest, BAF Flags, int X, int Y, int Wi
                uint8_t *sdata = src->Data + (Y * src->LineWidth) + (X<<2);
                uint8_t *ddata = dest->Data + (DestY * dest->LineWidth) + (DestX<<2);
 
-               if ((Flags & BAF::COPY) != BAF::NIL) { // Avoids blending in cases where the destination pixel is zero alpha.
+               // sRGB blending between bitmaps of the same pixel format is performed by a SIMD span kernel.  The
+               // COPY option does not apply the source Opacity.
+
+               simd_blend::span_fn kernel = nullptr;
+               if (((Flags & BAF::LINEAR) IS BAF::NIL) and (sA IS dA) and (sR IS dR) and (sG IS dG) and (sB IS dB)) {
+                  kernel = simd_blend::src_over({ sR, sG, sB, sA }, { dR, dG, dB, dA });
+               }
+
+               if (kernel) {
+                  const bool copy = (Flags & BAF::COPY) != BAF::NIL;
+                  simd_blend::span span = {
+                     .dest = ddata, .src = sdata, .covers = nullptr, .count = uint32_t(Width), .step = 4,
+                     .cover = copy ? uint8_t(0xff) : uint8_t(src->Opacity), .cover_plus_one = false, .skip_clear = true,
+                     .copy_empty = copy, .copy_first = true
+                  };
+
+                  for (int y=0; y < Height; y++) {
+                     kernel(span);
+                     span.src  += src->LineWidth;
+                     span.dest += dest->LineWidth;
+                  }
+               }
+               else if ((Flags & BAF::COPY) != BAF::NIL) { // Avoids blending in cases where the destination pixel is zero alpha.
                   for (int y=0; y < Height; y++) {
                      uint8_t *sp = sdata, *dp = ddata;
                      if ((Flags & BAF::LINEAR) != BAF::NIL) {
@@ -1038,10 +1176,7 @@ ERR CopyArea(objBitmap *Source, objBitmap *Dest, BAF Flags, int X, int Y, int Wi
                }
                else {
                   while (Height > 0) {
-                     for (i=0; (size_t)i > sizeof(int); i += sizeof(int)) {
-                        ((int *)(data+i))[0] = ((int *)(srcdata+i))[0];
-                     }
-                     while (i < Width) { data[i] = srcdata[i]; i++; }
+                     copymem(srcdata, data, Width);
                      srcdata += src->LineWidth;
                      data    += dest->LineWidth;
                      Height--;
@@ -1051,7 +1186,7 @@ ERR CopyArea(objBitmap *Source, objBitmap *Dest, BAF Flags, int X, int Y, int Wi
             else {
                // If the bitmaps do not match then we need to use this slower RGB translation subroutine.
 
-               bool dithered = false;
+               bool converted = false;
                if ((Flags & BAF::DITHER) != BAF::NIL) {
                   if ((dest->BitsPerPixel < 24) and
                       ((src->BitsPerPixel > dest->BitsPerPixel) or
@@ -1059,12 +1194,14 @@ ERR CopyArea(objBitmap *Source, objBitmap *Dest, BAF Flags, int X, int Y, int Wi
                      if ((src->Flags & BMF::TRANSPARENT) != BMF::NIL);
                      else {
                         dither(src, dest, nullptr, Width, Height, X, Y, DestX, DestY);
-                        dithered = TRUE;
+                        converted = true;
                      }
                   }
                }
 
-               if (dithered IS false) {
+               if ((!converted) and (src != dest)) converted = convert_area(src, dest, X, Y, Width, Height, DestX, DestY);
+
+               if (!converted) {
                   if ((src IS dest) and (DestY >= Y) and (DestY < Y+Height)) {
                      while (Height > 0) {
                         Y += Height - 1;
@@ -1230,6 +1367,8 @@ ERR CopyRawBitmap(BITMAPSURFACE *Surface, objBitmap *Bitmap, CSRF Flags, int X,
    if (Width < 1) return ERR::Okay;
    if (Height < 1) return ERR::Okay;
 
+   if (auto error = restore_area((extBitmap *)Bitmap, XDest, YDest, Width, Height, true); error != ERR::Okay) return error;
+
    // Adjust coordinates by offset values
 
    if ((Flags & CSRF::OFFSET) != CSRF::NIL) {
@@ -1599,6 +1738,8 @@ void DrawRectangle(objBitmap *Target, int X, int Y, const int Width, const int H
    if ((X + w) >= Bitmap->Clip.Right)   w = Bitmap->Clip.Right - X;
    if ((Y + h) >= Bitmap->Clip.Bottom) h = Bitmap->Clip.Bottom - Y;
 
+   if (restore_area(Bitmap, X, Y, w, h, true) != ERR::Okay) return;
+
    uint16_t red   = Bitmap->unpackRed(Colour);
    uint16_t green = Bitmap->unpackGreen(Colour);
    uint16_t blue  = Bitmap->unpackBlue(Colour);
@@ -1716,6 +1857,7 @@ void DrawRGBPixel(objBitmap *Bitmap, int X, int Y, RGB8 *Pixel)
 {
    if ((X >= Bitmap->Clip.Right) or (X < Bitmap->Clip.Left)) return;
    if ((Y >= Bitmap->Clip.Bottom) or (Y < Bitmap->Clip.Top)) return;
+   if (restore_area((extBitmap *)Bitmap, X, Y, 1, 1, true) != ERR::Okay) return;
    Bitmap->DrawUCRPixel(Bitmap, X, Y, Pixel);
 }
 
@@ -1739,6 +1881,7 @@ void DrawPixel(objBitmap *Bitmap, int X, int Y, uint32_t Colour)
 {
    if ((X >= Bitmap->Clip.Right) or (X < Bitmap->Clip.Left)) return;
    if ((Y >= Bitmap->Clip.Bottom) or (Y < Bitmap->Clip.Top)) return;
+   if (restore_area((extBitmap *)Bitmap, X, Y, 1, 1, true) != ERR::Okay) return;
    Bitmap->DrawUCPixel(Bitmap, X, Y, Colour);
 }
 
@@ -1859,6 +2002,9 @@ void ReadRGBPixel(objBitmap *Bitmap, int X, int Y, RGB8 **Pixel)
        (Y >= Bitmap->Clip.Bottom) or (Y < Bitmap->Clip.Top)) {
       pixel.Red = 0; pixel.Green = 0; pixel.Blue = 0; pixel.Alpha = 0;
    }
+   else if (restore_area((extBitmap *)Bitmap, X, Y, 1, 1, false) != ERR::Okay) {
+      pixel.Red = 0; pixel.Green = 0; pixel.Blue = 0; pixel.Alpha = 0;
+   }
    else {
       pixel.Alpha = 255;
       Bitmap->ReadUCRPixel(Bitmap, X, Y, &pixel);
@@ -1888,6 +2034,7 @@ uint32_t ReadPixel(objBitmap *Bitmap, int X, int Y)
 {
    if ((X >= Bitmap->Clip.Right) or (X < Bitmap->Clip.Left) or
        (Y >= Bitmap->Clip.Bottom) or (Y < Bitmap->Clip.Top)) return 0;
+   else if (restore_area((extBitmap *)Bitmap, X, Y, 1, 1, false) != ERR::Okay) return 0;
    else return Bitmap->ReadUCPixel(Bitmap, X, Y);
 }
 
@@ -1900,6 +2047,9 @@ The Resample() function provides a means for resampling a bitmap to a new colour
 bit depth of the image. It uses dithering so as to retain the quality of the image when down-sampling.  This function
 is generally used to 'pre-dither' true colour bitmaps in preparation for copying to bitmaps with lower colour quality.
 
+32-bit bitmaps are dithered with an ordered 4x4 matrix, which is vectorised and processed on multiple threads for large
+bitmaps.  Other bit depths use error diffusion.
+
 You are required to supply a !ColourFormat structure that describes the colour format that you would like to apply to
 the bitmap's image data.
 
@@ -1916,6 +2066,7 @@ NullArgs
 ERR Resample(objBitmap *Bitmap, ColourFormat *Format)
 {
    if ((!Bitmap) or (!Format)) return ERR::NullArgs;
+   if (auto error = restore_area((extBitmap *)Bitmap, 0, 0, Bitmap->Width, Bitmap->Height, true); error != ERR::Okay) return error;
 
    dither((extBitmap *)Bitmap, (extBitmap *)Bitmap, Format, Bitmap->Width, Bitmap->Height, 0, 0, 0, 0);
    return ERR::Okay;
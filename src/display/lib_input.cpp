@@ -7,6 +7,7 @@ Name: Input
 *********************************************************************************************************************/
 
 #include "defs.h"
+#include "input_queue.h"
 
 static ankerl::unordered_dense::map<int, InputCallback> glInputCallbacks;
 static std::vector<std::pair<int, InputCallback>> glNewSubscriptions;
@@ -67,6 +68,11 @@ ERR consume_input_events(const InputEvent *Events, int Handle)
 
 All processable events are referenced in the !InputEvent structure in the `Events` parameter.
 
+Pointer movement is delivered no more than once per display frame.  Consecutive movement events are coalesced so that
+only the most recent of each series is received, which is sufficient for most clients.  If every intermediate position
+is required (e.g. for drawing programs) then include `HISTORY` in the `Mask` and the full series will be delivered as a
+batch, with the `Timestamp` of each event preserved.
+
 `JET` constants are as follows and take note of `CROSSED_IN` and `CROSSED_OUT` which are software generated and not
 a device event:
 
@@ -158,6 +164,9 @@ ERR UnsubscribeInput(int Handle)
 //
 // Input events are sent to each subscriber as a dynamically constructed linked-list of filtered input events.
 //
+// Pointer movement is delivered no more than once per frame.  If input_queue::hold() reports that the queue is to be
+// held, a timer is set to deliver it at the start of the next frame.
+//
 // The copying of events isn't necessarily optimal in most cases, but it is the safest methodology and prevents
 // issues from arising if the event queue is modified during the callback.
 
@@ -170,6 +179,15 @@ struct input_call {
       handle(pHandle), callback(pCallback) { events.reserve(pEventCount); }
 };
 
+static int64_t glLastInputDelivery = 0;
+
+static ERR input_timer(OBJECTPTR, int64_t, int64_t)
+{
+   glInputTimer = nullptr;
+   input_event_loop(0, nullptr);
+   return ERR::Terminate;
+}
+
 void input_event_loop(HOSTHANDLE FD, APTR Data) // Data is not defined
 {
    glInputLock.lock();
@@ -179,6 +197,23 @@ void input_event_loop(HOSTHANDLE FD, APTR Data) // Data is not defined
       return;
    }
 
+   const auto now = PreciseTime();
+   const auto interval = frame_interval();
+   if (input_queue::hold(glInputEvents, now, glLastInputDelivery, interval)) {
+      if (glInputTimer) {
+         glInputLock.unlock();
+         return;
+      }
+
+      pf::SwitchContext context(glModule);
+      if (SubscribeTimer(double(interval - (now - glLastInputDelivery)) / 1000000.0, C_FUNCTION(input_timer), &glInputTimer) IS ERR::Okay) {
+         glInputLock.unlock();
+         return;
+      }
+   }
+
+   glLastInputDelivery = now;
+
    // Buffer the callbacks that we need to make so that no conflicts occur with the input event queue
    // or the callback queue.
 
@@ -195,13 +230,7 @@ void input_event_loop(HOSTHANDLE FD, APTR Data) // Data is not defined
 
       if (event_count) {
          auto &n = input_buffer.emplace_back(input_call { handle, sub.Callback, event_count });
-         for (auto &event : glInputEvents) {
-            if (((event.RecipientID IS sub.SurfaceFilter) or (!sub.SurfaceFilter)) and ((event.Flags & sub.InputMask) != JTYPE::NIL)) {
-               n.events.push_back(event);
-               n.events.back().Next = &n.events.back() + 1;
-            }
-         }
-         n.events.back().Next = nullptr;
+         input_queue::filter(glInputEvents, sub.SurfaceFilter, sub.InputMask, n.events);
       }
    }
 
@@ -9,6 +9,7 @@ Name: Surfaces
 #include "defs.h"
 
 SURFACELIST glSurfaces;
+ankerl::unordered_dense::map<OBJECTID, int> glSurfaceIndex;
 static OBJECTID glModalID = 0;
 
 //********************************************************************************************************************
@@ -53,12 +54,8 @@ void winDragDropFromHost_Drop(int SurfaceID, char *Datatypes)
 
 static bool check_visibility(const SURFACELIST &list, int index)
 {
-   OBJECTID scan = list[index].SurfaceID;
-   for (int i=index; i >= 0; i--) {
-      if (list[i].SurfaceID IS scan) {
-         if (list[i].invisible()) return false;
-         if (!(scan = list[i].ParentID)) return true;
-      }
+   for (int i=index; i >= 0; i=list[i].ParentIndex) {
+      if (list[i].invisible()) return false;
    }
 
    return true;
@@ -70,14 +67,13 @@ ERR get_surface_abs(OBJECTID SurfaceID, int *AbsX, int *AbsY, int *Width, int *H
 {
    const std::lock_guard<std::recursive_mutex> lock(glSurfaceLock);
 
-   for (auto &record : glSurfaces) {
-      if (record.SurfaceID IS SurfaceID) {
-         if (AbsX)   *AbsX = record.Left;
-         if (AbsY)   *AbsY = record.Top;
-         if (Width)  *Width  = record.Width;
-         if (Height) *Height = record.Height;
-         return ERR::Okay;
-      }
+   if (auto i = find_surface_list(SurfaceID); i != -1) {
+      auto &record = glSurfaces[i];
+      if (AbsX)   *AbsX = record.Left;
+      if (AbsY)   *AbsY = record.Top;
+      if (Width)  *Width  = record.Width;
+      if (Height) *Height = record.Height;
+      return ERR::Okay;
    }
 
    return ERR::Search;
@@ -182,7 +178,7 @@ ERR _redraw_surface(OBJECTID SurfaceID, const SURFACELIST &list, int index,
 
    if ((list[index].transparent()) and (!recursive)) {
       log.trace("Passing draw request to parent (I am transparent)");
-      if (auto parent_index = find_surface_list(list[index].ParentID, list.size()); parent_index != -1) {
+      if (auto parent_index = list[index].ParentIndex; parent_index != -1) {
          _redraw_surface(list[parent_index].SurfaceID, list, parent_index, Left, Top, Right, Bottom, Flags & (~IRF::IGNORE_CHILDREN));
       }
       else log.trace("Failed to find parent surface #%d", list[index].ParentID); // No big deal, this often happens when freeing a bunch of surfaces due to the parent/child relationships.
@@ -207,19 +203,13 @@ ERR _redraw_surface(OBJECTID SurfaceID, const SURFACELIST &list, int index,
       if (Bottom > list[index].Bottom) Bottom = list[index].Bottom;
    }
    else {
-      OBJECTID parent_id = SurfaceID;
-      int i = index;
-      while (parent_id) {
-         while ((list[i].SurfaceID != parent_id) and (i > 0)) i--;
-
+      for (int i=index; i >= 0; i=list[i].ParentIndex) {
          if (list[i].BitmapID != list[index].BitmapID) break; // Stop if we encounter a separate bitmap
 
          if (Left   < list[i].Left)   Left   = list[i].Left;
          if (Top    < list[i].Top)    Top    = list[i].Top;
          if (Right  > list[i].Right)  Right  = list[i].Right;
          if (Bottom > list[i].Bottom) Bottom = list[i].Bottom;
-
-         parent_id = list[i].ParentID;
       }
    }
 
@@ -282,16 +272,15 @@ ERR _redraw_surface(OBJECTID SurfaceID, const SURFACELIST &list, int index,
 }
 
 //********************************************************************************************************************
-// This function fulfils the recursive drawing requirements of _redraw_surface() and is not intended for any other use.
+// Draws a single rectangle of a surface's graphics into its bitmap buffer.  Area is in absolute coordinates and must
+// not be obscured by other surfaces that share the buffer.
 
-void _redraw_surface_do(extSurface *Self, const SURFACELIST &list, int Index, ClipRectangle &Area,
-   extBitmap *DestBitmap, IRF Flags)
+static void redraw_rect(extSurface *Self, const SURFACELIST &list, int Index, const ClipRectangle &Area,
+   extBitmap *DestBitmap)
 {
    pf::Log log("redraw_surface");
 
-   if (Self->transparent()) return;
-
-   if (Index >= std::ssize(list)) log.warning("Index %d > %d", Index, int(list.size()));
+   log.traceBranch("Index %d, %dx%d,%dx%d", Index, Area.Left, Area.Top, Area.Right - Area.Left, Area.Bottom - Area.Top);
 
    auto abs = Area;
 
@@ -300,94 +289,10 @@ void _redraw_surface_do(extSurface *Self, const SURFACELIST &list, int Index, Cl
    if (abs.Right  > list[Index].Right)  abs.Right  = list[Index].Right;
    if (abs.Bottom > list[Index].Bottom) abs.Bottom = list[Index].Bottom;
 
-   int i;
-   if ((Flags & IRF::FORCE_DRAW) IS IRF::NIL) {
-      int level = list[Index].Level + 1;   // The +1 is used to include children contained in the surface object
-
-      for (i=Index+1; (i < std::ssize(list)) and (list[i].Level > 1); i++) {
-         if (list[i].Level < level) level = list[i].Level;
-
-         // If the listed object obscures our surface area, analyse the region around it
-
-         if (list[i].Level <= level) {
-            // If we have a bitmap buffer and the underlying child region also has its own bitmap,
-            // we have to ignore it in order for our graphics buffer to be correct when exposes are made.
-
-            if (list[i].BitmapID != Self->BufferID) continue;
-            if (list[i].invisible()) continue;
-
-            // Check for an intersection and respond to it
-
-            auto listx      = list[i].Left;
-            auto listy      = list[i].Top;
-            auto listright  = list[i].Right;
-            auto listbottom = list[i].Bottom;
-
-            if ((listx < Area.Right) and (listy < Area.Bottom) and (listright > Area.Left) and (listbottom > Area.Top)) {
-               if (list[i].isCursor()) {
-                  // Objects like the pointer cursor are ignored completely.  They are redrawn following exposure.
-
-                  return;
-               }
-               else if (list[i].transparent()) {
-                  // If the surface object is see-through then we will ignore its bounds, but legally
-                  // it can also contain child surface objects that are solid.  For that reason,
-                  // we have to 'go inside' to check for solid children and draw around them.
-
-                  _redraw_surface_do(Self, list, i, Area, DestBitmap, Flags);
-                  return;
-               }
-
-               if (((Flags & (IRF::IGNORE_CHILDREN|IRF::IGNORE_NV_CHILDREN)) IS IRF::NIL) and (list[i].Level > list[Index].Level)) {
-                  // Client intends to redraw all children surfaces.
-                  // In this case, we may as well ignore children when they are smaller than 100x100 in size,
-                  // because splitting our drawing process into four sectors is probably going to be slower
-                  // than just redrawing the entire background in one shot.
-
-                  if (list[i].Width + list[i].Height <= 200) continue;
-               }
-
-               if (listx <= Area.Left) listx = Area.Left;
-               else {
-                  auto clip = ClipRectangle(Area.Left, Area.Top, listx, Area.Bottom);
-                  _redraw_surface_do(Self, list, Index, clip, DestBitmap, Flags); // left
-               }
-
-               if (listright >= Area.Right) listright = Area.Right;
-               else {
-                  auto clip = ClipRectangle(listright, Area.Top, Area.Right, Area.Bottom);
-                  _redraw_surface_do(Self, list, Index, clip, DestBitmap, Flags); // right
-               }
-
-               if (listy <= Area.Top) listy = Area.Top;
-               else {
-                  auto clip = ClipRectangle(listx, Area.Top, listright, listy);
-                  _redraw_surface_do(Self, list, Index, clip, DestBitmap, Flags); // top
-               }
-
-               if (listbottom < Area.Bottom) {
-                  auto clip = ClipRectangle(listx, listbottom, listright, Area.Bottom);
-                  _redraw_surface_do(Self, list, Index, clip, DestBitmap, Flags); // bottom
-               }
-
-               return;
-            }
-         }
-      }
-   }
-
-   log.traceBranch("Index %d, %dx%d,%dx%d", Index, Area.Left, Area.Top, Area.Right - Area.Left, Area.Bottom - Area.Top);
-
-   // If we have been called recursively due to the presence of volatile/invisible regions (see above),
-   // our Index field will not match with the surface that is referenced in Self.  We need to ensure
-   // correctness before going any further.
-
-   if (list[Index].SurfaceID != Self->UID) Index = find_surface_list(Self, list.size());
-
    // Prepare the buffer so that it matches the exposed area
 
    uint8_t *data;
-   int xo = 0, yo = 0;
+   int i, xo = 0, yo = 0;
    if (Self->BitmapOwnerID != Self->UID) {
       for (i=Index; (i > 0) and (list[i].SurfaceID != Self->BitmapOwnerID); i--);
       xo = list[Index].Left - list[i].Left;
@@ -458,6 +363,103 @@ void _redraw_surface_do(extSurface *Self, const SURFACELIST &list, int Index, Cl
    DestBitmap->Data = data;
 }
 
+//********************************************************************************************************************
+// Splits Area around the surfaces that obscure it and that share our buffer, and records the unobscured fragments.
+
+static void split_redraw(extSurface *Self, const SURFACELIST &list, int Index, const ClipRectangle &Area, IRF Flags,
+   std::vector<ClipRectangle> &Fragments)
+{
+   if ((Flags & IRF::FORCE_DRAW) IS IRF::NIL) {
+      int level = list[Index].Level + 1;   // The +1 is used to include children contained in the surface object
+
+      for (int i=Index+1; (i < std::ssize(list)) and (list[i].Level > 1); i++) {
+         if (list[i].Level < level) level = list[i].Level;
+
+         // If the listed object obscures our surface area, analyse the region around it
+
+         if (list[i].Level <= level) {
+            // If we have a bitmap buffer and the underlying child region also has its own bitmap,
+            // we have to ignore it in order for our graphics buffer to be correct when exposes are made.
+
+            if (list[i].BitmapID != Self->BufferID) continue;
+            if (list[i].invisible()) continue;
+
+            // Check for an intersection and respond to it
+
+            auto listx      = list[i].Left;
+            auto listy      = list[i].Top;
+            auto listright  = list[i].Right;
+            auto listbottom = list[i].Bottom;
+
+            if ((listx < Area.Right) and (listy < Area.Bottom) and (listright > Area.Left) and (listbottom > Area.Top)) {
+               if (list[i].isCursor()) {
+                  // Objects like the pointer cursor are ignored completely.  They are redrawn following exposure.
+
+                  return;
+               }
+               else if (list[i].transparent()) {
+                  // If the surface object is see-through then we will ignore its bounds, but legally
+                  // it can also contain child surface objects that are solid.  For that reason,
+                  // we have to 'go inside' to check for solid children and draw around them.
+
+                  split_redraw(Self, list, i, Area, Flags, Fragments);
+                  return;
+               }
+
+               if (((Flags & (IRF::IGNORE_CHILDREN|IRF::IGNORE_NV_CHILDREN)) IS IRF::NIL) and (list[i].Level > list[Index].Level)) {
+                  // Client intends to redraw all children surfaces.
+                  // In this case, we may as well ignore children when they are smaller than 100x100 in size,
+                  // because splitting our drawing process into four sectors is probably going to be slower
+                  // than just redrawing the entire background in one shot.
+
+                  if (list[i].Width + list[i].Height <= 200) continue;
+               }
+
+               if (listx <= Area.Left) listx = Area.Left;
+               else split_redraw(Self, list, Index, ClipRectangle(Area.Left, Area.Top, listx, Area.Bottom), Flags, Fragments); // left
+
+               if (listright >= Area.Right) listright = Area.Right;
+               else split_redraw(Self, list, Index, ClipRectangle(listright, Area.Top, Area.Right, Area.Bottom), Flags, Fragments); // right
+
+               if (listy <= Area.Top) listy = Area.Top;
+               else split_redraw(Self, list, Index, ClipRectangle(listx, Area.Top, listright, listy), Flags, Fragments); // top
+
+               if (listbottom < Area.Bottom) {
+                  split_redraw(Self, list, Index, ClipRectangle(listx, listbottom, listright, Area.Bottom), Flags, Fragments); // bottom
+               }
+
+               return;
+            }
+         }
+      }
+   }
+
+   Fragments.push_back(Area);
+}
+
+//********************************************************************************************************************
+// Redraws the Area of a surface that is not obscured by the surfaces in front of it.  The area is split around each
+// obscuring surface, and the fragments are merged into banded form if there are enough of them for the reduced number
+// of draw calls to outweigh the cost of the merge.
+
+void _redraw_surface_do(extSurface *Self, const SURFACELIST &list, int Index, ClipRectangle &Area,
+   extBitmap *DestBitmap, IRF Flags)
+{
+   pf::Log log("redraw_surface");
+
+   if (Self->transparent()) return;
+
+   if (Index >= std::ssize(list)) log.warning("Index %d > %d", Index, int(list.size()));
+
+   if (list[Index].SurfaceID != Self->UID) Index = find_surface_list(Self, list.size());
+
+   std::vector<ClipRectangle> fragments; // Not shared, as drawing callbacks can trigger nested redraws
+   split_redraw(Self, list, Index, Area, Flags, fragments);
+   merge_fragments(fragments);
+
+   for (auto &rect : fragments) redraw_rect(Self, list, Index, rect, DestBitmap);
+}
+
 //********************************************************************************************************************
 
 ERR RedrawSurface(OBJECTID SurfaceID, int Left, int Top, int Right, int Bottom, IRF Flags)
@@ -525,6 +527,7 @@ ERR track_layer(extSurface *Self)
    record.RootID        = Self->RootID;
    record.Width         = Self->Width;
    record.Height        = Self->Height;
+   record.ParentIndex   = -1;
 
    // Find the position at which the surface object should be inserted
 
@@ -532,6 +535,7 @@ ERR track_layer(extSurface *Self)
       record.setArea(Self->X, Self->Y, Self->X + Self->Width, Self->Y + Self->Height);
       record.Level  = 1;
       glSurfaces.push_back(record);
+      index_surfaces(int(glSurfaces.size()) - 1);
    }
    else {
       int parent;
@@ -558,6 +562,8 @@ ERR track_layer(extSurface *Self)
 
       if (i < glSurfaces.size()) glSurfaces.insert(glSurfaces.begin() + i, record);
       else glSurfaces.push_back(record);
+
+      index_surfaces(i);
    }
 
    return ERR::Okay;
@@ -583,9 +589,13 @@ void untrack_layer(OBJECTID ObjectID)
          glSurfaces[end].Flags &= ~RNF::VISIBLE;
       }
 
+      for (auto j=size_t(i); j < end; j++) glSurfaceIndex.erase(glSurfaces[j].SurfaceID);
+
       if (end >= glSurfaces.size()) glSurfaces.resize(i);
       else glSurfaces.erase(glSurfaces.begin() + i, glSurfaces.begin() + end);
 
+      index_surfaces(i);
+
       #ifdef DBG_LAYERS
          print_layer_list("untrack_layer_end", glSurfaces, i);
       #endif
@@ -626,6 +636,7 @@ ERR update_surface_copy(extSurface *Self)
 
    if (i != -1) {
       list[i].ParentID      = Self->ParentID;
+      list[i].ParentIndex   = Self->ParentID ? find_surface_list(Self->ParentID, i) : -1;
       //list[i].SurfaceID    = Self->UID; Never changes
       list[i].BitmapID      = Self->BufferID;
       list[i].DisplayID     = Self->DisplayID;
@@ -652,14 +663,11 @@ ERR update_surface_copy(extSurface *Self)
       auto level = list[i].Level;
       int c = i+1;
       while ((c < std::ssize(list)) and (list[c].Level > level)) {
-         for (auto j=c-1; j >= 0; j--) {
-            if (list[j].SurfaceID IS list[c].ParentID) {
-               list[c].Left   = list[j].Left + list[c].X;
-               list[c].Top    = list[j].Top  + list[c].Y;
-               list[c].Right  = list[c].Left + list[c].Width;
-               list[c].Bottom = list[c].Top  + list[c].Height;
-               break;
-            }
+         if (auto j = list[c].ParentIndex; j >= 0) {
+            list[c].Left   = list[j].Left + list[c].X;
+            list[c].Top    = list[j].Top  + list[c].Y;
+            list[c].Right  = list[c].Left + list[c].Width;
+            list[c].Bottom = list[c].Top  + list[c].Height;
          }
          c++;
       }
@@ -687,6 +695,27 @@ void move_layer_pos(SURFACELIST &List, int Src, int Dest)
    // Insert the saved content
    int target_index = (Dest > Src) ? Dest - children : Dest;
    List.insert(List.begin() + target_index, tmp.begin(), tmp.end());
+
+   if (&List IS &glSurfaces) index_surfaces(std::min(Src, target_index));
+}
+
+//********************************************************************************************************************
+// Refreshes glSurfaceIndex and the cached parent indices for all records from the From index onwards.  Records that
+// precede From are unaffected by an insertion or removal at that point, and parents always precede their children.
+
+void index_surfaces(int From)
+{
+   for (int i=From; i < std::ssize(glSurfaces); i++) {
+      auto &record = glSurfaces[i];
+      glSurfaceIndex[record.SurfaceID] = i;
+
+      record.ParentIndex = -1;
+      if (record.ParentID) {
+         if (auto it = glSurfaceIndex.find(record.ParentID); (it != glSurfaceIndex.end()) and (it->second < i)) {
+            if (glSurfaces[it->second].SurfaceID IS record.ParentID) record.ParentIndex = it->second;
+         }
+      }
+   }
 }
 
 //********************************************************************************************************************
@@ -804,10 +833,7 @@ ERR resize_layer(extSurface *Self, int X, int Y, int Width, int Height, int Insi
          for (vindex=index+1; (vindex < std::ssize(list)) and (list[vindex].Level > list[index].Level); vindex++);
          tlVolatileIndex = vindex;
 
-         int parent_index;
-         for (parent_index=index-1; parent_index >= 0; parent_index--) {
-            if (list[parent_index].SurfaceID IS Self->ParentID) break;
-         }
+         int parent_index = list[index].ParentIndex;
 
          ClipRectangle region_b(list[parent_index].Left + oldx, list[parent_index].Top + oldy,
             (list[parent_index].Left + oldx) + oldw, (list[parent_index].Top + oldy) + oldh);
@@ -874,19 +900,14 @@ void process_surface_callbacks(extSurface *Self, extBitmap *Bitmap)
 int8_t restrict_region_to_parents(const SURFACELIST &List, int Index, ClipRectangle &Area, bool MatchBitmap)
 {
    bool visible = true;
-   OBJECTID id = List[Index].SurfaceID;
-   for (int j=Index; (j >= 0) and (id); j--) {
-      if (List[j].SurfaceID IS id) {
-         if (List[j].invisible()) visible = false;
-
-         id = List[j].ParentID;
-
-         if ((!MatchBitmap) or (List[j].BitmapID IS List[Index].BitmapID)) {
-            if (Area.Left   < List[j].Left)   Area.Left   = List[j].Left;
-            if (Area.Top    < List[j].Top)    Area.Top    = List[j].Top;
-            if (Area.Right  > List[j].Right)  Area.Right  = List[j].Right;
-            if (Area.Bottom > List[j].Bottom) Area.Bottom = List[j].Bottom;
-         }
+   for (int j=Index; j >= 0; j=List[j].ParentIndex) {
+      if (List[j].invisible()) visible = false;
+
+      if ((!MatchBitmap) or (List[j].BitmapID IS List[Index].BitmapID)) {
+         if (Area.Left   < List[j].Left)   Area.Left   = List[j].Left;
+         if (Area.Top    < List[j].Top)    Area.Top    = List[j].Top;
+         if (Area.Right  > List[j].Right)  Area.Right  = List[j].Right;
+         if (Area.Bottom > List[j].Bottom) Area.Bottom = List[j].Bottom;
       }
    }
 
@@ -1015,6 +1036,8 @@ This function will copy the graphics data from any surface object to a target @B
 the fastest and most convenient way to get graphics information out of any surface.  As surfaces are buffered, it is
 guaranteed that the result will not be obscured by any overlapping surfaces that are on the display.
 
+Redraws that are pending for the next frame are completed before the graphics are copied.
+
 -INPUT-
 oid Surface: The ID of the surface object to copy from.
 obj(Bitmap) Bitmap: Must reference a target @Bitmap object.
@@ -1043,6 +1066,8 @@ ERR CopySurface(OBJECTID SurfaceID, objBitmap *Bitmap, BDF Flags,
 
    log.traceBranch("%dx%d,%dx%d TO %dx%d, Flags $%.8x", X, Y, Width, Height, XDest, YDest, int(Flags));
 
+   flush_frame();
+
    const std::lock_guard<std::recursive_mutex> lock(glSurfaceLock);
 
    BITMAPSURFACE surface;
@@ -1151,6 +1176,46 @@ ERR ExposeSurface(OBJECTID SurfaceID, int X, int Y, int Width, int Height, EXF F
 
 /*********************************************************************************************************************
 
+-FUNCTION-
+GetFrameStats: Returns performance statistics for the frame scheduler.
+
+Redraw requests for surfaces are merged and drawn once per frame, at the refresh rate of the display or at the
+configured `FrameRate` if the display is headless.  This function returns statistics that describe the performance of
+the frame scheduler since the display module was loaded.
+
+A frame is counted as dropped if one or more frame intervals pass while damage is pending, e.g. because a previous
+frame or other work in the process took too long to complete.
+
+On X11 the `PresentStalls` count records the number of times that an expose had to wait for the X server to finish
+reading a previously presented buffer.
+
+-INPUT-
+struct(*FrameStats) Stats: Pointer to a !FrameStats structure.
+structsize Size: The byte-size of the `Stats` structure.
+
+-ERRORS-
+Okay:
+NullArgs:
+BufferOverflow: The `Size` is smaller than the !FrameStats structure.
+
+*********************************************************************************************************************/
+
+ERR GetFrameStats(FrameStats *Stats, int Size)
+{
+   if (!Stats) return ERR::NullArgs;
+   if (Size < int(sizeof(FrameStats))) return ERR::BufferOverflow;
+
+   const std::lock_guard lock(glFrameLock);
+   *Stats = glFrameStats;
+   if (!glFrameTimer) Stats->FrameRate = get_frame_rate();
+#ifdef __xwindows__
+   Stats->PresentStalls = glPresentStalls;
+#endif
+   return ERR::Okay;
+}
+
+/*********************************************************************************************************************
+
 -FUNCTION-
 GetModalSurface: Returns the current modal surface (if defined).
 
@@ -18,6 +18,7 @@ FDEF argsGetCursorInfo[] = { { "Error", FD_INT|FD_ERROR }, { "CursorInfo:Info",
 FDEF argsGetCursorPos[] = { { "Error", FD_INT|FD_ERROR }, { "X", FD_DOUBLE|FD_RESULT }, { "Y", FD_DOUBLE|FD_RESULT }, { 0, 0 } };
 FDEF argsGetDisplayInfo[] = { { "Error", FD_INT|FD_ERROR }, { "Display", FD_OBJECTID }, { "DisplayInfo:Info", FD_PTR|FD_STRUCT|FD_RESULT }, { 0, 0 } };
 FDEF argsGetDisplayType[] = { { "Result", FD_INT }, { 0, 0 } };
+FDEF argsGetFrameStats[] = { { "Error", FD_INT|FD_ERROR }, { "FrameStats:Stats", FD_PTR|FD_STRUCT }, { "Size", FD_INT|FD_BUFSIZE }, { 0, 0 } };
 FDEF argsGetInputTypeName[] = { { "Result", FD_STR }, { "Type", FD_INT }, { 0, 0 } };
 FDEF argsGetModalSurface[] = { { "Result", FD_OBJECTID }, { 0, 0 } };
 FDEF argsGetRelativeCursorPos[] = { { "Error", FD_INT|FD_ERROR }, { "Surface", FD_OBJECTID }, { "X", FD_DOUBLE|FD_RESULT }, { "Y", FD_DOUBLE|FD_RESULT }, { 0, 0 } };
@@ -61,6 +62,7 @@ const struct Function glFunctions[] = {
    { (APTR)gfx::GetCursorPos, "GetCursorPos", argsGetCursorPos },
    { (APTR)gfx::GetDisplayInfo, "GetDisplayInfo", argsGetDisplayInfo },
    { (APTR)gfx::GetDisplayType, "GetDisplayType", argsGetDisplayType },
+   { (APTR)gfx::GetFrameStats, "GetFrameStats", argsGetFrameStats },
    { (APTR)gfx::GetInputTypeName, "GetInputTypeName", argsGetInputTypeName },
    { (APTR)gfx::GetModalSurface, "GetModalSurface", argsGetModalSurface },
    { (APTR)gfx::GetRelativeCursorPos, "GetRelativeCursorPos", argsGetRelativeCursorPos },
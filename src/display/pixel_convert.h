@@ -0,0 +1,328 @@
+// Row kernels for converting pixels between bitmap formats.  ColourFormat must be declared prior to inclusion.
+//
+// Each kernel produces results identical to the per-pixel ReadUCRIndex() and DrawUCRIndex() routines for the formats
+// involved, so they can be substituted freely in copy operations.  SSE2 variants are provided for the 16 and 32 bit
+// conversions and alpha multiplication, which are the common cases when loading images onto lower depth displays.  The
+// 24 bit conversions are byte shuffles that have no efficient SSE2 equivalent and use tight scalar loops instead.
+//
+// The ordered dither is a 4x4 Bayer matrix.  Unlike error diffusion, every pixel is dithered independently of its
+// neighbours, so rows can be vectorised and processed on separate threads.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) or defined(_M_X64) or defined(_M_AMD64)
+   #include <emmintrin.h>
+   #define PIXEL_CONVERT_SSE2
+#endif
+
+namespace pixel_convert {
+
+enum class ISA : uint8_t { SCALAR, SSE2 };
+
+#ifdef PIXEL_CONVERT_SSE2
+constexpr ISA DEFAULT_ISA = ISA::SSE2;
+#else
+constexpr ISA DEFAULT_ISA = ISA::SCALAR;
+#endif
+
+inline uint32_t load32(const uint8_t *Data) noexcept
+{
+   uint32_t value;
+   memcpy(&value, Data, sizeof(value));
+   return value;
+}
+
+inline void store32(uint8_t *Data, uint32_t Value) noexcept
+{
+   memcpy(Data, &Value, sizeof(Value));
+}
+
+//********************************************************************************************************************
+// 32 bit to 16 bit.  Equivalent to Dest->packPixel(R, G, B) for each source pixel.
+
+inline uint16_t pack16(uint32_t Pixel, const ColourFormat &Src, const ColourFormat &Dest) noexcept
+{
+   const uint8_t r = Pixel >> Src.RedPos, g = Pixel >> Src.GreenPos, b = Pixel >> Src.BluePos;
+   return (((r >> Dest.RedShift) & Dest.RedMask) << Dest.RedPos) |
+          (((g >> Dest.GreenShift) & Dest.GreenMask) << Dest.GreenPos) |
+          (((b >> Dest.BlueShift) & Dest.BlueMask) << Dest.BluePos) |
+          (((255 >> Dest.AlphaShift) & Dest.AlphaMask) << Dest.AlphaPos);
+}
+
+inline void row_32_to_16(const uint8_t *Src, uint8_t *Dest, int Width, const ColourFormat &SrcFormat,
+   const ColourFormat &DestFormat, ISA Isa = DEFAULT_ISA) noexcept
+{
+   int x = 0;
+#ifdef PIXEL_CONVERT_SSE2
+   if (Isa IS ISA::SSE2) {
+      const __m128i byte_mask = _mm_set1_epi32(0xff);
+      const __m128i alpha = _mm_set1_epi32(((255 >> DestFormat.AlphaShift) & DestFormat.AlphaMask) << DestFormat.AlphaPos);
+
+      struct channel { __m128i src_pos, shift, mask, dest_pos; };
+      auto make_channel = [](uint8_t SrcPos, uint8_t Shift, uint8_t Mask, uint8_t DestPos) {
+         return channel { _mm_cvtsi32_si128(SrcPos), _mm_cvtsi32_si128(Shift), _mm_set1_epi32(Mask), _mm_cvtsi32_si128(DestPos) };
+      };
+      const channel r = make_channel(SrcFormat.RedPos, DestFormat.RedShift, DestFormat.RedMask, DestFormat.RedPos);
+      const channel g = make_channel(SrcFormat.GreenPos, DestFormat.GreenShift, DestFormat.GreenMask, DestFormat.GreenPos);
+      const channel b = make_channel(SrcFormat.BluePos, DestFormat.BlueShift, DestFormat.BlueMask, DestFormat.BluePos);
+
+      auto convert = [&](__m128i Pixels) {
+         auto extract = [&](const channel &C) {
+            auto v = _mm_and_si128(_mm_srl_epi32(Pixels, C.src_pos), byte_mask);
+            v = _mm_and_si128(_mm_srl_epi32(v, C.shift), C.mask);
+            return _mm_sll_epi32(v, C.dest_pos);
+         };
+         auto v = _mm_or_si128(_mm_or_si128(extract(r), extract(g)), _mm_or_si128(extract(b), alpha));
+         return _mm_srai_epi32(_mm_slli_epi32(v, 16), 16); // Sign extend so that packs_epi32() preserves all 16 bits
+      };
+
+      for (; x + 8 <= Width; x += 8) {
+         const auto lo = convert(_mm_loadu_si128((const __m128i *)(Src + (x * 4))));
+         const auto hi = convert(_mm_loadu_si128((const __m128i *)(Src + (x * 4) + 16)));
+         _mm_storeu_si128((__m128i *)(Dest + (x * 2)), _mm_packs_epi32(lo, hi));
+      }
+   }
+#endif
+
+   for (; x < Width; x++) {
+      const uint16_t value = pack16(load32(Src + (x * 4)), SrcFormat, DestFormat);
+      memcpy(Dest + (x * 2), &value, sizeof(value));
+   }
+}
+
+//********************************************************************************************************************
+// 16 bit to 32 bit.  Equivalent to Dest->packPixelWB() of the unpacked source channels, with an opaque alpha value.
+
+inline uint32_t unpack16(uint16_t Pixel, const ColourFormat &Src, const ColourFormat &Dest) noexcept
+{
+   const uint8_t r = ((Pixel >> Src.RedPos) & Src.RedMask) << Src.RedShift;
+   const uint8_t g = ((Pixel >> Src.GreenPos) & Src.GreenMask) << Src.GreenShift;
+   const uint8_t b = ((Pixel >> Src.BluePos) & Src.BlueMask) << Src.BlueShift;
+   return (uint32_t(r) << Dest.RedPos) | (uint32_t(g) << Dest.GreenPos) | (uint32_t(b) << Dest.BluePos) |
+      (uint32_t(255) << Dest.AlphaPos);
+}
+
+inline void row_16_to_32(const uint8_t *Src, uint8_t *Dest, int Width, const ColourFormat &SrcFormat,
+   const ColourFormat &DestFormat, ISA Isa = DEFAULT_ISA) noexcept
+{
+   int x = 0;
+#ifdef PIXEL_CONVERT_SSE2
+   if (Isa IS ISA::SSE2) {
+      const __m128i zero = _mm_setzero_si128();
+      const __m128i byte_mask = _mm_set1_epi32(0xff);
+      const __m128i alpha = _mm_set1_epi32(int(uint32_t(255) << DestFormat.AlphaPos));
+
+      struct channel { __m128i src_pos, mask, shift, dest_pos; };
+      auto make_channel = [](uint8_t SrcPos, uint8_t Mask, uint8_t Shift, uint8_t DestPos) {
+         return channel { _mm_cvtsi32_si128(SrcPos), _mm_set1_epi32(Mask), _mm_cvtsi32_si128(Shift), _mm_cvtsi32_si128(DestPos) };
+      };
+      const channel r = make_channel(SrcFormat.RedPos, SrcFormat.RedMask, SrcFormat.RedShift, DestFormat.RedPos);
+      const channel g = make_channel(SrcFormat.GreenPos, SrcFormat.GreenMask, SrcFormat.GreenShift, DestFormat.GreenPos);
+      const channel b = make_channel(SrcFormat.BluePos, SrcFormat.BlueMask, SrcFormat.BlueShift, DestFormat.BluePos);
+
+      auto convert = [&](__m128i Pixels) {
+         auto extract = [&](const channel &C) {
+            auto v = _mm_and_si128(_mm_srl_epi32(Pixels, C.src_pos), C.mask);
+            v = _mm_and_si128(_mm_sll_epi32(v, C.shift), byte_mask);
+            return _mm_sll_epi32(v, C.dest_pos);
+         };
+         return _mm_or_si128(_mm_or_si128(extract(r), extract(g)), _mm_or_si128(extract(b), alpha));
+      };
+
+      for (; x + 8 <= Width; x += 8) {
+         const auto pixels = _mm_loadu_si128((const __m128i *)(Src + (x * 2)));
+         _mm_storeu_si128((__m128i *)(Dest + (x * 4)), convert(_mm_unpacklo_epi16(pixels, zero)));
+         _mm_storeu_si128((__m128i *)(Dest + (x * 4) + 16), convert(_mm_unpackhi_epi16(pixels, zero)));
+      }
+   }
+#endif
+
+   for (; x < Width; x++) {
+      uint16_t value;
+      memcpy(&value, Src + (x * 2), sizeof(value));
+      store32(Dest + (x * 4), unpack16(value, SrcFormat, DestFormat));
+   }
+}
+
+//********************************************************************************************************************
+// 32 bit to 24 bit and vice versa.  24 bit pixels are stored as B,G,R if RedPos is 16, otherwise R,G,B.
+
+inline void row_32_to_24(const uint8_t *Src, uint8_t *Dest, int Width, const ColourFormat &SrcFormat,
+   const ColourFormat &DestFormat) noexcept
+{
+   const int r = (DestFormat.RedPos IS 16) ? 2 : 0, b = 2 - r;
+   const uint8_t sr = SrcFormat.RedPos, sg = SrcFormat.GreenPos, sb = SrcFormat.BluePos;
+   for (int x=0; x < Width; x++, Src += 4, Dest += 3) {
+      const uint32_t pixel = load32(Src);
+      Dest[r] = pixel >> sr;
+      Dest[1] = pixel >> sg;
+      Dest[b] = pixel >> sb;
+   }
+}
+
+inline void row_24_to_32(const uint8_t *Src, uint8_t *Dest, int Width, const ColourFormat &SrcFormat,
+   const ColourFormat &DestFormat) noexcept
+{
+   const int r = (SrcFormat.RedPos IS 16) ? 2 : 0, b = 2 - r;
+   const uint8_t dr = DestFormat.RedPos, dg = DestFormat.GreenPos, db = DestFormat.BluePos;
+   const uint32_t alpha = uint32_t(255) << DestFormat.AlphaPos;
+   for (int x=0; x < Width; x++, Src += 3, Dest += 4) {
+      store32(Dest, (uint32_t(Src[r]) << dr) | (uint32_t(Src[1]) << dg) | (uint32_t(Src[b]) << db) | alpha);
+   }
+}
+
+//********************************************************************************************************************
+// Alpha multiplication of 32 bit pixels, where A is the byte offset of the alpha channel.  Src and Dest may refer to
+// the same row.
+//
+// Premultiplication computes (c * a + 0xff) >> 8, which also yields the expected results for alpha values of 0 and
+// 0xff and therefore needs no branches.  Demultiplication computes (c * 0xff) / a, clamped to 0xff.  The SSE2 path
+// divides in single precision: c * 0xff is exact, and the rounding error of the quotient is always less than the
+// distance to the next integer, so truncation gives the same result as integer division.
+
+inline void premultiply_row(const uint8_t *Src, uint8_t *Dest, int Width, uint8_t A, ISA Isa = DEFAULT_ISA) noexcept
+{
+   int x = 0;
+#ifdef PIXEL_CONVERT_SSE2
+   if (Isa IS ISA::SSE2) {
+      const __m128i zero = _mm_setzero_si128();
+      const __m128i round = _mm_set1_epi16(0xff);
+      const __m128i alpha_mask = _mm_set1_epi32(int(uint32_t(0xff) << (A * 8)));
+
+      auto kernel = [&]<int I>() {
+         for (; x + 4 <= Width; x += 4) {
+            const auto pixels = _mm_loadu_si128((const __m128i *)(Src + (x * 4)));
+            auto lo = _mm_unpacklo_epi8(pixels, zero);
+            auto hi = _mm_unpackhi_epi8(pixels, zero);
+            const auto a_lo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(I,I,I,I)), _MM_SHUFFLE(I,I,I,I));
+            const auto a_hi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(I,I,I,I)), _MM_SHUFFLE(I,I,I,I));
+            lo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(lo, a_lo), round), 8);
+            hi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(hi, a_hi), round), 8);
+            const auto result = _mm_or_si128(_mm_andnot_si128(alpha_mask, _mm_packus_epi16(lo, hi)), _mm_and_si128(alpha_mask, pixels));
+            _mm_storeu_si128((__m128i *)(Dest + (x * 4)), result);
+         }
+      };
+
+      switch (A) {
+         case 0: kernel.template operator()<0>(); break;
+         case 1: kernel.template operator()<1>(); break;
+         case 2: kernel.template operator()<2>(); break;
+         default: kernel.template operator()<3>(); break;
+      }
+   }
+#endif
+
+   for (; x < Width; x++) {
+      const uint8_t *s = Src + (x * 4);
+      uint8_t *d = Dest + (x * 4);
+      const uint8_t a = s[A];
+      for (int i=0; i < 4; i++) d[i] = (i IS A) ? a : uint8_t((s[i] * a + 0xff) >> 8);
+   }
+}
+
+inline void demultiply_row(const uint8_t *Src, uint8_t *Dest, int Width, uint8_t A, ISA Isa = DEFAULT_ISA) noexcept
+{
+   int x = 0;
+#ifdef PIXEL_CONVERT_SSE2
+   if (Isa IS ISA::SSE2) {
+      const __m128i byte_mask = _mm_set1_epi32(0xff);
+      const __m128i alpha_mask = _mm_set1_epi32(int(uint32_t(0xff) << (A * 8)));
+      const __m128 scale = _mm_set1_ps(255.0f);
+      const __m128 limit = _mm_set1_ps(255.0f);
+      const __m128i shift_a = _mm_cvtsi32_si128(A * 8);
+
+      for (; x + 4 <= Width; x += 4) {
+         const auto pixels = _mm_loadu_si128((const __m128i *)(Src + (x * 4)));
+
+         // Opaque pixels are unchanged, which is the common case for most images.
+
+         if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(pixels, alpha_mask), alpha_mask)) IS 0xffff) {
+            if (Src != Dest) _mm_storeu_si128((__m128i *)(Dest + (x * 4)), pixels);
+            continue;
+         }
+
+         const auto a = _mm_and_si128(_mm_srl_epi32(pixels, shift_a), byte_mask);
+         const auto af = _mm_cvtepi32_ps(a);
+         const auto visible = _mm_xor_si128(_mm_cmpeq_epi32(a, _mm_setzero_si128()), _mm_set1_epi32(-1));
+
+         // NB: min_ps() returns the second operand for the NaN and infinite quotients of zero alpha, which are then
+         // masked out.
+
+         auto result = _mm_and_si128(pixels, alpha_mask);
+         for (int i=0; i < 4; i++) {
+            if (i IS A) continue;
+            const auto c = _mm_and_si128(_mm_srl_epi32(pixels, _mm_cvtsi32_si128(i * 8)), byte_mask);
+            const auto q = _mm_min_ps(_mm_div_ps(_mm_mul_ps(_mm_cvtepi32_ps(c), scale), af), limit);
+            const auto v = _mm_and_si128(_mm_cvttps_epi32(q), visible);
+            result = _mm_or_si128(result, _mm_sll_epi32(v, _mm_cvtsi32_si128(i * 8)));
+         }
+         _mm_storeu_si128((__m128i *)(Dest + (x * 4)), result);
+      }
+   }
+#endif
+
+   for (; x < Width; x++) {
+      const uint8_t *s = Src + (x * 4);
+      uint8_t *d = Dest + (x * 4);
+      const uint8_t a = s[A];
+      for (int i=0; i < 4; i++) {
+         if (i IS A) d[i] = a;
+         else if (!a) d[i] = 0;
+         else {
+            const uint32_t v = (uint32_t(s[i]) * 0xff) / a;
+            d[i] = uint8_t((v > 0xff) ? 0xff : v);
+         }
+      }
+   }
+}
+
+//********************************************************************************************************************
+// Ordered dither of 32 bit pixels, quantising each colour channel to the precision of Format.  The output retains the
+// layout of the source, with the low bits of each colour channel cleared.  X and Y are the coordinates of the first
+// pixel, which select the phase of the dither matrix.
+
+inline void dither_row(const uint8_t *Src, uint8_t *Dest, int Width, int X, int Y, const ColourFormat &SrcFormat,
+   const ColourFormat &Format, ISA Isa = DEFAULT_ISA) noexcept
+{
+   static constexpr uint8_t BAYER[4][4] = { { 0, 8, 2, 10 }, { 12, 4, 14, 6 }, { 3, 11, 1, 9 }, { 15, 7, 13, 5 } };
+
+   // Per-byte thresholds and masks for four consecutive pixels, starting at the phase of X.
+
+   alignas(16) uint8_t threshold[16] = { }, mask[16];
+   const uint8_t r = SrcFormat.RedPos>>3, g = SrcFormat.GreenPos>>3, b = SrcFormat.BluePos>>3;
+   for (int i=0; i < 4; i++) {
+      const uint8_t t = BAYER[Y & 3][(X + i) & 3];
+      threshold[i*4 + r] = (t << Format.RedShift) >> 4;
+      threshold[i*4 + g] = (t << Format.GreenShift) >> 4;
+      threshold[i*4 + b] = (t << Format.BlueShift) >> 4;
+      for (int c=0; c < 4; c++) mask[i*4 + c] = 0xff;
+      mask[i*4 + r] = Format.RedMask << Format.RedShift;
+      mask[i*4 + g] = Format.GreenMask << Format.GreenShift;
+      mask[i*4 + b] = Format.BlueMask << Format.BlueShift;
+   }
+
+   int x = 0;
+#ifdef PIXEL_CONVERT_SSE2
+   if (Isa IS ISA::SSE2) {
+      const __m128i t = _mm_load_si128((const __m128i *)threshold);
+      const __m128i m = _mm_load_si128((const __m128i *)mask);
+      for (; x + 4 <= Width; x += 4) {
+         const auto pixels = _mm_loadu_si128((const __m128i *)(Src + (x * 4)));
+         _mm_storeu_si128((__m128i *)(Dest + (x * 4)), _mm_and_si128(_mm_adds_epu8(pixels, t), m));
+      }
+   }
+#endif
+
+   for (Src += x * 4, Dest += x * 4; x < Width; x++, Src += 4, Dest += 4) {
+      const uint8_t *t = threshold + ((x & 3) * 4), *m = mask + ((x & 3) * 4);
+      for (int c=0; c < 4; c++) {
+         const int v = Src[c] + t[c];
+         Dest[c] = uint8_t((v > 0xff) ? 0xff : v) & m[c];
+      }
+   }
+}
+
+} // namespace pixel_convert
@@ -15,6 +15,7 @@ extern ERR GetCursorInfo(struct CursorInfo * Info, int Size);
 extern ERR GetCursorPos(double * X, double * Y);
 extern ERR GetDisplayInfo(OBJECTID Display, struct DisplayInfoV3 ** Info);
 extern DT GetDisplayType();
+extern ERR GetFrameStats(struct FrameStats * Stats, int Size);
 extern CSTRING GetInputTypeName(JET Type);
 extern OBJECTID GetModalSurface();
 extern ERR GetRelativeCursorPos(OBJECTID Surface, double * X, double * Y);
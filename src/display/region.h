@@ -0,0 +1,262 @@
+// Banded rectangle sets for damage tracking, in the style of X11 and Pixman regions.  ClipRectangle must be declared
+// prior to inclusion.
+//
+// A region is stored as a list of non-overlapping rectangles that are sorted into horizontal bands.  Rectangles in the
+// same band share Top and Bottom values, are sorted by Left and never touch.  Vertically adjacent bands with identical
+// spans are merged.  Union, intersection and subtraction sweep both regions one band at a time, so their cost is
+// linear in the total number of rectangles.
+
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+class ClipRegion {
+public:
+   ClipRegion() = default;
+
+   ClipRegion(const ClipRectangle &Rect) {
+      if ((Rect.Right > Rect.Left) and (Rect.Bottom > Rect.Top)) rects.push_back(Rect);
+   }
+
+   [[nodiscard]] bool empty() const noexcept { return rects.empty(); }
+   [[nodiscard]] const std::vector<ClipRectangle> & rectangles() const noexcept { return rects; }
+   [[nodiscard]] auto begin() const noexcept { return rects.begin(); }
+   [[nodiscard]] auto end() const noexcept { return rects.end(); }
+   void clear() noexcept { rects.clear(); }
+
+   // Returns the bounding box of the region, or an empty rectangle if the region is empty.
+
+   [[nodiscard]] ClipRectangle extents() const noexcept {
+      if (rects.empty()) return ClipRectangle(0, 0, 0, 0);
+      ClipRectangle result(INT_MAX, rects.front().Top, INT_MIN, rects.back().Bottom);
+      for (auto &r : rects) {
+         if (r.Left < result.Left) result.Left = r.Left;
+         if (r.Right > result.Right) result.Right = r.Right;
+      }
+      return result;
+   }
+
+   [[nodiscard]] int64_t area() const noexcept {
+      int64_t total = 0;
+      for (auto &r : rects) total += int64_t(r.width()) * int64_t(r.height());
+      return total;
+   }
+
+   [[nodiscard]] bool intersects(const ClipRectangle &Rect) const noexcept {
+      if ((Rect.Right <= Rect.Left) or (Rect.Bottom <= Rect.Top)) return false;
+      for (auto &r : rects) {
+         if (r.Top >= Rect.Bottom) break; // Bands are sorted, so nothing further can intersect
+         if ((r.Bottom > Rect.Top) and (r.Left < Rect.Right) and (r.Right > Rect.Left)) return true;
+      }
+      return false;
+   }
+
+   [[nodiscard]] bool contains(int X, int Y) const noexcept {
+      for (auto &r : rects) {
+         if (r.Top > Y) break;
+         if ((Y < r.Bottom) and (X >= r.Left) and (X < r.Right)) return true;
+      }
+      return false;
+   }
+
+   void translate(int X, int Y) noexcept {
+      for (auto &r : rects) {
+         r.Left += X;
+         r.Right += X;
+         r.Top += Y;
+         r.Bottom += Y;
+      }
+   }
+
+   [[nodiscard]] bool operator==(const ClipRegion &Other) const noexcept {
+      if (rects.size() != Other.rects.size()) return false;
+      for (size_t i=0; i < rects.size(); i++) {
+         if (!same(rects[i], Other.rects[i]) or (rects[i].Top != Other.rects[i].Top) or
+             (rects[i].Bottom != Other.rects[i].Bottom)) return false;
+      }
+      return true;
+   }
+
+   ClipRegion & operator|=(const ClipRegion &Other) {
+      if (Other.empty()) return *this;
+      if (empty()) { rects = Other.rects; return *this; }
+      combine(Other.rects.data(), Other.rects.size(), OP::UNITE);
+      return *this;
+   }
+
+   ClipRegion & operator&=(const ClipRegion &Other) {
+      if (empty()) return *this;
+      if ((Other.empty()) or (!overlaps(extents(), Other.extents()))) { rects.clear(); return *this; }
+      combine(Other.rects.data(), Other.rects.size(), OP::INTERSECT);
+      return *this;
+   }
+
+   ClipRegion & operator-=(const ClipRegion &Other) {
+      if ((empty()) or (Other.empty())) return *this;
+      if (Other.rects.size() IS 1) return *this -= Other.rects.front();
+      if (overlaps(extents(), Other.extents())) combine(Other.rects.data(), Other.rects.size(), OP::SUBTRACT);
+      return *this;
+   }
+
+   // Rectangle variants avoid the allocation of a temporary region.
+
+   ClipRegion & operator|=(const ClipRectangle &Rect) {
+      if ((Rect.Right <= Rect.Left) or (Rect.Bottom <= Rect.Top)) return *this;
+      if (empty()) rects.push_back(Rect);
+      else combine(&Rect, 1, OP::UNITE);
+      return *this;
+   }
+
+   ClipRegion & operator&=(const ClipRectangle &Rect) {
+      if ((Rect.Right <= Rect.Left) or (Rect.Bottom <= Rect.Top)) rects.clear();
+      else if (!empty()) combine(&Rect, 1, OP::INTERSECT);
+      return *this;
+   }
+
+   // Subtracting an occluding rectangle is the most common operation, so cases that leave the region unchanged or
+   // empty are detected without running a sweep.
+
+   ClipRegion & operator-=(const ClipRectangle &Rect) {
+      if (!intersects(Rect)) return *this;
+      auto ext = extents();
+      if ((Rect.Left <= ext.Left) and (Rect.Top <= ext.Top) and (Rect.Right >= ext.Right) and (Rect.Bottom >= ext.Bottom)) {
+         rects.clear();
+      }
+      else combine(&Rect, 1, OP::SUBTRACT);
+      return *this;
+   }
+
+   friend ClipRegion operator|(ClipRegion A, const ClipRegion &B) { return A |= B; }
+   friend ClipRegion operator&(ClipRegion A, const ClipRegion &B) { return A &= B; }
+   friend ClipRegion operator-(ClipRegion A, const ClipRegion &B) { return A -= B; }
+
+private:
+   enum class OP { UNITE, INTERSECT, SUBTRACT };
+
+   std::vector<ClipRectangle> rects;
+
+   static constexpr bool overlaps(const ClipRectangle &A, const ClipRectangle &B) noexcept {
+      return (A.Left < B.Right) and (A.Right > B.Left) and (A.Top < B.Bottom) and (A.Bottom > B.Top);
+   }
+
+   static constexpr bool same(const ClipRectangle &A, const ClipRectangle &B) noexcept {
+      return (A.Left IS B.Left) and (A.Right IS B.Right);
+   }
+
+   // Returns the index of the first rectangle after the band that starts at Index.
+
+   static size_t band_end(std::span<const ClipRectangle> List, size_t Index) noexcept {
+      auto top = List[Index].Top;
+      while ((Index < List.size()) and (List[Index].Top IS top)) Index++;
+      return Index;
+   }
+
+   // Combines the spans [A, AEnd) and [B, BEnd) of two bands and appends the result to Output as a band covering
+   // Top to Bottom.  The band is merged with the previous band if their spans are identical.
+
+   static void combine_band(std::vector<ClipRectangle> &Output, size_t &PrevBand, const ClipRectangle *A,
+      const ClipRectangle *AEnd, const ClipRectangle *B, const ClipRectangle *BEnd, int Top, int Bottom, OP Op)
+   {
+      const size_t band = Output.size();
+      bool in_a = false, in_b = false, inside = false;
+      int start = 0;
+      int pa = 0, pb = 0; // Edge counters; even values refer to Left edges and odd values to Right edges
+      const int na = int(AEnd - A) * 2, nb = int(BEnd - B) * 2;
+
+      while ((pa < na) or (pb < nb)) {
+         const int xa = (pa < na) ? ((pa & 1) ? A[pa>>1].Right : A[pa>>1].Left) : INT_MAX;
+         const int xb = (pb < nb) ? ((pb & 1) ? B[pb>>1].Right : B[pb>>1].Left) : INT_MAX;
+         const int x = std::min(xa, xb);
+         if (xa IS x) { in_a = !(pa & 1); pa++; }
+         if (xb IS x) { in_b = !(pb & 1); pb++; }
+
+         bool now;
+         if (Op IS OP::UNITE) now = in_a or in_b;
+         else if (Op IS OP::INTERSECT) now = in_a and in_b;
+         else now = in_a and (!in_b);
+
+         if (now IS inside) continue;
+         if (now) start = x;
+         else if ((Output.size() > band) and (Output.back().Right IS start)) Output.back().Right = x;
+         else Output.emplace_back(start, Top, x, Bottom);
+         inside = now;
+      }
+
+      if (Output.size() IS band) return;
+
+      // Coalesce with the previous band if it is adjacent and has identical spans.
+
+      if ((PrevBand < band) and (Output[PrevBand].Bottom IS Top) and (band - PrevBand IS Output.size() - band)) {
+         bool identical = true;
+         for (size_t i=0; i < band - PrevBand; i++) {
+            if (!same(Output[PrevBand + i], Output[band + i])) { identical = false; break; }
+         }
+
+         if (identical) {
+            for (size_t i=PrevBand; i < band; i++) Output[i].Bottom = Bottom;
+            Output.resize(band);
+            return;
+         }
+      }
+
+      PrevBand = band;
+   }
+
+   void combine(const ClipRectangle *B, size_t BCount, OP Op) {
+      const auto &a = rects;
+      const std::span<const ClipRectangle> b(B, BCount);
+
+      // The output buffer is retained between calls so that its capacity can be reused.
+
+      static thread_local std::vector<ClipRectangle> output;
+      output.clear();
+      output.reserve(a.size() + b.size() * 4);
+
+      size_t ia = 0, ib = 0, prev_band = 0;
+      int y = std::min(a.front().Top, b.front().Top);
+
+      while ((ia < a.size()) or (ib < b.size())) {
+         if ((Op != OP::UNITE) and (ia >= a.size())) break; // Nothing more can be produced
+         if ((Op IS OP::INTERSECT) and (ib >= b.size())) break;
+
+         const int a_top = (ia < a.size()) ? std::max(a[ia].Top, y) : INT_MAX;
+         const int b_top = (ib < b.size()) ? std::max(b[ib].Top, y) : INT_MAX;
+         const int top = std::min(a_top, b_top);
+         const bool a_active = (a_top IS top);
+         const bool b_active = (b_top IS top);
+         const int bottom = std::min(a_active ? a[ia].Bottom : a_top, b_active ? b[ib].Bottom : b_top);
+
+         const size_t a_end = a_active ? band_end(a, ia) : ia;
+         const size_t b_end = b_active ? band_end(b, ib) : ib;
+
+         combine_band(output, prev_band, a.data() + ia, a.data() + a_end, b.data() + ib, b.data() + b_end, top, bottom, Op);
+
+         y = bottom;
+         if ((a_active) and (a[ia].Bottom IS bottom)) ia = a_end;
+         if ((b_active) and (b[ib].Bottom IS bottom)) ib = b_end;
+      }
+
+      rects.swap(output);
+   }
+};
+
+//********************************************************************************************************************
+// Splitting an area around its occluders is cheaper than region subtraction, but with many occluders it can produce
+// fragments that a banded region would merge.  Each fragment costs a drawing callback or a copy to the display, so
+// once the count exceeds MERGE_FRAGMENTS the fragments are replaced with their banded equivalent if it is smaller.
+// The fragments must not overlap.
+
+constexpr size_t MERGE_FRAGMENTS = 8;
+
+inline void merge_fragments(std::vector<ClipRectangle> &Fragments)
+{
+   if (Fragments.size() <= MERGE_FRAGMENTS) return;
+
+   ClipRegion region;
+   for (auto &rect : Fragments) region |= rect;
+   if (region.rectangles().size() < Fragments.size()) Fragments = region.rectangles();
+}
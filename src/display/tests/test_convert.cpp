@@ -0,0 +1,302 @@
+/*********************************************************************************************************************
+
+Tests and benchmarks for the pixel conversion kernels in pixel_convert.h.  Every kernel is compared against a per-pixel
+reference that reproduces the ReadUCRIndex() and DrawUCRIndex() routines of the Bitmap class, for all instruction sets
+that are available.  The ordered dither is checked for quantisation and for preservation of the average intensity.
+
+With -bench the throughput of each kernel is reported against the per-pixel reference.
+
+Usage: test_convert [-bench]
+
+*********************************************************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string_view>
+#include <vector>
+#include <kotuku/main.h>
+#include <kotuku/modules/core.h>
+#include "../pixel_convert.h"
+
+using namespace pixel_convert;
+
+static std::mt19937 glRandom(0x5eed);
+
+// Formats as configured by the Bitmap class for common display depths.
+
+static const ColourFormat BGRA32 = { 0, 0, 0, 0, 0xff, 0xff, 0xff, 0xff, 16, 8, 0, 24, 32 };
+static const ColourFormat RGBA32 = { 0, 0, 0, 0, 0xff, 0xff, 0xff, 0xff, 0, 8, 16, 24, 32 };
+static const ColourFormat RGB565 = { 3, 2, 3, 0, 0x1f, 0x3f, 0x1f, 0, 11, 5, 0, 0, 16 };
+static const ColourFormat RGB555 = { 3, 3, 3, 0, 0x1f, 0x1f, 0x1f, 0, 10, 5, 0, 0, 15 };
+static const ColourFormat BGR24  = { 0, 0, 0, 0, 0xff, 0xff, 0xff, 0, 16, 8, 0, 0, 24 };
+static const ColourFormat RGB24  = { 0, 0, 0, 0, 0xff, 0xff, 0xff, 0, 0, 8, 16, 0, 24 };
+
+static std::vector<ISA> glISAs = {
+   ISA::SCALAR,
+#ifdef PIXEL_CONVERT_SSE2
+   ISA::SSE2
+#endif
+};
+
+static const char * isa_name(ISA Isa) { return (Isa IS ISA::SSE2) ? "sse2" : "scalar"; }
+
+static std::vector<uint8_t> random_bytes(size_t Size)
+{
+   std::vector<uint8_t> result(Size);
+   std::uniform_int_distribution<int> dist(0, 255);
+   for (auto &v : result) v = dist(glRandom);
+   // Bias some alpha values to the extremes, as they take separate paths in several kernels
+   for (size_t i=3; i < Size; i += 28) result[i] = 0;
+   for (size_t i=7; i < Size; i += 36) result[i] = 0xff;
+   return result;
+}
+
+//********************************************************************************************************************
+// Per-pixel references, following the formulas of packPixel(), packPixelWB() and unpackRed() etc.
+
+static uint8_t ref_channel32(uint32_t Pixel, uint8_t Pos) { return uint8_t(Pixel >> Pos); }
+
+static uint16_t ref_pack16(const uint8_t *Src, const ColourFormat &S, const ColourFormat &D)
+{
+   uint32_t c; memcpy(&c, Src, 4);
+   const uint8_t r = ref_channel32(c, S.RedPos), g = ref_channel32(c, S.GreenPos), b = ref_channel32(c, S.BluePos);
+   return (((r>>D.RedShift) & D.RedMask) << D.RedPos) | (((g>>D.GreenShift) & D.GreenMask) << D.GreenPos) |
+          (((b>>D.BlueShift) & D.BlueMask) << D.BluePos) | (((255>>D.AlphaShift) & D.AlphaMask) << D.AlphaPos);
+}
+
+static uint32_t ref_unpack16(const uint8_t *Src, const ColourFormat &S, const ColourFormat &D)
+{
+   uint16_t c; memcpy(&c, Src, 2);
+   const uint8_t r = ((c >> S.RedPos) & S.RedMask) << S.RedShift;
+   const uint8_t g = ((c >> S.GreenPos) & S.GreenMask) << S.GreenShift;
+   const uint8_t b = ((c >> S.BluePos) & S.BlueMask) << S.BlueShift;
+   return (uint32_t(r) << D.RedPos) | (uint32_t(g) << D.GreenPos) | (uint32_t(b) << D.BluePos) | (uint32_t(255) << D.AlphaPos);
+}
+
+static void ref_premultiply(uint8_t *Pixel, uint8_t A)
+{
+   const uint8_t a = Pixel[A];
+   if (a < 0xff) {
+      for (int i=0; i < 4; i++) {
+         if (i IS A) continue;
+         Pixel[i] = (a IS 0) ? 0 : uint8_t((Pixel[i] * a + 0xff) >> 8);
+      }
+   }
+}
+
+static void ref_demultiply(uint8_t *Pixel, uint8_t A)
+{
+   const uint8_t a = Pixel[A];
+   if (a < 0xff) {
+      for (int i=0; i < 4; i++) {
+         if (i IS A) continue;
+         if (a IS 0) Pixel[i] = 0;
+         else {
+            const uint32_t v = (uint32_t(Pixel[i]) * 0xff) / a;
+            Pixel[i] = uint8_t((v > 0xff) ? 0xff : v);
+         }
+      }
+   }
+}
+
+//********************************************************************************************************************
+
+static int test_kernels()
+{
+   constexpr int WIDTH = 1027; // Not a multiple of the vector width, so that the scalar tails are exercised
+   int failures = 0;
+
+   auto report = [&](const char *Test, ISA Isa, int X) {
+      if (!failures) printf("✗ %s (%s) differs from the reference at pixel %d.\n", Test, isa_name(Isa), X);
+      failures++;
+   };
+
+   const auto src32 = random_bytes(WIDTH * 4);
+   const auto src16 = random_bytes(WIDTH * 2);
+   const auto src24 = random_bytes(WIDTH * 3);
+
+   for (auto isa : glISAs) {
+      for (auto src_fmt : { &BGRA32, &RGBA32 }) {
+         for (auto dest_fmt : { &RGB565, &RGB555 }) {
+            std::vector<uint8_t> out(WIDTH * 2);
+            row_32_to_16(src32.data(), out.data(), WIDTH, *src_fmt, *dest_fmt, isa);
+            for (int x=0; x < WIDTH; x++) {
+               uint16_t v; memcpy(&v, out.data() + (x * 2), 2);
+               if (v != ref_pack16(src32.data() + (x * 4), *src_fmt, *dest_fmt)) { report("32 to 16", isa, x); break; }
+            }
+
+            std::vector<uint8_t> out32(WIDTH * 4);
+            row_16_to_32(src16.data(), out32.data(), WIDTH, *dest_fmt, *src_fmt, isa);
+            for (int x=0; x < WIDTH; x++) {
+               uint32_t v; memcpy(&v, out32.data() + (x * 4), 4);
+               if (v != ref_unpack16(src16.data() + (x * 2), *dest_fmt, *src_fmt)) { report("16 to 32", isa, x); break; }
+            }
+         }
+
+         for (auto fmt24 : { &BGR24, &RGB24 }) {
+            std::vector<uint8_t> out24(WIDTH * 3), out32(WIDTH * 4);
+            row_32_to_24(src32.data(), out24.data(), WIDTH, *src_fmt, *fmt24);
+            row_24_to_32(out24.data(), out32.data(), WIDTH, *fmt24, *src_fmt);
+            for (int x=0; x < WIDTH; x++) {
+               uint32_t s, d; memcpy(&s, src32.data() + (x * 4), 4); memcpy(&d, out32.data() + (x * 4), 4);
+               if ((s | (0xffu << src_fmt->AlphaPos)) != d) { report("32 to 24 to 32", isa, x); break; }
+            }
+         }
+      }
+
+      for (uint8_t a : { 0, 3 }) {
+         auto pre = src32, de = src32;
+         premultiply_row(pre.data(), pre.data(), WIDTH, a, isa);
+         demultiply_row(de.data(), de.data(), WIDTH, a, isa);
+         for (int x=0; x < WIDTH; x++) {
+            uint8_t p[4], d[4];
+            memcpy(p, src32.data() + (x * 4), 4); memcpy(d, p, 4);
+            ref_premultiply(p, a);
+            ref_demultiply(d, a);
+            if (memcmp(p, pre.data() + (x * 4), 4)) { report("premultiply", isa, x); break; }
+            if (memcmp(d, de.data() + (x * 4), 4)) { report("demultiply", isa, x); break; }
+         }
+
+         // Out of place variants must match the in place results
+
+         std::vector<uint8_t> copy(WIDTH * 4);
+         premultiply_row(src32.data(), copy.data(), WIDTH, a, isa);
+         if (copy != pre) report("premultiply copy", isa, 0);
+         demultiply_row(src32.data(), copy.data(), WIDTH, a, isa);
+         if (copy != de) report("demultiply copy", isa, 0);
+      }
+
+      // Exhaustive demultiply check, as the SSE2 path relies on floating point division
+
+      std::vector<uint8_t> all(256 * 256 * 4), expected;
+      for (int a=0; a < 256; a++) {
+         for (int c=0; c < 256; c++) {
+            uint8_t *p = all.data() + (((a<<8) + c) * 4);
+            p[0] = c; p[1] = c; p[2] = 255 - c; p[3] = a;
+         }
+      }
+      expected = all;
+      for (size_t i=0; i < expected.size(); i += 4) ref_demultiply(expected.data() + i, 3);
+      demultiply_row(all.data(), all.data(), 256 * 256, 3, isa);
+      if (all != expected) report("demultiply exhaustive", isa, 0);
+
+      // Dither results must be quantised to the target format and identical across instruction sets
+
+      std::vector<uint8_t> dithered(WIDTH * 4), scalar(WIDTH * 4);
+      for (int phase=0; phase < 4; phase++) {
+         dither_row(src32.data(), dithered.data(), WIDTH, phase, phase, BGRA32, RGB565, isa);
+         dither_row(src32.data(), scalar.data(), WIDTH, phase, phase, BGRA32, RGB565, ISA::SCALAR);
+         if (dithered != scalar) report("dither", isa, 0);
+         for (int x=0; x < WIDTH; x++) {
+            const uint8_t *p = dithered.data() + (x * 4);
+            if ((p[0] & 7) or (p[1] & 3) or (p[2] & 7) or (p[3] != src32[(x * 4) + 3])) { report("dither quantisation", isa, x); break; }
+         }
+      }
+   }
+
+   // The average intensity of a flat area must be preserved by the dither, to within a quantisation step.
+
+   for (int level : { 3, 100, 129, 250 }) {
+      std::vector<uint8_t> flat(64 * 4, level), out(64 * 4);
+      int64_t total = 0;
+      for (int y=0; y < 4; y++) {
+         dither_row(flat.data(), out.data(), 64, 0, y, BGRA32, RGB565);
+         for (int x=0; x < 64; x++) total += out[x * 4];
+      }
+      const double mean = double(total) / (64 * 4);
+      if ((mean < level - 4.0) or (mean > level + 4.0)) {
+         printf("✗ Dither of level %d has a mean of %.2f\n", level, mean);
+         failures++;
+      }
+   }
+
+   return failures;
+}
+
+//********************************************************************************************************************
+
+static void benchmark()
+{
+   constexpr int WIDTH = 1920, HEIGHT = 1080, ROUNDS = 20;
+   const auto src32 = random_bytes(WIDTH * HEIGHT * 4);
+   std::vector<uint8_t> out16(WIDTH * HEIGHT * 2), out32(WIDTH * HEIGHT * 4);
+
+   auto measure = [&](const char *Name, auto &&Function) {
+      Function();
+      auto start = std::chrono::steady_clock::now();
+      for (int i=0; i < ROUNDS; i++) Function();
+      auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / ROUNDS;
+      printf("  %-28s %8.3f ms  %6.2f ns/pixel\n", Name, ms, ms * 1000000.0 / (WIDTH * HEIGHT));
+   };
+
+   printf("Conversion of %dx%d pixels:\n", WIDTH, HEIGHT);
+
+   measure("32 to 16 reference", [&]() {
+      for (int i=0; i < WIDTH * HEIGHT; i++) {
+         const uint16_t v = ref_pack16(src32.data() + (i * 4), BGRA32, RGB565);
+         memcpy(out16.data() + (i * 2), &v, 2);
+      }
+   });
+
+   // CopyArea() previously converted each pixel through the ReadUCRPixel() and DrawUCRPixel() function pointers.
+
+   struct RGB { uint8_t r, g, b, a; };
+   static void (* volatile read_pixel)(const uint8_t *, int, int, RGB *) = [](const uint8_t *Data, int X, int Y, RGB *C) {
+      uint32_t v; memcpy(&v, Data + (Y * WIDTH * 4) + (X * 4), 4);
+      *C = { uint8_t(v >> 16), uint8_t(v >> 8), uint8_t(v), uint8_t(v >> 24) };
+   };
+   static void (* volatile draw_pixel)(uint8_t *, int, int, RGB *) = [](uint8_t *Data, int X, int Y, RGB *C) {
+      const uint16_t v = ((C->r >> 3) << 11) | ((C->g >> 2) << 5) | (C->b >> 3);
+      memcpy(Data + (Y * WIDTH * 2) + (X * 2), &v, 2);
+   };
+
+   measure("32 to 16 per-pixel calls", [&]() {
+      RGB c;
+      for (int y=0; y < HEIGHT; y++) {
+         for (int x=0; x < WIDTH; x++) {
+            read_pixel(src32.data(), x, y, &c);
+            draw_pixel(out16.data(), x, y, &c);
+         }
+      }
+   });
+
+   for (auto isa : glISAs) {
+      char name[64];
+      snprintf(name, sizeof(name), "32 to 16 %s", isa_name(isa));
+      measure(name, [&]() { row_32_to_16(src32.data(), out16.data(), WIDTH * HEIGHT, BGRA32, RGB565, isa); });
+      snprintf(name, sizeof(name), "16 to 32 %s", isa_name(isa));
+      measure(name, [&]() { row_16_to_32(out16.data(), out32.data(), WIDTH * HEIGHT, RGB565, BGRA32, isa); });
+      snprintf(name, sizeof(name), "premultiply %s", isa_name(isa));
+      measure(name, [&]() { premultiply_row(src32.data(), out32.data(), WIDTH * HEIGHT, 3, isa); });
+      snprintf(name, sizeof(name), "demultiply %s", isa_name(isa));
+      measure(name, [&]() { demultiply_row(src32.data(), out32.data(), WIDTH * HEIGHT, 3, isa); });
+      snprintf(name, sizeof(name), "ordered dither %s", isa_name(isa));
+      measure(name, [&]() {
+         for (int y=0; y < HEIGHT; y++) {
+            dither_row(src32.data() + (y * WIDTH * 4), out32.data() + (y * WIDTH * 4), WIDTH, 0, y, BGRA32, RGB565, isa);
+         }
+      });
+   }
+
+   measure("32 to 24", [&]() { row_32_to_24(src32.data(), out32.data(), WIDTH * HEIGHT, BGRA32, BGR24); });
+   measure("24 to 32", [&]() { row_24_to_32(src32.data(), out32.data(), WIDTH * HEIGHT, BGR24, BGRA32); });
+}
+
+//********************************************************************************************************************
+
+int main(int argc, char **argv)
+{
+   const bool bench = (argc > 1) and (std::string_view(argv[1]) == "-bench");
+
+   if (auto failures = test_kernels()) {
+      printf("✗ %d pixel conversion checks failed.\n", failures);
+      return -1;
+   }
+
+   if (bench) benchmark();
+
+   printf("✓ Pixel conversion kernels match the reference.\n");
+   return 0;
+}
@@ -0,0 +1,111 @@
+/*********************************************************************************************************************
+
+Tests for the surface frame scheduler.  Draw requests are deferred until the next frame, and CopySurface() must flush
+any pending damage so that the copied graphics are current.  Overlapping requests made within the same frame are
+merged, so each pixel is drawn once in a single pass.
+
+Usage: test_frames --gfx-driver=headless
+
+*********************************************************************************************************************/
+
+#include <kotuku/startup.h>
+#include <kotuku/modules/display.h>
+
+JUMPTABLE_DISPLAY
+static OBJECTPTR modDisplay;
+
+using namespace pf;
+
+CSTRING ProgName = "SurfaceFrames";
+
+static constexpr int SIZE = 64;
+
+static int glFailures = 0;
+static int glCalls = 0;       // Count of drawing callbacks
+static int64_t glDrawn = 0;   // Total area drawn by the callbacks
+static uint8_t glRed = 0;     // Red component of the colour drawn by the callback
+
+//********************************************************************************************************************
+
+static void draw_surface(APTR Context, objSurface *Surface, objBitmap *Bitmap, APTR Meta)
+{
+   auto &clip = Bitmap->Clip;
+   glCalls++;
+   glDrawn += int64_t(clip.Right - clip.Left) * int64_t(clip.Bottom - clip.Top);
+   gfx::DrawRectangle(Bitmap, 0, 0, Surface->Width, Surface->Height, Bitmap->packPixel(glRed, 0, 0, 255), BAF::FILL);
+}
+
+static void check(bool Result, CSTRING Test)
+{
+   if (Result) printf("✓ %s\n", Test);
+   else {
+      printf("✗ %s\n", Test);
+      glFailures++;
+   }
+}
+
+static int64_t frames()
+{
+   FrameStats stats;
+   if (gfx::GetFrameStats(&stats, sizeof(stats)) != ERR::Okay) return -1;
+   return stats.Frames;
+}
+
+//********************************************************************************************************************
+
+int main(int argc, CSTRING *argv)
+{
+   if (auto msg = init_kotuku(argc, argv)) {
+      printf("%s\n", msg);
+      return -1;
+   }
+
+   if (objModule::load("display", &modDisplay, &DisplayBase) != ERR::Okay) return -1;
+
+   auto surface = objSurface::create::global({ fl::X(0), fl::Y(0), fl::Width(SIZE), fl::Height(SIZE) });
+   auto copy = objBitmap::create::global({ fl::Width(SIZE), fl::Height(SIZE), fl::BitsPerPixel(32) });
+   if ((!surface) or (!copy)) return -1;
+
+   surface->addCallback(C_FUNCTION(draw_surface));
+   acShow(surface);
+   gfx::CopySurface(surface->UID, copy, BDF::NIL, 0, 0, SIZE, SIZE, 0, 0); // Flush the initial frame
+
+   // A draw request is deferred, and CopySurface() flushes it before reading the surface.
+
+   glCalls = 0;
+   glDrawn = 0;
+   glRed = 255;
+   auto start = frames();
+   acDraw(surface);
+   check(glCalls IS 0, "Draw is deferred to the next frame");
+
+   gfx::CopySurface(surface->UID, copy, BDF::NIL, 0, 0, SIZE, SIZE, 0, 0);
+   check(glCalls > 0, "CopySurface flushes pending damage");
+   check(copy->unpackRed(gfx::ReadPixel(copy, SIZE / 2, SIZE / 2)) IS 255, "CopySurface returns the drawn pixels");
+   check(frames() IS start + 1, "Pending damage is drawn in one frame");
+
+   // Overlapping requests are merged.  The union of the three areas is 64x32 plus 32x16.
+
+   glCalls = 0;
+   glDrawn = 0;
+   glRed = 128;
+   start = frames();
+   acDrawArea(surface, 0, 0, 32, 32);
+   acDrawArea(surface, 16, 16, 32, 32);
+   acDrawArea(surface, 32, 0, 32, 32);
+   gfx::CopySurface(surface->UID, copy, BDF::NIL, 0, 0, SIZE, SIZE, 0, 0);
+
+   check(frames() IS start + 1, "Overlapping requests are drawn in one frame");
+   check(glDrawn IS (SIZE * 32) + (32 * 16), "Each damaged pixel is drawn once");
+   check(copy->unpackRed(gfx::ReadPixel(copy, 40, 40)) IS 128, "Merged damage covers every requested area");
+   check(copy->unpackRed(gfx::ReadPixel(copy, 4, 60)) IS 255, "Undamaged areas are not redrawn");
+
+   FreeResource(copy);
+   FreeResource(surface);
+
+   if (glFailures) printf("%d tests failed.\n", glFailures);
+
+   FreeResource(modDisplay);
+   close_kotuku();
+   return glFailures ? -1 : 0;
+}
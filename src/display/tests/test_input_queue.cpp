@@ -0,0 +1,161 @@
+/*********************************************************************************************************************
+
+Tests for the filtering of the input queue in input_queue.h, as used by input_event_loop().  Movement is coalesced
+separately for each subscriber, anchored deltas are summed, HISTORY subscribers receive every event with its original
+timestamp, and a queue that is held for the next frame is flushed as soon as a button event arrives.
+
+Usage: test_input_queue
+
+*********************************************************************************************************************/
+
+#include <kotuku/main.h>
+#include <kotuku/modules/core.h>
+#include <cstdio>
+#include "../input_queue.h"
+
+static constexpr OBJECTID SURFACE_A = 100;
+static constexpr OBJECTID SURFACE_B = 200;
+static constexpr int64_t FRAME = 16667; // Frame interval in microseconds
+
+static int glFailures = 0;
+
+static void check(bool Result, CSTRING Test)
+{
+   if (Result) printf("✓ %s\n", Test);
+   else {
+      printf("✗ %s\n", Test);
+      glFailures++;
+   }
+}
+
+static InputEvent movement(OBJECTID Surface, double X, double Y, int64_t Timestamp, JTYPE Flags = JTYPE::MOVEMENT)
+{
+   InputEvent event = {};
+   event.Type        = JET::ABS_XY;
+   event.Flags       = Flags;
+   event.Mask        = JTYPE::MOVEMENT;
+   event.RecipientID = Surface;
+   event.OverID      = Surface;
+   event.X           = X;
+   event.Y           = Y;
+   event.Timestamp   = Timestamp;
+   return event;
+}
+
+static InputEvent button(OBJECTID Surface, int64_t Timestamp)
+{
+   InputEvent event = {};
+   event.Type        = JET::LMB;
+   event.Flags       = JTYPE::BUTTON;
+   event.Mask        = JTYPE::BUTTON;
+   event.Value       = 1;
+   event.RecipientID = Surface;
+   event.OverID      = Surface;
+   event.Timestamp   = Timestamp;
+   return event;
+}
+
+static bool linked(const std::vector<InputEvent> &Events)
+{
+   for (size_t i=0; i < Events.size(); i++) {
+      if (Events[i].Next != ((i + 1 < Events.size()) ? &Events[i + 1] : nullptr)) return false;
+   }
+   return true;
+}
+
+//********************************************************************************************************************
+// Movement over two surfaces is interleaved.  A subscriber to each surface receives only the final position over
+// its own surface, while a subscriber without a filter receives the interleaved series, as consecutive events never
+// share a recipient.
+
+static void test_per_subscriber()
+{
+   std::vector<InputEvent> queue = {
+      movement(SURFACE_A, 1, 1, 10), movement(SURFACE_A, 2, 2, 20), movement(SURFACE_B, 5, 5, 30),
+      movement(SURFACE_A, 3, 3, 40), movement(SURFACE_B, 6, 6, 50)
+   };
+
+   std::vector<InputEvent> a, b, all;
+   input_queue::filter(queue, SURFACE_A, JTYPE::MOVEMENT, a);
+   input_queue::filter(queue, SURFACE_B, JTYPE::MOVEMENT, b);
+   input_queue::filter(queue, 0, JTYPE::MOVEMENT, all);
+
+   check((a.size() IS 1) and (a[0].X IS 3) and (a[0].Timestamp IS 40), "Movement is coalesced to the last position for surface A");
+   check((b.size() IS 1) and (b[0].X IS 6) and (b[0].Timestamp IS 50), "Movement is coalesced to the last position for surface B");
+   check((all.size() IS 4) and (all[0].X IS 2) and (all[3].X IS 6), "Movement over different surfaces is not merged");
+   check(linked(a) and linked(b) and linked(all), "Filtered events are linked in order");
+}
+
+//********************************************************************************************************************
+// Anchored movement is reported as a delta from the anchor, so coalescing must sum the deltas.
+
+static void test_anchored()
+{
+   std::vector<InputEvent> queue = {
+      movement(SURFACE_A, 1, -2, 10, JTYPE::ANCHORED), movement(SURFACE_A, 3, 4, 20, JTYPE::ANCHORED),
+      movement(SURFACE_A, -1, 5, 30, JTYPE::ANCHORED)
+   };
+
+   std::vector<InputEvent> out;
+   input_queue::filter(queue, SURFACE_A, JTYPE::ANCHORED, out);
+   check((out.size() IS 1) and (out[0].X IS 3) and (out[0].Y IS 7), "Anchored deltas are summed");
+   check((out.size() IS 1) and (out[0].Timestamp IS 30), "Coalesced anchored movement carries the last timestamp");
+}
+
+//********************************************************************************************************************
+// A HISTORY subscriber receives every event, each with the timestamp that it was queued with, while an ordinary
+// subscriber to the same surface receives a single event.
+
+static void test_history()
+{
+   std::vector<InputEvent> queue;
+   for (int i=0; i < 5; i++) queue.push_back(movement(SURFACE_A, i, i * 2, 1000 + (i * 100)));
+
+   std::vector<InputEvent> history, plain;
+   input_queue::filter(queue, SURFACE_A, JTYPE::MOVEMENT|JTYPE::HISTORY, history);
+   input_queue::filter(queue, SURFACE_A, JTYPE::MOVEMENT, plain);
+
+   bool timestamps = history.size() IS 5;
+   for (size_t i=0; (timestamps) and (i < history.size()); i++) {
+      timestamps = (history[i].Timestamp IS int64_t(1000 + (i * 100))) and (history[i].X IS double(i));
+   }
+
+   check(timestamps, "HISTORY subscribers receive every event with its timestamp");
+   check(linked(history), "The history is linked in order");
+   check((plain.size() IS 1) and (plain[0].Timestamp IS 1400), "Other subscribers receive the coalesced event");
+}
+
+//********************************************************************************************************************
+// Movement is held within a frame, but a button event flushes the queue immediately.  The button is delivered after
+// the movement that precedes it, and movement on either side of the button is not merged across it.
+
+static void test_flush()
+{
+   const int64_t last = 1000000;
+   std::vector<InputEvent> queue = { movement(SURFACE_A, 1, 1, last + 100), movement(SURFACE_A, 2, 2, last + 200) };
+
+   check(input_queue::hold(queue, last + 300, last, FRAME), "Movement is held within the frame");
+   check(!input_queue::hold(queue, last + FRAME, last, FRAME), "Movement is released at the next frame");
+
+   queue.push_back(button(SURFACE_A, last + 300));
+   queue.push_back(movement(SURFACE_A, 3, 3, last + 400));
+   check(!input_queue::hold(queue, last + 500, last, FRAME), "A button event flushes held movement");
+
+   std::vector<InputEvent> out;
+   input_queue::filter(queue, SURFACE_A, JTYPE::MOVEMENT|JTYPE::BUTTON, out);
+   check((out.size() IS 3) and (out[0].X IS 2) and (out[1].Type IS JET::LMB) and (out[2].X IS 3),
+      "Movement is not coalesced across a button event");
+}
+
+//********************************************************************************************************************
+
+int main(int argc, char **argv)
+{
+   test_per_subscriber();
+   test_anchored();
+   test_history();
+   test_flush();
+
+   if (glFailures) printf("%d tests failed.\n", glFailures);
+   return glFailures ? -1 : 0;
+}
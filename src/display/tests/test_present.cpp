@@ -0,0 +1,139 @@
+/*********************************************************************************************************************
+
+Tests the asynchronous presentation of exposes on X11.  A window is exposed repeatedly and resized, and the shared
+memory segments created by the process are counted to confirm that the presentation buffers are recycled when the
+X server reports ShmCompletion, and released when the window's pixmap is replaced or the window is closed.
+
+Requires an X server with the MIT-SHM extension, e.g. Xvfb.  The test is skipped if DISPLAY is undefined.
+
+Usage: xvfb-run -a test_present
+
+*********************************************************************************************************************/
+
+#include <kotuku/startup.h>
+#include <kotuku/modules/display.h>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+JUMPTABLE_DISPLAY
+static OBJECTPTR modDisplay;
+
+using namespace pf;
+
+CSTRING ProgName = "Present";
+
+static int glFailures = 0;
+
+//********************************************************************************************************************
+
+static void draw_surface(APTR Context, objSurface *Surface, objBitmap *Bitmap, APTR Meta)
+{
+   static uint8_t red = 0;
+   red += 16;
+   gfx::DrawRectangle(Bitmap, 0, 0, Surface->Width, Surface->Height, Bitmap->packPixel(red, 0, 0, 255), BAF::FILL);
+}
+
+static void check(bool Result, CSTRING Test)
+{
+   if (Result) printf("✓ %s\n", Test);
+   else {
+      printf("✗ %s\n", Test);
+      glFailures++;
+   }
+}
+
+//********************************************************************************************************************
+// Counts the System V shared memory segments that were created by this process.
+
+static int count_segments()
+{
+   std::ifstream file("/proc/sysvipc/shm");
+   std::string line;
+   std::getline(file, line); // Skip the header
+
+   int total = 0;
+   while (std::getline(file, line)) {
+      std::istringstream row(line);
+      long key, shmid, perms, size, cpid;
+      if ((row >> key >> shmid >> perms >> size >> cpid) and (cpid IS getpid())) total++;
+   }
+   return total;
+}
+
+static FrameStats frame_stats()
+{
+   FrameStats stats = {};
+   gfx::GetFrameStats(&stats, sizeof(stats));
+   return stats;
+}
+
+// Process messages until the next frame has been drawn and its ShmCompletion events have been received.
+
+static void next_frame()
+{
+   auto start = frame_stats().Frames;
+   for (int i=0; (i < 100) and (frame_stats().Frames IS start); i++) ProcessMessages(PMF::NIL, 10);
+   ProcessMessages(PMF::NIL, 20);
+}
+
+//********************************************************************************************************************
+
+int main(int argc, CSTRING *argv)
+{
+   if (!getenv("DISPLAY")) {
+      printf("DISPLAY is undefined; skipping the presentation tests.\n");
+      return 0;
+   }
+
+   if (auto msg = init_kotuku(argc, argv)) {
+      printf("%s\n", msg);
+      return -1;
+   }
+
+   if (objModule::load("display", &modDisplay, &DisplayBase) != ERR::Okay) return -1;
+
+   auto initial = count_segments();
+
+   auto surface = objSurface::create::global({ fl::X(0), fl::Y(0), fl::Width(320), fl::Height(240) });
+   if (!surface) return -1;
+
+   surface->addCallback(C_FUNCTION(draw_surface));
+   acShow(surface);
+   next_frame();
+
+   auto baseline = count_segments();
+   auto stalls = frame_stats().PresentStalls;
+
+   // Each expose posts a segment from the ring.  If ShmCompletion events were not received, the ring would be
+   // exhausted after a few frames and presentation would stall.
+
+   for (int i=0; i < 30; i++) {
+      acDraw(surface);
+      next_frame();
+   }
+
+   check(frame_stats().PresentStalls IS stalls, "Segments are released on ShmCompletion");
+   check(count_segments() IS baseline, "Repeated exposes do not allocate segments");
+
+   // Growing the window replaces its pixmap.  The presenter of the old pixmap must be released.
+
+   for (int i=1; i <= 5; i++) {
+      acResize(surface, 320 + (i * 32), 240 + (i * 32), 0);
+      acDraw(surface);
+      next_frame();
+   }
+
+   check(count_segments() IS baseline, "Resizing the window does not leak segments");
+
+   FreeResource(surface);
+   ProcessMessages(PMF::NIL, 20);
+
+   check(count_segments() IS initial, "Closing the window releases its segments");
+
+   if (glFailures) printf("%d tests failed.\n", glFailures);
+
+   FreeResource(modDisplay);
+   close_kotuku();
+   return glFailures ? -1 : 0;
+}
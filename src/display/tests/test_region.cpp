@@ -0,0 +1,225 @@
+/*********************************************************************************************************************
+
+Tests and benchmarks for the banded ClipRegion type in region.h.  Region operations on random rectangle sets are
+compared against a per-pixel reference, and the band structure of every result is validated.
+
+The benchmark models a redraw of overlapping surfaces.  For each surface the area that is not obscured by the
+surfaces in front of it is computed with the recursive four-way splitting that the surface code uses, with splitting
+followed by merge_fragments(), and with region subtraction.  The number of fragments produced and the time taken are
+reported.
+
+Usage: test_region [-bench]
+
+*********************************************************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string_view>
+#include <kotuku/main.h>
+#include <kotuku/modules/core.h>
+#include "../region.h"
+
+static constexpr int GRID = 64;
+static std::mt19937 glRandom(0x5eed);
+
+//********************************************************************************************************************
+
+static ClipRectangle random_rect(int Limit)
+{
+   std::uniform_int_distribution<int> dist(0, Limit);
+   int x1 = dist(glRandom), x2 = dist(glRandom), y1 = dist(glRandom), y2 = dist(glRandom);
+   return ClipRectangle(std::min(x1, x2), std::min(y1, y2), std::max(x1, x2), std::max(y1, y2));
+}
+
+static ClipRegion random_region(std::vector<bool> &Mask)
+{
+   ClipRegion region;
+   Mask.assign(GRID * GRID, false);
+   std::uniform_int_distribution<int> count(0, 6);
+   for (int n=count(glRandom); n > 0; n--) {
+      auto r = random_rect(GRID);
+      region |= r;
+      for (int y=r.Top; y < r.Bottom; y++) {
+         for (int x=r.Left; x < r.Right; x++) Mask[y * GRID + x] = true;
+      }
+   }
+   return region;
+}
+
+//********************************************************************************************************************
+// Checks that a region matches a pixel mask and that its bands are sorted, disjoint and fully coalesced.
+
+static bool validate(const ClipRegion &Region, const std::vector<bool> &Mask)
+{
+   for (int y=0; y < GRID; y++) {
+      for (int x=0; x < GRID; x++) {
+         if (Region.contains(x, y) != Mask[y * GRID + x]) return false;
+      }
+   }
+
+   auto &rects = Region.rectangles();
+   for (size_t i=0; i < rects.size(); i++) {
+      auto &r = rects[i];
+      if ((r.Left >= r.Right) or (r.Top >= r.Bottom)) return false;
+      if (i IS 0) continue;
+
+      auto &p = rects[i-1];
+      if (p.Top IS r.Top) { // Same band
+         if ((p.Bottom != r.Bottom) or (p.Right >= r.Left)) return false;
+      }
+      else if (r.Top < p.Bottom) return false;
+   }
+
+   // Adjacent bands with identical spans must have been merged
+
+   size_t prev = 0, band = 0;
+   while (band < rects.size()) {
+      size_t end = band;
+      while ((end < rects.size()) and (rects[end].Top IS rects[band].Top)) end++;
+      if ((band > 0) and (rects[prev].Bottom IS rects[band].Top) and (band - prev IS end - band)) {
+         bool identical = true;
+         for (size_t i=0; i < band - prev; i++) {
+            if ((rects[prev+i].Left != rects[band+i].Left) or (rects[prev+i].Right != rects[band+i].Right)) identical = false;
+         }
+         if (identical) return false;
+      }
+      prev = band;
+      band = end;
+   }
+
+   return true;
+}
+
+//********************************************************************************************************************
+
+static int test_operations()
+{
+   int failures = 0;
+   for (int i=0; i < 5000; i++) {
+      std::vector<bool> ma, mb, expected(GRID * GRID);
+      auto a = random_region(ma);
+      auto b = random_region(mb);
+
+      for (int op=0; op < 3; op++) {
+         ClipRegion result;
+         if (op IS 0) result = a | b;
+         else if (op IS 1) result = a & b;
+         else result = a - b;
+
+         for (int p=0; p < GRID * GRID; p++) {
+            if (op IS 0) expected[p] = ma[p] or mb[p];
+            else if (op IS 1) expected[p] = ma[p] and mb[p];
+            else expected[p] = ma[p] and (!mb[p]);
+         }
+
+         if (!validate(result, expected)) {
+            static const char *names[] = { "union", "intersect", "subtract" };
+            if (!failures) printf("✗ Region %s failed on iteration %d.\n", names[op], i);
+            failures++;
+         }
+      }
+   }
+   return failures;
+}
+
+//********************************************************************************************************************
+// The visible area of a surface is found by splitting the area around each obscuring surface and recursing into each
+// side.  This replicates the approach used by the surface code.
+
+static void split_visible(const std::vector<ClipRectangle> &Surfaces, size_t Index, size_t Scan, ClipRectangle Area,
+   std::vector<ClipRectangle> &Output)
+{
+   for (size_t i=Scan; i < Surfaces.size(); i++) {
+      auto s = Surfaces[i];
+      if ((s.Left < Area.Right) and (s.Top < Area.Bottom) and (s.Right > Area.Left) and (s.Bottom > Area.Top)) {
+         if (s.Left <= Area.Left) s.Left = Area.Left;
+         else split_visible(Surfaces, Index, i + 1, ClipRectangle(Area.Left, Area.Top, s.Left, Area.Bottom), Output);
+
+         if (s.Right >= Area.Right) s.Right = Area.Right;
+         else split_visible(Surfaces, Index, i + 1, ClipRectangle(s.Right, Area.Top, Area.Right, Area.Bottom), Output);
+
+         if (s.Top <= Area.Top) s.Top = Area.Top;
+         else split_visible(Surfaces, Index, i + 1, ClipRectangle(s.Left, Area.Top, s.Right, s.Top), Output);
+
+         if (s.Bottom < Area.Bottom) split_visible(Surfaces, Index, i + 1, ClipRectangle(s.Left, s.Bottom, s.Right, Area.Bottom), Output);
+         return;
+      }
+   }
+   Output.push_back(Area);
+}
+
+static void benchmark_surfaces(int Surfaces)
+{
+   constexpr int ROUNDS = 2000;
+
+   std::vector<ClipRectangle> surfaces;
+   std::uniform_int_distribution<int> pos(0, 1600), size(100, 600);
+   for (int i=0; i < Surfaces; i++) {
+      int x = pos(glRandom), y = pos(glRandom) * 9 / 16;
+      surfaces.emplace_back(x, y, x + size(glRandom), y + size(glRandom));
+   }
+
+   struct result { size_t fragments = 0; int64_t area = 0; double time = 0; };
+
+   auto measure = [&](auto &&Visible) {
+      result r;
+      auto start = std::chrono::steady_clock::now();
+      for (int round=0; round < ROUNDS; round++) {
+         for (size_t i=0; i < surfaces.size(); i++) {
+            std::vector<ClipRectangle> output;
+            Visible(i, output);
+            if (!round) {
+               r.fragments += output.size();
+               for (auto &rect : output) r.area += int64_t(rect.width()) * rect.height();
+            }
+         }
+      }
+      r.time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / ROUNDS;
+      return r;
+   };
+
+   auto split = measure([&](size_t i, std::vector<ClipRectangle> &Output) {
+      split_visible(surfaces, i, i + 1, surfaces[i], Output);
+   });
+
+   auto merged = measure([&](size_t i, std::vector<ClipRectangle> &Output) {
+      split_visible(surfaces, i, i + 1, surfaces[i], Output);
+      merge_fragments(Output);
+   });
+
+   auto region = measure([&](size_t i, std::vector<ClipRectangle> &Output) {
+      ClipRegion visible(surfaces[i]);
+      for (size_t j=i + 1; (j < surfaces.size()) and (!visible.empty()); j++) visible -= surfaces[j];
+      Output = visible.rectangles();
+   });
+
+   printf("Visible areas of %d overlapping surfaces (%lld pixels):\n", Surfaces, (long long)region.area);
+   printf("  split   %6zu fragments  %8.2f us\n", split.fragments, split.time);
+   printf("  merged  %6zu fragments  %8.2f us\n", merged.fragments, merged.time);
+   printf("  region  %6zu fragments  %8.2f us\n", region.fragments, region.time);
+
+   if ((split.area != region.area) or (merged.area != region.area)) {
+      printf("✗ Visible area mismatch: %lld, %lld, %lld\n", (long long)split.area, (long long)merged.area, (long long)region.area);
+   }
+}
+
+//********************************************************************************************************************
+
+int main(int argc, char **argv)
+{
+   const bool bench = (argc > 1) and (std::string_view(argv[1]) == "-bench");
+
+   if (auto failures = test_operations()) {
+      printf("✗ %d region operations did not match the reference.\n", failures);
+      return -1;
+   }
+
+   if (bench) {
+      for (int surfaces : { 10, 50, 200 }) benchmark_surfaces(surfaces);
+   }
+
+   printf("✓ Region operations match the reference.\n");
+   return 0;
+}
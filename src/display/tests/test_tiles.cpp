@@ -0,0 +1,190 @@
+/*********************************************************************************************************************
+
+Tests and benchmarks for the tiled bitmap storage in bitmap_tiles.h.  Images of each pixel depth are compressed and
+restored in full and in part, with the result compared against the original.  Tile sharing is checked between identical
+areas of the same and of separate stores, and writes are confirmed to release the shared tile.
+
+With -bench the compression ratio and throughput of a document-like image is reported.
+
+Usage: test_tiles [-bench]
+
+*********************************************************************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string_view>
+#include <vector>
+#include <kotuku/main.h>
+#include <kotuku/modules/core.h>
+#include "../bitmap_tiles.h"
+
+using namespace bitmap_tiles;
+
+static std::mt19937 glRandom(0x5eed);
+static int glFailures = 0;
+
+#define CHECK(Condition, ...) if (!(Condition)) { printf("  ✗ " __VA_ARGS__); printf("\n"); glFailures++; }
+
+struct Image {
+   int width, height, bpp, line_width;
+   std::vector<uint8_t> data;
+
+   Image(int Width, int Height, int BPP) : width(Width), height(Height), bpp(BPP),
+      line_width((Width * BPP + 3) & ~3), data(line_width * Height) { }
+
+   uint8_t * pixel(int X, int Y) { return data.data() + (Y * line_width) + (X * bpp); }
+};
+
+// Generates content that resembles a document page: a flat background, blank margins, a gradient header, blocks of
+// noisy 'text' and rows that repeat the one above.
+
+static Image document(int Width, int Height, int BPP)
+{
+   Image img(Width, Height, BPP);
+   std::uniform_int_distribution<int> dist(0, 255);
+
+   for (int y=0; y < Height; y++) {
+      for (int x=0; x < Width; x++) {
+         uint32_t value;
+         if ((x < 40) or (y < 40)) value = 0; // Transparent margin
+         else if (y < 120) value = 0xff000000 | ((x & 0xff) << 8) | (y & 0xff); // Gradient
+         else if (((y / 24) & 1) and (x > 100) and (x < Width - 100) and ((y % 24) < 16)) {
+            value = ((y % 3) IS 1) ? 0 : uint32_t(dist(glRandom) * 0x010101); // Text with repeated rows
+         }
+         else value = 0xffffffff; // Background
+         memcpy(img.pixel(x, y), &value, BPP);
+      }
+
+      if (((y % 24) IS 17) and (y > 120)) memcpy(img.pixel(0, y), img.pixel(0, y - 1), Width * BPP);
+   }
+   return img;
+}
+
+static bool same_area(Image &A, Image &B, int X, int Y, int Width, int Height)
+{
+   for (int y=Y; y < Y + Height; y++) {
+      if (memcmp(A.pixel(X, y), B.pixel(X, y), Width * A.bpp)) return false;
+   }
+   return true;
+}
+
+//********************************************************************************************************************
+
+static void test_round_trip()
+{
+   for (int bpp : { 1, 2, 3, 4 }) {
+      for (auto [width, height] : { std::pair { 300, 200 }, std::pair { 64, 64 }, std::pair { 17, 130 } }) {
+         auto original = document(width, height, bpp);
+
+         // Noise in one corner forces raw storage for at least one tile.
+         std::uniform_int_distribution<int> dist(0, 255);
+         for (int y=0; y < std::min(64, height); y++) {
+            for (int x=0; x < std::min(64, width) * bpp; x++) original.pixel(0, y)[x] = dist(glRandom);
+         }
+
+         auto work = original;
+         TileStore store(width, height, bpp, work.line_width);
+         store.compress(work.data.data());
+         CHECK(store.Packed IS store.count(), "%d bpp: all tiles should be packed after compression", bpp);
+
+         std::fill(work.data.begin(), work.data.end(), 0xcd);
+
+         // Restore a single pixel and confirm that only its tile is resident.
+
+         CHECK(store.restore(work.data.data(), width - 1, height - 1, 1, 1, false), "%d bpp: restore failed", bpp);
+         const int tx = ((width - 1) / TILE_SIZE) * TILE_SIZE, ty = ((height - 1) / TILE_SIZE) * TILE_SIZE;
+         CHECK(same_area(original, work, tx, ty, width - tx, height - ty), "%d bpp %dx%d: corner tile differs", bpp, width, height);
+         CHECK(store.Packed IS store.count() - 1, "%d bpp: only one tile should be restored", bpp);
+
+         CHECK(store.restore(work.data.data(), -10, -10, width + 20, height + 20, false), "%d bpp: restore failed", bpp);
+         CHECK(same_area(original, work, 0, 0, width, height), "%d bpp %dx%d: full restore differs from the original", bpp, width, height);
+         CHECK(!store.Packed, "%d bpp: all tiles should be resident", bpp);
+      }
+   }
+}
+
+//********************************************************************************************************************
+
+static void test_sharing()
+{
+   const size_t base = TileCache::instance().size();
+
+   {
+      Image blank(640, 640, 4);
+      std::fill(blank.data.begin(), blank.data.end(), 0xff);
+
+      TileStore a(blank.width, blank.height, 4, blank.line_width);
+      TileStore b(blank.width, blank.height, 4, blank.line_width);
+      a.compress(blank.data.data());
+      b.compress(blank.data.data());
+
+      CHECK(TileCache::instance().size() IS base + 1, "Identical tiles should share one cache entry, found %d", int(TileCache::instance().size() - base));
+      CHECK(a.packed_size() < 128, "A blank bitmap should compress to a few bytes, got %d", int(a.packed_size()));
+
+      // Writing to a restored tile releases the shared copy, so only the modified tile is encoded again.
+
+      CHECK(a.restore(blank.data.data(), 70, 70, 10, 10, true), "Restore failed");
+      *blank.pixel(75, 75) = 0;
+      a.compress(blank.data.data());
+      CHECK(TileCache::instance().size() IS base + 2, "The modified tile should add one cache entry");
+
+      std::fill(blank.data.begin(), blank.data.end(), 0);
+      b.restore(blank.data.data(), 0, 0, blank.width, blank.height, false);
+      uint32_t v;
+      memcpy(&v, blank.pixel(75, 75), 4);
+      CHECK(v IS 0xffffffff, "Modification leaked into a shared tile");
+      memcpy(&v, blank.pixel(0, 639), 4);
+      CHECK(v IS 0xffffffff, "Shared tile was not restored");
+   }
+
+   CHECK(TileCache::instance().size() IS base, "Cache entries should be released with their stores");
+}
+
+//********************************************************************************************************************
+
+static void benchmark()
+{
+   constexpr int WIDTH = 1920, HEIGHT = 2400, ROUNDS = 10;
+   auto page = document(WIDTH, HEIGHT, 4);
+
+   TileStore store(WIDTH, HEIGHT, 4, page.line_width);
+   auto start = std::chrono::steady_clock::now();
+   for (int i=0; i < ROUNDS; i++) {
+      store.restore(page.data.data(), 0, 0, WIDTH, HEIGHT, true); // Marks every tile as modified
+      store.compress(page.data.data());
+   }
+   const double compress_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / ROUNDS;
+
+   start = std::chrono::steady_clock::now();
+   for (int i=0; i < ROUNDS; i++) {
+      store.restore(page.data.data(), 0, 0, WIDTH, HEIGHT, false);
+      store.compress(page.data.data()); // No tiles are modified, so this only releases them
+   }
+   const double restore_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / ROUNDS;
+
+   printf("Document of %dx%d pixels, %d bytes:\n", WIDTH, HEIGHT, int(page.data.size()));
+   printf("  Packed size            %d bytes (%.1f%%)\n", int(store.packed_size()), 100.0 * store.packed_size() / page.data.size());
+   printf("  Restore and re-encode  %8.3f ms  %6.2f GB/s\n", compress_ms, page.data.size() / compress_ms / 1000000.0);
+   printf("  Restore unmodified     %8.3f ms  %6.2f GB/s\n", restore_ms, page.data.size() / restore_ms / 1000000.0);
+}
+
+//********************************************************************************************************************
+
+int main(int argc, char **argv)
+{
+   const bool bench = (argc > 1) and (std::string_view(argv[1]) == "-bench");
+
+   test_round_trip();
+   test_sharing();
+
+   if (glFailures) {
+      printf("✗ %d tile storage checks failed.\n", glFailures);
+      return -1;
+   }
+
+   if (bench) benchmark();
+
+   printf("✓ Tiled bitmap storage restores the original image.\n");
+   return 0;
+}
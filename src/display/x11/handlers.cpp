@@ -1,5 +1,6 @@
 
 void process_movement(Window Window, int X, int Y);
+static void process_motion(const std::vector<XMotionEvent> &);
 
 static inline OBJECTID get_display(Window Window)
 {
@@ -25,18 +26,17 @@ void X11ManagerLoop(HOSTHANDLE FD, APTR Data)
 {
    pf::Log log("X11Mgr");
    XEvent xevent;
-   XEvent last_motion;
-   last_motion.xany.window = 0;
+   std::vector<XMotionEvent> motion;
 
    if (!XDisplay) return;
 
    while (XPending(XDisplay)) {
       XNextEvent(XDisplay, &xevent);
       //log.trace("Event %d", xevent.type);
-      if ((xevent.type != MotionNotify) and (last_motion.xany.window)) {
-         // Buffered MotionNotify event detected, process it now
-         process_movement(last_motion.xany.window, last_motion.xmotion.x_root, last_motion.xmotion.y_root);
-         last_motion.xany.window = 0;
+      if ((!motion.empty()) and ((xevent.type != MotionNotify) or (xevent.xmotion.window != motion.back().window))) {
+         // Buffered MotionNotify events detected, process them now
+         process_motion(motion);
+         motion.clear();
       }
 
       switch (xevent.type) {
@@ -51,8 +51,9 @@ void X11ManagerLoop(HOSTHANDLE FD, APTR Data)
 
          case MotionNotify:
             // Handling of motion events is delayed in case there is a long series of them
-            // (i.e. due to rapid pointer movement).
-            last_motion = xevent;
+            // (i.e. due to rapid pointer movement).  Every sample is kept so that the input
+            // history remains available to subscribers.
+            motion.push_back(xevent.xmotion);
             break;
 
          case FocusIn: {
@@ -138,6 +139,12 @@ void X11ManagerLoop(HOSTHANDLE FD, APTR Data)
                }
             }
             break;
+
+         default:
+            if ((glXShmCompletion) and (xevent.type IS glXShmCompletion)) {
+               x11_shm_completion((XShmCompletionEvent *)&xevent);
+            }
+            break;
       }
 
       #ifdef XRANDR_ENABLED
@@ -163,9 +170,7 @@ void X11ManagerLoop(HOSTHANDLE FD, APTR Data)
       #endif
    }
 
-   if (last_motion.xany.window) {
-      process_movement(last_motion.xany.window, last_motion.xmotion.x_root, last_motion.xmotion.y_root);
-   }
+   if (!motion.empty()) process_motion(motion);
 
    XFlush(XDisplay);
    if (XDisplay) XSync(XDisplay, False);
@@ -693,3 +698,38 @@ void process_movement(Window Window, int X, int Y)
    }
 }
 
+
+//********************************************************************************************************************
+// Feeds a series of buffered motion events from the same window to the pointer in a single call.  The X server time of
+// each event is used to backdate its timestamp relative to the most recent.
+
+static void process_motion(const std::vector<XMotionEvent> &Motion)
+{
+   if (auto pointer = gfx::AccessPointer()) {
+      auto &last = Motion.back();
+      pointer->HostX = last.x_root;
+      pointer->HostY = last.y_root;
+
+      if (auto display_id = get_display(last.window)) pointer->set(FID_Surface, GetOwnerID(display_id));
+
+      const auto now = PreciseTime();
+      std::vector<dcDeviceInput> input(Motion.size());
+      for (size_t i=0; i < Motion.size(); i++) {
+         input[i].Type      = JET::ABS_XY;
+         input[i].Flags     = JTYPE::NIL;
+         input[i].Values[0] = Motion[i].x_root;
+         input[i].Values[1] = Motion[i].y_root;
+         input[i].Timestamp = now - int64_t(uint32_t(last.time - Motion[i].time)) * 1000LL;
+      }
+
+      struct acDataFeed feed = {
+         .Object   = nullptr,
+         .Datatype = DATA::DEVICE_INPUT,
+         .Buffer   = input.data(),
+         .Size     = int(input.size() * sizeof(dcDeviceInput))
+      };
+      Action(AC::DataFeed, pointer, &feed);
+
+      ReleaseObject(pointer);
+   }
+}
@@ -0,0 +1,221 @@
+/*********************************************************************************************************************
+
+Asynchronous presentation of XImage buffers via the MIT-SHM extension.
+
+Each destination drawable is allocated a small ring of shared memory segments, sized to match the drawable so that
+sources of differing dimensions can be presented to it without reallocation.  An expose copies the affected area of
+the source bitmap into a free segment at the destination coordinates and posts it with XShmPutImage() with send_event
+enabled, then returns without waiting for the X server.  The segment is marked busy until the server's ShmCompletion event is received by the X11
+event handler, so the client can render the next frame while the previous one is being presented.  The client only
+blocks if every segment in the ring is still in use, which is recorded in the PresentStalls count of FrameStats.
+
+The owner of a drawable must call x11_free_presenter() before the drawable is destroyed or replaced.
+
+Staging the pixels also means that alpha channel bitmaps can be premultiplied in the segment rather than in place, so
+the source no longer needs to be demultiplied after an XSync() round trip.
+
+*********************************************************************************************************************/
+
+static constexpr int PRESENT_BUFFERS = 3;
+
+struct ShmBuffer {
+   XShmSegmentInfo Info;
+   XImage Image;
+   uint8_t *Data = nullptr;
+   bool Busy = false;
+};
+
+struct X11Presenter {
+   std::array<ShmBuffer, PRESENT_BUFFERS> Buffers;
+   int Width = 0, Height = 0, LineWidth = 0, Depth = 0, BitsPerPixel = 0;
+   int Next = 0;
+};
+
+static ankerl::unordered_dense::map<Drawable, X11Presenter> glPresenters;
+int glXShmCompletion = 0; // Event type for ShmCompletion events, or zero if MIT-SHM is unavailable
+int64_t glPresentStalls = 0; // Count of presentations that had to wait for the server to release a segment
+
+//********************************************************************************************************************
+// Called by the X11 event handler when the server has finished reading from a segment.
+
+void x11_shm_completion(XShmCompletionEvent *Event)
+{
+   if (auto it = glPresenters.find(Event->drawable); it != glPresenters.end()) {
+      for (auto &buffer : it->second.Buffers) {
+         if ((buffer.Data) and (buffer.Info.shmseg IS Event->shmseg)) {
+            buffer.Busy = false;
+            break;
+         }
+      }
+   }
+}
+
+//********************************************************************************************************************
+// Blocks until the server releases a segment that was posted to the given drawable.  Other events are left in the
+// queue for the X11 event handler.
+
+static Bool match_completion(Display *, XEvent *Event, XPointer Drawable)
+{
+   return (Event->type IS glXShmCompletion) and (((XShmCompletionEvent *)Event)->drawable IS (::Drawable)Drawable);
+}
+
+static void wait_for_release(Drawable Target)
+{
+   glPresentStalls++;
+   XEvent event;
+   XIfEvent(XDisplay, &event, match_completion, (XPointer)Target);
+   x11_shm_completion((XShmCompletionEvent *)&event);
+}
+
+//********************************************************************************************************************
+
+static void free_buffers(Drawable Target, X11Presenter &Presenter)
+{
+   bool attached = false;
+   for (auto &buffer : Presenter.Buffers) {
+      if (buffer.Data) {
+         XShmDetach(XDisplay, &buffer.Info);
+         attached = true;
+      }
+   }
+
+   if (!attached) return;
+
+   // The server must have detached from the segments before they can be released.  Any outstanding completion events
+   // for the drawable are discarded.
+
+   XSync(XDisplay, False);
+   XEvent event;
+   while (XCheckIfEvent(XDisplay, &event, match_completion, (XPointer)Target));
+
+   for (auto &buffer : Presenter.Buffers) {
+      if (buffer.Data) {
+         free_shm(buffer.Data, buffer.Info.shmid);
+         buffer.Data = nullptr;
+         buffer.Busy = false;
+      }
+   }
+}
+
+void x11_free_presenter(Drawable Target)
+{
+   if (auto it = glPresenters.find(Target); it != glPresenters.end()) {
+      free_buffers(Target, it->second);
+      glPresenters.erase(it);
+   }
+}
+
+void x11_free_presenters(void)
+{
+   for (auto &[drawable, presenter] : glPresenters) free_buffers(drawable, presenter);
+   glPresenters.clear();
+}
+
+//********************************************************************************************************************
+// (Re)allocates the segments of a presenter to cover an area of Width x Height, using the pixel layout of the source.
+
+static ERR alloc_buffers(X11Presenter &Presenter, extBitmap *Source, int Width, int Height)
+{
+   pf::Log log(__FUNCTION__);
+
+   log.trace("Allocating %d segments of %dx%d for presentation.", PRESENT_BUFFERS, Width, Height);
+
+   const int line_width = ((Width * Source->BytesPerPixel) + 3) & (~3);
+
+   for (auto &buffer : Presenter.Buffers) {
+      if (alloc_shm(line_width * Height, &buffer.Data, &buffer.Info.shmid) != ERR::Okay) {
+         return ERR::AllocMemory;
+      }
+
+      buffer.Info.shmaddr  = (char *)buffer.Data;
+      buffer.Info.readOnly = True;
+      if (!XShmAttach(XDisplay, &buffer.Info)) {
+         free_shm(buffer.Data, buffer.Info.shmid);
+         buffer.Data = nullptr;
+         return log.warning(ERR::SystemCall);
+      }
+
+      buffer.Image                = Source->x11.ximage; // Inherit the pixel format of the source
+      buffer.Image.width          = Width;
+      buffer.Image.height         = Height;
+      buffer.Image.bytes_per_line = line_width;
+      buffer.Image.data           = (char *)buffer.Data;
+      buffer.Image.obdata         = (char *)&buffer.Info;
+      buffer.Busy = false;
+   }
+
+   Presenter.Width        = Width;
+   Presenter.Height       = Height;
+   Presenter.LineWidth    = line_width;
+   Presenter.Depth        = Source->x11.ximage.depth;
+   Presenter.BitsPerPixel = Source->x11.ximage.bits_per_pixel;
+   Presenter.Next         = 0;
+   return ERR::Okay;
+}
+
+//********************************************************************************************************************
+// Copies an area of Source to the drawable of Dest without waiting for the X server.  Returns NoSupport if the
+// presentation path is unavailable, in which case the caller should fall back to a synchronous XPutImage().
+
+ERR x11_present(extBitmap *Source, extBitmap *Dest, int X, int Y, int Width, int Height, int DestX, int DestY)
+{
+   if ((!glXShmCompletion) or (!Source->x11.XShmImage) or (!Dest->x11.drawable)) return ERR::NoSupport;
+   if ((Width < 1) or (Height < 1)) return ERR::Okay;
+
+   if ((DestX < 0) or (DestY < 0)) return ERR::NoSupport;
+
+   // The segments are sized to the drawable rather than the source, so that every source presented to the drawable can
+   // share them.  They are only reallocated if the drawable grows or the pixel format changes.
+
+   const int width  = std::max(Dest->Width, DestX + Width);
+   const int height = std::max(Dest->Height, DestY + Height);
+
+   auto &presenter = glPresenters[Dest->x11.drawable];
+
+   if ((presenter.Width != width) or (presenter.Height != height) or
+       (presenter.Depth != Source->x11.ximage.depth) or (presenter.BitsPerPixel != Source->x11.ximage.bits_per_pixel)) {
+      free_buffers(Dest->x11.drawable, presenter);
+      if (alloc_buffers(presenter, Source, width, height) != ERR::Okay) {
+         free_buffers(Dest->x11.drawable, presenter);
+         glPresenters.erase(Dest->x11.drawable);
+         return ERR::NoSupport;
+      }
+   }
+
+   // Select the next free segment, waiting for the server to release one if necessary.
+
+   int index = -1;
+   while (index IS -1) {
+      for (int i=0; i < PRESENT_BUFFERS; i++) {
+         auto n = (presenter.Next + i) % PRESENT_BUFFERS;
+         if (!presenter.Buffers[n].Busy) { index = n; break; }
+      }
+      if (index IS -1) wait_for_release(Dest->x11.drawable);
+   }
+
+   auto &buffer = presenter.Buffers[index];
+   presenter.Next = (index + 1) % PRESENT_BUFFERS;
+
+   // Stage the area in the segment at the destination coordinates, premultiplying alpha channel data as required by
+   // the X server.
+
+   const auto bpp = Source->BytesPerPixel;
+   auto src  = Source->Data + (Y * Source->LineWidth) + (X * bpp);
+   auto dest = buffer.Data + (DestY * presenter.LineWidth) + (DestX * bpp);
+
+   if (((Source->Flags & BMF::ALPHA_CHANNEL) != BMF::NIL) and ((Source->Flags & BMF::PREMUL) IS BMF::NIL) and (bpp IS 4)) {
+      const uint8_t A = Source->ColourFormat->AlphaPos>>3;
+      for (int y=0; y < Height; y++, src += Source->LineWidth, dest += presenter.LineWidth) {
+         pixel_convert::premultiply_row(src, dest, Width, A);
+      }
+   }
+   else {
+      for (int y=0; y < Height; y++, src += Source->LineWidth, dest += presenter.LineWidth) {
+         copymem(src, dest, Width * bpp);
+      }
+   }
+
+   XShmPutImage(XDisplay, Dest->x11.drawable, Dest->getGC(), &buffer.Image, DestX, DestY, DestX, DestY, Width, Height, True);
+   buffer.Busy = true;
+   return ERR::Okay;
+}
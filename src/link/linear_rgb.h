@@ -22,15 +22,58 @@ private:
       return (ix < 0) ? 0 : (ix > 255) ? 255 : ix;
    }
 
+   // Applies a conversion table to the colour channels of a row of 32-bit pixels.  Pixels with an alpha value of zero
+   // are skipped; set A to 0xff if the pixels have no alpha channel.
+   //
+   // The table lookup is faster than the vectorised alternatives that have been measured on x86 (PSHUFB lookups and
+   // polynomial evaluation with SSE2 or AVX2), so there is no SIMD path.
+
+   static void apply_row(const uint8_t *Table, uint8_t *Pixel, int Width, uint8_t R, uint8_t G, uint8_t B, uint8_t A) noexcept {
+      if (A IS 0xff) {
+         for (; Width > 0; Width--, Pixel += 4) {
+            Pixel[R] = Table[Pixel[R]];
+            Pixel[G] = Table[Pixel[G]];
+            Pixel[B] = Table[Pixel[B]];
+         }
+      }
+      else {
+         for (; Width > 0; Width--, Pixel += 4) {
+            if (Pixel[A]) {
+               Pixel[R] = Table[Pixel[R]];
+               Pixel[G] = Table[Pixel[G]];
+               Pixel[B] = Table[Pixel[B]];
+            }
+         }
+      }
+   }
+
 public:
    inline rgb_to_linear() {
       // Initialise conversion tables
       for (int i=0; i < 256; i++) {
          r2l[i] = conv_r2l((double)i * (1.0 / 255.0));
          l2r[i] = conv_l2r((double)i * (1.0 / 255.0));
+         identity[i] = i;
       }
    }
 
+   // Row conversion for 32-bit pixels, refer to apply_row() for the parameters.
+
+   inline void convert_row(uint8_t *Pixel, int Width, uint8_t R, uint8_t G, uint8_t B, uint8_t A) const noexcept {
+      apply_row(r2l, Pixel, Width, R, G, B, A);
+   }
+
+   inline void invert_row(uint8_t *Pixel, int Width, uint8_t R, uint8_t G, uint8_t B, uint8_t A) const noexcept {
+      apply_row(l2r, Pixel, Width, R, G, B, A);
+   }
+
+   // Returns a table that decodes colour values to linear RGB, for input that is either sRGB or already linear.
+   // Allows linear input to be consumed without a separate conversion pass.
+
+   inline constexpr const uint8_t * decode_table(bool Linear) const {
+      return Linear ? identity : r2l;
+   }
+
    inline constexpr uint8_t convert(const uint8_t Colour) { // RGB to linear
       return r2l[Colour];
    }
@@ -84,6 +127,7 @@ public:
 private:
    uint8_t r2l[256];
    uint8_t l2r[256];
+   uint8_t identity[256];
 };
 
 extern rgb_to_linear glLinearRGB;
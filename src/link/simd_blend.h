@@ -0,0 +1,408 @@
+// SIMD span blenders for 32-bit pixels, shared by the Display and Vector modules.  The kernels are exact replacements
+// for the scalar source-over arithmetic that is used throughout the framework:
+//
+//   dest.c = ((src.c * a) + (dest.c * (255 - a)) + 255) >> 8
+//   dest.a = 255 - (((255 - a) * (255 - dest.a)) >> 8)
+//
+// SSE2 is the baseline on x64 and an AVX2 variant is selected at runtime if the CPU supports it (GCC and Clang only, as
+// the AVX2 code is compiled with a target attribute).  AArch64 targets use NEON, and all other targets fall back to the
+// scalar implementation.
+//
+// To include: #include "../link/simd_blend.h"
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#ifndef IS
+#define IS ==
+#endif
+
+#if defined(__SSE2__) or defined(_M_X64) or defined(_M_AMD64)
+   #include <emmintrin.h>
+   #define SIMD_BLEND_SSE2
+   #if defined(__GNUC__) and (defined(__x86_64__) or defined(__i386__))
+      #include <immintrin.h>
+      #define SIMD_BLEND_AVX2
+   #endif
+#elif defined(__aarch64__)
+   #include <arm_neon.h>
+   #define SIMD_BLEND_NEON
+#endif
+
+namespace simd_blend {
+
+enum class ISA : uint8_t { SCALAR, SSE2, AVX2, NEON };
+
+// Byte offsets of the colour channels within a pixel.
+
+struct offsets {
+   uint8_t r, g, b, a;
+};
+
+// A horizontal span of pixels to blend.  The effective alpha of each source pixel is scaled by its coverage value
+// before it is applied.
+
+struct span {
+   uint8_t *dest;           // Destination pixels
+   const uint8_t *src;      // Source pixels, or a single pixel if step is zero
+   const uint8_t *covers;   // Per-pixel coverage, or nullptr to apply 'cover' to every pixel
+   uint32_t count;          // Total number of pixels
+   uint8_t step;            // Bytes between source pixels; 4, or 0 for a solid colour
+   uint8_t cover;
+   bool cover_plus_one;     // Alpha is scaled as (a * (cover + 1)) >> 8 if true, otherwise (a * cover + 255) >> 8
+   bool skip_clear;         // The destination is unchanged where the source alpha is zero
+   bool copy_empty;         // The scaled source is copied where the destination alpha is zero
+   bool copy_first;         // copy_empty takes precedence over skip_clear
+};
+
+typedef void (*span_fn)(const span &) noexcept;
+
+inline uint32_t load32(const void *Data) noexcept
+{
+   uint32_t value;
+   memcpy(&value, Data, sizeof(value));
+   return value;
+}
+
+//********************************************************************************************************************
+// P0-P3 give the source byte for each destination byte, and AI is the byte offset of alpha in the destination.
+
+template <int P0, int P1, int P2, int P3, int AI>
+inline void blend_pixel(uint8_t *D, const uint8_t *S, uint8_t Cover, const span &Span) noexcept
+{
+   constexpr int p[4] = { P0, P1, P2, P3 };
+   const uint8_t sa = S[p[AI]];
+   const bool copy = (Span.copy_empty) and (!D[AI]);
+   if ((Span.skip_clear) and (!sa) and ((!copy) or (!Span.copy_first))) return;
+
+   const uint8_t a = ((sa * Cover) + (Span.cover_plus_one ? sa : 0xff))>>8;
+   if (copy) {
+      for (int i=0; i < 4; i++) D[i] = (i IS AI) ? a : S[p[i]];
+   }
+   else {
+      const uint8_t ia = 0xff - a;
+      for (int i=0; i < 4; i++) {
+         if (i != AI) D[i] = ((S[p[i]] * a) + (D[i] * ia) + 0xff)>>8;
+      }
+      D[AI] = 0xff - ((ia * (0xff - D[AI]))>>8);
+   }
+}
+
+template <int P0, int P1, int P2, int P3, int AI>
+inline void blend_tail(uint8_t *D, const uint8_t *S, const uint8_t *Covers, uint32_t Count, const span &Span) noexcept
+{
+   for (; Count; Count--) {
+      blend_pixel<P0,P1,P2,P3,AI>(D, S, Covers ? *Covers++ : Span.cover, Span);
+      D += 4;
+      S += Span.step;
+   }
+}
+
+template <int P0, int P1, int P2, int P3, int AI>
+void span_scalar(const span &Span) noexcept
+{
+   blend_tail<P0,P1,P2,P3,AI>(Span.dest, Span.src, Span.covers, Span.count, Span);
+}
+
+//********************************************************************************************************************
+// The SSE2 and AVX2 kernels widen each pixel to four 16-bit lanes.  The alpha lane is computed with the colour lanes
+// by blending (255 - dest.a) with zero and inverting the result, which reproduces the scalar alpha formula.
+
+#ifdef SIMD_BLEND_SSE2
+
+template <int P0, int P1, int P2, int P3, int AI>
+void span_sse2(const span &Span) noexcept
+{
+   constexpr int SHUFFLE = (P3<<6)|(P2<<4)|(P1<<2)|P0;
+   constexpr int ALPHA   = (AI<<6)|(AI<<4)|(AI<<2)|AI;
+
+   const __m128i zero       = _mm_setzero_si128();
+   const __m128i k255       = _mm_set1_epi16(0xff);
+   const __m128i alpha_mask = _mm_set_epi64x(0xffffll << (AI * 16), 0xffffll << (AI * 16));
+   const __m128i alpha_255  = _mm_and_si128(alpha_mask, k255);
+   const __m128i round      = _mm_andnot_si128(alpha_mask, k255);
+   const __m128i bias       = Span.cover_plus_one ? zero : k255;
+   const __m128i extra      = _mm_set1_epi32(Span.cover_plus_one ? 1 : 0);
+   const __m128i skip_clear = Span.skip_clear ? _mm_cmpeq_epi16(zero, zero) : zero;
+   const __m128i copy_empty = Span.copy_empty ? _mm_cmpeq_epi16(zero, zero) : zero;
+   const __m128i copy_first = Span.copy_first ? _mm_cmpeq_epi16(zero, zero) : zero;
+   const __m128i cover      = _mm_set1_epi16(Span.cover + (Span.cover_plus_one ? 1 : 0));
+   const __m128i solid      = _mm_set1_epi32(load32(Span.src));
+
+   auto select = [](__m128i Mask, __m128i A, __m128i B) {
+      return _mm_or_si128(_mm_and_si128(Mask, A), _mm_andnot_si128(Mask, B));
+   };
+
+   // Blends two pixels that have been widened to 16-bit lanes.
+
+   auto blend = [&](__m128i S, __m128i D, __m128i M) {
+      S = _mm_shufflehi_epi16(_mm_shufflelo_epi16(S, SHUFFLE), SHUFFLE);
+      const __m128i sa = _mm_shufflehi_epi16(_mm_shufflelo_epi16(S, ALPHA), ALPHA);
+      const __m128i da = _mm_shufflehi_epi16(_mm_shufflelo_epi16(D, ALPHA), ALPHA);
+      const __m128i a  = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(sa, M), bias), 8);
+      const __m128i sc = _mm_andnot_si128(alpha_mask, S);
+
+      __m128i result = _mm_add_epi16(_mm_mullo_epi16(sc, a), _mm_mullo_epi16(_mm_xor_si128(D, alpha_255), _mm_sub_epi16(k255, a)));
+      result = _mm_xor_si128(_mm_srli_epi16(_mm_add_epi16(result, round), 8), alpha_255);
+
+      const __m128i skip = _mm_and_si128(skip_clear, _mm_cmpeq_epi16(sa, zero));
+      const __m128i copy = _mm_and_si128(copy_empty, _mm_cmpeq_epi16(da, zero));
+      result = select(_mm_andnot_si128(_mm_andnot_si128(copy_first, skip), copy), _mm_or_si128(sc, _mm_and_si128(alpha_mask, a)), result);
+      return select(_mm_andnot_si128(_mm_and_si128(copy_first, copy), skip), D, result);
+   };
+
+   uint8_t *d = Span.dest;
+   const uint8_t *s = Span.src;
+   const uint8_t *c = Span.covers;
+   uint32_t n = Span.count;
+   for (; n >= 4; n -= 4) {
+      const __m128i src  = Span.step ? _mm_loadu_si128((const __m128i *)s) : solid;
+      const __m128i dest = _mm_loadu_si128((const __m128i *)d);
+
+      __m128i m_lo = cover, m_hi = cover;
+      if (c) {
+         __m128i m = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(load32(c)), zero), zero);
+         m = _mm_add_epi32(m, extra);
+         m = _mm_or_si128(m, _mm_slli_epi32(m, 16));
+         m_lo = _mm_unpacklo_epi32(m, m);
+         m_hi = _mm_unpackhi_epi32(m, m);
+         c += 4;
+      }
+
+      const __m128i lo = blend(_mm_unpacklo_epi8(src, zero), _mm_unpacklo_epi8(dest, zero), m_lo);
+      const __m128i hi = blend(_mm_unpackhi_epi8(src, zero), _mm_unpackhi_epi8(dest, zero), m_hi);
+      _mm_storeu_si128((__m128i *)d, _mm_packus_epi16(lo, hi));
+      d += 16;
+      s += Span.step * 4;
+   }
+
+   blend_tail<P0,P1,P2,P3,AI>(d, s, c, n, Span);
+}
+
+#endif
+
+#ifdef SIMD_BLEND_AVX2
+
+template <int P0, int P1, int P2, int P3, int AI>
+__attribute__((target("avx2"))) void span_avx2(const span &Span) noexcept
+{
+   constexpr int SHUFFLE = (P3<<6)|(P2<<4)|(P1<<2)|P0;
+   constexpr int ALPHA   = (AI<<6)|(AI<<4)|(AI<<2)|AI;
+
+   const __m256i zero       = _mm256_setzero_si256();
+   const __m256i ones       = _mm256_cmpeq_epi16(zero, zero);
+   const __m256i k255       = _mm256_set1_epi16(0xff);
+   const __m256i alpha_mask = _mm256_set1_epi64x(0xffffll << (AI * 16));
+   const __m256i alpha_255  = _mm256_and_si256(alpha_mask, k255);
+   const __m256i round      = _mm256_andnot_si256(alpha_mask, k255);
+   const __m256i bias       = Span.cover_plus_one ? zero : k255;
+   const __m256i extra      = _mm256_set1_epi32(Span.cover_plus_one ? 1 : 0);
+   const __m256i skip_clear = Span.skip_clear ? ones : zero;
+   const __m256i copy_empty = Span.copy_empty ? ones : zero;
+   const __m256i copy_first = Span.copy_first ? ones : zero;
+   const __m256i cover      = _mm256_set1_epi16(Span.cover + (Span.cover_plus_one ? 1 : 0));
+   const __m256i solid      = _mm256_set1_epi32(load32(Span.src));
+
+   auto blend = [&](__m256i S, __m256i D, __m256i M) __attribute__((target("avx2"))) {
+      S = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(S, SHUFFLE), SHUFFLE);
+      const __m256i sa = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(S, ALPHA), ALPHA);
+      const __m256i da = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(D, ALPHA), ALPHA);
+      const __m256i a  = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(sa, M), bias), 8);
+      const __m256i sc = _mm256_andnot_si256(alpha_mask, S);
+
+      __m256i result = _mm256_add_epi16(_mm256_mullo_epi16(sc, a), _mm256_mullo_epi16(_mm256_xor_si256(D, alpha_255), _mm256_sub_epi16(k255, a)));
+      result = _mm256_xor_si256(_mm256_srli_epi16(_mm256_add_epi16(result, round), 8), alpha_255);
+
+      const __m256i skip = _mm256_and_si256(skip_clear, _mm256_cmpeq_epi16(sa, zero));
+      const __m256i copy = _mm256_and_si256(copy_empty, _mm256_cmpeq_epi16(da, zero));
+      result = _mm256_blendv_epi8(result, _mm256_or_si256(sc, _mm256_and_si256(alpha_mask, a)), _mm256_andnot_si256(_mm256_andnot_si256(copy_first, skip), copy));
+      return _mm256_blendv_epi8(result, D, _mm256_andnot_si256(_mm256_and_si256(copy_first, copy), skip));
+   };
+
+   uint8_t *d = Span.dest;
+   const uint8_t *s = Span.src;
+   const uint8_t *c = Span.covers;
+   uint32_t n = Span.count;
+   for (; n >= 8; n -= 8) {
+      const __m256i src  = Span.step ? _mm256_loadu_si256((const __m256i *)s) : solid;
+      const __m256i dest = _mm256_loadu_si256((const __m256i *)d);
+
+      __m256i m_lo = cover, m_hi = cover;
+      if (c) { // Coverage values for pixels 0-3 and 4-7 are placed in the low and high 128-bit lanes respectively.
+         __m256i m = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)c));
+         m = _mm256_add_epi32(m, extra);
+         m = _mm256_or_si256(m, _mm256_slli_epi32(m, 16));
+         m_lo = _mm256_unpacklo_epi32(m, m);
+         m_hi = _mm256_unpackhi_epi32(m, m);
+         c += 8;
+      }
+
+      const __m256i lo = blend(_mm256_unpacklo_epi8(src, zero), _mm256_unpacklo_epi8(dest, zero), m_lo);
+      const __m256i hi = blend(_mm256_unpackhi_epi8(src, zero), _mm256_unpackhi_epi8(dest, zero), m_hi);
+      _mm256_storeu_si256((__m256i *)d, _mm256_packus_epi16(lo, hi));
+      d += 32;
+      s += Span.step * 8;
+   }
+
+   blend_tail<P0,P1,P2,P3,AI>(d, s, c, n, Span);
+}
+
+#endif
+
+//********************************************************************************************************************
+// The NEON kernel keeps the pixels in 8-bit lanes and widens only for the multiplications.
+
+#ifdef SIMD_BLEND_NEON
+
+template <int P0, int P1, int P2, int P3, int AI>
+void span_neon(const span &Span) noexcept
+{
+   const uint8_t perm_table[16]  = { P0, P1, P2, P3, P0+4, P1+4, P2+4, P3+4, P0+8, P1+8, P2+8, P3+8, P0+12, P1+12, P2+12, P3+12 };
+   const uint8_t alpha_table[16] = { AI, AI, AI, AI, AI+4, AI+4, AI+4, AI+4, AI+8, AI+8, AI+8, AI+8, AI+12, AI+12, AI+12, AI+12 };
+   const uint8_t cover_table[16] = { 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3 };
+   uint8_t mask_table[16] = { };
+   for (int i=AI; i < 16; i += 4) mask_table[i] = 0xff;
+
+   const uint8x16_t perm       = vld1q_u8(perm_table);
+   const uint8x16_t alpha_idx  = vld1q_u8(alpha_table);
+   const uint8x16_t cover_idx  = vld1q_u8(cover_table);
+   const uint8x16_t alpha_mask = vld1q_u8(mask_table);
+   const uint8x16_t zero       = vdupq_n_u8(0);
+   const uint16x8_t k255       = vdupq_n_u16(0xff);
+   const uint8x16_t round      = vbicq_u8(vdupq_n_u8(0xff), alpha_mask);
+   const uint8x16_t skip_clear = vdupq_n_u8(Span.skip_clear ? 0xff : 0);
+   const uint8x16_t copy_empty = vdupq_n_u8(Span.copy_empty ? 0xff : 0);
+   const uint8x16_t copy_first = vdupq_n_u8(Span.copy_first ? 0xff : 0);
+   const uint8x16_t solid      = vreinterpretq_u8_u32(vdupq_n_u32(load32(Span.src)));
+
+   uint8_t *d = Span.dest;
+   const uint8_t *s = Span.src;
+   const uint8_t *c = Span.covers;
+   uint32_t n = Span.count;
+   for (; n >= 4; n -= 4) {
+      const uint8x16_t src  = vqtbl1q_u8(Span.step ? vld1q_u8(s) : solid, perm);
+      const uint8x16_t dest = vld1q_u8(d);
+      const uint8x16_t sa   = vqtbl1q_u8(src, alpha_idx);
+      const uint8x16_t da   = vqtbl1q_u8(dest, alpha_idx);
+
+      uint8x16_t m;
+      if (c) {
+         m = vqtbl1q_u8(vreinterpretq_u8_u32(vdupq_n_u32(load32(c))), cover_idx);
+         c += 4;
+      }
+      else m = vdupq_n_u8(Span.cover);
+
+      uint16x8_t a_lo = vmull_u8(vget_low_u8(sa), vget_low_u8(m));
+      uint16x8_t a_hi = vmull_high_u8(sa, m);
+      if (Span.cover_plus_one) {
+         a_lo = vaddw_u8(a_lo, vget_low_u8(sa));
+         a_hi = vaddw_high_u8(a_hi, sa);
+      }
+      else {
+         a_lo = vaddq_u16(a_lo, k255);
+         a_hi = vaddq_u16(a_hi, k255);
+      }
+      const uint8x16_t a  = vcombine_u8(vshrn_n_u16(a_lo, 8), vshrn_n_u16(a_hi, 8));
+      const uint8x16_t ia = vmvnq_u8(a);
+      const uint8x16_t sc = vbicq_u8(src, alpha_mask);
+      const uint8x16_t dc = veorq_u8(dest, alpha_mask);
+
+      uint16x8_t r_lo = vmlal_u8(vmull_u8(vget_low_u8(sc), vget_low_u8(a)), vget_low_u8(dc), vget_low_u8(ia));
+      uint16x8_t r_hi = vmlal_high_u8(vmull_high_u8(sc, a), dc, ia);
+      r_lo = vaddw_u8(r_lo, vget_low_u8(round));
+      r_hi = vaddw_high_u8(r_hi, round);
+      uint8x16_t result = veorq_u8(vcombine_u8(vshrn_n_u16(r_lo, 8), vshrn_n_u16(r_hi, 8)), alpha_mask);
+
+      const uint8x16_t skip = vandq_u8(skip_clear, vceqq_u8(sa, zero));
+      const uint8x16_t copy = vandq_u8(copy_empty, vceqq_u8(da, zero));
+      result = vbslq_u8(vbicq_u8(copy, vbicq_u8(skip, copy_first)), vbslq_u8(alpha_mask, a, src), result);
+      result = vbslq_u8(vbicq_u8(skip, vandq_u8(copy, copy_first)), dest, result);
+      vst1q_u8(d, result);
+
+      d += 16;
+      s += Span.step * 4;
+   }
+
+   blend_tail<P0,P1,P2,P3,AI>(d, s, c, n, Span);
+}
+
+#endif
+
+//********************************************************************************************************************
+
+inline bool isa_supported(ISA Isa) noexcept
+{
+   switch (Isa) {
+      case ISA::SCALAR: return true;
+#ifdef SIMD_BLEND_SSE2
+      case ISA::SSE2: return true;
+#endif
+#ifdef SIMD_BLEND_AVX2
+      case ISA::AVX2: return __builtin_cpu_supports("avx2");
+#endif
+#ifdef SIMD_BLEND_NEON
+      case ISA::NEON: return true;
+#endif
+      default: return false;
+   }
+}
+
+inline ISA best_isa() noexcept
+{
+   static const ISA isa = []() {
+      if (isa_supported(ISA::AVX2)) return ISA::AVX2;
+      if (isa_supported(ISA::SSE2)) return ISA::SSE2;
+      if (isa_supported(ISA::NEON)) return ISA::NEON;
+      return ISA::SCALAR;
+   }();
+   return isa;
+}
+
+template <int P0, int P1, int P2, int P3, int AI>
+span_fn select_kernel(ISA Isa) noexcept
+{
+   switch (Isa) {
+#ifdef SIMD_BLEND_SSE2
+      case ISA::SSE2: return &span_sse2<P0,P1,P2,P3,AI>;
+#endif
+#ifdef SIMD_BLEND_AVX2
+      case ISA::AVX2: return &span_avx2<P0,P1,P2,P3,AI>;
+#endif
+#ifdef SIMD_BLEND_NEON
+      case ISA::NEON: return &span_neon<P0,P1,P2,P3,AI>;
+#endif
+      default: return &span_scalar<P0,P1,P2,P3,AI>;
+   }
+}
+
+//********************************************************************************************************************
+// Returns a source-over kernel for the given source and destination channel layouts, or nullptr if the combination
+// or the instruction set is not supported.  Kernels are instantiated for the layouts that the framework uses: matching
+// layouts with alpha in the first or last byte, and RGBA sources blended to any of the four 32-bit formats.
+
+inline span_fn src_over(const offsets Src, const offsets Dest, ISA Isa = best_isa()) noexcept
+{
+   if (!isa_supported(Isa)) return nullptr;
+
+   uint8_t perm[4];
+   perm[Dest.r & 3] = Src.r;
+   perm[Dest.g & 3] = Src.g;
+   perm[Dest.b & 3] = Src.b;
+   perm[Dest.a & 3] = Src.a;
+
+   const uint32_t key = (perm[0]<<12) | (perm[1]<<8) | (perm[2]<<4) | perm[3];
+   if (Dest.a IS 3) {
+      if (key IS 0x0123) return select_kernel<0,1,2,3,3>(Isa);
+      if (key IS 0x2103) return select_kernel<2,1,0,3,3>(Isa);
+   }
+   else if (Dest.a IS 0) {
+      if (key IS 0x0123) return select_kernel<0,1,2,3,0>(Isa);
+      if (key IS 0x3120) return select_kernel<3,1,2,0,0>(Isa);
+      if (key IS 0x3012) return select_kernel<3,0,1,2,0>(Isa);
+   }
+   return nullptr;
+}
+
+} // namespace simd_blend
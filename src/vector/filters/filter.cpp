@@ -21,7 +21,9 @@ in which they are added.  It is most optimal to create each pipeline in advance,
 be created for each pipeline as necessary.
 
 It is important to note that filter effects are CPU intensive tasks and real-time performance may be disappointing.
-If this is an issue, consider pre-rendering the filter effects in advance and caching the results in memory or files.
+To mitigate this, the output of a filter is cached by the scene when the client vector and the filter's
+configuration remain unchanged between frames.  Filters that use the background as an input, or that reference other
+vectors via @SourceFX, are always re-rendered.
 
 It is a requirement that VectorFilter objects are owned by the @VectorScene they are targeting.
 
@@ -37,7 +39,8 @@ struct target {
    double x, y, width, height;
 };
 
-static ERR get_source_bitmap(extVectorFilter *, objBitmap **, VSF, objFilterEffect *, bool);
+static ERR get_source_bitmap(extVectorFilter *, objBitmap **, VSF, objFilterEffect *, bool, CS = CS::SRGB);
+static void set_colour_space(objBitmap *, CS);
 
 //********************************************************************************************************************
 // Universal function for rendering a filter's Bitmap to the target region.
@@ -120,6 +123,27 @@ template <class T> void render_to_filter(T *Self, objBitmap *Bitmap, ARF AspectR
    else gfx::CopyArea(Bitmap, Self->Target, BAF::NIL, 0, 0, Bitmap->Width, Bitmap->Height, -img_transform.tx, -img_transform.ty);
 }
 
+//********************************************************************************************************************
+// SIMD support for the effect kernels.  SSE2 is guaranteed on x64 targets; AVX2 kernels are only compiled in if the
+// compiler has been configured to target it.
+
+#if defined(__SSE2__) or defined(_M_X64) or defined(_M_AMD64)
+   #include <emmintrin.h>
+   #define FX_SSE2
+   #ifdef __SSE4_1__
+      #include <smmintrin.h>
+   #endif
+   #ifdef __AVX2__
+      #include <immintrin.h>
+      #define FX_AVX2
+   #endif
+#elif defined(__ARM_NEON) or defined(__aarch64__)
+   #include <arm_neon.h>
+   #define FX_NEON
+#endif
+
+#include <bs_thread_pool.h>
+
 //********************************************************************************************************************
 
 #include "filter_effect.cpp"
@@ -196,41 +220,64 @@ static void compute_target_area(extVectorFilter *Self)
 }
 
 //********************************************************************************************************************
-// Return a bitmap from the bank.  In order to save memory, bitmap data is managed internally so that it always
-// reflects the size of the clipping region.  The bitmap's size reflects the Filter's (X,Y), (Width,Height) values in
-// accordance with the unit setting.
+// Return a bitmap from the scene's filter bank.  In order to save memory, bitmap data is managed internally so that
+// it always reflects the size of the clipping region, and the buffers are shared with all other filters in the scene.
+// The bitmap's coordinate system reflects the page, so effects can continue to work in absolute coordinates.
+//
+// Bitmaps are returned to the bank by the scene renderer once the filter output has been composited.
 
-static ERR get_banked_bitmap(extVectorFilter *Self, objBitmap **BitmapResult)
+static ERR get_banked_bitmap(extVectorFilter *Self, objBitmap **BitmapResult, bool Clear = false)
 {
    pf::Log log(__FUNCTION__);
 
-   auto bi = Self->BankIndex;
-   if (bi >= 255) return log.warning(ERR::ArrayFull);
+   auto scene = (extVectorScene *)Self->ClientViewport->Scene;
+   auto &bank = scene->FilterBank;
+   if (bank.Index >= 255) return log.warning(ERR::ArrayFull);
 
-   if (bi >= Self->Bank.size()) Self->Bank.emplace_back(std::make_unique<filter_bitmap>());
+   pf::SwitchContext ctx(scene); // Bitmaps belong to the scene, not the filter.
+   auto fb = bank.acquire();
 
    #ifdef DEBUG_FILTER_BITMAP
-      auto bmp = Self->Bank[bi].get()->get_bitmap(Self->ClientViewport->Scene->PageWidth, Self->ClientViewport->Scene->PageHeight, Self->VectorClip, true);
+      auto bmp = fb->get_bitmap(scene->PageWidth, scene->PageHeight, Self->VectorClip, true);
    #else
-      auto bmp = Self->Bank[bi].get()->get_bitmap(Self->ClientViewport->Scene->PageWidth, Self->ClientViewport->Scene->PageHeight, Self->VectorClip, false);
+      auto bmp = fb->get_bitmap(scene->PageWidth, scene->PageHeight, Self->VectorClip, false);
    #endif
 
    if (bmp) {
       bmp->ColourSpace = CS::SRGB;
+      bmp->BlendMode = BLM::AUTO;
       bmp->Flags &= ~BMF::PREMUL;
+      if (Clear) fb->clear();
       *BitmapResult = bmp;
-      Self->BankIndex++;
       return ERR::Okay;
    }
    else return log.warning(ERR::CreateObject);
 }
 
+//********************************************************************************************************************
+// Converts a filter bitmap to the given colour space if it is not already in it.  Effect output can be left in linear
+// RGB when it is only consumed by other effects, so this is where redundant sRGB round trips are avoided.  Conversion
+// has to operate on normalised colour values, so premultiplied content is demultiplied first.
+
+static void set_colour_space(objBitmap *Bitmap, CS Space)
+{
+   if ((Space IS CS::NIL) or (Bitmap->ColourSpace IS Space)) return;
+
+   if ((Bitmap->Flags & BMF::PREMUL) != BMF::NIL) Bitmap->demultiply();
+
+   if (Space IS CS::LINEAR_RGB) Bitmap->convertToLinear();
+   else Bitmap->convertToRGB();
+}
+
 //********************************************************************************************************************
 // Returns a rendered bitmap that represents the source.  Where possible, if a bitmap is being referenced then that
 // reference will be returned.  Otherwise a new bitmap is allocated and rendered with the effect.  The bitmap must
 // not be freed as they are permanently maintained until the VectorFilter is destroyed.
+//
+// The bitmap is converted to the requested colour Space if necessary.  Effects that can consume either colour space
+// directly use CS::NIL and check the ColourSpace of the result.
 
-static ERR get_source_bitmap(extVectorFilter *Self, objBitmap **BitmapResult, VSF SourceType, objFilterEffect *Effect, bool Premultiply)
+static ERR get_source_bitmap(extVectorFilter *Self, objBitmap **BitmapResult, VSF SourceType, objFilterEffect *Effect, bool Premultiply, CS Space)
 {
    pf::Log log(__FUNCTION__);
 
@@ -271,7 +318,7 @@ static ERR get_source_bitmap(extVectorFilter *Self, objBitmap **BitmapResult, VS
       //
       // Refer to enable-background support in scene_draw.cpp
 
-      if (auto error = get_banked_bitmap(Self, &bmp); error != ERR::Okay) return log.warning(error);
+      if (auto error = get_banked_bitmap(Self, &bmp, true); error != ERR::Okay) return log.warning(error);
 
       if ((Self->BkgdBitmap) and ((Self->BkgdBitmap->Flags & BMF::ALPHA_CHANNEL) != BMF::NIL)) {
          gfx::CopyArea(Self->BkgdBitmap, bmp, BAF::NIL, Self->VectorClip.left, Self->VectorClip.top,
@@ -280,7 +327,7 @@ static ERR get_source_bitmap(extVectorFilter *Self, objBitmap **BitmapResult, VS
       }
    }
    else if (SourceType IS VSF::BKGD_ALPHA) {
-      if (auto error = get_banked_bitmap(Self, &bmp); error != ERR::Okay) return log.warning(error);
+      if (auto error = get_banked_bitmap(Self, &bmp, true); error != ERR::Okay) return log.warning(error);
       if ((Self->BkgdBitmap) and ((Self->BkgdBitmap->Flags & BMF::ALPHA_CHANNEL) != BMF::NIL)) {
          int dy = bmp->Clip.Top;
          for (int sy=Self->BkgdBitmap->Clip.Top; sy < Self->BkgdBitmap->Clip.Bottom; sy++) {
@@ -326,7 +373,10 @@ static ERR get_source_bitmap(extVectorFilter *Self, objBitmap **BitmapResult, VS
       save_bitmap(bmp, std::to_string(Self->UID) + "_" + std::to_string(Self->ClientVector->UID) + "_source");
    #endif
 
+   set_colour_space(bmp, Space);
+
    if (Premultiply) bmp->premultiply();
+   else if ((bmp->Flags & BMF::PREMUL) != BMF::NIL) bmp->demultiply(); // Left premultiplied by a previous consumer
 
    *BitmapResult = bmp;
    return ERR::Okay;
@@ -336,9 +386,7 @@ static ERR get_source_bitmap(extVectorFilter *Self, objBitmap **BitmapResult, VS
 // Render the vector client(s) to an internal bitmap that can be used for SourceGraphic and SourceAlpha input.
 // If the referenced vector has no content then the result is a bitmap cleared to 0x00000000, as per SVG specs.
 // Rendering will occur only once to SourceGraphic, so multiple calls to this function in a filter pipeline are OK.
-//
-// TODO: It would be efficient to hook into the dirty markers of the client vector so that re-rendering
-// occurs only in the event that the client has been modified.
+// Re-rendering of an unmodified client is avoided by the filter cache, see render_filter().
 
 objBitmap * get_source_graphic(extVectorFilter *Self)
 {
@@ -353,22 +401,12 @@ objBitmap * get_source_graphic(extVectorFilter *Self)
 
    pf::SwitchContext ctx(Self);
 
-   if (!Self->SourceGraphic) {
-      // The BlendMode is set to SRGB for the sake of SVG compatibility.  Otherwise the use of filters
-      // like feColorMatrix can produce unexpected results.
+   // The SourceGraphic is a banked bitmap, so its buffer only covers the filter region.  The BlendMode is set to
+   // SRGB for the sake of SVG compatibility.  Otherwise the use of filters like feColorMatrix can produce unexpected
+   // results.
 
-      if (!(Self->SourceGraphic = objBitmap::create::local(fl::Name("source_graphic"),
-         fl::Width(Self->ClientViewport->Scene->PageWidth),
-         fl::Height(Self->ClientViewport->Scene->PageHeight),
-         fl::BitsPerPixel(32),
-         fl::Flags(BMF::ALPHA_CHANNEL),
-         fl::BlendMode(BLM::SRGB),
-         fl::ColourSpace(CS::SRGB)))) return nullptr;
-   }
-   else if ((Self->ClientViewport->Scene->PageWidth > Self->SourceGraphic->Width) or
-            (Self->ClientViewport->Scene->PageHeight > Self->SourceGraphic->Height)) {
-      Self->SourceGraphic->resize(Self->ClientViewport->Scene->PageWidth, Self->ClientViewport->Scene->PageHeight);
-   }
+   if (get_banked_bitmap(Self, &Self->SourceGraphic, true) != ERR::Okay) return nullptr;
+   Self->SourceGraphic->BlendMode = BLM::SRGB;
 
    if (!Self->SourceScene) {
       if ((Self->SourceScene = extVectorScene::create::local(
@@ -380,31 +418,28 @@ objBitmap * get_source_graphic(extVectorFilter *Self)
       }
       else return nullptr;
    }
-   else if ((Self->ClientViewport->Scene->PageWidth > Self->SourceGraphic->Width) or
-            (Self->ClientViewport->Scene->PageHeight > Self->SourceGraphic->Height)) {
+   else if ((Self->ClientViewport->Scene->PageWidth > Self->SourceScene->PageWidth) or
+            (Self->ClientViewport->Scene->PageHeight > Self->SourceScene->PageHeight)) {
       acResize(Self->SourceScene, Self->ClientViewport->Scene->PageWidth, Self->ClientViewport->Scene->PageHeight, 0);
    }
 
+   // This non-fatal clipping check will trigger if vector bounds lie outside of the visible/drawable area.
+   if ((Self->SourceGraphic->Clip.Top >= Self->SourceGraphic->Clip.Bottom) or
+       (Self->SourceGraphic->Clip.Left >= Self->SourceGraphic->Clip.Right)) {
+      Self->SourceGraphic = nullptr;
+      return nullptr;
+   }
+
    auto const save_child = Self->SourceScene->Viewport->Child;
    Self->SourceScene->Viewport->Child = Self->ClientVector;
-   Self->SourceGraphic->Clip = { Self->VectorClip.left, Self->VectorClip.top, Self->VectorClip.right, Self->VectorClip.bottom };
-
-   if (Self->SourceGraphic->Clip.Top < 0)  Self->SourceGraphic->Clip.Top = 0;
-   if (Self->SourceGraphic->Clip.Left < 0) Self->SourceGraphic->Clip.Left = 0;
-   if (Self->SourceGraphic->Clip.Bottom > Self->SourceGraphic->Height) Self->SourceGraphic->Clip.Bottom = Self->SourceGraphic->Height;
-   if (Self->SourceGraphic->Clip.Right  > Self->SourceGraphic->Width)  Self->SourceGraphic->Clip.Right  = Self->SourceGraphic->Width;
-
-   // These non-fatal clipping checks will trigger if vector bounds lie outside of the visible/drawable area.
-   if (Self->SourceGraphic->Clip.Top >= Self->SourceGraphic->Clip.Bottom) return nullptr;
-   if (Self->SourceGraphic->Clip.Left >= Self->SourceGraphic->Clip.Right) return nullptr;
 
    auto const save_vector = Self->ClientVector->Next; // Switch off the Next pointer to prevent processing of siblings.
    Self->ClientVector->Next = nullptr;
    Self->Disabled = true; // Turning off the filter is required to prevent infinite recursion.
 
-   gfx::DrawRectangle(Self->SourceGraphic, 0, 0, Self->SourceGraphic->Width, Self->SourceGraphic->Height, 0x00000000, BAF::FILL);
    Self->SourceScene->Bitmap = Self->SourceGraphic;
    acDraw(Self->SourceScene);
+   Self->SourceScene->Bitmap = nullptr; // The bitmap is returned to the bank once the filter is composited
 
    Self->Disabled = false;
    Self->ClientVector->Next = save_vector;
@@ -500,6 +535,184 @@ static ERR set_clip_region(extVectorFilter *Self, extVectorViewport *Viewport, e
    return ERR::Okay;
 }
 
+//********************************************************************************************************************
+// Filter output cache.  See filter_cache in vector.h for an overview.
+
+objBitmap * filter_cache::lookup(uint64_t Key, uint64_t State, bool &Store)
+{
+   auto &e = Entries[Key];
+   if (!e) e = std::make_unique<entry>();
+   e->LastUsed = Frame;
+
+   if (e->State IS State) {
+      if (e->Valid) return e->Output.Bitmap;
+      Store = true; // Stable for two renders in a row; the caller should store the result.
+   }
+   else {
+      invalidate(*e);
+      e->State = State;
+      Store = false;
+   }
+   return nullptr;
+}
+
+//********************************************************************************************************************
+// Records the state of the inputs following a render.  Rendering the client can modify it (e.g. by resolving its
+// dimensions against the filter's viewport), in which case the state prior to the render would never be seen again.
+
+void filter_cache::settle(uint64_t Key, uint64_t State)
+{
+   if (auto it = Entries.find(Key); it != Entries.end()) it->second->State = State;
+}
+
+//********************************************************************************************************************
+// Copy the live region of a filter's output to the cache.  If the budget would be exceeded, the least recently used
+// entries are discarded first.
+
+void filter_cache::store(uint64_t Key, objBitmap *Bitmap)
+{
+   pf::Log log(__FUNCTION__);
+
+   auto it = Entries.find(Key);
+   if (it IS Entries.end()) return;
+   auto &e = *it->second;
+
+   TClipRectangle<int> clip = { Bitmap->Clip.Left, Bitmap->Clip.Top, Bitmap->Clip.Right, Bitmap->Clip.Bottom };
+   const size_t size = size_t(clip.width()) * size_t(clip.height()) * Bitmap->BytesPerPixel;
+   if (size > BUDGET) return;
+
+   while (Bytes + size > BUDGET) {
+      entry *lru = nullptr;
+      for (auto &[k, v] : Entries) {
+         if ((v->Valid) and (v.get() != &e) and ((!lru) or (v->LastUsed < lru->LastUsed))) lru = v.get();
+      }
+      if (!lru) break;
+      invalidate(*lru);
+   }
+
+   auto bmp = e.Output.get_bitmap(Bitmap->Width, Bitmap->Height, clip, false);
+   if (!bmp) return;
+
+   const int row_size = clip.width() * Bitmap->BytesPerPixel;
+   for (int y=clip.top; y < clip.bottom; y++) {
+      copymem(Bitmap->Data + (y * Bitmap->LineWidth) + (clip.left * Bitmap->BytesPerPixel),
+         bmp->Data + (y * bmp->LineWidth) + (clip.left * bmp->BytesPerPixel), row_size);
+   }
+
+   bmp->ColourSpace = Bitmap->ColourSpace;
+   bmp->BlendMode   = Bitmap->BlendMode;
+   bmp->Flags       = (bmp->Flags & ~BMF::PREMUL) | (Bitmap->Flags & BMF::PREMUL);
+
+   e.Valid = true;
+   Bytes += e.Output.Data.size();
+}
+
+//********************************************************************************************************************
+
+void filter_cache::invalidate(entry &Entry)
+{
+   if (!Entry.Valid) return;
+   Bytes -= Entry.Output.Data.size();
+   Entry.Valid = false;
+   Entry.Output.Data.clear();
+   Entry.Output.Data.shrink_to_fit();
+}
+
+//********************************************************************************************************************
+// Called once per frame.  Entries that have not been used recently belong to vectors that are hidden or destroyed.
+
+void filter_cache::end_frame()
+{
+   if ((++Frame % EXPIRY) != 0) return;
+
+   std::erase_if(Entries, [this](auto &Item) {
+      if (Frame - Item.second->LastUsed < EXPIRY) return false;
+      invalidate(*Item.second);
+      return true;
+   });
+}
+
+//********************************************************************************************************************
+// Fingerprint everything that determines the filter's output.  The content of the client is represented by its
+// Generation, which is incremented whenever the client or one of its children is modified, and the scene's
+// DefGeneration covers the gradients, patterns and images that it may reference.  Returns false if the output depends
+// on state that cannot be fingerprinted, such as the background, a referenced vector or the pixels of an ImageFX
+// bitmap, which the client can modify without notification.
+
+template <class T> static inline void fingerprint(uint64_t &Hash, const T Value)
+{
+   Hash = ankerl::unordered_dense::detail::wyhash::hash(&Value, sizeof(T)) ^ (Hash * 0x9e3779b97f4a7c15ull);
+}
+
+static bool is_cacheable_source(VSF Type)
+{
+   return (Type != VSF::BKGD) and (Type != VSF::BKGD_ALPHA) and (Type != VSF::FILL) and (Type != VSF::STROKE);
+}
+
+static bool filter_fingerprint(extVectorFilter *Self, extVector *Vector, uint64_t &State)
+{
+   if (Self->ReqBkgd) return false;
+
+   uint64_t h = Self->Generation;
+   fingerprint(h, Vector->Generation);
+   fingerprint(h, ((extVectorScene *)Vector->Scene)->DefGeneration);
+   fingerprint(h, Self->X);
+   fingerprint(h, Self->Y);
+   fingerprint(h, Self->Width);
+   fingerprint(h, Self->Height);
+   fingerprint(h, Self->Inherit);
+   fingerprint(h, Self->ResX);
+   fingerprint(h, Self->ResY);
+   fingerprint(h, Self->Units);
+   fingerprint(h, Self->PrimitiveUnits);
+   fingerprint(h, Self->Dimensions);
+   fingerprint(h, Self->ColourSpace);
+   fingerprint(h, Self->AspectRatio);
+   fingerprint(h, Self->VectorClip.left);
+   fingerprint(h, Self->VectorClip.top);
+   fingerprint(h, Self->VectorClip.right);
+   fingerprint(h, Self->VectorClip.bottom);
+   fingerprint(h, Self->BoundWidth);
+   fingerprint(h, Self->BoundHeight);
+   fingerprint(h, Self->TargetX);
+   fingerprint(h, Self->TargetY);
+   fingerprint(h, Self->TargetWidth);
+   fingerprint(h, Self->TargetHeight);
+   fingerprint(h, Vector->Transform.sx);
+   fingerprint(h, Vector->Transform.shy);
+   fingerprint(h, Vector->Transform.shx);
+   fingerprint(h, Vector->Transform.sy);
+   fingerprint(h, Vector->Transform.tx);
+   fingerprint(h, Vector->Transform.ty);
+
+   for (auto e = Self->Effects; e; e = (extFilterEffect *)e->Next) {
+      if ((e->classID() IS CLASSID::SOURCEFX) or (e->classID() IS CLASSID::IMAGEFX)) return false;
+
+      if (e->classID() IS CLASSID::MERGEFX) {
+         for (auto &src : ((extMergeFX *)e)->List) {
+            if (!is_cacheable_source(src.SourceType)) return false;
+         }
+      }
+
+      if (!is_cacheable_source(e->SourceType)) return false;
+      if (!is_cacheable_source(e->MixType)) return false;
+
+      fingerprint(h, e->UID);
+      fingerprint(h, e->Input);
+      fingerprint(h, e->Mix);
+      fingerprint(h, e->X);
+      fingerprint(h, e->Y);
+      fingerprint(h, e->Width);
+      fingerprint(h, e->Height);
+      fingerprint(h, e->Dimensions);
+      fingerprint(h, e->SourceType);
+      fingerprint(h, e->MixType);
+   }
+
+   State = h;
+   return true;
+}
+
 //********************************************************************************************************************
 // Main rendering routine for filter effects.  Called by the scene graph renderer whenever a vector uses a filter.
 
@@ -523,7 +736,7 @@ ERR render_filter(extVectorFilter *Self, extVectorViewport *Viewport, extVector
    Self->ClientVector   = Vector;
    Self->BkgdBitmap     = BkgdBitmap; // For VSF::BKGD and VSF::BKGD_ALPHA
    Self->Rendered       = false; // Set to true when SourceGraphic is rendered
-   Self->BankIndex      = 0;
+   Self->SourceGraphic  = nullptr; // Banked on demand by get_source_graphic()
 
    if (auto error = set_clip_region(Self, Viewport, Vector); error != ERR::Okay) return error;
 
@@ -531,6 +744,21 @@ ERR render_filter(extVectorFilter *Self, extVectorViewport *Viewport, extVector
 
    compute_target_area(Self);
 
+   // If the filter's inputs are unchanged since the last render, the cached output is returned without rendering
+   // the client to SourceGraphic.
+
+   auto scene = (extVectorScene *)Viewport->Scene;
+   const auto cache_key = filter_cache::key(Self->UID, Vector->UID);
+   uint64_t state;
+   bool cacheable = false, store = false;
+   if ((cacheable = filter_fingerprint(Self, Vector, state))) {
+      if (auto cached = scene->FilterCache.lookup(cache_key, state, store)) {
+         log.trace("Using cached output.");
+         *Output = cached;
+         return ERR::Okay;
+      }
+   }
+
    // Render the effect pipeline in sequence.  Linked effects get their own bitmap, everything else goes to a shared
    // output bitmap.  After all effects are rendered, the shared output bitmap is returned for rendering to the scene graph.
    //
@@ -547,13 +775,11 @@ ERR render_filter(extVectorFilter *Self, extVectorViewport *Viewport, extVector
       Self->ActiveEffect = e;
 
       if (e->UsageCount > 0) { // This effect is an input to something else
-         if (auto error = get_banked_bitmap(Self, &e->Target); error != ERR::Okay) return error;
-         gfx::DrawRectangle(e->Target, 0, 0, e->Target->Width, e->Target->Height, 0x00000000, BAF::FILL);
+         if (auto error = get_banked_bitmap(Self, &e->Target, true); error != ERR::Okay) return error;
       }
       else { // This effect can render directly to the shared output bitmap
          if (!out) {
-            if (auto error = get_banked_bitmap(Self, &out); error != ERR::Okay) return error;
-            gfx::DrawRectangle(out, 0, 0, out->Width, out->Height, 0x00000000, BAF::FILL);
+            if (auto error = get_banked_bitmap(Self, &out, true); error != ERR::Okay) return error;
          }
          e->Target = out;
       }
@@ -564,8 +790,7 @@ ERR render_filter(extVectorFilter *Self, extVectorViewport *Viewport, extVector
 
    if (!out) {
       log.warning("Effect pipeline did not produce an output bitmap.");
-      if (auto error = get_banked_bitmap(Self, &out); error != ERR::Okay) return error;
-      gfx::DrawRectangle(out, 0, 0, out->Width, out->Height, 0x00000000, BAF::FILL);
+      if (auto error = get_banked_bitmap(Self, &out, true); error != ERR::Okay) return error;
    }
 
    #if defined(EXPORT_FILTER_BITMAP) && defined (DEBUG_FILTER_BITMAP)
@@ -574,6 +799,14 @@ ERR render_filter(extVectorFilter *Self, extVectorViewport *Viewport, extVector
 
    #ifdef DEBUG_FILTER_BITMAP
       gfx::DrawRectangle(out, out->Clip.Left, out->Clip.Top, out->Clip.Right-out->Clip.Left, out->Clip.Bottom-out->Clip.Top, 0xff0000ff, BAF::NIL);
+   #else
+      if ((cacheable) and (filter_fingerprint(Self, Vector, state))) {
+         scene->FilterCache.settle(cache_key, state);
+         if (store) {
+            pf::SwitchContext ctx(scene); // Cached bitmaps belong to the scene, not the filter.
+            scene->FilterCache.store(cache_key, out);
+         }
+      }
    #endif
 
    *Output = out;
@@ -593,9 +826,6 @@ static ERR VECTORFILTER_Clear(extVectorFilter *Self)
    log.branch();
    while (Self->Effects) FreeResource(Self->Effects);
 
-   Self->Bank.clear();
-   Self->BankIndex = 0;
-
    return ERR::Okay;
 }
 
@@ -605,7 +835,6 @@ static ERR VECTORFILTER_Free(extVectorFilter *Self)
 {
    acClear(Self);
 
-   if (Self->SourceGraphic) { FreeResource(Self->SourceGraphic); Self->SourceGraphic = nullptr; }
    if (Self->SourceScene)   { FreeResource(Self->SourceScene);   Self->SourceScene = nullptr; }
 
    Self->~extVectorFilter();
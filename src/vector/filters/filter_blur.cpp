@@ -82,9 +82,331 @@ class extBlurFX : public extFilterEffect {
    double SX, SY;
 };
 
+//********************************************************************************************************************
+// Channel vectors for the blur kernels.  Each pixel is unpacked to four 32-bit lanes, one per channel, so that the
+// running sums for R, G, B and A are maintained with a single instruction.  Channel order is irrelevant to the
+// kernels.  The AVX2 variant packs two pixels per vector, which allows two independent lines to be blurred at once;
+// the second pixel of each pair is located at a fixed byte offset ('Next') from the first.
+
+#if defined(FX_SSE2)
+
+struct blur_px {
+   using type = __m128i;
+   static constexpr int PIXELS = 1;
+
+   static inline type zero() { return _mm_setzero_si128(); }
+
+   static inline type load(const uint8_t *P, ptrdiff_t) {
+      const auto z = _mm_setzero_si128();
+      return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(*(const int32_t *)P), z), z);
+   }
+
+   static inline void store(uint8_t *P, ptrdiff_t, type V) {
+      const auto w = _mm_packs_epi32(V, V);
+      *(int32_t *)P = _mm_cvtsi128_si32(_mm_packus_epi16(w, w));
+   }
+
+   static inline type add(type A, type B) { return _mm_add_epi32(A, B); }
+   static inline type sub(type A, type B) { return _mm_sub_epi32(A, B); }
+
+   static inline type mul(type V, uint32_t M) {
+#ifdef __SSE4_1__
+      return _mm_mullo_epi32(V, _mm_set1_epi32(M));
+#else
+      const auto m    = _mm_set1_epi32(M);
+      const auto even = _mm_mul_epu32(V, m);
+      const auto odd  = _mm_mul_epu32(_mm_srli_epi64(V, 32), m);
+      return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0,0,2,0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0,0,2,0)));
+#endif
+   }
+
+   static inline type shr(type V, int S) { return _mm_srl_epi32(V, _mm_cvtsi32_si128(S)); }
+
+   static inline type scale(type V, float S) {
+      return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(V), _mm_set1_ps(S)), _mm_set1_ps(0.5f)));
+   }
+};
+
+#elif defined(FX_NEON)
+
+struct blur_px {
+   using type = uint32x4_t;
+   static constexpr int PIXELS = 1;
+
+   static inline type zero() { return vdupq_n_u32(0); }
+
+   static inline type load(const uint8_t *P, ptrdiff_t) {
+      return vmovl_u16(vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(*(const uint32_t *)P)))));
+   }
+
+   static inline void store(uint8_t *P, ptrdiff_t, type V) {
+      const auto w = vmovn_u32(V);
+      *(uint32_t *)P = vget_lane_u32(vreinterpret_u32_u8(vmovn_u16(vcombine_u16(w, w))), 0);
+   }
+
+   static inline type add(type A, type B) { return vaddq_u32(A, B); }
+   static inline type sub(type A, type B) { return vsubq_u32(A, B); }
+   static inline type mul(type V, uint32_t M) { return vmulq_n_u32(V, M); }
+   static inline type shr(type V, int S) { return vshlq_u32(V, vdupq_n_s32(-S)); }
+
+   static inline type scale(type V, float S) {
+      return vcvtq_u32_f32(vaddq_f32(vmulq_n_f32(vcvtq_f32_u32(V), S), vdupq_n_f32(0.5f)));
+   }
+};
+
+#else
+
+struct blur_px {
+   struct type { uint32_t c[4]; };
+   static constexpr int PIXELS = 1;
+
+   static inline type zero() { return { 0, 0, 0, 0 }; }
+   static inline type load(const uint8_t *P, ptrdiff_t) { return { P[0], P[1], P[2], P[3] }; }
+   static inline void store(uint8_t *P, ptrdiff_t, type V) {
+      P[0] = V.c[0]; P[1] = V.c[1]; P[2] = V.c[2]; P[3] = V.c[3];
+   }
+   static inline type add(type A, type B) { return { A.c[0]+B.c[0], A.c[1]+B.c[1], A.c[2]+B.c[2], A.c[3]+B.c[3] }; }
+   static inline type sub(type A, type B) { return { A.c[0]-B.c[0], A.c[1]-B.c[1], A.c[2]-B.c[2], A.c[3]-B.c[3] }; }
+   static inline type mul(type V, uint32_t M) { return { V.c[0]*M, V.c[1]*M, V.c[2]*M, V.c[3]*M }; }
+   static inline type shr(type V, int S) { return { V.c[0]>>S, V.c[1]>>S, V.c[2]>>S, V.c[3]>>S }; }
+   static inline type scale(type V, float S) {
+      return { uint32_t(V.c[0] * S + 0.5f), uint32_t(V.c[1] * S + 0.5f), uint32_t(V.c[2] * S + 0.5f), uint32_t(V.c[3] * S + 0.5f) };
+   }
+};
+
+#endif
+
+#ifdef FX_AVX2
+
+struct blur_px2 {
+   using type = __m256i;
+   static constexpr int PIXELS = 2;
+
+   static inline type zero() { return _mm256_setzero_si256(); }
+
+   static inline type load(const uint8_t *P, ptrdiff_t Next) {
+      return _mm256_cvtepu8_epi32(_mm_unpacklo_epi32(_mm_cvtsi32_si128(*(const int32_t *)P),
+         _mm_cvtsi32_si128(*(const int32_t *)(P + Next))));
+   }
+
+   static inline void store(uint8_t *P, ptrdiff_t Next, type V) {
+      const auto w = _mm_packs_epi32(_mm256_castsi256_si128(V), _mm256_extracti128_si256(V, 1));
+      const auto b = _mm_packus_epi16(w, w);
+      *(int32_t *)P = _mm_cvtsi128_si32(b);
+      *(int32_t *)(P + Next) = _mm_cvtsi128_si32(_mm_srli_si128(b, 4));
+   }
+
+   static inline type add(type A, type B) { return _mm256_add_epi32(A, B); }
+   static inline type sub(type A, type B) { return _mm256_sub_epi32(A, B); }
+   static inline type mul(type V, uint32_t M) { return _mm256_mullo_epi32(V, _mm256_set1_epi32(M)); }
+   static inline type shr(type V, int S) { return _mm256_srl_epi32(V, _mm_cvtsi32_si128(S)); }
+
+   static inline type scale(type V, float S) {
+      return _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(V), _mm256_set1_ps(S)), _mm256_set1_ps(0.5f)));
+   }
+};
+
+#endif
+
+//********************************************************************************************************************
+// Describes a single line of pixels to be blurred, which may be a row or a column.  Step is the distance between
+// consecutive pixels of the line and Next is the distance to the paired line when blurring two lines at once.
+
+struct blur_line {
+   const uint8_t *src;
+   uint8_t *dest;
+   ptrdiff_t src_step, src_next;
+   ptrdiff_t dest_step, dest_next;
+   int length;
+};
+
 //********************************************************************************************************************
 // This is the stack blur algorithm originally implemented in AGG.  It is intended to produce a near identical output
-// to that of a standard gaussian blur algorithm.
+// to that of a standard gaussian blur algorithm.  The source and destination may be the same line, because each
+// source pixel is always read before the destination pixel at the same position is written.
+
+constexpr int STACK_BLUR_MAX = 254; // Largest radius supported by the stack blur tables
+
+template <class V> static void stack_blur_line(const blur_line &L, int Radius, typename V::type *Stack)
+{
+   const int div = (Radius * 2) + 1;
+   const uint32_t mul_sum = stack_blur_tables<int>::g_stack_blur8_mul[Radius];
+   const int shr_sum = stack_blur_tables<int>::g_stack_blur8_shr[Radius];
+   const int last = L.length - 1;
+
+   // The leading half of the stack is primed with the first pixel, in lieu of pixels beyond the edge.
+
+   const uint8_t *src = L.src;
+   auto pix = V::load(src, L.src_next);
+   for (int i=0; i <= Radius; i++) Stack[i] = pix;
+   auto sum     = V::mul(pix, ((Radius + 1) * (Radius + 2))>>1);
+   auto sum_out = V::mul(pix, Radius + 1);
+   auto sum_in  = V::zero();
+
+   for (int i=1; i <= Radius; i++) {
+      if (i <= last) src += L.src_step;
+      pix = V::load(src, L.src_next);
+      Stack[i + Radius] = pix;
+      sum    = V::add(sum, V::mul(pix, Radius + 1 - i));
+      sum_in = V::add(sum_in, pix);
+   }
+
+   int stack_ptr = Radius;
+   int xp = std::min(Radius, last);
+   src = L.src + (xp * L.src_step);
+   uint8_t *dest = L.dest;
+   for (int x=0; x < L.length; x++) {
+      V::store(dest, L.dest_next, V::shr(V::mul(sum, mul_sum), shr_sum));
+      dest += L.dest_step;
+
+      sum = V::sub(sum, sum_out);
+
+      int stack_start = stack_ptr + div - Radius;
+      if (stack_start >= div) stack_start -= div;
+      sum_out = V::sub(sum_out, Stack[stack_start]);
+
+      if (xp < last) {
+         src += L.src_step;
+         xp++;
+      }
+
+      pix = V::load(src, L.src_next);
+      Stack[stack_start] = pix;
+      sum_in = V::add(sum_in, pix);
+      sum    = V::add(sum, sum_in);
+
+      if (++stack_ptr >= div) stack_ptr = 0;
+      sum_out = V::add(sum_out, Stack[stack_ptr]);
+      sum_in  = V::sub(sum_in, Stack[stack_ptr]);
+   }
+}
+
+//********************************************************************************************************************
+// Box blur approximation for radii that exceed the stack blur's limits.  Three successive box passes give a close
+// approximation of a gaussian, as recommended by the SVG specification, and the cost is independent of the radius.
+// If the box size is even, the first two boxes are offset by half a pixel in opposite directions and the third is
+// centred with a size of Box+1.
+
+template <class V> static void box_pass(const typename V::type *In, typename V::type *Out, int Length, int Left, int Right)
+{
+   const float scale = 1.0f / float(Left + Right + 1);
+   const int last = Length - 1;
+
+   auto sum = V::zero();
+   for (int i=-Left; i <= Right; i++) sum = V::add(sum, In[std::clamp(i, 0, last)]);
+
+   for (int x=0; x < Length; x++) {
+      Out[x] = V::scale(sum, scale);
+      sum = V::add(sum, In[std::min(x + Right + 1, last)]);
+      sum = V::sub(sum, In[std::max(x - Left, 0)]);
+   }
+}
+
+template <class V> static void box_blur_line(const blur_line &L, int Box, typename V::type *A, typename V::type *B)
+{
+   const uint8_t *src = L.src;
+   for (int i=0; i < L.length; i++, src += L.src_step) A[i] = V::load(src, L.src_next);
+
+   const int half = Box>>1;
+   if (Box & 1) {
+      box_pass<V>(A, B, L.length, half, half);
+      box_pass<V>(B, A, L.length, half, half);
+      box_pass<V>(A, B, L.length, half, half);
+   }
+   else {
+      box_pass<V>(A, B, L.length, half, half - 1);
+      box_pass<V>(B, A, L.length, half - 1, half);
+      box_pass<V>(A, B, L.length, half, half);
+   }
+
+   uint8_t *dest = L.dest;
+   for (int i=0; i < L.length; i++, dest += L.dest_step) V::store(dest, L.dest_next, B[i]);
+}
+
+//********************************************************************************************************************
+// Blurs Count lines, using the paired AVX2 kernel where two lines are available.  Radius is the stack blur radius
+// and Box is the box size, of which only one is used.
+
+template <class V> struct blur_buffers {
+   typename V::type *a = nullptr, *b = nullptr;
+
+   blur_buffers(int Radius, int Box, int Length) {
+      if (Box) {
+         a = new typename V::type[Length];
+         b = new typename V::type[Length];
+      }
+      else a = new typename V::type[(Radius * 2) + 1];
+   }
+
+   ~blur_buffers() { delete [] a; delete [] b; }
+};
+
+static void blur_lines(blur_line L, int Count, ptrdiff_t SrcAdvance, ptrdiff_t DestAdvance, int Radius, int Box)
+{
+   int i = 0;
+
+#ifdef FX_AVX2
+   if (Count >= 2) {
+      blur_buffers<blur_px2> buf(Radius, Box, L.length);
+      L.src_next  = SrcAdvance;
+      L.dest_next = DestAdvance;
+      for (; i + 2 <= Count; i += 2) {
+         if (Box) box_blur_line<blur_px2>(L, Box, buf.a, buf.b);
+         else stack_blur_line<blur_px2>(L, Radius, buf.a);
+         L.src  += SrcAdvance * 2;
+         L.dest += DestAdvance * 2;
+      }
+   }
+#endif
+
+   if (i < Count) {
+      blur_buffers<blur_px> buf(Radius, Box, L.length);
+      for (; i < Count; i++) {
+         if (Box) box_blur_line<blur_px>(L, Box, buf.a, buf.b);
+         else stack_blur_line<blur_px>(L, Radius, buf.a);
+         L.src  += SrcAdvance;
+         L.dest += DestAdvance;
+      }
+   }
+}
+
+//********************************************************************************************************************
+// The blur operates on premultiplied content.  These routines fuse premultiplication with the colour space
+// conversions that surround the blur, so that each is a single pass per row.  Decode is either the sRGB to linear
+// table or an identity table.  If Encode is true, demultiplied output is converted from linear RGB to sRGB.
+
+static void premultiply_row(uint8_t *Pixel, int Width, const uint8_t *Decode, uint8_t A, uint8_t R, uint8_t G, uint8_t B)
+{
+   for (int x=0; x < Width; x++, Pixel += 4) {
+      const uint8_t a = Pixel[A];
+      if (!a) Pixel[R] = Pixel[G] = Pixel[B] = 0;
+      else {
+         Pixel[R] = (Decode[Pixel[R]] * a + 0xff)>>8;
+         Pixel[G] = (Decode[Pixel[G]] * a + 0xff)>>8;
+         Pixel[B] = (Decode[Pixel[B]] * a + 0xff)>>8;
+      }
+   }
+}
+
+static void demultiply_row(uint8_t *Pixel, int Width, bool Encode, uint8_t A, uint8_t R, uint8_t G, uint8_t B)
+{
+   uint8_t *p = Pixel;
+   for (int x=0; x < Width; x++, p += 4) {
+      const uint32_t a = p[A];
+      if (!a) p[R] = p[G] = p[B] = 0;
+      else if (a < 0xff) {
+         p[R] = std::min<uint32_t>((p[R] * 0xff) / a, 0xff);
+         p[G] = std::min<uint32_t>((p[G] * 0xff) / a, 0xff);
+         p[B] = std::min<uint32_t>((p[B] * 0xff) / a, 0xff);
+      }
+   }
+
+   if (Encode) glLinearRGB.invert_row(Pixel, Width, R, G, B, A);
+}
+
+//********************************************************************************************************************
+// Rows are blurred in parallel for the horizontal pass and column stripes are blurred in parallel for the vertical
+// pass.  Stripes keep each thread's reads within a narrow band of cache lines as it works down the bitmap.
 //
 // Note that blurring is always performed with premultiplied colour values; otherwise the function will output pixels
 // that are darkly tinted.
@@ -97,293 +419,147 @@ static ERR BLURFX_Draw(extBlurFX *Self, struct acDraw *Args)
    double scale = 1.0;
    if (Self->Filter->ClientVector) scale = Self->Filter->ClientVector->Transform.scale();
 
-   int rx, ry;
+   double sx, sy; // Standard deviation in pixels
    if (Self->Filter->PrimitiveUnits IS VUNIT::BOUNDING_BOX) {
       if (Self->Filter->AspectRatio IS VFA::NONE) {
          // Scaling is applied evenly on both axis.  Uses the same formula as a scaled stroke-width.
          double diag = dist(0, 0, Self->Filter->BoundWidth, Self->Filter->BoundHeight) * INV_SQRT2;
-         rx = int(Self->SX * diag * 2 * scale);
-         ry = int(Self->SY * diag * 2 * scale);
+         sx = Self->SX * diag * scale;
+         sy = Self->SY * diag * scale;
       }
       else {
          // Scaling is stretched independently of each axis
-         rx = int(Self->SX * Self->Filter->BoundWidth * 2 * scale);
-         ry = int(Self->SY * Self->Filter->BoundHeight * 2 * scale);
+         sx = Self->SX * Self->Filter->BoundWidth * scale;
+         sy = Self->SY * Self->Filter->BoundHeight * scale;
       }
    }
    else {
-      rx = int(Self->SX * 2 * scale);
-      ry = int(Self->SY * 2 * scale);
+      sx = Self->SX * scale;
+      sy = Self->SY * scale;
    }
 
+   int rx = int(sx * 2);
+   int ry = int(sy * 2);
+
+   // In linear mode the input is accepted in either colour space and converted during premultiplication.  The output
+   // remains in linear RGB if it is only consumed by other effects, which convert it on demand.
+
+   const bool linear = Self->Filter->ColourSpace IS VCS::LINEAR_RGB;
+   const CS out_space = (linear and (Self->UsageCount > 0)) ? CS::LINEAR_RGB : CS::SRGB;
+
    objBitmap *inBmp;
+   if (get_source_bitmap(Self->Filter, &inBmp, Self->SourceType, Self->Input, false, linear ? CS::NIL : CS::SRGB) != ERR::Okay) return ERR::NoData;
 
    if ((rx < 1) and (ry < 1)) {
-      if (get_source_bitmap(Self->Filter, &inBmp, Self->SourceType, Self->Input, false) != ERR::Okay) return ERR::NoData;
-      BAF copy_flags = (Self->Filter->ColourSpace IS VCS::LINEAR_RGB) ? BAF::LINEAR : BAF::NIL;
-      gfx::CopyArea(inBmp, outBmp, copy_flags, 0, 0, inBmp->Width, inBmp->Height, 0, 0);
+      set_colour_space(inBmp, out_space);
+      gfx::CopyArea(inBmp, outBmp, BAF::NIL, 0, 0, inBmp->Width, inBmp->Height, 0, 0);
+      outBmp->ColourSpace = out_space;
       return ERR::Okay;
    }
 
-   if (get_source_bitmap(Self->Filter, &inBmp, Self->SourceType, Self->Input, false) != ERR::Okay) return ERR::NoData;
+   // Radii beyond the stack blur's limit switch to the box approximation, with the box size computed as per the SVG
+   // specification.
 
-   if (Self->Filter->ColourSpace IS VCS::LINEAR_RGB) inBmp->convertToLinear();
+   const int box_x = (rx > STACK_BLUR_MAX) ? int(sx * 3.0 * std::sqrt(2.0 * agg::pi) / 4.0 + 0.5) : 0;
+   const int box_y = (ry > STACK_BLUR_MAX) ? int(sy * 3.0 * std::sqrt(2.0 * agg::pi) / 4.0 + 0.5) : 0;
 
-   inBmp->premultiply();
+   if ((inBmp->Flags & BMF::PREMUL) != BMF::NIL) { // The input has to be normalised before it can be converted
+      if (linear) set_colour_space(inBmp, CS::LINEAR_RGB);
+      else inBmp->demultiply();
+   }
 
-   uint8_t *dst_pix_ptr;
-   agg::rgba8 *stack_pix_ptr;
+   const uint8_t A = inBmp->ColourFormat->AlphaPos>>3;
+   const uint8_t R = inBmp->ColourFormat->RedPos>>3;
+   const uint8_t G = inBmp->ColourFormat->GreenPos>>3;
+   const uint8_t B = inBmp->ColourFormat->BluePos>>3;
+   const uint8_t *decode = glLinearRGB.decode_table((!linear) or (inBmp->ColourSpace IS CS::LINEAR_RGB));
 
    const int w = (outBmp->Clip.Right - outBmp->Clip.Left);
    const int h = (outBmp->Clip.Bottom - outBmp->Clip.Top);
-   const int wm = w - 1;
-   const int hm = h - 1;
-
-   uint8_t A = inBmp->ColourFormat->AlphaPos>>3;
-   uint8_t R = inBmp->ColourFormat->RedPos>>3;
-   uint8_t G = inBmp->ColourFormat->GreenPos>>3;
-   uint8_t B = inBmp->ColourFormat->BluePos>>3;
-
-   uint8_t *in_data  = inBmp->Data + (outBmp->Clip.Left<<2) + (outBmp->Clip.Top * inBmp->LineWidth);
-   uint8_t *out_data = outBmp->Data + (outBmp->Clip.Left<<2) + (outBmp->Clip.Top * inBmp->LineWidth);
-
-   uint32_t sum_r, sum_g, sum_b, sum_a;
-   uint32_t sum_in_r, sum_in_g, sum_in_b, sum_in_a;
-   uint32_t sum_out_r, sum_out_g, sum_out_b, sum_out_a;
-   int x, y, xp, yp;
-   uint32_t stack_ptr;
-   uint32_t stack_start;
-   uint32_t div;
-   uint32_t mul_sum;
-   uint32_t shr_sum;
-
-   std::vector<agg::rgba8> stack;
-
-   if (rx > 0) {
-      if (rx > 254) rx = 254;
-      div = rx * 2 + 1;
-      mul_sum = stack_blur_tables<int>::g_stack_blur8_mul[rx];
-      shr_sum = stack_blur_tables<int>::g_stack_blur8_shr[rx];
-      stack.resize(div);
-
-      for (y=0; y < h; y++) {
-         sum_r = sum_g = sum_b = sum_a = sum_in_r = sum_in_g = sum_in_b = sum_in_a = sum_out_r = sum_out_g = sum_out_b = sum_out_a = 0;
-
-         const uint8_t * src_pix_ptr = in_data + (outBmp->LineWidth * y);
-         for (int i=0; i <= rx; i++) {
-             stack_pix_ptr    = &stack[i];
-             stack_pix_ptr->r = src_pix_ptr[R];
-             stack_pix_ptr->g = src_pix_ptr[G];
-             stack_pix_ptr->b = src_pix_ptr[B];
-             stack_pix_ptr->a = src_pix_ptr[A];
-             sum_r     += src_pix_ptr[R] * (i + 1);
-             sum_g     += src_pix_ptr[G] * (i + 1);
-             sum_b     += src_pix_ptr[B] * (i + 1);
-             sum_a     += src_pix_ptr[A] * (i + 1);
-             sum_out_r += src_pix_ptr[R];
-             sum_out_g += src_pix_ptr[G];
-             sum_out_b += src_pix_ptr[B];
-             sum_out_a += src_pix_ptr[A];
-         }
-
-         for (int i=1; i <= rx; i++) {
-            if (i <= wm) src_pix_ptr += 4;
-            stack_pix_ptr = &stack[i + rx];
-            stack_pix_ptr->r = src_pix_ptr[R];
-            stack_pix_ptr->g = src_pix_ptr[G];
-            stack_pix_ptr->b = src_pix_ptr[B];
-            stack_pix_ptr->a = src_pix_ptr[A];
-            sum_r    += src_pix_ptr[R] * (rx + 1 - i);
-            sum_g    += src_pix_ptr[G] * (rx + 1 - i);
-            sum_b    += src_pix_ptr[B] * (rx + 1 - i);
-            sum_a    += src_pix_ptr[A] * (rx + 1 - i);
-            sum_in_r += src_pix_ptr[R];
-            sum_in_g += src_pix_ptr[G];
-            sum_in_b += src_pix_ptr[B];
-            sum_in_a += src_pix_ptr[A];
-         }
-
-         stack_ptr = rx;
-         xp = rx;
-         if (xp > wm) xp = wm;
-         src_pix_ptr = in_data + (outBmp->LineWidth * y) + (xp<<2);
-         dst_pix_ptr = out_data + (outBmp->LineWidth * y);
-         for (int x=0; x < w; x++) {
-            dst_pix_ptr[R] = (sum_r * mul_sum) >> shr_sum;
-            dst_pix_ptr[G] = (sum_g * mul_sum) >> shr_sum;
-            dst_pix_ptr[B] = (sum_b * mul_sum) >> shr_sum;
-            dst_pix_ptr[A] = (sum_a * mul_sum) >> shr_sum;
-            dst_pix_ptr += 4;
-
-            sum_r -= sum_out_r;
-            sum_g -= sum_out_g;
-            sum_b -= sum_out_b;
-            sum_a -= sum_out_a;
-
-            stack_start = stack_ptr + div - rx;
-            if (stack_start >= div) stack_start -= div;
-            stack_pix_ptr = &stack[stack_start];
-
-            sum_out_r -= stack_pix_ptr->r;
-            sum_out_g -= stack_pix_ptr->g;
-            sum_out_b -= stack_pix_ptr->b;
-            sum_out_a -= stack_pix_ptr->a;
-
-            if (xp < wm) {
-               src_pix_ptr += 4;
-               ++xp;
-            }
-
-            stack_pix_ptr->r = src_pix_ptr[R];
-            stack_pix_ptr->g = src_pix_ptr[G];
-            stack_pix_ptr->b = src_pix_ptr[B];
-            stack_pix_ptr->a = src_pix_ptr[A];
-
-            sum_in_r += src_pix_ptr[R];
-            sum_in_g += src_pix_ptr[G];
-            sum_in_b += src_pix_ptr[B];
-            sum_in_a += src_pix_ptr[A];
-            sum_r    += sum_in_r;
-            sum_g    += sum_in_g;
-            sum_b    += sum_in_b;
-            sum_a    += sum_in_a;
-
-            ++stack_ptr;
-            if (stack_ptr >= div) stack_ptr = 0;
-            stack_pix_ptr = &stack[stack_ptr];
-
-            sum_out_r += stack_pix_ptr->r;
-            sum_out_g += stack_pix_ptr->g;
-            sum_out_b += stack_pix_ptr->b;
-            sum_out_a += stack_pix_ptr->a;
-            sum_in_r  -= stack_pix_ptr->r;
-            sum_in_g  -= stack_pix_ptr->g;
-            sum_in_b  -= stack_pix_ptr->b;
-            sum_in_a  -= stack_pix_ptr->a;
-         }
-      }
-   }
 
-   if (ry > 0) {
-      if (rx > 0) {
-         in_data = out_data; // If rx was already processed, the dest becomes the source
+   uint8_t *in_pixels = inBmp->Data + (outBmp->Clip.Left<<2) + (outBmp->Clip.Top * inBmp->LineWidth);
+   const uint8_t *in_data = in_pixels;
+   uint8_t *out_data = outBmp->Data + (outBmp->Clip.Left<<2) + (outBmp->Clip.Top * outBmp->LineWidth);
+   ptrdiff_t in_stride = inBmp->LineWidth;
+
+   int thread_count = std::thread::hardware_concurrency();
+   if (thread_count < 1) thread_count = 1;
+   if (int64_t(w) * int64_t(h) < 256 * 256) thread_count = 1; // Not worth the overhead
+
+   BS::thread_pool pool(thread_count);
+
+   const int rows_per_task = (((h + thread_count - 1) / thread_count) + 1) & ~1; // Even, for paired kernels
+
+   // Input rows are premultiplied by the same task that blurs them, while they are in the cache.
+
+   auto premultiply_rows = [=](int Top, int Count) {
+      for (int y=Top; y < Top + Count; y++) premultiply_row(in_pixels + (y * in_stride), w, decode, A, R, G, B);
+   };
+
+   if (rx > 0) { // Horizontal pass
+      const int radius = std::min(rx, STACK_BLUR_MAX);
+
+      for (int top=0; top < h; top += rows_per_task) {
+         const int count = std::min(rows_per_task, h - top);
+         pool.detach_task([=]() {
+            premultiply_rows(top, count);
+
+            blur_line line = {
+               .src = in_data + (top * in_stride), .dest = out_data + (top * outBmp->LineWidth),
+               .src_step = 4, .src_next = 0, .dest_step = 4, .dest_next = 0, .length = w
+            };
+            blur_lines(line, count, in_stride, outBmp->LineWidth, radius, box_x);
+         });
       }
 
-      if (ry > 254) ry = 254;
-      div = ry * 2 + 1;
-      mul_sum = stack_blur_tables<int>::g_stack_blur8_mul[ry];
-      shr_sum = stack_blur_tables<int>::g_stack_blur8_shr[ry];
-      stack.resize(div);
-
-      int stride = outBmp->LineWidth;
-      for (x = 0; x < w; x++) {
-         sum_r = sum_g = sum_b = sum_a = sum_in_r = sum_in_g = sum_in_b = sum_in_a = sum_out_r = sum_out_g = sum_out_b = sum_out_a = 0;
-
-         const uint8_t * src_pix_ptr = in_data + (x<<2);
-         for (int i = 0; i <= ry; i++) {
-             stack_pix_ptr    = &stack[i];
-             stack_pix_ptr->r = src_pix_ptr[R];
-             stack_pix_ptr->g = src_pix_ptr[G];
-             stack_pix_ptr->b = src_pix_ptr[B];
-             stack_pix_ptr->a = src_pix_ptr[A];
-             sum_r += src_pix_ptr[R] * (i + 1);
-             sum_g += src_pix_ptr[G] * (i + 1);
-             sum_b += src_pix_ptr[B] * (i + 1);
-             sum_a += src_pix_ptr[A] * (i + 1);
-             sum_out_r += src_pix_ptr[R];
-             sum_out_g += src_pix_ptr[G];
-             sum_out_b += src_pix_ptr[B];
-             sum_out_a += src_pix_ptr[A];
-         }
-
-         for (int i = 1; i <= ry; i++) {
-             if (i <= hm) src_pix_ptr += stride;
-             stack_pix_ptr = &stack[i + ry];
-             stack_pix_ptr->r = src_pix_ptr[R];
-             stack_pix_ptr->g = src_pix_ptr[G];
-             stack_pix_ptr->b = src_pix_ptr[B];
-             stack_pix_ptr->a = src_pix_ptr[A];
-             sum_r += src_pix_ptr[R] * (ry + 1 - i);
-             sum_g += src_pix_ptr[G] * (ry + 1 - i);
-             sum_b += src_pix_ptr[B] * (ry + 1 - i);
-             sum_a += src_pix_ptr[A] * (ry + 1 - i);
-             sum_in_r += src_pix_ptr[R];
-             sum_in_g += src_pix_ptr[G];
-             sum_in_b += src_pix_ptr[B];
-             sum_in_a += src_pix_ptr[A];
-         }
-
-         stack_ptr = ry;
-         yp = ry;
-         if (yp > hm) yp = hm;
-         src_pix_ptr = in_data + (x<<2) + (outBmp->LineWidth * yp);
-         dst_pix_ptr = out_data + (x<<2);
-         for (int y = 0; y < h; y++) {
-            dst_pix_ptr[R] = (sum_r * mul_sum) >> shr_sum;
-            dst_pix_ptr[G] = (sum_g * mul_sum) >> shr_sum;
-            dst_pix_ptr[B] = (sum_b * mul_sum) >> shr_sum;
-            dst_pix_ptr[A] = (sum_a * mul_sum) >> shr_sum;
-            dst_pix_ptr += stride;
-
-            sum_r -= sum_out_r;
-            sum_g -= sum_out_g;
-            sum_b -= sum_out_b;
-            sum_a -= sum_out_a;
-
-            stack_start = stack_ptr + div - ry;
-            if (stack_start >= div) stack_start -= div;
-
-            stack_pix_ptr = &stack[stack_start];
-            sum_out_r -= stack_pix_ptr->r;
-            sum_out_g -= stack_pix_ptr->g;
-            sum_out_b -= stack_pix_ptr->b;
-            sum_out_a -= stack_pix_ptr->a;
-
-            if (yp < hm) {
-                src_pix_ptr += stride;
-                ++yp;
-            }
-
-            stack_pix_ptr->r = src_pix_ptr[R];
-            stack_pix_ptr->g = src_pix_ptr[G];
-            stack_pix_ptr->b = src_pix_ptr[B];
-            stack_pix_ptr->a = src_pix_ptr[A];
-
-            sum_in_r += src_pix_ptr[R];
-            sum_in_g += src_pix_ptr[G];
-            sum_in_b += src_pix_ptr[B];
-            sum_in_a += src_pix_ptr[A];
-            sum_r    += sum_in_r;
-            sum_g    += sum_in_g;
-            sum_b    += sum_in_b;
-            sum_a    += sum_in_a;
-
-            ++stack_ptr;
-            if (stack_ptr >= div) stack_ptr = 0;
-            stack_pix_ptr = &stack[stack_ptr];
-
-            sum_out_r += stack_pix_ptr->r;
-            sum_out_g += stack_pix_ptr->g;
-            sum_out_b += stack_pix_ptr->b;
-            sum_out_a += stack_pix_ptr->a;
-            sum_in_r  -= stack_pix_ptr->r;
-            sum_in_g  -= stack_pix_ptr->g;
-            sum_in_b  -= stack_pix_ptr->b;
-            sum_in_a  -= stack_pix_ptr->a;
-         }
+      pool.wait();
+
+      in_data   = out_data; // If rx was already processed, the dest becomes the source
+      in_stride = outBmp->LineWidth;
+   }
+   else {
+      for (int top=0; top < h; top += rows_per_task) {
+         pool.detach_task([=]() { premultiply_rows(top, std::min(rows_per_task, h - top)); });
       }
+      pool.wait();
    }
 
-   //bmpDemultiply(inBmp);
+   inBmp->Flags |= BMF::PREMUL;
+   if (linear) inBmp->ColourSpace = CS::LINEAR_RGB;
+
+   if (ry > 0) { // Vertical pass
+      const int radius = std::min(ry, STACK_BLUR_MAX);
+      const int cols_per_task = (((w + thread_count - 1) / thread_count) + 1) & ~1;
+
+      for (int left=0; left < w; left += cols_per_task) {
+         const int count = std::min(cols_per_task, w - left);
+         pool.detach_task([=]() {
+            blur_line line = {
+               .src = in_data + (left<<2), .dest = out_data + (left<<2),
+               .src_step = in_stride, .src_next = 0, .dest_step = outBmp->LineWidth, .dest_next = 0, .length = h
+            };
+            blur_lines(line, count, 4, 4, radius, box_y);
+         });
+      }
+
+      pool.wait();
+   }
 
-   outBmp->Flags |= BMF::PREMUL; // Need to tell the bitmap it has premultiplied output before Demultiply()
-   outBmp->demultiply();
+   // Demultiply the output, converting it back to sRGB in the same pass unless it is to remain linear.
 
-   if (Self->Filter->ColourSpace IS VCS::LINEAR_RGB) {
-      outBmp->ColourSpace = CS::LINEAR_RGB;
-      outBmp->convertToRGB();
+   const bool encode = linear and (out_space IS CS::SRGB);
+   for (int top=0; top < h; top += rows_per_task) {
+      const int count = std::min(rows_per_task, h - top);
+      pool.detach_task([=]() {
+         for (int y=top; y < top + count; y++) demultiply_row(out_data + (y * outBmp->LineWidth), w, encode, A, R, G, B);
+      });
    }
 
+   pool.wait();
+
+   outBmp->Flags &= ~BMF::PREMUL;
+   outBmp->ColourSpace = out_space;
+
    return ERR::Okay;
 }
 
@@ -407,6 +583,7 @@ static ERR BLURFX_GET_SX(extBlurFX *Self, double *Value)
 static ERR BLURFX_SET_SX(extBlurFX *Self, double Value)
 {
    Self->SX = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -430,6 +607,7 @@ static ERR BLURFX_GET_SY(extBlurFX *Self, double *Value)
 static ERR BLURFX_SET_SY(extBlurFX *Self, double Value)
 {
    Self->SY = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
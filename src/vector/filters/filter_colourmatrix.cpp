@@ -348,7 +348,9 @@ static ERR COLOURFX_Draw(extColourFX *Self, struct acDraw *Args)
    ColourMatrix &matrix = *Self->Matrix;
 
    objBitmap *inBmp;
-   if (get_source_bitmap(Self->Filter, &inBmp, Self->SourceType, Self->Input, false) != ERR::Okay) return ERR::NoData;
+   if (get_source_bitmap(Self->Filter, &inBmp, Self->SourceType, Self->Input, false, CS::NIL) != ERR::Okay) return ERR::NoData;
+
+   const uint8_t *decode = glLinearRGB.decode_table(inBmp->ColourSpace IS CS::LINEAR_RGB);
 
    auto out_line = Self->Target->Data + (Self->Target->Clip.Left<<2) + (Self->Target->Clip.Top * Self->Target->LineWidth);
    auto in_line  = inBmp->Data + (inBmp->Clip.Left<<2) + (inBmp->Clip.Top * inBmp->LineWidth);
@@ -359,9 +361,9 @@ static ERR COLOURFX_Draw(extColourFX *Self, struct acDraw *Args)
       for (int x=0; x < inBmp->Clip.Right - inBmp->Clip.Left; x++, pixel += 4, out += 4) {
          double a = pixel[A];
          if (a) {
-            double r = glLinearRGB.convert(pixel[R]);
-            double g = glLinearRGB.convert(pixel[G]);
-            double b = glLinearRGB.convert(pixel[B]);
+            double r = decode[pixel[R]];
+            double g = decode[pixel[G]];
+            double b = decode[pixel[B]];
 
             int r2 = 0.5 + (r * matrix[0]) + (g * matrix[1]) + (b * matrix[2]) + (a * matrix[3]) + matrix[4];
             int g2 = 0.5 + (r * matrix[5]) + (g * matrix[6]) + (b * matrix[7]) + (a * matrix[8]) + matrix[9];
@@ -497,6 +499,7 @@ static ERR COLOURFX_GET_Mode(extColourFX *Self, CM *Value)
 static ERR COLOURFX_SET_Mode(extColourFX *Self, CM Value)
 {
    Self->Mode = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -524,6 +527,7 @@ static ERR COLOURFX_SET_Values(extColourFX *Self, double *Array, int Elements)
    if (Elements > std::ssize(Self->Values)) return ERR::InvalidValue;
    if (Array) copymem(Array, Self->Values, Elements * sizeof(double));
    clearmem(Self->Values + Elements, (std::ssize(Self->Values) - Elements) * sizeof(double));
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -22,6 +22,11 @@ class extCompositeFX : public extFilterEffect {
 
    template <class CompositeOp>
    void doMix(objBitmap *InBitmap, objBitmap *MixBitmap, uint8_t *Dest, uint8_t *In, uint8_t *Mix) {
+      // Colour values are decoded to linear RGB via tables, so that linear input needs no conversion pass.
+
+      const uint8_t *SL = glLinearRGB.decode_table(InBitmap->ColourSpace IS CS::LINEAR_RGB);
+      const uint8_t *ML = glLinearRGB.decode_table(MixBitmap->ColourSpace IS CS::LINEAR_RGB);
+
       const uint8_t A = Target->ColourFormat->AlphaPos>>3;
       const uint8_t R = Target->ColourFormat->RedPos>>3;
       const uint8_t G = Target->ColourFormat->GreenPos>>3;
@@ -37,7 +42,7 @@ class extCompositeFX : public extFilterEffect {
          auto sp = In;
          auto mp = Mix;
          for (int x=0; x < width; x++) {
-            CompositeOp::blend(dp, sp, mp, A, R, G, B);
+            CompositeOp::blend(dp, sp, mp, SL, ML, A, R, G, B);
             dp += 4;
             sp += 4;
             mp += 4;
@@ -57,7 +62,7 @@ class extCompositeFX : public extFilterEffect {
 // D = Dest; S = Source; M = Mix (equates to Dest as a pixel source)
 
 struct composite_over {
-   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
+   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, const uint8_t *SL, const uint8_t *ML, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
       if (!M[A]) ((uint32_t *)D)[0] = ((uint32_t *)S)[0];
       else if (!S[A]) ((uint32_t *)D)[0] = ((uint32_t *)M)[0];
       else {
@@ -66,16 +71,16 @@ struct composite_over {
          const uint32_t cA = 256 - sA;
          const uint32_t mA = M[A] + (M[A] >> 7); // 0..255 -> 0..256
 
-         D[R] = glLinearRGB.invert(((glLinearRGB.convert(S[R]) * sA + ((glLinearRGB.convert(M[R]) * mA * cA)>>8))>>8) * 255 / dA);
-         D[G] = glLinearRGB.invert(((glLinearRGB.convert(S[G]) * sA + ((glLinearRGB.convert(M[G]) * mA * cA)>>8))>>8) * 255 / dA);
-         D[B] = glLinearRGB.invert(((glLinearRGB.convert(S[B]) * sA + ((glLinearRGB.convert(M[B]) * mA * cA)>>8))>>8) * 255 / dA);
+         D[R] = glLinearRGB.invert(((SL[S[R]] * sA + ((ML[M[R]] * mA * cA)>>8))>>8) * 255 / dA);
+         D[G] = glLinearRGB.invert(((SL[S[G]] * sA + ((ML[M[G]] * mA * cA)>>8))>>8) * 255 / dA);
+         D[B] = glLinearRGB.invert(((SL[S[B]] * sA + ((ML[M[B]] * mA * cA)>>8))>>8) * 255 / dA);
          D[A] = dA;
       }
    }
 };
 
 struct composite_in {
-   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
+   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, const uint8_t *SL, const uint8_t *ML, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
       if (M[A] IS 255) ((uint32_t *)D)[0] = ((uint32_t *)S)[0];
       else {
          D[R] = S[R];
@@ -87,7 +92,7 @@ struct composite_in {
 };
 
 struct composite_out {
-   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
+   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, const uint8_t *SL, const uint8_t *ML, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
       if (!M[A]) ((uint32_t *)D)[0] = ((uint32_t *)S)[0];
       else {
          D[R] = S[R];
@@ -102,15 +107,15 @@ struct composite_out {
 // output.  S alpha is ignored except for blending with M.
 
 struct composite_atop {
-   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
+   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, const uint8_t *SL, const uint8_t *ML, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
       if (auto m_alpha = M[A]) {
-         auto sR = glLinearRGB.convert(S[R]);
-         auto sG = glLinearRGB.convert(S[G]);
-         auto sB = glLinearRGB.convert(S[B]);
+         auto sR = SL[S[R]];
+         auto sG = SL[S[G]];
+         auto sB = SL[S[B]];
 
-         auto mR = glLinearRGB.convert(M[R]);
-         auto mG = glLinearRGB.convert(M[G]);
-         auto mB = glLinearRGB.convert(M[B]);
+         auto mR = ML[M[R]];
+         auto mG = ML[M[G]];
+         auto mB = ML[M[B]];
 
          const uint8_t sA  = S[A];
          const uint8_t scA = 0xff - sA;
@@ -124,14 +129,14 @@ struct composite_atop {
 };
 
 struct composite_xor {
-   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
-      auto sR = glLinearRGB.convert(S[R]);
-      auto sG = glLinearRGB.convert(S[G]);
-      auto sB = glLinearRGB.convert(S[B]);
+   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, const uint8_t *SL, const uint8_t *ML, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
+      auto sR = SL[S[R]];
+      auto sG = SL[S[G]];
+      auto sB = SL[S[B]];
 
-      auto mR = glLinearRGB.convert(M[R]);
-      auto mG = glLinearRGB.convert(M[G]);
-      auto mB = glLinearRGB.convert(M[B]);
+      auto mR = ML[M[R]];
+      auto mG = ML[M[G]];
+      auto mB = ML[M[B]];
 
       const uint8_t s1a = 0xff - S[A];
       const uint8_t d1a = 0xff - M[A];
@@ -146,14 +151,14 @@ struct composite_xor {
 // Blending algorithms, refer to https://en.wikipedia.org/wiki/Blend_modes
 
 struct blend_screen {
-   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
-      auto sR = glLinearRGB.convert(S[R]);
-      auto sG = glLinearRGB.convert(S[G]);
-      auto sB = glLinearRGB.convert(S[B]);
+   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, const uint8_t *SL, const uint8_t *ML, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
+      auto sR = SL[S[R]];
+      auto sG = SL[S[G]];
+      auto sB = SL[S[B]];
 
-      auto mR = glLinearRGB.convert(M[R]);
-      auto mG = glLinearRGB.convert(M[G]);
-      auto mB = glLinearRGB.convert(M[B]);
+      auto mR = ML[M[R]];
+      auto mG = ML[M[G]];
+      auto mB = ML[M[B]];
 
       D[R] = glLinearRGB.invert(sR + mR - ((sR * mR + 0Xff) >> 8));
       D[G] = glLinearRGB.invert(sG + mG - ((sG * mG + 0Xff) >> 8));
@@ -163,15 +168,15 @@ struct blend_screen {
 };
 
 struct blend_multiply {
-   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
+   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, const uint8_t *SL, const uint8_t *ML, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
       if ((S[A]) or (M[A])) {
-         auto sR = glLinearRGB.convert(S[R]);
-         auto sG = glLinearRGB.convert(S[G]);
-         auto sB = glLinearRGB.convert(S[B]);
+         auto sR = SL[S[R]];
+         auto sG = SL[S[G]];
+         auto sB = SL[S[B]];
 
-         auto mR = glLinearRGB.convert(M[R]);
-         auto mG = glLinearRGB.convert(M[G]);
-         auto mB = glLinearRGB.convert(M[B]);
+         auto mR = ML[M[R]];
+         auto mG = ML[M[G]];
+         auto mB = ML[M[B]];
 
          const uint8_t s1a = 0xff - S[A];
          const uint8_t d1a = 0xff - M[A];
@@ -184,15 +189,15 @@ struct blend_multiply {
 };
 
 struct blend_darken {
-   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
+   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, const uint8_t *SL, const uint8_t *ML, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
       if ((S[A]) or (M[A])) {
-         auto sR = glLinearRGB.convert(S[R]);
-         auto sG = glLinearRGB.convert(S[G]);
-         auto sB = glLinearRGB.convert(S[B]);
+         auto sR = SL[S[R]];
+         auto sG = SL[S[G]];
+         auto sB = SL[S[B]];
 
-         auto mR = glLinearRGB.convert(M[R]);
-         auto mG = glLinearRGB.convert(M[G]);
-         auto mB = glLinearRGB.convert(M[B]);
+         auto mR = ML[M[R]];
+         auto mG = ML[M[G]];
+         auto mB = ML[M[B]];
 
          uint8_t d1a = 0xff - D[A];
          uint8_t s1a = 0xff - S[A];
@@ -207,15 +212,15 @@ struct blend_darken {
 };
 
 struct blend_lighten {
-   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
+   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, const uint8_t *SL, const uint8_t *ML, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
       if ((S[A]) or (M[A])) {
-         auto sR = glLinearRGB.convert(S[R]);
-         auto sG = glLinearRGB.convert(S[G]);
-         auto sB = glLinearRGB.convert(S[B]);
+         auto sR = SL[S[R]];
+         auto sG = SL[S[G]];
+         auto sB = SL[S[B]];
 
-         auto mR = glLinearRGB.convert(M[R]);
-         auto mG = glLinearRGB.convert(M[G]);
-         auto mB = glLinearRGB.convert(M[B]);
+         auto mR = ML[M[R]];
+         auto mG = ML[M[G]];
+         auto mB = ML[M[B]];
 
          uint8_t d1a = 0xff - D[A];
          uint8_t s1a = 0xff - S[A];
@@ -229,15 +234,15 @@ struct blend_lighten {
 };
 
 struct blend_dodge {
-   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
+   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, const uint8_t *SL, const uint8_t *ML, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
       if ((S[A]) or (M[A])) {
-         auto sR = glLinearRGB.convert(S[R]);
-         auto sG = glLinearRGB.convert(S[G]);
-         auto sB = glLinearRGB.convert(S[B]);
+         auto sR = SL[S[R]];
+         auto sG = SL[S[G]];
+         auto sB = SL[S[B]];
 
-         auto mR = glLinearRGB.convert(M[R]);
-         auto mG = glLinearRGB.convert(M[G]);
-         auto mB = glLinearRGB.convert(M[B]);
+         auto mR = ML[M[R]];
+         auto mG = ML[M[G]];
+         auto mB = ML[M[B]];
 
          int d1a  = 0xff - M[A];
          int s1a  = 0xff - S[A];
@@ -267,14 +272,14 @@ struct blend_dodge {
 };
 
 struct blend_contrast {
-   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
-      auto sR = glLinearRGB.convert(S[R]);
-      auto sG = glLinearRGB.convert(S[G]);
-      auto sB = glLinearRGB.convert(S[B]);
+   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, const uint8_t *SL, const uint8_t *ML, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
+      auto sR = SL[S[R]];
+      auto sG = SL[S[G]];
+      auto sB = SL[S[B]];
 
-      auto mR = glLinearRGB.convert(M[R]);
-      auto mG = glLinearRGB.convert(M[G]);
-      auto mB = glLinearRGB.convert(M[B]);
+      auto mR = ML[M[R]];
+      auto mG = ML[M[G]];
+      auto mB = ML[M[B]];
 
       int d2a = M[A] >> 1;
       uint8_t s2a = S[A] >> 1;
@@ -294,15 +299,15 @@ struct blend_contrast {
 };
 
 struct blend_overlay {
-   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
+   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, const uint8_t *SL, const uint8_t *ML, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
       if ((S[A]) or (M[A])) {
-         auto sR = glLinearRGB.convert(S[R]);
-         auto sG = glLinearRGB.convert(S[G]);
-         auto sB = glLinearRGB.convert(S[B]);
+         auto sR = SL[S[R]];
+         auto sG = SL[S[G]];
+         auto sB = SL[S[B]];
 
-         auto mR = glLinearRGB.convert(M[R]);
-         auto mG = glLinearRGB.convert(M[G]);
-         auto mB = glLinearRGB.convert(M[B]);
+         auto mR = ML[M[R]];
+         auto mG = ML[M[G]];
+         auto mB = ML[M[B]];
 
          uint8_t d1a = 0xff - M[A];
          uint8_t s1a = 0xff - S[A];
@@ -326,15 +331,15 @@ struct blend_overlay {
 };
 
 struct blend_burn {
-   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
+   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, const uint8_t *SL, const uint8_t *ML, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
       if ((S[A]) or (M[A])) {
-         auto sR = glLinearRGB.convert(S[R]);
-         auto sG = glLinearRGB.convert(S[G]);
-         auto sB = glLinearRGB.convert(S[B]);
+         auto sR = SL[S[R]];
+         auto sG = SL[S[G]];
+         auto sB = SL[S[B]];
 
-         auto mR = glLinearRGB.convert(M[R]);
-         auto mG = glLinearRGB.convert(M[G]);
-         auto mB = glLinearRGB.convert(M[B]);
+         auto mR = ML[M[R]];
+         auto mG = ML[M[G]];
+         auto mB = ML[M[B]];
 
          const uint8_t d1a = 0xff - D[A];
          const uint8_t s1a = 0xff - S[A];
@@ -364,15 +369,15 @@ struct blend_burn {
 };
 
 struct blend_hard_light {
-   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
+   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, const uint8_t *SL, const uint8_t *ML, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
       if ((S[A]) or (M[A])) {
-         auto sR = glLinearRGB.convert(S[R]);
-         auto sG = glLinearRGB.convert(S[G]);
-         auto sB = glLinearRGB.convert(S[B]);
+         auto sR = SL[S[R]];
+         auto sG = SL[S[G]];
+         auto sB = SL[S[B]];
 
-         auto mR = glLinearRGB.convert(M[R]);
-         auto mG = glLinearRGB.convert(M[G]);
-         auto mB = glLinearRGB.convert(M[B]);
+         auto mR = ML[M[R]];
+         auto mG = ML[M[G]];
+         auto mB = ML[M[B]];
 
          uint8_t d1a  = 0xff - D[A];
          uint8_t s1a  = 0xff - S[A];
@@ -396,11 +401,11 @@ struct blend_hard_light {
 };
 
 struct blend_soft_light {
-   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
+   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, const uint8_t *SL, const uint8_t *ML, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
       if ((S[A]) or (M[A])) {
-         auto sR = glLinearRGB.convert(S[R]);
-         auto sG = glLinearRGB.convert(S[G]);
-         auto sB = glLinearRGB.convert(S[B]);
+         auto sR = SL[S[R]];
+         auto sG = SL[S[G]];
+         auto sB = SL[S[B]];
 
          double xr = double(glLinearRGB.convert(D[R])) / 0xff;
          double xg = double(glLinearRGB.convert(D[G])) / 0xff;
@@ -428,15 +433,15 @@ struct blend_soft_light {
 };
 
 struct blend_difference {
-   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
+   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, const uint8_t *SL, const uint8_t *ML, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
       if ((S[A]) or (M[A])) {
-         auto sR = glLinearRGB.convert(S[R]);
-         auto sG = glLinearRGB.convert(S[G]);
-         auto sB = glLinearRGB.convert(S[B]);
+         auto sR = SL[S[R]];
+         auto sG = SL[S[G]];
+         auto sB = SL[S[B]];
 
-         auto mR = glLinearRGB.convert(M[R]);
-         auto mG = glLinearRGB.convert(M[G]);
-         auto mB = glLinearRGB.convert(M[B]);
+         auto mR = ML[M[R]];
+         auto mG = ML[M[G]];
+         auto mB = ML[M[B]];
 
          D[R] = glLinearRGB.invert(sR + mR - ((2 * agg::sd_min(sR*M[A], mR*S[A]) + 0xff) >> 8));
          D[G] = glLinearRGB.invert(sG + mG - ((2 * agg::sd_min(sG*M[A], mG*S[A]) + 0xff) >> 8));
@@ -447,15 +452,15 @@ struct blend_difference {
 };
 
 struct blend_exclusion {
-   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
+   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, const uint8_t *SL, const uint8_t *ML, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
       if ((S[A]) or (M[A])) {
-         auto sR = glLinearRGB.convert(S[R]);
-         auto sG = glLinearRGB.convert(S[G]);
-         auto sB = glLinearRGB.convert(S[B]);
+         auto sR = SL[S[R]];
+         auto sG = SL[S[G]];
+         auto sB = SL[S[B]];
 
-         auto mR = glLinearRGB.convert(M[R]);
-         auto mG = glLinearRGB.convert(M[G]);
-         auto mB = glLinearRGB.convert(M[B]);
+         auto mR = ML[M[R]];
+         auto mG = ML[M[G]];
+         auto mB = ML[M[B]];
 
          const uint8_t d1a = 0xff - D[A];
          const uint8_t s1a = 0xff - S[A];
@@ -468,11 +473,11 @@ struct blend_exclusion {
 };
 
 struct blend_plus {
-   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
+   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, const uint8_t *SL, const uint8_t *ML, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
       if ((S[A]) or (M[A])) {
-         auto sR = glLinearRGB.convert(S[R]);
-         auto sG = glLinearRGB.convert(S[G]);
-         auto sB = glLinearRGB.convert(S[B]);
+         auto sR = SL[S[R]];
+         auto sG = SL[S[G]];
+         auto sB = SL[S[B]];
 
          const uint8_t xr = glLinearRGB.convert(D[R]) + sR;
          const uint8_t xg = glLinearRGB.convert(D[G]) + sG;
@@ -487,11 +492,11 @@ struct blend_plus {
 };
 
 struct blend_minus {
-   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
+   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, const uint8_t *SL, const uint8_t *ML, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
       if ((S[A]) or (M[A])) {
-         auto sR = glLinearRGB.convert(S[R]);
-         auto sG = glLinearRGB.convert(S[G]);
-         auto sB = glLinearRGB.convert(S[B]);
+         auto sR = SL[S[R]];
+         auto sG = SL[S[G]];
+         auto sB = SL[S[B]];
 
          const uint8_t xr = glLinearRGB.convert(D[R]) - sR;
          const uint8_t xg = glLinearRGB.convert(D[G]) - sG;
@@ -506,7 +511,7 @@ struct blend_minus {
 };
 
 struct blend_invert {
-   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
+   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, const uint8_t *SL, const uint8_t *ML, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
       if ((S[A]) or (M[A])) {
          auto dR = glLinearRGB.convert(D[R]);
          auto dG = glLinearRGB.convert(D[G]);
@@ -525,11 +530,11 @@ struct blend_invert {
 };
 
 struct blend_invert_rgb {
-   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
+   static inline void blend(uint8_t *D, uint8_t *S, uint8_t *M, const uint8_t *SL, const uint8_t *ML, uint8_t A, uint8_t R, uint8_t G, uint8_t B) {
       if (S[A]) {
-         auto sR = glLinearRGB.convert(S[R]);
-         auto sG = glLinearRGB.convert(S[G]);
-         auto sB = glLinearRGB.convert(S[B]);
+         auto sR = SL[S[R]];
+         auto sG = SL[S[G]];
+         auto sB = SL[S[B]];
 
          auto dR = glLinearRGB.convert(D[R]);
          auto dG = glLinearRGB.convert(D[G]);
@@ -601,9 +606,9 @@ static ERR COMPOSITEFX_Draw(extCompositeFX *Self, struct acDraw *Args)
       }
 
       case OP::ATOP: {
-         if (get_source_bitmap(Self->Filter, &inBmp, Self->SourceType, Self->Input, false) IS ERR::Okay) {
+         if (get_source_bitmap(Self->Filter, &inBmp, Self->SourceType, Self->Input, false, CS::NIL) IS ERR::Okay) {
             objBitmap *mixBmp;
-            if (get_source_bitmap(Self->Filter, &mixBmp, Self->MixType, Self->Mix, false) IS ERR::Okay) {
+            if (get_source_bitmap(Self->Filter, &mixBmp, Self->MixType, Self->Mix, false, CS::NIL) IS ERR::Okay) {
                uint8_t *in  = inBmp->Data + (inBmp->Clip.Left * 4) + (inBmp->Clip.Top * inBmp->LineWidth);
                uint8_t *mix = mixBmp->Data + (mixBmp->Clip.Left * 4) + (mixBmp->Clip.Top * mixBmp->LineWidth);
                Self->doMix<composite_atop>(inBmp, mixBmp, dest, in, mix);
@@ -613,9 +618,9 @@ static ERR COMPOSITEFX_Draw(extCompositeFX *Self, struct acDraw *Args)
       }
 
       case OP::XOR: {
-         if (get_source_bitmap(Self->Filter, &inBmp, Self->SourceType, Self->Input, false) IS ERR::Okay) {
+         if (get_source_bitmap(Self->Filter, &inBmp, Self->SourceType, Self->Input, false, CS::NIL) IS ERR::Okay) {
             objBitmap *mixBmp;
-            if (get_source_bitmap(Self->Filter, &mixBmp, Self->MixType, Self->Mix, false) IS ERR::Okay) {
+            if (get_source_bitmap(Self->Filter, &mixBmp, Self->MixType, Self->Mix, false, CS::NIL) IS ERR::Okay) {
                uint8_t *in  = inBmp->Data + (inBmp->Clip.Left * 4) + (inBmp->Clip.Top * inBmp->LineWidth);
                uint8_t *mix = mixBmp->Data + (mixBmp->Clip.Left * 4) + (mixBmp->Clip.Top * mixBmp->LineWidth);
                Self->doMix<composite_xor>(inBmp, mixBmp, dest, in, mix);
@@ -625,7 +630,7 @@ static ERR COMPOSITEFX_Draw(extCompositeFX *Self, struct acDraw *Args)
       }
 
       case OP::ARITHMETIC: {
-         if (get_source_bitmap(Self->Filter, &inBmp, Self->SourceType, Self->Input, false) IS ERR::Okay) {
+         if (get_source_bitmap(Self->Filter, &inBmp, Self->SourceType, Self->Input, false, CS::NIL) IS ERR::Okay) {
             objBitmap *mixBmp;
             int height = Self->Target->Clip.Bottom - Self->Target->Clip.Top;
             int width  = Self->Target->Clip.Right - Self->Target->Clip.Left;
@@ -637,9 +642,11 @@ static ERR COMPOSITEFX_Draw(extCompositeFX *Self, struct acDraw *Args)
             const uint8_t G = Self->Target->ColourFormat->GreenPos>>3;
             const uint8_t B = Self->Target->ColourFormat->BluePos>>3;
 
-            if (get_source_bitmap(Self->Filter, &mixBmp, Self->MixType, Self->Mix, false) IS ERR::Okay) {
+            if (get_source_bitmap(Self->Filter, &mixBmp, Self->MixType, Self->Mix, false, CS::NIL) IS ERR::Okay) {
                uint8_t *in  = inBmp->Data + (inBmp->Clip.Left * 4) + (inBmp->Clip.Top * inBmp->LineWidth);
                uint8_t *mix = mixBmp->Data + (mixBmp->Clip.Left * 4) + (mixBmp->Clip.Top * mixBmp->LineWidth);
+               const uint8_t *SL = glLinearRGB.decode_table(inBmp->ColourSpace IS CS::LINEAR_RGB);
+               const uint8_t *ML = glLinearRGB.decode_table(mixBmp->ColourSpace IS CS::LINEAR_RGB);
                for (int y=0; y < height; y++) {
                   auto dp = dest;
                   auto sp = in;
@@ -650,14 +657,14 @@ static ERR COMPOSITEFX_Draw(extCompositeFX *Self, struct acDraw *Args)
                         #define SCALE (1.0 / 255.0)
                         #define DESCALE 255.0
                         const double sA = double(sp[A]) * SCALE;
-                        const double sR = double(glLinearRGB.convert(sp[R])) * SCALE * sA;
-                        const double sG = double(glLinearRGB.convert(sp[G])) * SCALE * sA;
-                        const double sB = double(glLinearRGB.convert(sp[B])) * SCALE * sA;
+                        const double sR = double(SL[sp[R]]) * SCALE * sA;
+                        const double sG = double(SL[sp[G]]) * SCALE * sA;
+                        const double sB = double(SL[sp[B]]) * SCALE * sA;
 
                         const double mA = double(mp[A]) * SCALE;
-                        const double mR = double(glLinearRGB.convert(mp[R])) * SCALE * mA;
-                        const double mG = double(glLinearRGB.convert(mp[G])) * SCALE * mA;
-                        const double mB = double(glLinearRGB.convert(mp[B])) * SCALE * mA;
+                        const double mR = double(ML[mp[R]]) * SCALE * mA;
+                        const double mG = double(ML[mp[G]]) * SCALE * mA;
+                        const double mB = double(ML[mp[B]]) * SCALE * mA;
 
                         double dA = (Self->K1 * sA * mA) + (Self->K2 * sA) + (Self->K3 * mA) + Self->K4;
 
@@ -774,6 +781,7 @@ static ERR COMPOSITEFX_GET_K1(extCompositeFX *Self, double *Value)
 static ERR COMPOSITEFX_SET_K1(extCompositeFX *Self, double Value)
 {
    Self->K1 = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -793,6 +801,7 @@ static ERR COMPOSITEFX_GET_K2(extCompositeFX *Self, double *Value)
 static ERR COMPOSITEFX_SET_K2(extCompositeFX *Self, double Value)
 {
    Self->K2 = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -812,6 +821,7 @@ static ERR COMPOSITEFX_GET_K3(extCompositeFX *Self, double *Value)
 static ERR COMPOSITEFX_SET_K3(extCompositeFX *Self, double Value)
 {
    Self->K3 = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -831,6 +841,7 @@ static ERR COMPOSITEFX_GET_K4(extCompositeFX *Self, double *Value)
 static ERR COMPOSITEFX_SET_K4(extCompositeFX *Self, double Value)
 {
    Self->K4 = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -853,6 +864,7 @@ static ERR COMPOSITEFX_GET_Operator(extCompositeFX *Self, OP *Value)
 static ERR COMPOSITEFX_SET_Operator(extCompositeFX *Self, OP Value)
 {
    Self->Operator = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -180,13 +180,15 @@ static ERR CONVOLVEFX_Draw(extConvolveFX *Self, struct acDraw *Args)
    std::vector<uint8_t> data;
    data.resize(canvas_width * canvas_height * Self->Target->BytesPerPixel);
 
+   // The input is left in linear RGB on completion, as get_source_bitmap() will convert it if a later effect needs sRGB.
+
+   const CS space = (Self->Filter->ColourSpace IS VCS::LINEAR_RGB) ? CS::LINEAR_RGB : CS::SRGB;
    objBitmap *inBmp;
-   if (get_source_bitmap(Self->Filter, &inBmp, Self->SourceType, Self->Input, false) != ERR::Okay) return ERR::NoData;
+   if (get_source_bitmap(Self->Filter, &inBmp, Self->SourceType, Self->Input, false, space) != ERR::Okay) return ERR::NoData;
 
    // Note: The inBmp->Data pointer is pre-adjusted to match the Clip Left and Top values (i.e. add
    // (Clip.Left * BPP) + (Clip.Top * LineWidth) to Data in order to get its true value)
 
-   if (Self->Filter->ColourSpace IS VCS::LINEAR_RGB) inBmp->convertToLinear();
    inBmp->premultiply();
 
    int thread_count = std::thread::hardware_concurrency();
@@ -222,8 +224,6 @@ static ERR CONVOLVEFX_Draw(extConvolveFX *Self, struct acDraw *Args)
       src += canvas_width;
    }
 
-   if (Self->Filter->ColourSpace IS VCS::LINEAR_RGB) inBmp->convertToRGB();
-
    inBmp->demultiply();
    return ERR::Okay;
 }
@@ -307,6 +307,7 @@ static ERR CONVOLVEFX_GET_Bias(extConvolveFX *Self, double *Value)
 static ERR CONVOLVEFX_SET_Bias(extConvolveFX *Self, double Value)
 {
    Self->Bias = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -333,6 +334,7 @@ static ERR CONVOLVEFX_SET_Divisor(extConvolveFX *Self, double Value)
    pf::Log log;
    if (Value <= 0) return log.warning(ERR::InvalidValue);
    Self->Divisor = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -355,6 +357,7 @@ static ERR CONVOLVEFX_GET_EdgeMode(extConvolveFX *Self, EM *Value)
 static ERR CONVOLVEFX_SET_EdgeMode(extConvolveFX *Self, EM Value)
 {
    Self->EdgeMode = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -382,6 +385,7 @@ static ERR CONVOLVEFX_SET_Matrix(extConvolveFX *Self, double *Value, int Element
    if ((Elements > 0) and (Elements <= std::ssize(Self->Matrix))) {
       Self->MatrixSize = Elements;
       copymem(Value, Self->Matrix, sizeof(double) * Elements);
+      Self->modified();
       return ERR::Okay;
    }
    else return log.warning(ERR::InvalidValue);
@@ -410,6 +414,7 @@ static ERR CONVOLVEFX_SET_MatrixRows(extConvolveFX *Self, int Value)
    if (Value <= 0) return log.warning(ERR::InvalidValue);
 
    Self->MatrixRows = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -436,6 +441,7 @@ static ERR CONVOLVEFX_SET_MatrixColumns(extConvolveFX *Self, int Value)
    if (Value <= 0) return log.warning(ERR::InvalidValue);
 
    Self->MatrixColumns = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -455,6 +461,7 @@ static ERR CONVOLVEFX_GET_PreserveAlpha(extConvolveFX *Self, int *Value)
 static ERR CONVOLVEFX_SET_PreserveAlpha(extConvolveFX *Self, int Value)
 {
    Self->PreserveAlpha = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -484,6 +491,7 @@ static ERR CONVOLVEFX_SET_TargetX(extConvolveFX *Self, int Value)
    }
 
    Self->TargetX = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -513,6 +521,7 @@ static ERR CONVOLVEFX_SET_TargetY(extConvolveFX *Self, int Value)
    }
 
    Self->TargetY = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -544,6 +553,7 @@ static ERR CONVOLVEFX_SET_UnitX(extConvolveFX *Self, double Value)
    if (Value < 0) return ERR::InvalidValue;
 
    Self->UnitX = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -575,6 +585,7 @@ static ERR CONVOLVEFX_SET_UnitY(extConvolveFX *Self, double Value)
    if (Value < 0) return ERR::InvalidValue;
 
    Self->UnitY = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -174,6 +174,7 @@ static ERR DISPLACEMENTFX_GET_Scale(extDisplacementFX *Self, double *Value)
 static ERR DISPLACEMENTFX_SET_Scale(extDisplacementFX *Self, double Value)
 {
    Self->Scale = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -194,6 +195,7 @@ static ERR DISPLACEMENTFX_GET_XChannel(extDisplacementFX *Self, CMP *Value)
 static ERR DISPLACEMENTFX_SET_XChannel(extDisplacementFX *Self, CMP Value)
 {
    Self->XChannel = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -214,6 +216,7 @@ static ERR DISPLACEMENTFX_GET_YChannel(extDisplacementFX *Self, CMP *Value)
 static ERR DISPLACEMENTFX_SET_YChannel(extDisplacementFX *Self, CMP Value)
 {
    Self->YChannel = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
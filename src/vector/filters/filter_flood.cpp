@@ -110,6 +110,7 @@ static ERR FLOODFX_SET_Colour(extFloodFX *Self, float *Value, int Elements)
       else return log.warning(ERR::InvalidValue);
    }
    else Self->Colour.Alpha = 0;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -131,6 +132,7 @@ static ERR FLOODFX_SET_Opacity(extFloodFX *Self, double Value)
    pf::Log log;
    if ((Value >= 0.0) and (Value <= 1.0)) {
       Self->Opacity = Value;
+      Self->modified();
       return ERR::Okay;
    }
    else return log.warning(ERR::OutOfRange);
@@ -112,6 +112,7 @@ static ERR IMAGEFX_GET_AspectRatio(extImageFX *Self, ARF *Value)
 static ERR IMAGEFX_SET_AspectRatio(extImageFX *Self, ARF Value)
 {
    Self->AspectRatio = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -154,6 +155,7 @@ static ERR IMAGEFX_SET_Path(extImageFX *Self, CSTRING Value)
 
    if ((Self->Picture = objPicture::create::local(fl::Path(Value), fl::BitsPerPixel(32), fl::Flags(PCF::FORCE_ALPHA_32)))) {
       Self->Bitmap = Self->Picture->Bitmap;
+      Self->modified();
       return ERR::Okay;
    }
    else return ERR::CreateObject;
@@ -177,6 +179,7 @@ static ERR IMAGEFX_GET_ResampleMethod(extImageFX *Self, VSM *Value)
 static ERR IMAGEFX_SET_ResampleMethod(extImageFX *Self, VSM Value)
 {
    Self->ResampleMethod = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -608,9 +608,9 @@ void extLightingFX::draw()
    lt.y -= Target->Clip.Top;
 
    objBitmap *bmp;
-   if (get_source_bitmap(Filter, &bmp, SourceType, Input, false) != ERR::Okay) return;
+   if (get_source_bitmap(Filter, &bmp, SourceType, Input, false, CS::NIL) != ERR::Okay) return;
 
-   // Note! Linear conversion of the source bitmap is unnecessary because only the alpha channel is used.
+   // Note! Colour space conversion of the source bitmap is unnecessary because only the alpha channel is used.
 
    // The alpha channel of the source bitmap will function as the Z value for the bump map.  The RGB components
    // are ignored for input purposes.
@@ -700,6 +700,7 @@ static ERR LIGHTINGFX_SetDistantLight(extLightingFX *Self, struct lt::SetDistant
    Self->Elevation   = Args->Elevation;
    Self->LightSource = LS::DISTANT;
    Self->Direction   = point3(cos(Self->Azimuth * DEG2RAD) * cos(Self->Elevation * DEG2RAD), sin(Self->Azimuth * DEG2RAD) * cos(Self->Elevation * DEG2RAD), sin(Self->Elevation * DEG2RAD));
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -743,6 +744,7 @@ static ERR LIGHTINGFX_SetPointLight(extLightingFX *Self, struct lt::SetPointLigh
    Self->Y = Args->Y;
    Self->Z = Args->Z;
 
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -796,6 +798,7 @@ static ERR LIGHTINGFX_SetSpotLight(extLightingFX *Self, struct lt::SetSpotLight
    Self->SpotExponent = Args->Exponent;
    Self->ConeAngle    = Args->ConeAngle;
 
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -835,6 +838,7 @@ static ERR LIGHTINGFX_SET_Colour(extLightingFX *Self, float *Value, int Elements
    Self->LinearColour = Self->Colour;
    glLinearRGB.convert(Self->LinearColour);
 
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -857,6 +861,7 @@ static ERR LIGHTINGFX_SET_Constant(extLightingFX *Self, double Value)
 {
    if (Value >= 0) {
       Self->Constant = Value;
+      Self->modified();
       return ERR::Okay;
    }
    else return ERR::InvalidValue;
@@ -882,6 +887,7 @@ static ERR LIGHTINGFX_SET_Exponent(extLightingFX *Self, double Value)
 {
    if ((Value >= 1.0) and (Value <= 128.0)) {
       Self->SpecularExponent = Value;
+      Self->modified();
       return ERR::Okay;
    }
    else return ERR::OutOfRange;
@@ -903,6 +909,7 @@ static ERR LIGHTINGFX_GET_Scale(extLightingFX *Self, double *Value)
 static ERR LIGHTINGFX_SET_Scale(extLightingFX *Self, double Value)
 {
    Self->MapHeight = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -923,6 +930,7 @@ static ERR LIGHTINGFX_GET_Type(extLightingFX *Self, LT *Value)
 static ERR LIGHTINGFX_SET_Type(extLightingFX *Self, LT Value)
 {
    Self->Type = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -951,6 +959,7 @@ static ERR LIGHTINGFX_SET_UnitX(extLightingFX *Self, double Value)
 {
    if (Value < 0) return ERR::InvalidValue;
    Self->UnitX = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -979,6 +988,7 @@ static ERR LIGHTINGFX_SET_UnitY(extLightingFX *Self, double Value)
 {
    if (Value < 0) return ERR::InvalidValue;
    Self->UnitY = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -48,6 +48,7 @@ static ERR MERGEFX_Draw(extMergeFX *Self, struct acDraw *Args)
       else bmp = get_source_graphic(Self->Filter);
       if (!bmp) continue;
 
+      set_colour_space(bmp, CS::SRGB); // Effect output may have been left in linear RGB
       gfx::CopyArea(bmp, Self->Target, copy_flags, 0, 0, bmp->Width, bmp->Height, 0, 0);
 
       copy_flags |= BAF::BLEND|BAF::COPY; // Any subsequent copies are to be blended
@@ -89,6 +90,7 @@ static ERR MERGEFX_SET_SourceList(extMergeFX *Self, MergeSource *Value, int Elem
 {
    if ((!Value) or (Elements <= 0)) {
       Self->List.clear();
+      Self->modified();
       return ERR::Okay;
    }
 
@@ -101,6 +103,7 @@ static ERR MERGEFX_SET_SourceList(extMergeFX *Self, MergeSource *Value, int Elem
       Self->List.push_back(Value[i]);
    }
 
+   Self->modified();
    return ERR::Okay;
 }
 
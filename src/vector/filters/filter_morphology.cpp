@@ -36,168 +36,222 @@ class extMorphologyFX : public extFilterEffect {
    MOP Operator;
 };
 
-/*********************************************************************************************************************
--ACTION-
-Draw: Render the effect to the target bitmap.
--END-
-*********************************************************************************************************************/
+//********************************************************************************************************************
+// Morphology is computed with the van Herk/Gil-Werman algorithm, which costs roughly three comparisons per pixel
+// irrespective of the radius.  Each line is padded with the operator's identity value (0 for dilation, 255 for
+// erosion) so that pixels outside of the canvas never win, then split into blocks of 2r+1 pixels.  A forward pass
+// records the running extreme from the start of each block (G) and a backward pass records it from the end of each
+// block (H).  Any window [x, x+2r] spans at most two neighbouring blocks, so its result is op(H[x], G[x+2r]).
+//
+// Pixels are handled as packed 32-bit values and compared per byte, so all four channels are resolved by a single
+// SIMD instruction and the channel order is irrelevant.
+
+constexpr int MORPH_STRIPE = 64; // Width of the column stripes processed by the vertical pass, in pixels
+
+struct morph_dilate {
+   static constexpr uint32_t IDENTITY = 0;
+   static inline uint8_t u8(uint8_t A, uint8_t B) { return A > B ? A : B; }
+#if defined(FX_SSE2)
+   static inline __m128i vec(__m128i A, __m128i B) { return _mm_max_epu8(A, B); }
+#elif defined(FX_NEON)
+   static inline uint8x16_t vec(uint8x16_t A, uint8x16_t B) { return vmaxq_u8(A, B); }
+   static inline uint8x8_t vec(uint8x8_t A, uint8x8_t B) { return vmax_u8(A, B); }
+#endif
+};
 
-static ERR MORPHOLOGYFX_Draw(extMorphologyFX *Self, struct acDraw *Args)
+struct morph_erode {
+   static constexpr uint32_t IDENTITY = 0xffffffff;
+   static inline uint8_t u8(uint8_t A, uint8_t B) { return A < B ? A : B; }
+#if defined(FX_SSE2)
+   static inline __m128i vec(__m128i A, __m128i B) { return _mm_min_epu8(A, B); }
+#elif defined(FX_NEON)
+   static inline uint8x16_t vec(uint8x16_t A, uint8x16_t B) { return vminq_u8(A, B); }
+   static inline uint8x8_t vec(uint8x8_t A, uint8x8_t B) { return vmin_u8(A, B); }
+#endif
+};
+
+// Per-channel operation on a single pixel.
+
+template <class OP> static inline uint32_t morph_px(uint32_t A, uint32_t B)
 {
-   const int canvasWidth = Self->Target->Clip.Right - Self->Target->Clip.Left;
-   const int canvasHeight = Self->Target->Clip.Bottom - Self->Target->Clip.Top;
+#if defined(FX_SSE2)
+   return _mm_cvtsi128_si32(OP::vec(_mm_cvtsi32_si128(A), _mm_cvtsi32_si128(B)));
+#elif defined(FX_NEON)
+   return vget_lane_u32(vreinterpret_u32_u8(OP::vec(vreinterpret_u8_u32(vdup_n_u32(A)), vreinterpret_u8_u32(vdup_n_u32(B)))), 0);
+#else
+   return uint32_t(OP::u8(A, B)) | (uint32_t(OP::u8(A>>8, B>>8))<<8) |
+      (uint32_t(OP::u8(A>>16, B>>16))<<16) | (uint32_t(OP::u8(A>>24, B>>24))<<24);
+#endif
+}
+
+// Per-channel operation across a span of pixels, four pixels per vector.
+
+template <class OP> static inline void morph_span(uint32_t *Dest, const uint32_t *A, const uint32_t *B, int Count)
+{
+   int i = 0;
+#if defined(FX_SSE2)
+   for (; i + 4 <= Count; i += 4) {
+      auto a = _mm_loadu_si128((const __m128i *)(A + i));
+      auto b = _mm_loadu_si128((const __m128i *)(B + i));
+      _mm_storeu_si128((__m128i *)(Dest + i), OP::vec(a, b));
+   }
+#elif defined(FX_NEON)
+   for (; i + 4 <= Count; i += 4) {
+      vst1q_u8((uint8_t *)(Dest + i), OP::vec(vld1q_u8((const uint8_t *)(A + i)), vld1q_u8((const uint8_t *)(B + i))));
+   }
+#endif
+   for (; i < Count; i++) Dest[i] = morph_px<OP>(A[i], B[i]);
+}
+
+//********************************************************************************************************************
+// Horizontal pass over a single row.  P and G must have room for Width + 2*Radius pixels.  P is recycled as the H
+// buffer once G has been computed from it.
+
+template <class OP> static void morph_row(const uint32_t *Src, uint32_t *Dest, int Width, int Radius, uint32_t *P, uint32_t *G)
+{
+   const int k = (Radius * 2) + 1;
+   const int n = Width + (Radius * 2);
+
+   std::fill(P, P + Radius, OP::IDENTITY);
+   copymem(Src, P + Radius, size_t(Width) * sizeof(uint32_t));
+   std::fill(P + Radius + Width, P + n, OP::IDENTITY);
+
+   for (int b=0; b < n; b += k) {
+      const int e = std::min(b + k, n);
+      G[b] = P[b];
+      for (int i=b+1; i < e; i++) G[i] = morph_px<OP>(G[i-1], P[i]);
+      for (int i=e-2; i >= b; i--) P[i] = morph_px<OP>(P[i+1], P[i]); // P becomes H
+   }
+
+   const uint32_t *g = G + (Radius * 2);
+   for (int x=0; x < Width; x++) Dest[x] = morph_px<OP>(P[x], g[x]);
+}
+
+//********************************************************************************************************************
+// Vertical pass over a stripe of up to MORPH_STRIPE columns.  Whole row segments are combined at a time, so the
+// inner loops are contiguous and vectorise cleanly.  G and H must have room for (Height + 2*Radius) * Width pixels.
+
+template <class OP> static void morph_stripe(const uint8_t *Src, int SrcStride, uint8_t *Dest, int DestStride,
+   int Width, int Height, int Radius, uint32_t *G, uint32_t *H, const uint32_t *Identity)
+{
+   const int k = (Radius * 2) + 1;
+   const int n = Height + (Radius * 2);
+
+   auto row = [&](int i) -> const uint32_t * {
+      i -= Radius;
+      return ((i < 0) or (i >= Height)) ? Identity : (const uint32_t *)(Src + (ptrdiff_t(i) * SrcStride));
+   };
+
+   for (int b=0; b < n; b += k) {
+      const int e = std::min(b + k, n);
+      copymem(row(b), G + (size_t(b) * Width), size_t(Width) * sizeof(uint32_t));
+      for (int i=b+1; i < e; i++) {
+         morph_span<OP>(G + (size_t(i) * Width), G + (size_t(i-1) * Width), row(i), Width);
+      }
+
+      copymem(row(e-1), H + (size_t(e-1) * Width), size_t(Width) * sizeof(uint32_t));
+      for (int i=e-2; i >= b; i--) {
+         morph_span<OP>(H + (size_t(i) * Width), H + (size_t(i+1) * Width), row(i), Width);
+      }
+   }
+
+   for (int y=0; y < Height; y++) {
+      morph_span<OP>((uint32_t *)(Dest + (ptrdiff_t(y) * DestStride)), H + (size_t(y) * Width),
+         G + (size_t(y + (Radius * 2)) * Width), Width);
+   }
+}
 
-   if (canvasWidth * canvasHeight > 4096 * 4096) return ERR::OutOfRange; // Bail on really large bitmaps.
+//********************************************************************************************************************
+// Rows are independent in the horizontal pass and columns are independent in the vertical pass, so both are
+// distributed across a thread pool.
 
-   const uint8_t A = Self->Target->ColourFormat->AlphaPos>>3;
-   const uint8_t R = Self->Target->ColourFormat->RedPos>>3;
-   const uint8_t G = Self->Target->ColourFormat->GreenPos>>3;
-   const uint8_t B = Self->Target->ColourFormat->BluePos>>3;
+template <class OP> static ERR morph_draw(extMorphologyFX *Self, objBitmap *InBmp, int Width, int Height)
+{
+   uint8_t *input = InBmp->Data + (InBmp->Clip.Top * InBmp->LineWidth) + (InBmp->Clip.Left * InBmp->BytesPerPixel);
+   uint8_t *output = Self->Target->Data + (Self->Target->Clip.Left<<2) + (Self->Target->Clip.Top * Self->Target->LineWidth);
 
-   uint8_t *out_line;
-   uint8_t *buffer = nullptr;
-   int out_linewidth;
-   bool buffer_as_input;
+   const int rx = std::min(Self->RadiusX, Width - 1);
+   const int ry = std::min(Self->RadiusY, Height - 1);
 
    // A temporary buffer is required if we are applying the effect on both axis.  Otherwise we can
    // directly write to the target bitmap.
 
+   std::unique_ptr<uint32_t[]> buffer;
    if ((Self->RadiusX > 0) and (Self->RadiusY > 0)) {
-      buffer = new (std::nothrow) uint8_t[canvasWidth * canvasHeight * 4];
+      buffer.reset(new (std::nothrow) uint32_t[size_t(Width) * size_t(Height)]);
       if (!buffer) return ERR::Memory;
-      out_line = buffer;
-      out_linewidth = canvasWidth * 4;
-      buffer_as_input = true;
-   }
-   else {
-      out_line = (uint8_t *)(Self->Target->Data + (Self->Target->Clip.Left<<2) + (Self->Target->Clip.Top * Self->Target->LineWidth));
-      out_linewidth = Self->Target->LineWidth;
-      buffer_as_input = false;
    }
 
-   objBitmap *inBmp;
-   if (get_source_bitmap(Self->Filter, &inBmp, Self->SourceType, Self->Input, false) != ERR::Okay) return ERR::NoData;
-   uint8_t *input = inBmp->Data + (inBmp->Clip.Top * inBmp->LineWidth) + (inBmp->Clip.Left * inBmp->BytesPerPixel);
-
-   if (Self->RadiusX > 0) { // Top-to-bottom dilate
-      auto radius = Self->RadiusX;
-      if (canvasWidth - 1 < radius) radius = canvasWidth - 1;
-
-      const uint8_t *endinput  = input + (radius * 4);
-      const uint8_t *inputline = input;
-
-      for (int x=0; x < canvasWidth; ++x) {
-         const uint8_t *in  = inputline;
-         const uint8_t *end = endinput;
-         auto out         = out_line;
-
-         if (Self->Operator IS MOP::DILATE) {
-            for (int y = 0; y < canvasHeight; ++y) {
-               uint8_t maxB = 0, maxG = 0, maxR = 0, maxA = 0;
-               for (const uint8_t *pix=in; pix <= end; pix += 4) {
-                  if (pix[B] > maxB) maxB = pix[B];
-                  if (pix[G] > maxG) maxG = pix[G];
-                  if (pix[R] > maxR) maxR = pix[R];
-                  if (pix[A] > maxA) maxA = pix[A];
-               }
-               out[R] = maxR; out[G] = maxG; out[B] = maxB; out[A] = maxA;
-
-               out += out_linewidth;
-               in  += inBmp->LineWidth;
-               end += inBmp->LineWidth;
-            }
-         }
-         else { // ERODE
-            for (int y = 0; y < canvasHeight; ++y) {
-               uint8_t minB = 255, minG = 255, minR = 255, minA = 255;
-               for (const uint8_t *p=in; p <= end; p += 4) {
-                  if (p[B] < minB) minB = p[B];
-                  if (p[G] < minG) minG = p[G];
-                  if (p[R] < minR) minR = p[R];
-                  if (p[A] < minA) minA = p[A];
-               }
-               out[R] = minR; out[G] = minG; out[B] = minB; out[A] = minA;
-
-               out += out_linewidth;
-               in  += inBmp->LineWidth;
-               end += inBmp->LineWidth;
-            }
-         }
-
-         if (x >= radius) inputline += 4;
-         if (x + radius < canvasWidth - 1) endinput += 4;
-         out_line += 4;
-      }
-   }
+   int thread_count = std::thread::hardware_concurrency();
+   if (thread_count < 1) thread_count = 1;
+   if (int64_t(Width) * int64_t(Height) < 256 * 256) thread_count = 1; // Not worth the overhead
 
-   if (Self->RadiusY > 0) { // Left-to-right dilate
-      auto radius = Self->RadiusY;
-      if (canvasHeight - 1 < radius) radius = canvasHeight - 1;
+   BS::thread_pool pool(thread_count);
 
-      const uint8_t *endinput;
-      const uint8_t *inputline;
-      int inwidth;
+   if (Self->RadiusX > 0) { // Horizontal pass
+      uint8_t *dest   = buffer ? (uint8_t *)buffer.get() : output;
+      int dest_stride = buffer ? Width * 4 : Self->Target->LineWidth;
+      const int rows_per_task = (Height + thread_count - 1) / thread_count;
 
-      if (buffer_as_input) {
-         endinput  = buffer + (radius * (canvasWidth * 4));
-         inputline = buffer;
-         inwidth   = canvasWidth * 4;
-      }
-      else {
-         endinput  = input + (radius * inBmp->LineWidth); // Inner-loop will stop when reaching endinput
-         inputline = input;
-         inwidth   = inBmp->LineWidth;
+      for (int top=0; top < Height; top += rows_per_task) {
+         const int bottom = std::min(top + rows_per_task, Height);
+         pool.detach_task([=]() {
+            std::vector<uint32_t> p(Width + (rx * 2)), g(Width + (rx * 2));
+            for (int y=top; y < bottom; y++) {
+               morph_row<OP>((const uint32_t *)(input + (ptrdiff_t(y) * InBmp->LineWidth)),
+                  (uint32_t *)(dest + (ptrdiff_t(y) * dest_stride)), Width, rx, p.data(), g.data());
+            }
+         });
       }
 
-      out_line = (uint8_t *)(Self->Target->Data + (Self->Target->Clip.Left<<2) + (Self->Target->Clip.Top * Self->Target->LineWidth));
-      out_linewidth = Self->Target->LineWidth;
-
-      for (int y=0; y < canvasHeight; y++) {
-         const uint8_t *in = inputline;
-         const uint8_t *end = endinput;
-         auto out = out_line;
-
-         if (Self->Operator IS MOP::DILATE) {
-            for (int x=0; x < canvasWidth; x++) {
-               uint8_t maxB = 0, maxG = 0, maxR = 0, maxA = 0;
-               for (const uint8_t *pix=in; pix <= end; pix += inwidth) {
-                  if (pix[B] > maxB) maxB = pix[B];
-                  if (pix[G] > maxG) maxG = pix[G];
-                  if (pix[R] > maxR) maxR = pix[R];
-                  if (pix[A] > maxA) maxA = pix[A];
-               }
-               out[R] = maxR; out[G] = maxG; out[B] = maxB; out[A] = maxA;
-               out += 4;
-               in  += 4;
-               end += 4;
-            }
-         }
-         else { // ERODE
-            for (int x=0; x < canvasWidth; x++) {
-               uint8_t minB = 255, minG = 255, minR = 255, minA = 255;
-               for (const uint8_t *pix=in; pix <= end; pix += inwidth) {
-                  if (pix[B] < minB) minB = pix[B];
-                  if (pix[G] < minG) minG = pix[G];
-                  if (pix[R] < minR) minR = pix[R];
-                  if (pix[A] < minA) minA = pix[A];
-               }
-               out[R] = minR; out[G] = minG; out[B] = minB; out[A] = minA;
-               out += 4;
-               in  += 4;
-               end += 4;
+      pool.wait();
+   }
+
+   if (Self->RadiusY > 0) { // Vertical pass
+      const uint8_t *src = buffer ? (const uint8_t *)buffer.get() : input;
+      int src_stride     = buffer ? Width * 4 : InBmp->LineWidth;
+      const int stripes  = (Width + MORPH_STRIPE - 1) / MORPH_STRIPE;
+      const int stripes_per_task = (stripes + thread_count - 1) / thread_count;
+
+      for (int first=0; first < stripes; first += stripes_per_task) {
+         const int last = std::min(first + stripes_per_task, stripes);
+         pool.detach_task([=]() {
+            const size_t n = size_t(Height + (ry * 2)) * MORPH_STRIPE;
+            std::vector<uint32_t> g(n), h(n), identity(MORPH_STRIPE, OP::IDENTITY);
+            for (int s=first; s < last; s++) {
+               const int x = s * MORPH_STRIPE;
+               morph_stripe<OP>(src + (x * 4), src_stride, output + (x * 4), Self->Target->LineWidth,
+                  std::min(MORPH_STRIPE, Width - x), Height, ry, g.data(), h.data(), identity.data());
             }
-         }
-         if (y >= radius) inputline += inwidth;
-         if (y + radius < canvasHeight - 1) endinput += inwidth;
-         out_line += Self->Target->LineWidth;
+         });
       }
-   }
 
-   if (buffer) delete [] buffer;
+      pool.wait();
+   }
 
    return ERR::Okay;
 }
 
+/*********************************************************************************************************************
+-ACTION-
+Draw: Render the effect to the target bitmap.
+-END-
+*********************************************************************************************************************/
+
+static ERR MORPHOLOGYFX_Draw(extMorphologyFX *Self, struct acDraw *Args)
+{
+   const int canvasWidth = Self->Target->Clip.Right - Self->Target->Clip.Left;
+   const int canvasHeight = Self->Target->Clip.Bottom - Self->Target->Clip.Top;
+
+   if ((canvasWidth <= 0) or (canvasHeight <= 0)) return ERR::Okay;
+
+   objBitmap *inBmp;
+   if (get_source_bitmap(Self->Filter, &inBmp, Self->SourceType, Self->Input, false) != ERR::Okay) return ERR::NoData;
+
+   if (Self->Operator IS MOP::DILATE) return morph_draw<morph_dilate>(Self, inBmp, canvasWidth, canvasHeight);
+   else return morph_draw<morph_erode>(Self, inBmp, canvasWidth, canvasHeight);
+}
+
 //********************************************************************************************************************
 
 static ERR MORPHOLOGYFX_NewObject(extMorphologyFX *Self)
@@ -223,6 +277,7 @@ static ERR MORPHOLOGYFX_GET_Operator(extMorphologyFX *Self, MOP *Value)
 static ERR MORPHOLOGYFX_SET_Operator(extMorphologyFX *Self, MOP Value)
 {
    Self->Operator = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -243,6 +298,7 @@ static ERR MORPHOLOGYFX_SET_RadiusX(extMorphologyFX *Self, int Value)
 {
    if (Value >= 0) {
       Self->RadiusX = Value;
+      Self->modified();
       return ERR::Okay;
    }
    else return ERR::OutOfRange;
@@ -265,6 +321,7 @@ static ERR MORPHOLOGYFX_SET_RadiusY(extMorphologyFX *Self, int Value)
 {
    if (Value >= 0) {
       Self->RadiusY = Value;
+      Self->modified();
       return ERR::Okay;
    }
    else return ERR::OutOfRange;
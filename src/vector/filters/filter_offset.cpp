@@ -26,8 +26,12 @@ static ERR OFFSETFX_Draw(extOffsetFX *Self, struct acDraw *Args)
    objBitmap *inBmp;
    int dx = int((double)Self->XOffset * Self->Filter->ClientVector->Transform.sx);
    int dy = int((double)Self->YOffset * Self->Filter->ClientVector->Transform.sy);
-   if (get_source_bitmap(Self->Filter, &inBmp, Self->SourceType, Self->Input, false) IS ERR::Okay) {
+   // The colour space of the input is passed through if the output is only consumed by other effects.
+
+   const CS space = (Self->UsageCount > 0) ? CS::NIL : CS::SRGB;
+   if (get_source_bitmap(Self->Filter, &inBmp, Self->SourceType, Self->Input, false, space) IS ERR::Okay) {
       gfx::CopyArea(inBmp, Self->Target, BAF::NIL, 0, 0, inBmp->Width, inBmp->Height, dx, dy);
+      Self->Target->ColourSpace = inBmp->ColourSpace;
       return ERR::Okay;
    }
    else return ERR::NoData;
@@ -51,6 +55,7 @@ static ERR OFFSETFX_GET_XOffset(extOffsetFX *Self, int *Value)
 static ERR OFFSETFX_SET_XOffset(extOffsetFX *Self, int Value)
 {
    Self->XOffset = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -72,6 +77,7 @@ static ERR OFFSETFX_GET_YOffset(extOffsetFX *Self, int *Value)
 static ERR OFFSETFX_SET_YOffset(extOffsetFX *Self, int Value)
 {
    Self->YOffset = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
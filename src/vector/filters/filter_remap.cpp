@@ -260,6 +260,7 @@ static ERR REMAPFX_SelectDiscrete(extRemapFX *Self, struct rf::SelectDiscrete *A
    if (auto cmp = Self->getComponent(Args->Component)) {
       cmp->select_discrete(Args->Values, Args->Size);
       log.detail("%s Values: %d", cmp->Name.c_str(), Args->Size);
+      Self->modified();
       return ERR::Okay;
    }
    else return log.warning(ERR::Args);
@@ -291,6 +292,7 @@ static ERR REMAPFX_SelectIdentity(extRemapFX *Self, struct rf::SelectIdentity *A
    if (auto cmp = Self->getComponent(Args->Component)) {
       cmp->select_identity();
       log.detail("%s", cmp->Name.c_str());
+      Self->modified();
       return ERR::Okay;
    }
    else return log.warning(ERR::Args);
@@ -325,6 +327,7 @@ static ERR REMAPFX_SelectGamma(extRemapFX *Self, struct rf::SelectGamma *Args)
    if (auto cmp = Self->getComponent(Args->Component)) {
       cmp->select_gamma(Args->Amplitude, Args->Exponent, Args->Offset);
       log.detail("%s Amplitude: %.2f, Exponent: %.2f, Offset: %.2f", cmp->Name.c_str(), cmp->Amplitude, cmp->Exponent, cmp->Offset);
+      Self->modified();
       return ERR::Okay;
    }
    else return log.warning(ERR::Args);
@@ -359,6 +362,7 @@ static ERR REMAPFX_SelectInvert(extRemapFX *Self, struct rf::SelectInvert *Args)
    if (auto cmp = Self->getComponent(Args->Component)) {
       cmp->select_invert();
       log.detail("%s", cmp->Name.c_str());
+      Self->modified();
       return ERR::Okay;
    }
    else return log.warning(ERR::Args);
@@ -394,6 +398,7 @@ static ERR REMAPFX_SelectLinear(extRemapFX *Self, struct rf::SelectLinear *Args)
    if (auto cmp = Self->getComponent(Args->Component)) {
       cmp->select_linear(Args->Slope, Args->Intercept);
       log.detail("%s Slope: %.2f, Intercept: %.2f", cmp->Name.c_str(), cmp->Slope, Args->Intercept);
+      Self->modified();
       return ERR::Okay;
    }
    else return log.warning(ERR::Args);
@@ -430,6 +435,7 @@ static ERR REMAPFX_SelectMask(extRemapFX *Self, struct rf::SelectMask *Args)
    if (auto cmp = Self->getComponent(Args->Component)) {
       cmp->select_mask(Args->Mask);
       log.detail("%s, Mask: $%.2x", cmp->Name.c_str(), Args->Mask);
+      Self->modified();
       return ERR::Okay;
    }
    else return log.warning(ERR::Args);
@@ -467,6 +473,7 @@ static ERR REMAPFX_SelectTable(extRemapFX *Self, struct rf::SelectTable *Args)
    if (auto cmp = Self->getComponent(Args->Component)) {
       cmp->select_table(Args->Values, Args->Size);
       log.detail("%s Values: %d", cmp->Name.c_str(), Args->Size);
+      Self->modified();
       return ERR::Okay;
    }
    else return log.warning(ERR::Args);
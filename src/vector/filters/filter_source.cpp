@@ -228,6 +228,7 @@ static ERR SOURCEFX_SET_AspectRatio(extSourceFX *Self, ARF Value)
 {
    Self->AspectRatio = Value;
    Self->Render = true;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -251,6 +252,7 @@ static ERR SOURCEFX_SET_Source(extSourceFX *Self, objVector *Value)
    Self->Source = Value;
    SubscribeAction(Value, AC::Free, C_FUNCTION(notify_free_source));
    Self->Render = true;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -283,6 +285,7 @@ static ERR SOURCEFX_SET_SourceName(extSourceFX *Self, CSTRING Value)
       Self->Source = src;
       SubscribeAction(src, AC::Free, C_FUNCTION(notify_free_source));
       Self->Render = true;
+      Self->modified();
       return ERR::Okay;
    }
    else return log.warning(ERR::Search);
@@ -367,6 +367,7 @@ static ERR TURBULENCEFX_SET_FX(extTurbulenceFX *Self, double Value)
    if (Value >= 0) {
       Self->FX = Value;
       Self->Dirty = true;
+      Self->modified();
       return ERR::Okay;
    }
    else return ERR::InvalidValue;
@@ -392,6 +393,7 @@ static ERR TURBULENCEFX_SET_FY(extTurbulenceFX *Self, double Value)
    if (Value >= 0) {
       Self->FY = Value;
       Self->Dirty = true;
+      Self->modified();
       return ERR::Okay;
    }
    else return ERR::InvalidValue;
@@ -416,6 +418,7 @@ static ERR TURBULENCEFX_SET_Octaves(extTurbulenceFX *Self, int Value)
 {
    Self->Octaves = Value;
    Self->Dirty = true;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -439,6 +442,7 @@ static ERR TURBULENCEFX_SET_Seed(extTurbulenceFX *Self, int Value)
 {
    Self->Seed = Value;
    Self->Dirty = true;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -471,6 +475,7 @@ static ERR TURBULENCEFX_SET_Stitch(extTurbulenceFX *Self, int Value)
 {
    Self->Stitch = Value;
    Self->Dirty = true;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -492,6 +497,7 @@ static ERR TURBULENCEFX_SET_Type(extTurbulenceFX *Self, TB Value)
 {
    Self->Type = Value;
    Self->Dirty = true;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -191,6 +191,7 @@ static ERR WAVEFUNCTIONFX_GET_AspectRatio(extWaveFunctionFX *Self, ARF *Value)
 static ERR WAVEFUNCTIONFX_SET_AspectRatio(extWaveFunctionFX *Self, ARF Value)
 {
    Self->AspectRatio = Value;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -227,6 +228,7 @@ static ERR WAVEFUNCTIONFX_SET_ColourMap(extWaveFunctionFX *Self, CSTRING Value)
       Self->Colours = new (std::nothrow) GradientColours(glColourMaps[Value], 1);
       if (!Self->Colours) return ERR::AllocMemory;
       Self->ColourMap = Value;
+      Self->modified();
       return ERR::Okay;
    }
    else return ERR::NotFound;
@@ -252,6 +254,7 @@ static ERR WAVEFUNCTIONFX_SET_L(extWaveFunctionFX *Self, int Value)
    if (Value >= 0) {
       Self->L = Value;
       Self->Dirty = true;
+      Self->modified();
       return ERR::Okay;
    }
    else return ERR::InvalidValue;
@@ -276,6 +279,7 @@ static ERR WAVEFUNCTIONFX_SET_M(extWaveFunctionFX *Self, int Value)
 {
    Self->M = Value;
    Self->Dirty = true;
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -299,6 +303,7 @@ static ERR WAVEFUNCTIONFX_SET_N(extWaveFunctionFX *Self, int Value)
    if (Value >= 1) {
       Self->N = Value;
       Self->Dirty = true;
+      Self->modified();
       return ERR::Okay;
    }
    else return ERR::InvalidValue;
@@ -329,6 +334,7 @@ static ERR WAVEFUNCTIONFX_SET_Resolution(extWaveFunctionFX *Self, int Value)
    if (Value >= 0) {
       Self->Resolution = Value;
       Self->Dirty = true;
+      Self->modified();
       return ERR::Okay;
    }
    else return ERR::InvalidValue;
@@ -352,6 +358,7 @@ static ERR WAVEFUNCTIONFX_SET_Scale(extWaveFunctionFX *Self, double Value)
    if (Value >= 0) {
       Self->Scale = Value;
       Self->Dirty = true;
+      Self->modified();
       return ERR::Okay;
    }
    else return ERR::InvalidValue;
@@ -385,6 +392,7 @@ static ERR WAVEFUNCTIONFX_SET_Stops(extWaveFunctionFX *Self, GradientStop *Value
       if (Self->Colours) delete Self->Colours;
       Self->Colours = new (std::nothrow) GradientColours(Self->Stops, /*Self->Filter->ColourSpace*/ VCS::SRGB, 1.0, 1);
       if (!Self->Colours) return ERR::AllocMemory;
+      Self->modified();
       return ERR::Okay;
    }
    else {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <kotuku/main.h>
+#include <atomic>
 
 #include <ft2build.h>
 #include FT_SIZES_H
@@ -47,18 +48,133 @@ class freetype_font {
    public:
       struct glyph {
          agg::path_storage path; // AGG vector path generated from the freetype glyph
-         double adv_x, adv_y;    // Pixel advances, these values should not be rounded
-         int   glyph_index;     // Freetype glyph index; saves having to call a function for conversion
+         double adv_x = 0, adv_y = 0; // Pixel advances, these values should not be rounded
+         int   glyph_index = 0;      // Freetype glyph index; saves having to call a function for conversion
+      };
+
+      // Reads a glyph path with its own iterator and curve state.  Glyph paths are shared by all threads, so they
+      // must be read through this adaptor rather than the stateful rewind() and vertex() methods of the path.
+
+      class glyph_reader {
+         const agg::path_storage &m_path;
+         agg::curve3_div m_curve3;
+         agg::curve4_div m_curve4;
+         double m_last_x = 0, m_last_y = 0;
+         unsigned m_iterator = 0;
+
+         public:
+         glyph_reader(const agg::path_storage &Path, double Scale = 1.0) : m_path(Path) {
+            m_curve3.approximation_scale(Scale);
+            m_curve4.approximation_scale(Scale);
+         }
+
+         void rewind(unsigned PathID) {
+            m_iterator = PathID;
+            m_last_x = m_last_y = 0;
+            m_curve3.reset();
+            m_curve4.reset();
+         }
+
+         unsigned vertex(double *X, double *Y) {
+            if ((!agg::is_stop(m_curve3.vertex(X, Y))) or (!agg::is_stop(m_curve4.vertex(X, Y)))) {
+               m_last_x = *X;
+               m_last_y = *Y;
+               return agg::path_cmd_line_to;
+            }
+
+            unsigned cmd = agg::path_cmd_stop;
+            if (m_iterator < m_path.total_vertices()) cmd = m_path.vertex(m_iterator++, X, Y);
+
+            if (cmd IS agg::path_cmd_curve3) {
+               double end_x, end_y;
+               m_path.vertex(m_iterator++, &end_x, &end_y);
+               m_curve3.init(m_last_x, m_last_y, *X, *Y, end_x, end_y);
+               m_curve3.vertex(X, Y); // Returns path_cmd_move_to
+               m_curve3.vertex(X, Y); // First vertex of the curve
+               cmd = agg::path_cmd_line_to;
+            }
+            else if (cmd IS agg::path_cmd_curve4) {
+               double ct2_x, ct2_y, end_x, end_y;
+               m_path.vertex(m_iterator++, &ct2_x, &ct2_y);
+               m_path.vertex(m_iterator++, &end_x, &end_y);
+               m_curve4.init(m_last_x, m_last_y, *X, *Y, ct2_x, ct2_y, end_x, end_y);
+               m_curve4.vertex(X, Y);
+               m_curve4.vertex(X, Y);
+               cmd = agg::path_cmd_line_to;
+            }
+
+            m_last_x = *X;
+            m_last_y = *Y;
+            return cmd;
+         }
+      };
+
+      struct glyph_mask {
+         int x, y;          // Position of the mask relative to the glyph origin, in pixels
+         int width, height;
+         size_t offset;     // Location of the coverage values in the atlas
+      };
+
+      // Unicode to glyph lookup.  Glyphs are never moved or removed once published, so lookups are lock-free and
+      // the returned references remain valid for the lifetime of the table.  Insertion must be serialised by the
+      // caller (see freetype_font::lock).
+
+      class glyph_table {
+         static constexpr uint32_t PAGE_BITS  = 10;
+         static constexpr uint32_t PAGE_SIZE  = 1<<PAGE_BITS;
+         static constexpr uint32_t MAX_UNICODE = 0x110000;
+         using PAGE = std::array<std::atomic<glyph *>, PAGE_SIZE>;
+
+         std::array<std::atomic<PAGE *>, (MAX_UNICODE>>PAGE_BITS)> pages = { };
+
+         public:
+         glyph_table() = default;
+         glyph_table(const glyph_table &) = delete;
+         glyph_table & operator=(const glyph_table &) = delete;
+
+         ~glyph_table() {
+            for (auto &p : pages) {
+               if (auto page = p.load(std::memory_order_relaxed)) {
+                  for (auto &g : *page) delete g.load(std::memory_order_relaxed);
+                  delete page;
+               }
+            }
+         }
+
+         inline glyph * find(uint32_t Unicode) const {
+            if (Unicode >= MAX_UNICODE) return nullptr;
+            if (auto page = pages[Unicode>>PAGE_BITS].load(std::memory_order_acquire)) {
+               return (*page)[Unicode & (PAGE_SIZE-1)].load(std::memory_order_acquire);
+            }
+            else return nullptr;
+         }
+
+         // The glyph must be fully initialised before it is inserted, as it becomes visible to other threads
+         // immediately.
+
+         inline void insert(uint32_t Unicode, glyph *Glyph) {
+            auto &slot = pages[Unicode>>PAGE_BITS];
+            auto page = slot.load(std::memory_order_relaxed);
+            if (!page) {
+               page = new PAGE();
+               slot.store(page, std::memory_order_release);
+            }
+            (*page)[Unicode & (PAGE_SIZE-1)].store(Glyph, std::memory_order_release);
+         }
       };
 
       using METRIC_GROUP = std::vector<FT_Fixed>;
-      using GLYPH_TABLE = ankerl::unordered_dense::map<uint32_t, glyph>; // Unicode to glyph lookup
+      using GLYPH_TABLE = glyph_table;
+      using MASK_TABLE = ankerl::unordered_dense::map<uint64_t, glyph_mask>; // Scale, unicode & subpixel offset to mask lookup
 
       class ft_point : public common_font {
          public:
             GLYPH_TABLE glyphs;
+            MASK_TABLE masks;
+            std::vector<uint8_t> atlas; // Coverage values for all masks, 8-bit alpha
             freetype_font *font = nullptr;
             FT_Size ft_size = nullptr;
+            int size = 0; // The point size that the instance is hinted for
 
             // These values are measured as pixels in 72 DPI.
             //
@@ -71,7 +187,11 @@ class freetype_font {
             double line_spacing;
             METRIC_GROUP axis;
 
+            static constexpr size_t MAX_ATLAS = 4 * 1024 * 1024; // The atlas is reset if it grows beyond this size
+
             glyph & get_glyph(uint32_t);
+            const glyph_mask & get_mask(uint32_t, double, int);
+            void get_kerning(int, int, double &, double &);
 
             ft_point() : common_font(CF_FREETYPE) { }
 
@@ -96,6 +216,7 @@ class freetype_font {
             }
 
             void set_size(int Size) {
+               size = Size;
                if (!FT_New_Size(font->face, &ft_size)) {
                   FT_Activate_Size(ft_size);
                   FT_Set_Char_Size(font->face, 0, Size<<6, 72, 72);
@@ -148,16 +269,26 @@ class freetype_font {
       using METRIC_TABLE = std::map<std::string, METRIC_GROUP, CaseInsensitiveMap>;
 
    public:
+      // Text that is sized by the client is drawn from hinted instances at the bucket sizes, with in-between sizes
+      // scaled from the nearest bucket.  Once a style has MAX_LIVE_SIZES instances, scaling from the nearest existing
+      // instance is preferred to creating a new one.
+
+      static constexpr int SIZE_BUCKETS[] = { 4, 6, 8, 9, 10, 11, 12, 13, 14, 16, 18, 20, 24, 30, 36, 48, 60, 72, 96, 128, 192, 256 };
+      static constexpr size_t MAX_LIVE_SIZES = 12;
+
+      std::recursive_mutex lock; // FT_Face is not thread-safe; all calls that use the face must hold this lock
       FT_Face face = nullptr;
       STYLE_CACHE style_cache; // Lists all known styles and contains the glyph cache for each style
       METRIC_TABLE metrics; // For variable fonts, these are pre-defined metrics with style names
       FMETA meta = FMETA::NIL;
       int glyph_flags = 0;
+      bool has_kerning = false; // True if the face has a kerning table
       ft_point *active_size = nullptr;
 
       freetype_font()  { }
-      freetype_font(FT_Face pFace, STYLE_CACHE &pStyles, METRIC_TABLE &pMetrics, FMETA pMeta = FMETA::NIL)
-         : face(pFace), style_cache(pStyles), metrics(pMetrics), meta(pMeta) {
+      freetype_font(FT_Face pFace, STYLE_CACHE &&pStyles, METRIC_TABLE &pMetrics, FMETA pMeta = FMETA::NIL)
+         : face(pFace), style_cache(std::move(pStyles)), metrics(pMetrics), meta(pMeta) {
+         has_kerning = FT_HAS_KERNING(pFace);
          if ((pMeta & FMETA::HINT_INTERNAL) != FMETA::NIL) glyph_flags = FT_LOAD_TARGET_NORMAL|FT_LOAD_FORCE_AUTOHINT;
          else if ((pMeta & FMETA::HINT_LIGHT) != FMETA::NIL) glyph_flags = FT_LOAD_TARGET_LIGHT;
          else if ((pMeta & FMETA::HINT_NORMAL) != FMETA::NIL) glyph_flags = FT_LOAD_TARGET_NORMAL; // Use the font's hinting information
@@ -167,11 +298,14 @@ class freetype_font {
       ~freetype_font();
 };
 
-extern ERR get_font(pf::Log &Log, CSTRING, CSTRING, int, int, common_font **);
+extern ERR get_font(pf::Log &Log, CSTRING, CSTRING, int, int, common_font **, bool = false);
 
 // Caching note: Although it is policy for cached fonts to be permanently retained, it is not necessary for the
 // glyphs themselves to be permanently cached.  Future resource management should therefore actively remove
 // glyphs that have gone stale.
+//
+// glFontMutex protects the font registries and their style caches.  It is not required for glyph access, which is
+// managed by the glyph tables and the lock of each freetype_font.
 
 extern std::recursive_mutex glFontMutex;
 extern ankerl::unordered_dense::map<uint32_t, std::unique_ptr<bmp_font>> glBitmapFonts;
@@ -21,79 +21,67 @@ definition.  This will ensure that the VectorGradient is de-allocated when the s
 
 static ERR VECTORGRADIENT_SET_Stops(extVectorGradient *Self, GradientStop *Value, int Elements);
 
-// Return a gradient table for a vector with its opacity multiplier applied.  The table is cached with the vector so
-// that it does not need to be recalculated when required again.
+// Return a gradient table with an opacity multiplier applied.  Tables are cached by the gradient's colour table so that
+// they are shared by all vectors using the gradient, and do not need to be recalculated when the opacity changes.
 
-GRADIENT_TABLE * get_fill_gradient_table(extPainter &Painter, double Opacity)
+static GRADIENT_TABLE * get_gradient_table(extVectorGradient &Gradient, double Opacity)
 {
    pf::Log log(__FUNCTION__);
 
-   GradientColours *cols = ((extVectorGradient *)Painter.Gradient)->Colours;
+   auto cols = Gradient.Colours;
    if (!cols) {
-      log.warning("No colour table in gradient %p.", Painter.Gradient);
+      log.warning("No colour table in gradient #%d.", Gradient.UID);
       return nullptr;
    }
 
-   if (Opacity >= 1.0) { // Return the original gradient table if no translucency is applicable.
-      Painter.GradientAlpha = 1.0;
-      return &cols->table;
-   }
-   else {
-      if ((Painter.GradientTable) and (Opacity IS Painter.GradientAlpha)) return Painter.GradientTable;
-
-      delete Painter.GradientTable;
-      Painter.GradientTable = new (std::nothrow) GRADIENT_TABLE();
-      if (!Painter.GradientTable) {
-         log.warning("Failed to allocate fill gradient table");
-         return nullptr;
-      }
-      Painter.GradientAlpha = Opacity;
+   if (Opacity >= 1.0) return &cols->table; // Return the original gradient table if no translucency is applicable.
 
-      for (unsigned i=0; i < Painter.GradientTable->size(); i++) {
-         (*Painter.GradientTable)[i] = agg::rgba8(cols->table[i].r, cols->table[i].g, cols->table[i].b,
-            cols->table[i].a * Opacity);
-      }
-
-      return Painter.GradientTable;
+   bool hit;
+   auto table = cols->alpha_table(Opacity, hit);
+   if (auto cache = get_gradient_cache(Gradient)) {
+      cache->stats[hit ? GradientCache::TABLE_HITS : GradientCache::TABLE_MISSES]++;
    }
+   return table;
+}
+
+GRADIENT_TABLE * get_fill_gradient_table(extPainter &Painter, double Opacity)
+{
+   return get_gradient_table(*((extVectorGradient *)Painter.Gradient), Opacity);
 }
 
 //********************************************************************************************************************
 
 GRADIENT_TABLE * get_stroke_gradient_table(extVector &Vector)
 {
-   pf::Log log(__FUNCTION__);
+   return get_gradient_table(*((extVectorGradient *)Vector.Stroke.Gradient), Vector.StrokeOpacity * Vector.Opacity);
+}
 
-   GradientColours *cols = ((extVectorGradient *)Vector.Stroke.Gradient)->Colours;
-   if (!cols) {
-      if (!cols) {
-         log.warning("No colour table referenced in stroke gradient %p for vector #%d.", Vector.Stroke.Gradient, Vector.UID);
-         return nullptr;
+//********************************************************************************************************************
+// Return the colour table with Opacity applied to the alpha channel.  The least recently used table is recycled
+// if the cache is full.
+
+GRADIENT_TABLE * GradientColours::alpha_table(double Opacity, bool &Hit)
+{
+   for (auto it = alpha_tables.begin(); it != alpha_tables.end(); it++) {
+      if (it->first IS Opacity) {
+         std::rotate(alpha_tables.begin(), it, it + 1);
+         Hit = true;
+         return alpha_tables.front().second.get();
       }
    }
 
-   if ((Vector.StrokeOpacity IS 1.0) and (Vector.Opacity IS 1.0)) {
-      Vector.Stroke.GradientAlpha = 1.0;
-      return &cols->table;
+   Hit = false;
+   if (alpha_tables.size() < MAX_ALPHA_TABLES) {
+      alpha_tables.emplace_back(Opacity, std::make_unique<GRADIENT_TABLE>());
    }
-   else {
-      double opacity = Vector.StrokeOpacity * Vector.Opacity;
-      if ((Vector.Stroke.GradientTable) and (opacity IS Vector.Stroke.GradientAlpha)) return Vector.Stroke.GradientTable;
-
-      delete Vector.Stroke.GradientTable;
-      Vector.Stroke.GradientTable = new (std::nothrow) GRADIENT_TABLE();
-      if (!Vector.Stroke.GradientTable) {
-         log.warning("Failed to allocate stroke gradient table");
-         return nullptr;
-      }
-      Vector.Stroke.GradientAlpha = opacity;
+   else alpha_tables.back().first = Opacity;
+   std::rotate(alpha_tables.begin(), alpha_tables.end() - 1, alpha_tables.end());
 
-      for (unsigned i=0; i < Vector.Stroke.GradientTable->size(); i++) {
-         (*Vector.Stroke.GradientTable)[i] = agg::rgba8(cols->table[i].r, cols->table[i].g, cols->table[i].b, cols->table[i].a * opacity);
-      }
-
-      return Vector.Stroke.GradientTable;
+   auto &dest = *alpha_tables.front().second;
+   for (unsigned i=0; i < dest.size(); i++) {
+      dest[i] = agg::rgba8(table[i].r, table[i].g, table[i].b, table[i].a * Opacity);
    }
+   return &dest;
 }
 
 //********************************************************************************************************************
@@ -153,6 +141,7 @@ static ERR VECTORGRADIENT_Free(extVectorGradient *Self)
 {
    if (Self->ID) { FreeResource(Self->ID); Self->ID = nullptr; }
    if (Self->Colours) { delete Self->Colours; Self->Colours = nullptr; }
+   if (Self->Cache)   { delete Self->Cache; Self->Cache = nullptr; }
    Self->Stops.~vector<GradientStop>();
    Self->ColourMap.~basic_string();
 
@@ -212,6 +201,30 @@ static ERR VECTORGRADIENT_NewObject(extVectorGradient *Self)
 
 /*********************************************************************************************************************
 
+-FIELD-
+CacheStats: Reports the efficiency of the gradient's render caches.
+
+This read-only field returns an array of four counters that reflect the use of the gradient's internal caches since
+it was created.  In order, the values are the number of hits and misses on the cache of opacity-adjusted colour tables,
+followed by the number of hits and misses on the cache of distance transforms for `CONTOUR` gradients.
+
+A high miss count for colour tables indicates that the gradient is used at many different opacity levels.  A high
+miss count for contours indicates that the paths of the vectors that use the gradient are changing frequently.
+
+*********************************************************************************************************************/
+
+static ERR VECTORGRADIENT_GET_CacheStats(extVectorGradient *Self, int **Value, int *Elements)
+{
+   if (auto cache = get_gradient_cache(*Self)) {
+      *Value = cache->stats.data();
+      *Elements = cache->stats.size();
+      return ERR::Okay;
+   }
+   else return ERR::AllocMemory;
+}
+
+/*********************************************************************************************************************
+
 -FIELD-
 CenterX: The horizontal center point of the gradient.
 
@@ -878,6 +891,7 @@ static const FieldArray clGradientFields[] = {
    { "Flags",        FDF_INTFLAGS|FDF_RW, nullptr, nullptr, &clVectorGradientFlags },
    { "ColourSpace",  FDF_INT|FDF_RI, nullptr, nullptr, &clVectorGradientColourSpace },
    // Virtual fields
+   { "CacheStats",   FDF_VIRTUAL|FDF_INT|FDF_ARRAY|FDF_R, VECTORGRADIENT_GET_CacheStats },
    { "Colour",       FDF_VIRTUAL|FD_FLOAT|FDF_ARRAY|FD_RW, VECTORGRADIENT_GET_Colour, VECTORGRADIENT_SET_Colour },
    { "ColourMap",    FDF_VIRTUAL|FDF_STRING|FDF_W, VECTORGRADIENT_GET_ColourMap, VECTORGRADIENT_SET_ColourMap },
    { "CX",           FDF_VIRTUAL|FDF_SYNONYM|FDF_UNIT|FDF_DOUBLE|FDF_SCALED|FDF_RW, VECTORGRADIENT_GET_CenterX, VECTORGRADIENT_SET_CenterX },
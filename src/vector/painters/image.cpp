@@ -18,6 +18,14 @@ NOTE: For the rendering of vectors as flattened images, use @VectorPattern.
 
 *********************************************************************************************************************/
 
+static ERR IMAGE_Free(extVectorImage *Self)
+{
+   if (Self->Mips) { delete Self->Mips; Self->Mips = nullptr; }
+   return ERR::Okay;
+}
+
+//********************************************************************************************************************
+
 static ERR IMAGE_Init(extVectorImage *Self)
 {
    pf::Log log;
@@ -68,6 +76,9 @@ Bitmap: Reference to a source bitmap for the rendering algorithm.
 This field must be set prior to initialisation.  It will refer to a source bitmap that will be used by the rendering
 algorithm.  The source bitmap must be in a 32-bit graphics format.
 
+Reduced copies of the bitmap are cached for drawing at small scales.  If the content of the bitmap is modified in
+place, set this field again so that the cache is refreshed.
+
 *********************************************************************************************************************/
 
 static ERR IMAGE_SET_Bitmap(extVectorImage *Self, objBitmap *Value)
@@ -80,6 +91,8 @@ static ERR IMAGE_SET_Bitmap(extVectorImage *Self, objBitmap *Value)
 
    Self->Bitmap = Value;
    Self->Picture = nullptr;
+   if (Self->Mips) Self->Mips->reset(); // Reduced levels are regenerated from the new bitmap on demand
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -110,6 +123,8 @@ static ERR IMAGE_SET_Picture(extVectorImage *Self, objPicture *Value)
 
    Self->Picture = Value;
    if (Value) Self->Bitmap = Value->Bitmap;
+   if (Self->Mips) Self->Mips->reset();
+   Self->modified();
    return ERR::Okay;
 }
 
@@ -168,6 +183,7 @@ static ERR IMAGE_SET_Y(extVectorImage *Self, double Value)
 //********************************************************************************************************************
 
 static const ActionArray clImageActions[] = {
+   { AC::Free,      IMAGE_Free },
    { AC::Init,      IMAGE_Init },
    { AC::NewObject, IMAGE_NewObject },
    { AC::NIL, nullptr }
@@ -48,6 +48,8 @@ static ERR PATTERN_Draw(extVectorPattern *Self, struct acDraw *Args)
    Self->Scene->Bitmap = Self->Bitmap;
    acDraw(Self->Scene);
 
+   if (Self->Mips) Self->Mips->reset(); // Reduced levels are regenerated from the new tile on demand
+
    return ERR::Okay;
 }
 
@@ -64,6 +66,7 @@ static ERR PATTERN_Free(extVectorPattern *Self)
 
    if (Self->Bitmap) { FreeResource(Self->Bitmap); Self->Bitmap = nullptr; }
    if (Self->Scene)  { FreeResource(Self->Scene); Self->Scene = nullptr; }
+   if (Self->Mips)   { delete Self->Mips; Self->Mips = nullptr; }
 
    return ERR::Okay;
 }
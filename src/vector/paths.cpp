@@ -1,5 +1,6 @@
 
 #include "agg_trans_single_path.h"
+#include <bs_thread_pool.h>
 
 //********************************************************************************************************************
 
@@ -46,6 +47,53 @@ void gen_vector_tree(extVector *Vector)
    gen_vector_path(Vector);
 }
 
+//********************************************************************************************************************
+// Transform the captured vertices and add them to Raster.  The transform runs over the flat coordinate array as a
+// separate pass so that the compiler is free to vectorise it.
+
+void flat_path::rasterise(agg::rasterizer_scanline_aa<> &Raster, const agg::trans_affine &Transform) const
+{
+   static thread_local std::vector<double> transformed;
+   transformed.resize(Coords.size());
+
+   const double sx = Transform.sx, shx = Transform.shx, tx = Transform.tx;
+   const double shy = Transform.shy, sy = Transform.sy, ty = Transform.ty;
+   auto src = Coords.data();
+   auto dest = transformed.data();
+   for (size_t i=0; i < Coords.size(); i += 2) {
+      const double x = src[i], y = src[i+1];
+      dest[i]   = x * sx + y * shx + tx;
+      dest[i+1] = x * shy + y * sy + ty;
+   }
+
+   for (size_t i=0; i < Commands.size(); i++) Raster.add_vertex(dest[i*2], dest[i*2+1], Commands[i]);
+}
+
+//********************************************************************************************************************
+// Add an outline to Raster, reusing the vector's captured outline if only the transform has changed since it was
+// flattened.
+
+template <class VertexSource>
+static void rasterise_outline(flat_path &Outline, VertexSource &Source, uint64_t Key, double Scale,
+   const agg::trans_affine &Transform, agg::rasterizer_scanline_aa<> &Raster)
+{
+   if (Outline.valid(Key, Scale)) Outline.rasterise(Raster, Transform);
+   else if (Outline.Armed) {
+      Outline.capture(Source, Key, Scale);
+      Outline.rasterise(Raster, Transform);
+   }
+   else {
+      Outline.Armed = true;
+      agg::conv_transform<VertexSource, agg::trans_affine> path(Source, Transform);
+      Raster.add_path(path);
+   }
+}
+
+template <class T> static inline void outline_key(uint64_t &Hash, const T Value)
+{
+   Hash = ankerl::unordered_dense::detail::wyhash::hash(&Value, sizeof(T)) ^ (Hash * 0x9e3779b97f4a7c15ull);
+}
+
 //********************************************************************************************************************
 // (Re)Generates the path for a vector.  Switches off most of the Dirty flag markers.  For Viewports, the vpFixed*
 // and boundary field values will all be set.  There is no recursion into child vectors.
@@ -53,12 +101,15 @@ void gen_vector_tree(extVector *Vector)
 // NOTE: If parent vectors are marked as dirty at the time of calling this function, any relative values will be
 // computed from stale information and likely to produce the wrong result.  Use gen_vector_tree() to avoid
 // such problems.
+//
+// Returns true if the path changed.  Notifications are left to the caller, as this function can run on a worker
+// thread (see gen_scene_paths()).
 
-void gen_vector_path(extVector *Vector)
+static bool build_vector_path(extVector *Vector)
 {
    pf::Log log(__FUNCTION__);
 
-   if ((!Vector->GeneratePath) and (Vector->classID() != CLASSID::VECTORVIEWPORT) and (Vector->classID() != CLASSID::VECTORGROUP)) return;
+   if ((!Vector->GeneratePath) and (Vector->classID() != CLASSID::VECTORVIEWPORT) and (Vector->classID() != CLASSID::VECTORGROUP)) return false;
 
    pf::SwitchContext context(Vector);
 
@@ -72,7 +123,7 @@ void gen_vector_path(extVector *Vector)
       Vector->Transform.reset();
       apply_parent_transforms(Vector, Vector->Transform);
       Vector->Dirty &= ~RC::DIRTY; // Making out that the group has been refreshed is important
-      return;
+      return false;
    }
    else if (Vector->classID() IS CLASSID::VECTORVIEWPORT) {
       auto view = (extVectorViewport *)Vector;
@@ -252,6 +303,8 @@ void gen_vector_path(extVector *Vector)
 
       if ((Vector->Dirty & RC::BASE_PATH) != RC::NIL) {
          Vector->BasePath.free_all();
+         Vector->FillOutline.reset();
+         Vector->StrokeOutline.reset();
 
          Vector->GeneratePath(Vector, Vector->BasePath);
 
@@ -336,9 +389,10 @@ void gen_vector_path(extVector *Vector)
          Vector->Dirty = (Vector->Dirty & (~RC::TRANSFORM)) | RC::FINAL_PATH;
       }
 
+      const double scale = Vector->Transform.scale();
+      const bool fine_angles = (Vector->Matrices) and (scale > 1.0);
       if (Vector->Matrices) {
-         double scale = Vector->Transform.scale();
-         if (scale > 1.0) Vector->BasePath.angle_tolerance(0.2); // Set in radians.  The less this value is, the more accurate it will be at sharp turns.
+         if (fine_angles) Vector->BasePath.angle_tolerance(0.2); // Set in radians.  The less this value is, the more accurate it will be at sharp turns.
          else Vector->BasePath.angle_tolerance(0);
       }
 
@@ -347,13 +401,12 @@ void gen_vector_path(extVector *Vector)
       if ((Vector->Fill[0].Colour.Alpha > 0) or (Vector->Fill[0].Gradient) or (Vector->Fill[0].Image) or (Vector->Fill[0].Pattern)) {
          if (!Vector->FillRaster) {
             Vector->FillRaster = new (std::nothrow) agg::rasterizer_scanline_aa<>;
-            if (!Vector->FillRaster) return;
+            if (!Vector->FillRaster) return false;
          }
          else Vector->FillRaster->reset();
 
-         Vector->BasePath.approximation_scale(Vector->Transform.scale());
-         agg::conv_transform<agg::path_storage, agg::trans_affine> fill_path(Vector->BasePath, Vector->Transform);
-         Vector->FillRaster->add_path(fill_path);
+         Vector->BasePath.approximation_scale(scale);
+         rasterise_outline(Vector->FillOutline, Vector->BasePath, uint64_t(fine_angles), scale, Vector->Transform, *Vector->FillRaster);
       }
       else if (Vector->FillRaster) {
          delete Vector->FillRaster;
@@ -366,7 +419,7 @@ void gen_vector_path(extVector *Vector)
 
          if (!Vector->StrokeRaster) {
             Vector->StrokeRaster = new (std::nothrow) agg::rasterizer_scanline_aa<>;
-            if (!Vector->StrokeRaster) return;
+            if (!Vector->StrokeRaster) return false;
          }
          else Vector->StrokeRaster->reset();
 
@@ -378,11 +431,18 @@ void gen_vector_path(extVector *Vector)
             Vector->StrokeRaster->add_path(stroke_path);
          }
          else {
-            Vector->BasePath.approximation_scale(Vector->Transform.scale());
+            Vector->BasePath.approximation_scale(scale);
             agg::conv_stroke<agg::path_storage> stroked_path(Vector->BasePath);
             configure_stroke(*Vector, stroked_path);
-            agg::conv_transform<agg::conv_stroke<agg::path_storage>, agg::trans_affine> stroke_path(stroked_path, Vector->Transform);
-            Vector->StrokeRaster->add_path(stroke_path);
+
+            uint64_t key = uint64_t(fine_angles);
+            outline_key(key, stroked_path.width());
+            outline_key(key, int(Vector->LineJoin));
+            outline_key(key, int(Vector->LineCap));
+            outline_key(key, int(Vector->InnerJoin));
+            outline_key(key, Vector->MiterLimit);
+            outline_key(key, Vector->InnerMiterLimit);
+            rasterise_outline(Vector->StrokeOutline, stroked_path, key, scale, Vector->Transform, *Vector->StrokeRaster);
          }
       }
       else if (Vector->StrokeRaster) {
@@ -394,6 +454,14 @@ void gen_vector_path(extVector *Vector)
    }
    else log.warning("Target vector is not a shape.");
 
+   return true;
+}
+
+//********************************************************************************************************************
+// Notify the client and scene that the path of a vector has changed.  Always called from the main thread.
+
+static void path_changed(extVector *Vector)
+{
    send_feedback(Vector, FM::PATH_CHANGED);
 
    // Changes to the path could mean that the mouse cursor needs to be refreshed.
@@ -401,6 +469,90 @@ void gen_vector_path(extVector *Vector)
    Vector->RequiresRedraw = true;
 }
 
+void gen_vector_path(extVector *Vector)
+{
+   if (build_vector_path(Vector)) path_changed(Vector);
+}
+
+//********************************************************************************************************************
+// Returns true if the path of a vector can be generated on a worker thread.  Viewports and groups are cheap to compute
+// and their children depend on them.  Vectors that refer to other vectors for their path are excluded because
+// generation would recurse into the referenced vector.
+
+static bool is_parallel_path(extVector *Vector)
+{
+   if ((Vector->classID() IS CLASSID::VECTORVIEWPORT) or (Vector->classID() IS CLASSID::VECTORGROUP)) return false;
+   if ((!Vector->GeneratePath) or (Vector->AppendPath) or (Vector->Morph)) return false;
+   if (Vector->classID() IS CLASSID::VECTORTEXT) return is_parallel_text((extVectorText *)Vector);
+   return true;
+}
+
+//********************************************************************************************************************
+// Generates the paths of all dirty vectors in a scene graph, as a pre-pass to drawing.  The tree is processed one
+// level at a time so that parents, viewports in particular, are always generated before their children.  The dirty
+// vectors of a level are independent of each other and are generated in parallel if there are enough of them.
+// Vectors that draw_vectors() would not visit due to their visibility are left as they are.
+
+void gen_scene_paths(extVector *Root)
+{
+   constexpr size_t MIN_PARALLEL = 16; // Minimum number of paths for parallel generation to be worth the overhead
+
+   std::vector<std::pair<extVector *, bool>> level = { { Root, true } }; // First sibling and visibility of the parent
+   std::vector<std::pair<extVector *, bool>> next;
+   std::vector<extVector *> parallel;
+   std::unique_ptr<BS::thread_pool<>> pool;
+
+   while (!level.empty()) {
+      next.clear();
+      parallel.clear();
+
+      for (auto [first, parent_visible] : level) {
+         for (auto node=first; node; node=(extVector *)node->Next) {
+            if ((node->baseClassID() != CLASSID::VECTOR) or (!node->Scene)) continue;
+
+            if (node->dirty()) {
+               if (is_parallel_path(node)) parallel.push_back(node);
+               else gen_vector_path(node);
+            }
+
+            bool visible;
+            if (node->Visibility IS VIS::INHERIT) visible = parent_visible;
+            else visible = node->Visibility IS VIS::VISIBLE;
+
+            if ((node->Child) and ((visible) or (node->classID() IS CLASSID::VECTORGROUP))) {
+               next.emplace_back((extVector *)node->Child, visible);
+            }
+         }
+      }
+
+      if (parallel.size() >= MIN_PARALLEL) {
+         if (!pool) {
+            int thread_count = std::thread::hardware_concurrency();
+            if (thread_count < 1) thread_count = 1;
+            pool = std::make_unique<BS::thread_pool<>>(thread_count);
+         }
+
+         std::vector<uint8_t> changed(parallel.size());
+         pool->detach_loop(size_t(0), parallel.size(), [&parallel, &changed](size_t i) {
+            // A vector may already have been generated as a dependency of a serially generated vector.
+            if (parallel[i]->dirty()) changed[i] = build_vector_path(parallel[i]);
+         });
+         pool->wait();
+
+         for (size_t i=0; i < parallel.size(); i++) {
+            if (changed[i]) path_changed(parallel[i]);
+         }
+      }
+      else {
+         for (auto vector : parallel) {
+            if (vector->dirty()) gen_vector_path(vector);
+         }
+      }
+
+      level.swap(next);
+   }
+}
+
 //********************************************************************************************************************
 // Apply all transforms in the correct SVG order to a target agg::trans_affine object.  The process starts with the
 // vector passed in to the function, and proceeds upwards through the parent nodes.
@@ -174,7 +174,7 @@ static void linear32ARGB(uint8_t *p, uint8_t cr, uint8_t cg, uint8_t cb, uint8_t
 // sRGB copy and cover operations
 
 static void srgbCopy32BGRA(uint8_t *p, uint8_t cr, uint8_t cg, uint8_t cb, uint8_t alpha) noexcept {
-   blend32<2,1,0,3,srgb_blend32>(p,cr,cg,cb,alpha);
+   copy32<2,1,0,3,srgb_blend32>(p,cr,cg,cb,alpha);
 }
 
 static void srgbCover32BGRA(uint8_t *p, uint8_t cr, uint8_t cg, uint8_t cb, uint8_t alpha, uint32_t cover) noexcept {
@@ -208,7 +208,7 @@ static void srgbCover32ARGB(uint8_t *p, uint8_t cr, uint8_t cg, uint8_t cb, uint
 // Gamma correct copy and cover operations
 
 static void gammaCopy32BGRA(uint8_t *p, uint8_t cr, uint8_t cg, uint8_t cb, uint8_t alpha) noexcept {
-   blend32<2,1,0,3,srgb_blend32_gamma>(p,cr,cg,cb,alpha);
+   copy32<2,1,0,3,srgb_blend32_gamma>(p,cr,cg,cb,alpha);
 }
 
 static void gammaCover32BGRA(uint8_t *p, uint8_t cr, uint8_t cg, uint8_t cb, uint8_t alpha, uint32_t cover) noexcept {
@@ -304,6 +304,7 @@ public:
    void (*fBlendSolidHSpan)(agg::pixfmt_psl *, int x, int y, uint32_t len, const agg::rgba8 &, const uint8_t *covers) noexcept;
    void (*fBlendColorHSpan)(agg::pixfmt_psl *, int x, int y, uint32_t len, const agg::rgba8 *, const uint8_t *covers, uint8_t cover) noexcept;
    void (*fCopyColorHSpan)(agg::pixfmt_psl *, int x, int y, uint32_t len, const agg::rgba8 *) noexcept; // copy_color_hspan
+   simd_blend::span_fn fSpanBlend; // Source-over kernel for rgba8 spans, used by the SIMD span routines
 
    inline unsigned width()  const { return mWidth;  }
    inline unsigned height() const { return mHeight; }
@@ -407,6 +408,39 @@ private:
       } while(--len);
    }
 
+   // 32-bit sRGB routines that blend whole spans with a SIMD kernel.  The results are identical to those of the
+   // generic routines.
+
+   static void simdBlendHLine32(agg::pixfmt_psl *Self, int x, int y, unsigned len, const agg::rgba8 &c, int8u cover) noexcept
+   {
+      if ((!c.a) or (((uint32_t(c.a) * (cover + 1)) >> 8) == 0xff)) blendHLine32(Self, x, y, len, c, cover);
+      else {
+         Self->fSpanBlend({
+            .dest = Self->mData + (y * Self->mStride) + (x<<2), .src = &c.r, .covers = nullptr, .count = len,
+            .step = 0, .cover = cover, .cover_plus_one = true, .skip_clear = false, .copy_empty = true, .copy_first = false
+         });
+      }
+   }
+
+   static void simdBlendSolidHSpan32(agg::pixfmt_psl *Self, int x, int y, uint32_t len, const agg::rgba8 &c, const uint8_t *covers) noexcept
+   {
+      if (c.a) {
+         Self->fSpanBlend({
+            .dest = Self->mData + (y * Self->mStride) + (x<<2), .src = &c.r, .covers = covers, .count = len,
+            .step = 0, .cover = 0xff, .cover_plus_one = true, .skip_clear = false, .copy_empty = true, .copy_first = false
+         });
+      }
+   }
+
+   static void simdBlendColorHSpan32(agg::pixfmt_psl *Self, int x, int y, uint32_t len, const agg::rgba8 *colors, const uint8_t *covers, uint8_t cover) noexcept
+   {
+      Self->fSpanBlend({
+         .dest = Self->mData + (y * Self->mStride) + (x<<2), .src = &colors->r, .covers = covers, .count = len,
+         .step = sizeof(agg::rgba8), .cover = cover, .cover_plus_one = true, .skip_clear = true, .copy_empty = true,
+         .copy_first = false
+      });
+   }
+
    // Generic 8-bit grey-scale routines
 
    static void blendHLine8(agg::pixfmt_psl *Self, int x, int y, unsigned len, const agg::rgba8 &c, int8u cover) noexcept
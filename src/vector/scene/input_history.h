@@ -0,0 +1,43 @@
+// Batching of pointer movement for the input subscribers of a scene.  InputEvent must be declared prior to inclusion.
+//
+// A series of movement events received from the scene's surface is consolidated so that the vector under the pointer
+// is only resolved for the final position.  Subscribers that include JTYPE::HISTORY in their mask receive every
+// position in the series instead, in the coordinate space of the vector and with the original timestamps.
+
+#pragma once
+
+#include <vector>
+
+namespace input_history {
+
+// Returns the last event of the movement series that starts at Event, or Event if it is not movement.
+
+inline const InputEvent * consolidate(const InputEvent *Event)
+{
+   if ((Event->Flags & (JTYPE::ANCHORED|JTYPE::MOVEMENT)) != JTYPE::NIL) {
+      while ((Event->Next) and ((Event->Next->Flags & JTYPE::MOVEMENT) != JTYPE::NIL)) Event = Event->Next;
+   }
+   return Event;
+}
+
+// Builds the history for a vector from the events in [Run, Last), followed by Final which is the localised copy of
+// Last.  Events that were not over the scene's surface are skipped.  Transform is the inverse of the vector's
+// transform, and must provide transform(double *, double *).  The Next fields of History are linked on return.
+
+template <class T>
+void localise(const InputEvent *Run, const InputEvent *Last, const InputEvent &Final, OBJECTID SurfaceID,
+   OBJECTID VectorID, const T &Transform, std::vector<InputEvent> &History)
+{
+   for (auto e=Run; e != Last; e=e->Next) {
+      if (e->OverID != SurfaceID) continue;
+      auto &h = History.emplace_back(*e);
+      h.OverID = VectorID;
+      h.AbsX   = e->X;
+      h.AbsY   = e->Y;
+      Transform.transform(&h.X, &h.Y);
+   }
+   History.push_back(Final);
+   for (size_t i=0; i < History.size(); i++) History[i].Next = (i + 1 < History.size()) ? &History[i + 1] : nullptr;
+}
+
+} // namespace input_history
@@ -465,8 +465,11 @@ static ERR VECTORSCENE_Init(extVectorScene *Self)
          }
       }
 
+      // The movement history is always requested so that it can be passed on to vectors that want it.  Hit-testing
+      // is limited to the most recent position of each series.
+
       auto callback = C_FUNCTION(scene_input_events);
-      if (gfx::SubscribeInput(&callback, Self->SurfaceID, JTYPE::MOVEMENT|JTYPE::CROSSING|JTYPE::BUTTON|JTYPE::REPEATED|JTYPE::EXT_MOVEMENT, 0, &Self->InputHandle) != ERR::Okay) {
+      if (gfx::SubscribeInput(&callback, Self->SurfaceID, JTYPE::MOVEMENT|JTYPE::CROSSING|JTYPE::BUTTON|JTYPE::REPEATED|JTYPE::EXT_MOVEMENT|JTYPE::HISTORY, 0, &Self->InputHandle) != ERR::Okay) {
          return ERR::Function;
       }
    }
@@ -594,7 +597,8 @@ cont:
 -FIELD-
 Bitmap: Target bitmap for drawing vectors.
 
-The target bitmap to use when drawing the vectors must be specified here.
+The target bitmap to use when drawing the vectors must be specified here.  Set to `NULL` to detach the scene from a
+bitmap that is about to be freed.
 -END-
 *********************************************************************************************************************/
 
@@ -615,7 +619,10 @@ static ERR SET_Bitmap(extVectorScene *Self, objBitmap *Value)
       }
       else return ERR::Memory;
    }
-   else Self->Buffer = nullptr;
+   else {
+      if (Self->Buffer) { delete Self->Buffer; Self->Buffer = nullptr; }
+      Self->Bitmap = nullptr;
+   }
 
    return ERR::Okay;
 }
@@ -1,6 +1,8 @@
-// TODO: Currently mask bitmaps are created and torn down on each drawing cycle.  We may be able to cache the bitmaps
-// with Vectors when they request a mask.  Bear in mind that caching has to be on a per-vector basis and not in the
-// VectorClip itself due to the fact that a given VectorClip can be referenced by many vectors.
+// Mask bitmaps that are drawn from a VectorClip are retained by the clip for reuse on the next frame.  A given VectorClip
+// can be referenced by many vectors, so the masks are keyed by the client vector and its transform, and the most
+// recently used masks are kept.  Changes to the clip paths are detected through their dirty flags and the Generation of
+// the clip's viewport, which covers changes to appearance such as visibility, clip rule and fill.  Either will increment
+// the clip's Generation and thereby invalidate the masks of all clients.
 
 //********************************************************************************************************************
 // This function recursively draws all child vectors to a bitmap mask in an additive way.
@@ -52,7 +54,8 @@ void SceneRenderer::ClipBuffer::draw_clips(SceneRenderer &Render, extVector *Sha
                      agg::pixfmt_psl pixf;
                      agg::renderer_base<agg::pixfmt_psl> rb(pixf);
                      ColourFormat cf; // Dummy, not required
-                     pixf.rawBitmap(m_bitmap.data(), m_width, m_height, m_width, 8, cf, BLM::LINEAR);
+                     pixf.rawBitmap(m_mask->bitmap.data(), m_mask->width, m_mask->height, m_mask->width, 8, cf, BLM::LINEAR);
+                     m_cacheable = false; // Painters can change without marking the clip paths as dirty
                      rb.attach(pixf);
 
                      agg::conv_transform<agg::path_storage, agg::trans_affine> final_path(node->BasePath, t);
@@ -123,21 +126,17 @@ void SceneRenderer::ClipBuffer::resize_bitmap(int X, int Y, int Width, int Heigh
    if (Width > 8192)  Width = 8192;
    if (Height > 8192) Height = 8192;
 
-   m_bitmap.resize(Width * Height);
-
-   m_width  = Width;
-   m_height = Height;
-
-   Y *= Width;
+   if (!m_mask) m_mask = std::make_shared<ClipMask>();
+   m_mask->bitmap.assign(size_t(Width) * Height, 0);
+   m_mask->width  = Width;
+   m_mask->height = Height;
+}
 
-   if (X < 0) X = 0;
-   if (Y < 0) Y = 0;
+//********************************************************************************************************************
 
-   if ((X < Width) and (Y < Height)) {
-      for (; Y < Height; Y += Width) {
-         clearmem(m_bitmap.data() + Y + X, Width - X);
-      }
-   }
+void SceneRenderer::ClipBuffer::attach()
+{
+   m_renderer.attach(m_mask->bitmap.data(), m_mask->width-1, m_mask->height-1, m_mask->width);
 }
 
 //********************************************************************************************************************
@@ -150,7 +149,7 @@ void SceneRenderer::ClipBuffer::draw_viewport(SceneRenderer &Render)
 
    resize_bitmap(int(vp->vpBounds.left), int(vp->vpBounds.top), int(vp->vpBounds.right) + 2, int(vp->vpBounds.bottom) + 2);
 
-   m_renderer.attach(m_bitmap.data(), m_width-1, m_height-1, m_width);
+   attach();
    agg::pixfmt_gray8 pixf(m_renderer);
    agg::renderer_base<agg::pixfmt_gray8> rb(pixf);
    agg::renderer_scanline_aa_solid<agg::renderer_base<agg::pixfmt_gray8>> solid(rb);
@@ -182,8 +181,75 @@ void SceneRenderer::ClipBuffer::draw(SceneRenderer &Scene)
       m_clip->Viewport->newMatrix(nullptr, false);
    }
 
-   if (m_clip->Units IS VUNIT::BOUNDING_BOX) draw_bounding_box(Scene);
+   // The key covers everything outside of the clip paths that affects the mask.
+
+   uint64_t key = 0;
+   auto mix = [&key](const auto Value) {
+      key = ankerl::unordered_dense::detail::wyhash::hash(&Value, sizeof(Value)) ^ (key * 0x9e3779b97f4a7c15ull);
+   };
+
+   mix(m_shape);
+   mix(m_clip->Flags);
+   mix(m_clip->Units);
+   mix(m_shape->Transform);
+
+   TClipRectangle<double> shape_bounds = TCR_EXPANDING; // Bounds *without transforms*
+   if (m_clip->Units IS VUNIT::BOUNDING_BOX) {
+      calc_full_boundary(m_shape, shape_bounds, false, false, false);
+      mix(shape_bounds);
+      for (auto t=m_shape->Matrices; t; t=t->Next) {
+         mix(t->ScaleX); mix(t->ShearY); mix(t->ShearX); mix(t->ScaleY); mix(t->TranslateX); mix(t->TranslateY);
+      }
+   }
+   else {
+      mix(get_parent_width(m_shape));
+      mix(get_parent_height(m_shape));
+      mix(m_shape->classID());
+   }
+
+   auto viewport = (extVector *)m_clip->Viewport;
+   if ((check_dirty(viewport)) or (viewport->Generation != m_clip->SeenGeneration)) m_clip->Generation++;
+
+   auto &masks = m_clip->Masks;
+   for (auto it = masks.begin(); it != masks.end(); it++) {
+      if (((*it)->key IS key) and ((*it)->generation IS m_clip->Generation)) {
+         std::rotate(masks.begin(), it, it + 1);
+         m_mask = masks.front();
+         m_clip->Bounds = m_mask->bounds;
+         m_clip->SeenGeneration = viewport->Generation;
+         attach();
+         return;
+      }
+   }
+
+   m_mask = std::make_shared<ClipMask>();
+   m_cacheable = true;
+
+   if (m_clip->Units IS VUNIT::BOUNDING_BOX) draw_bounding_box(Scene, shape_bounds);
    else draw_userspace(Scene);
+
+   if (m_mask->bitmap.empty()) { // No paths were defined
+      resize_bitmap(0, 0, 1, 1);
+      attach();
+   }
+
+   // Drawing the mask sizes the viewport to the client, so the generation is sampled afterwards.
+
+   m_clip->SeenGeneration = viewport->Generation;
+
+   // The mask is retained only if drawing it has left the clip paths in a clean state, otherwise the next frame would
+   // miss regardless.
+
+   if ((m_cacheable) and (!check_dirty(viewport))) {
+      m_mask->key        = key;
+      m_mask->generation = m_clip->Generation;
+      m_mask->bounds     = m_clip->Bounds;
+
+      auto it = std::find_if(masks.begin(), masks.end(), [key](auto &Mask) { return Mask->key IS key; });
+      if (it != masks.end()) masks.erase(it);
+      if (masks.size() >= extVectorClip::MAX_MASKS) masks.pop_back();
+      masks.insert(masks.begin(), m_mask);
+   }
 }
 
 //********************************************************************************************************************
@@ -233,7 +299,7 @@ void SceneRenderer::ClipBuffer::draw_userspace(SceneRenderer &Scene)
 
    // Every child vector of the VectorClip that exports a path will be rendered to the mask.
 
-   m_renderer.attach(m_bitmap.data(), m_width-1, m_height-1, m_width);
+   attach();
    agg::pixfmt_gray8 pixf(m_renderer);
    agg::renderer_base<agg::pixfmt_gray8> rb(pixf);
    agg::rasterizer_scanline_aa<> rasterizer;
@@ -243,11 +309,8 @@ void SceneRenderer::ClipBuffer::draw_userspace(SceneRenderer &Scene)
 
 //********************************************************************************************************************
 
-void SceneRenderer::ClipBuffer::draw_bounding_box(SceneRenderer &Render)
+void SceneRenderer::ClipBuffer::draw_bounding_box(SceneRenderer &Render, const TClipRectangle<double> &shape_bounds)
 {
-   TClipRectangle<double> shape_bounds = TCR_EXPANDING; // Bounds *without transforms*
-   calc_full_boundary(m_shape, shape_bounds, false, false, false);
-
    // Set the target area to mock the shape.  The viewbox will remain at (0 0 1 1), or whatever the
    // client has defined if the default is overridden.
 
@@ -273,7 +336,7 @@ void SceneRenderer::ClipBuffer::draw_bounding_box(SceneRenderer &Render)
 
    // Every child vector of the VectorClip that exports a path will be rendered to the mask.
 
-   m_renderer.attach(m_bitmap.data(), m_width-1, m_height-1, m_width);
+   attach();
    agg::pixfmt_gray8 pixf(m_renderer);
    agg::renderer_base<agg::pixfmt_gray8> rb(pixf);
    agg::rasterizer_scanline_aa<> rasterizer;
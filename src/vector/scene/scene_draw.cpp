@@ -19,9 +19,9 @@ public:
 
    class ClipBuffer {
       VectorState *m_state;
-      std::vector<uint8_t> m_bitmap;
-      int m_width, m_height;
+      std::shared_ptr<ClipMask> m_mask;
       extVector *m_shape;
+      bool m_cacheable = true; // False if the mask uses painters that are not tracked by dirty flags
 
       public:
       agg::rendering_buffer m_renderer;
@@ -38,9 +38,10 @@ public:
       void draw_viewport(SceneRenderer &);
       void draw_clips(SceneRenderer &, extVector *, agg::rasterizer_scanline_aa<> &,
          agg::renderer_base<agg::pixfmt_gray8> &, const agg::trans_affine &);
-      void draw_bounding_box(SceneRenderer &);
+      void draw_bounding_box(SceneRenderer &, const TClipRectangle<double> &);
       void draw_userspace(SceneRenderer &);
       void resize_bitmap(int, int, int, int);
+      void attach();
    };
 
 private:
@@ -57,6 +58,7 @@ private:
    }
 
    void render_fill(VectorState &, extVector &, agg::rasterizer_scanline_aa<> &, extPainter &);
+   bool render_text_fill(VectorState &, extVector &);
    void render_stroke(VectorState &, extVector &);
    void draw_vectors(extVector *, VectorState &);
    static const agg::trans_affine build_fill_transform(extVector &, bool,  VectorState &);
@@ -365,32 +367,30 @@ void set_filter(agg::image_filter_lut &Filter, VSM Method, agg::trans_affine &Tr
 // Optimium drawing speed is ensured by only using the chosen SampleMethod if the transform is complex.
 
 template <class T> void drawBitmap(T &Scanline, VSM SampleMethod, agg::renderer_base<agg::pixfmt_psl> &RenderBase, agg::rasterizer_scanline_aa<> &Raster,
-   objBitmap *SrcBitmap, VSPREAD SpreadMethod, double Opacity, agg::trans_affine *Transform = nullptr, double XOffset = 0, double YOffset = 0)
+   agg::pixfmt_psl &Pixels, VSPREAD SpreadMethod, double Opacity, agg::trans_affine *Transform = nullptr, double XOffset = 0, double YOffset = 0)
 {
-   agg::pixfmt_psl pixels(*SrcBitmap);
-
    if ((Transform) and (Transform->is_complex())) {
       agg::span_interpolator_linear interpolator(*Transform);
       agg::image_filter_lut filter;
       set_filter(filter, SampleMethod, *Transform);  // Set the interpolation filter to use.
 
       if (SpreadMethod IS VSPREAD::REFLECT_X) {
-         agg::span_reflect_x source(pixels, XOffset, YOffset);
+         agg::span_reflect_x source(Pixels, XOffset, YOffset);
          agg::span_image_filter_rgba<agg::span_reflect_x, agg::span_interpolator_linear<>> spangen(source, interpolator, filter, true);
          drawBitmapRender(Scanline, RenderBase, Raster, spangen, Opacity);
       }
       else if (SpreadMethod IS VSPREAD::REFLECT_Y) {
-         agg::span_reflect_y source(pixels, XOffset, YOffset);
+         agg::span_reflect_y source(Pixels, XOffset, YOffset);
          agg::span_image_filter_rgba<agg::span_reflect_y, agg::span_interpolator_linear<>> spangen(source, interpolator, filter, true);
          drawBitmapRender(Scanline, RenderBase, Raster, spangen, Opacity);
       }
       else if (SpreadMethod IS VSPREAD::REPEAT) {
-         agg::span_repeat_pf source(pixels, XOffset, YOffset);
+         agg::span_repeat_pf source(Pixels, XOffset, YOffset);
          agg::span_image_filter_rgba<agg::span_repeat_pf, agg::span_interpolator_linear<>> spangen(source, interpolator, filter, true);
          drawBitmapRender(Scanline, RenderBase, Raster, spangen, Opacity);
       }
       else { // VSPREAD::PAD and VSPREAD::CLIP modes.
-         agg::span_once<agg::pixfmt_psl> source(pixels, XOffset, YOffset);
+         agg::span_once<agg::pixfmt_psl> source(Pixels, XOffset, YOffset);
          agg::span_image_filter_rgba<agg::span_once<agg::pixfmt_psl>, agg::span_interpolator_linear<>> spangen(source, interpolator, filter, true);
          drawBitmapRender(Scanline, RenderBase, Raster, spangen, Opacity);
       }
@@ -404,24 +404,31 @@ template <class T> void drawBitmap(T &Scanline, VSM SampleMethod, agg::renderer_
       }
 
       if (SpreadMethod IS VSPREAD::REFLECT_X) {
-         agg::span_reflect_x source(pixels, XOffset, YOffset);
+         agg::span_reflect_x source(Pixels, XOffset, YOffset);
          drawBitmapRender(Scanline, RenderBase, Raster, source, Opacity);
       }
       else if (SpreadMethod IS VSPREAD::REFLECT_Y) {
-         agg::span_reflect_y source(pixels, XOffset, YOffset);
+         agg::span_reflect_y source(Pixels, XOffset, YOffset);
          drawBitmapRender(Scanline, RenderBase, Raster, source, Opacity);
       }
       else if (SpreadMethod IS VSPREAD::REPEAT) {
-         agg::span_repeat_pf source(pixels, XOffset, YOffset);
+         agg::span_repeat_pf source(Pixels, XOffset, YOffset);
          drawBitmapRender(Scanline, RenderBase, Raster, source, Opacity);
       }
       else { // VSPREAD::PAD and VSPREAD::CLIP modes.
-         agg::span_once<agg::pixfmt_psl> source(pixels, XOffset, YOffset);
+         agg::span_once<agg::pixfmt_psl> source(Pixels, XOffset, YOffset);
          drawBitmapRender(Scanline, RenderBase, Raster, source, Opacity);
       }
    }
 }
 
+template <class T> void drawBitmap(T &Scanline, VSM SampleMethod, agg::renderer_base<agg::pixfmt_psl> &RenderBase, agg::rasterizer_scanline_aa<> &Raster,
+   objBitmap *SrcBitmap, VSPREAD SpreadMethod, double Opacity, agg::trans_affine *Transform = nullptr, double XOffset = 0, double YOffset = 0)
+{
+   agg::pixfmt_psl pixels(*SrcBitmap);
+   drawBitmap(Scanline, SampleMethod, RenderBase, Raster, pixels, SpreadMethod, Opacity, Transform, XOffset, YOffset);
+}
+
 //********************************************************************************************************************
 // Use for drawing stroked paths with texture brushes.  Source images should have width of ^2 if maximum efficiency
 // is desired.
@@ -572,10 +579,17 @@ void SceneRenderer::draw(objBitmap *Bitmap, objVectorViewport *Viewport)
       mView = nullptr; // Current view
       mRenderBase.clip_box(Bitmap->Clip.Left, Bitmap->Clip.Top, Bitmap->Clip.Right-1, Bitmap->Clip.Bottom-1);
 
-      Scene->InputBoundaries.clear();
+      Scene->InputLookup.begin_frame(Bitmap->Width, Bitmap->Height);
+
+      gen_scene_paths((extVector *)Viewport);
 
       VectorState state;
       draw_vectors((extVector *)Viewport, state);
+
+      Scene->InputLookup.end_frame();
+
+      Scene->FilterBank.end_frame();
+      Scene->FilterCache.end_frame();
    }
 }
 
@@ -694,11 +708,16 @@ void SceneRenderer::draw_vectors(extVector *CurrentVector, VectorState &ParentSt
             log.traceBranch("Rendering filter for %s.", get_name(shape));
          #endif
 
+         // Bitmaps drawn from the filter bank are only required until the output has been composited.
+
+         auto &bank = ((extVectorScene *)mView->Scene)->FilterBank;
+         auto const bank_mark = bank.Index;
          objBitmap *bmp;
          if (render_filter(filter, mView, shape, mBitmap, &bmp) IS ERR::Okay) {
             bmp->Opacity = (filter->Opacity < 1.0) ? (255.0 * filter->Opacity) : 255;
             gfx::CopyArea(bmp, mBitmap, BAF::BLEND|BAF::COPY, 0, 0, bmp->Width, bmp->Height, 0, 0);
          }
+         bank.release(bank_mark);
          continue;
       }
 
@@ -796,7 +815,7 @@ void SceneRenderer::draw_vectors(extVector *CurrentVector, VectorState &ParentSt
 
                if ((shape->InputSubscriptions) or ((shape->Cursor != PTC::NIL) and (shape->Cursor != PTC::DEFAULT))) {
                   clip.shrinking(view);
-                  Scene->InputBoundaries.emplace_back(shape->UID, view->Cursor, clip, view->vpBounds.left, view->vpBounds.top);
+                  Scene->InputLookup.add(InputBoundary(shape->UID, view->Cursor, clip, view->vpBounds.left, view->vpBounds.top));
                }
 
                if ((Scene->Flags & VPF::OUTLINE_VIEWPORTS) != VPF::NIL) { // Debug option: Draw the viewport's path with a green outline
@@ -1002,8 +1021,11 @@ void SceneRenderer::draw_vectors(extVector *CurrentVector, VectorState &ParentSt
             }
 
             if (shape->FillRaster) {
-               render_fill(state, *shape, *shape->FillRaster, shape->Fill[0]);
-               if (shape->FGFill) render_fill(state, *shape, *shape->FillRaster, shape->Fill[1]);
+               if ((shape->classID() IS CLASSID::VECTORTEXT) and (render_text_fill(state, *shape)));
+               else {
+                  render_fill(state, *shape, *shape->FillRaster, shape->Fill[0]);
+                  if (shape->FGFill) render_fill(state, *shape, *shape->FillRaster, shape->Fill[1]);
+               }
             }
 
             if (shape->StrokeRaster) {
@@ -1041,7 +1063,7 @@ void SceneRenderer::draw_vectors(extVector *CurrentVector, VectorState &ParentSt
                TClipRectangle<double> rb_bounds = { double(mRenderBase.xmin()), double(mRenderBase.ymin()), double(mRenderBase.xmax()), double(mRenderBase.ymax()) };
                b.shrinking(rb_bounds);
 
-               Scene->InputBoundaries.emplace_back(shape->UID, shape->Cursor, b, abs_x, abs_y, shape->InputSubscriptions ? false : true);
+               Scene->InputLookup.add(InputBoundary(shape->UID, shape->Cursor, b, abs_x, abs_y, shape->InputSubscriptions ? false : true));
             }
          } // if: shape->GeneratePath
 
@@ -1167,6 +1189,7 @@ void agg::pixfmt_psl::rawBitmap(uint8_t *Data, int Width, int Height, int Stride
    mHeight = Height;
    mStride = Stride;
    mBytesPerPixel = BitsPerPixel/8;
+   fSpanBlend     = nullptr;
 
    if (BitsPerPixel IS 32) {
       fBlendHLine      = &blendHLine32;
@@ -1229,6 +1252,15 @@ void agg::pixfmt_psl::rawBitmap(uint8_t *Data, int Width, int Height, int Stride
             fCopyPix  = &srgbCopy32ARGB;
             fCoverPix = &srgbCover32ARGB;
          }
+
+         // Linear and gamma blending are table driven, so only sRGB blending uses the SIMD span kernels.
+
+         fSpanBlend = simd_blend::src_over({ 0, 1, 2, 3 }, { mPixelOrder.Red, mPixelOrder.Green, mPixelOrder.Blue, mPixelOrder.Alpha });
+         if (fSpanBlend) {
+            fBlendHLine      = &simdBlendHLine32;
+            fBlendSolidHSpan = &simdBlendSolidHSpan32;
+            fBlendColorHSpan = &simdBlendColorHSpan32;
+         }
       }
       else { // BLM::GAMMA
          if (ColourFormat.AlphaPos IS 24) {
@@ -1,4 +1,44 @@
 
+//********************************************************************************************************************
+// Fills a VectorText object through its glyph masks, which is considerably faster than rasterising the outlines of
+// every glyph on each frame.  The composited masks take the place of the clip mask for the duration of the fill, so
+// all painter types are supported.  Returns false if the text needs to be drawn from its outline.
+
+bool SceneRenderer::render_text_fill(VectorState &State, extVector &Vector)
+{
+   if ((Vector.PathQuality IS RQ::CRISP) or (Vector.PathQuality IS RQ::FAST)) return false;
+   if (Vector.FillRule != VFR::NON_ZERO) return false;
+
+   const TClipRectangle<int> clip = { std::max(mRenderBase.xmin(), 0), std::max(mRenderBase.ymin(), 0),
+      mRenderBase.xmax() + 1, mRenderBase.ymax() + 1 };
+   if (!clip.valid()) return true;
+
+   auto &coverage = Scene->GlyphCoverage;
+   if (!build_text_coverage(&Vector, clip, coverage)) return false;
+
+   const auto &area = coverage.Area;
+   if (!area.valid()) return true;
+
+   if (!State.mClipStack->empty()) { // Apply the active clip mask to the coverage values
+      agg::alpha_mask_gray8 alpha_mask(State.mClipStack->top().m_renderer);
+      for (int y=area.top; y < area.bottom; y++) {
+         alpha_mask.combine_hspan(area.left, y, coverage.Data.data() + size_t(y) * coverage.Width + area.left, area.width());
+      }
+   }
+
+   agg::rasterizer_scanline_aa<> raster;
+   basic_path(raster, area.left, area.top, area.right, area.bottom);
+
+   State.mClipStack->emplace(State, nullptr, &Vector);
+   State.mClipStack->top().m_renderer.attach(coverage.Data.data(), coverage.Width, coverage.Height, coverage.Width);
+
+   render_fill(State, Vector, raster, Vector.Fill[0]);
+   if (Vector.FGFill) render_fill(State, Vector, raster, Vector.Fill[1]);
+
+   State.mClipStack->pop();
+   return true;
+}
+
 //********************************************************************************************************************
 
 void SceneRenderer::render_fill(VectorState &State, extVector &Vector, agg::rasterizer_scanline_aa<> &Raster, extPainter &Painter)
@@ -59,6 +99,185 @@ void SceneRenderer::render_fill(VectorState &State, extVector &Vector, agg::rast
    }
 }
 
+//********************************************************************************************************************
+// Returns the requested level of the chain, generating any missing levels from the one above it.  A level is only
+// returned if it is smaller than the source, and the smallest available level is returned if Level exceeds the depth
+// of the chain.  Only 32-bit sources are supported; the levels share the source's colour format.
+//
+// The chain is keyed on the identity and layout of the source, so that this check is O(1) when drawing.  Changes to
+// the content of the source are signalled by the owning painter calling reset(), e.g. when the Bitmap of a VectorImage
+// is set or a VectorPattern redraws its tile.
+
+MipChain::level * MipChain::get(objBitmap &Source, int Level)
+{
+   if ((Source.BitsPerPixel != 32) or (Level < 1)) return nullptr;
+
+   uint64_t hash = uint64_t(uintptr_t(Source.Data)) ^ (uint64_t(uintptr_t(&Source)) * 0x9e3779b97f4a7c15ull);
+   hash ^= (uint64_t(Source.Width) | (uint64_t(Source.Height)<<32)) * 0xbf58476d1ce4e5b9ull;
+   hash ^= uint64_t(Source.LineWidth) * 0x94d049bb133111ebull;
+
+   if (hash != key) {
+      levels.clear();
+      key = hash;
+   }
+
+   const uint8_t a = Source.ColourFormat->AlphaPos>>3;
+   Level = std::min(Level, MAX_LEVELS);
+   while (int(levels.size()) < Level) {
+      const uint8_t *src;
+      int src_width, src_height, src_stride;
+      if (levels.empty()) {
+         src        = Source.Data;
+         src_width  = Source.Width;
+         src_height = Source.Height;
+         src_stride = Source.LineWidth;
+      }
+      else {
+         auto &prev = levels.back();
+         src        = (const uint8_t *)prev.data.data();
+         src_width  = prev.width;
+         src_height = prev.height;
+         src_stride = prev.width * 4;
+      }
+
+      if ((src_width <= 1) and (src_height <= 1)) break;
+
+      level next;
+      next.width  = (src_width + 1)>>1;
+      next.height = (src_height + 1)>>1;
+      next.data.resize(size_t(next.width) * next.height);
+
+      // 2x2 box reduction.  Odd edges reuse the last row or column.  Colour is weighted by alpha so that transparent
+      // pixels do not darken the edges of opaque content.
+
+      auto dest = (uint8_t *)next.data.data();
+      for (int y=0; y < next.height; y++) {
+         auto row0 = src + (y * 2) * src_stride;
+         auto row1 = src + std::min(y * 2 + 1, src_height - 1) * src_stride;
+         for (int x=0; x < next.width; x++, dest += 4) {
+            const int x0 = x * 8, x1 = std::min(x * 2 + 1, src_width - 1) * 4;
+            const uint8_t *p[4] = { row0 + x0, row0 + x1, row1 + x0, row1 + x1 };
+
+            if ((p[0][a] IS p[1][a]) and (p[0][a] IS p[2][a]) and (p[0][a] IS p[3][a])) {
+               for (int c=0; c < 4; c++) dest[c] = (p[0][c] + p[1][c] + p[2][c] + p[3][c] + 2)>>2;
+            }
+            else {
+               const int alpha = p[0][a] + p[1][a] + p[2][a] + p[3][a];
+               for (int c=0; c < 4; c++) {
+                  if (c IS a) dest[c] = (alpha + 2)>>2;
+                  else if (alpha) dest[c] = ((p[0][c] * p[0][a]) + (p[1][c] * p[1][a]) + (p[2][c] * p[2][a]) + (p[3][c] * p[3][a]) + (alpha>>1)) / alpha;
+                  else dest[c] = 0;
+               }
+            }
+         }
+      }
+
+      levels.push_back(std::move(next));
+   }
+
+   if (levels.empty()) return nullptr;
+   return &levels[std::min(Level, int(levels.size())) - 1];
+}
+
+//********************************************************************************************************************
+// Interpolates between Level and the level below it by Fraction, for trilinear drawing.  The result has the dimensions
+// of Level, with each pixel of the smaller level covering a 2x2 block.  Colour is weighted by alpha in the same manner
+// as the reduction, so that the result can be drawn once at the caller's opacity.  Returns nullptr if there is nothing
+// to interpolate, in which case Level should be drawn as-is.
+
+MipChain::level * MipChain::blend(objBitmap &Source, int Level, double Fraction)
+{
+   const int weight = int(std::lround(Fraction * 256.0));
+   if (weight <= 0) return nullptr;
+
+   auto lower = get(Source, Level + 1); // Generate the smaller level first, as it may reallocate the chain
+   auto upper = get(Source, Level);
+   if ((!upper) or (!lower) or (upper IS lower)) return nullptr;
+
+   blended.width  = upper->width;
+   blended.height = upper->height;
+   blended.data.resize(size_t(upper->width) * upper->height);
+
+   const uint8_t a = Source.ColourFormat->AlphaPos>>3;
+   const int inverse = 256 - weight;
+   auto dest = (uint8_t *)blended.data.data();
+   for (int y=0; y < upper->height; y++) {
+      auto p = (const uint8_t *)(upper->data.data() + size_t(y) * upper->width);
+      auto q_row = (const uint8_t *)(lower->data.data() + size_t(std::min(y>>1, lower->height - 1)) * lower->width);
+      for (int x=0; x < upper->width; x++, p += 4, dest += 4) {
+         auto q = q_row + std::min(x>>1, lower->width - 1) * 4;
+         if (p[a] IS q[a]) {
+            for (int c=0; c < 4; c++) dest[c] = ((p[c] * inverse) + (q[c] * weight) + 128)>>8;
+         }
+         else {
+            const int wp = p[a] * inverse, wq = q[a] * weight, alpha = wp + wq;
+            for (int c=0; c < 4; c++) {
+               if (c IS a) dest[c] = (alpha + 128)>>8;
+               else if (alpha) dest[c] = ((p[c] * wp) + (q[c] * wq) + (alpha>>1)) / alpha;
+               else dest[c] = 0;
+            }
+         }
+      }
+   }
+   return &blended;
+}
+
+//********************************************************************************************************************
+// Determines the mip level for drawing a source through Transform (target to source).  The level is derived from the
+// area scale of the transform, so the remaining reduction after a level is chosen is always less than 2:1 and can be
+// handled by the sample method's kernel.  Returns zero if the source is not reduced by half or more.
+
+static double mip_lod(const agg::trans_affine &Transform)
+{
+   const double reduction = std::sqrt(std::abs(Transform.determinant()));
+   return (reduction >= 2.0) ? std::log2(reduction) : 0;
+}
+
+//********************************************************************************************************************
+// Draws a source bitmap from one of its mip levels.  The Transform maps the target to the source, so it is extended
+// to map the source onto the reduced level.
+
+template <class T> static void draw_mip_level(T &Scanline, VSM SampleMethod, agg::renderer_base<agg::pixfmt_psl> &RenderBase,
+   agg::rasterizer_scanline_aa<> &Raster, objBitmap &Source, MipChain::level &Level, VSPREAD SpreadMethod, double Opacity,
+   const agg::trans_affine &Transform)
+{
+   agg::pixfmt_psl pixels((uint8_t *)Level.data.data(), Level.width, Level.height, Level.width * 4, 32, *Source.ColourFormat);
+   agg::trans_affine transform(Transform);
+   transform *= agg::trans_affine_scaling(double(Level.width) / Source.Width, double(Level.height) / Source.Height);
+   drawBitmap(Scanline, SampleMethod, RenderBase, Raster, pixels, SpreadMethod, Opacity, &transform);
+}
+
+//********************************************************************************************************************
+// Draws Source through Transform (target to source), using its mip chain if the source is reduced by half or more.  If
+// Trilinear is true, the level is interpolated with the next in proportion to the fractional level so that there is
+// no visible step between levels when the scale is animated.  Returns false if the source was not drawn.
+
+template <class T> static bool draw_mipmapped(T &Scanline, VSM SampleMethod, agg::renderer_base<agg::pixfmt_psl> &RenderBase,
+   agg::rasterizer_scanline_aa<> &Raster, objBitmap &Source, MipChain *Mips, VSPREAD SpreadMethod, double Opacity,
+   const agg::trans_affine &Transform, bool Trilinear)
+{
+   if (!Mips) return false;
+
+   const double lod = mip_lod(Transform);
+   if (lod < 1.0) return false;
+
+   auto mip = Mips->get(Source, int(lod));
+   if (!mip) return false;
+
+   if (Trilinear) {
+      if (auto blended = Mips->blend(Source, int(lod), lod - std::floor(lod))) mip = blended;
+      else mip = Mips->get(Source, int(lod)); // blend() may have extended the chain
+   }
+
+   draw_mip_level(Scanline, SampleMethod, RenderBase, Raster, Source, *mip, SpreadMethod, Opacity, Transform);
+   return true;
+}
+
+inline bool use_trilinear(const SceneDef &Def)
+{
+   return (Def.HostScene) and ((Def.HostScene->Flags & VPF::TRILINEAR) != VPF::NIL);
+}
+
 //********************************************************************************************************************
 // Image extension
 // Path: The original vector path without transforms.
@@ -91,20 +310,32 @@ static void fill_image(VectorState &State, const TClipRectangle<double> &Bounds,
    const double final_x_scale = t_scale * x_scale;
    const double final_y_scale = t_scale * y_scale;
 
+   // Sources that are reduced by half or more are drawn from the mip chain, which leaves no more than a 2:1 reduction
+   // for the sampling kernel.  Bicubic is sufficient for that and avoids the wide kernels that sinc would use.
+
+   const bool mipmap = (Image.Bitmap->BitsPerPixel IS 32) and (mip_lod(transform) >= 1.0);
+
    if (SampleMethod IS VSM::AUTO) {
-      if ((final_x_scale <= 0.5) or (final_y_scale <= 0.5)) SampleMethod = VSM::BICUBIC;
+      if (mipmap) SampleMethod = VSM::BICUBIC;
+      else if ((final_x_scale <= 0.5) or (final_y_scale <= 0.5)) SampleMethod = VSM::BICUBIC;
       else if ((final_x_scale <= 1.0) or (final_y_scale <= 1.0)) SampleMethod = VSM::SINC;
       else SampleMethod = VSM::SPLINE16; // Spline works well for enlarging monotone vectors and avoids sharpening artifacts.
    }
 
+   auto draw = [&](auto &Scanline) {
+      if ((mipmap) and (draw_mipmapped(Scanline, SampleMethod, RenderBase, Raster, *Image.Bitmap, get_mip_chain(Image),
+            Image.SpreadMethod, Alpha, transform, use_trilinear(Image)))) return;
+      drawBitmap(Scanline, SampleMethod, RenderBase, Raster, Image.Bitmap, Image.SpreadMethod, Alpha, &transform);
+   };
+
    if (!State.mClipStack->empty()) {
       agg::alpha_mask_gray8 alpha_mask(State.mClipStack->top().m_renderer);
       agg::scanline_u8_am<agg::alpha_mask_gray8> masked_scanline(alpha_mask);
-      drawBitmap(masked_scanline, SampleMethod, RenderBase, Raster, Image.Bitmap, Image.SpreadMethod, Alpha, &transform);
+      draw(masked_scanline);
    }
    else {
       agg::scanline_u8 scanline;
-      drawBitmap(scanline, SampleMethod, RenderBase, Raster, Image.Bitmap, Image.SpreadMethod, Alpha, &transform);
+      draw(scanline);
    }
 }
 
@@ -427,16 +658,19 @@ static void fill_gradient(VectorState &State, const TClipRectangle<double> &Boun
       render_gradient(gradient_func, 0, radial_col_span);
    }
    else if (Gradient.Type IS VGT::CONTOUR) {
-      // TODO: The creation of the contour gradient is expensive, but it can be cached as long as the
-      // path hasn't been modified.
+      // The distance transform of the path is expensive to compute, so it is cached by the gradient.
+
+      auto cache = get_gradient_cache(Gradient);
+      if (!cache) return;
+      auto contour = cache->get_contour(*Path);
+      if (!contour) return;
+      auto &gradient_func = *contour;
 
       auto x2 = std::clamp(Gradient.X2, 0.01, 10.0);
       auto x1 = std::clamp(Gradient.X1, 0.0, x2);
 
-      agg::gradient_contour gradient_func;
       gradient_func.d1(x1 * 256.0);  // d1 is added to the DT base values
       gradient_func.d2(x2);  // d2 is a multiplier of the base DT value
-      gradient_func.contour_create(*Path);
 
       transform.translate(Bounds.left, Bounds.top);
       apply_transforms(Gradient, transform);
@@ -463,6 +697,40 @@ static void fill_gradient(VectorState &State, const TClipRectangle<double> &Boun
    }
 }
 
+//********************************************************************************************************************
+// Return the contour gradient for a path, computing its distance transform if the path is not in the cache.  Paths
+// are identified by their vertices, so a vector that is only transformed will continue to hit the cache.
+
+agg::gradient_contour * GradientCache::get_contour(agg::path_storage &Path)
+{
+   uint64_t hash = Path.total_vertices();
+   for (unsigned i=0; i < Path.total_vertices(); i++) {
+      struct { double x, y; uint64_t cmd; } v;
+      v.cmd = Path.vertex(i, &v.x, &v.y);
+      hash = ankerl::unordered_dense::detail::wyhash::hash(&v, sizeof(v)) ^ (hash * 0x9e3779b97f4a7c15ull);
+   }
+
+   for (auto it = contours.begin(); it != contours.end(); it++) {
+      if (it->first IS hash) {
+         std::rotate(contours.begin(), it, it + 1);
+         stats[CONTOUR_HITS]++;
+         return contours.front().second.get();
+      }
+   }
+
+   stats[CONTOUR_MISSES]++;
+   if (contours.size() < MAX_CONTOURS) contours.emplace_back(hash, std::make_unique<agg::gradient_contour>());
+   else contours.back().first = hash;
+   std::rotate(contours.begin(), contours.end() - 1, contours.end());
+
+   auto &contour = *contours.front().second;
+   if (!contour.contour_create(Path)) contour = agg::gradient_contour(); // Path is empty; nothing will be drawn
+   return &contour;
+}
+
+GradientCache::GradientCache() { }
+GradientCache::~GradientCache() { }
+
 //********************************************************************************************************************
 // Fixed-size patterns can be rendered internally as a separate bitmap for tiling.  That bitmap is copied to the
 // target bitmap with the necessary transforms applied.  USERSPACE patterns are suitable for this method.  If the
@@ -590,13 +858,21 @@ static void fill_pattern(VectorState &State, const TClipRectangle<double> &Bound
       SampleMethod = VSM::BILINEAR;
    }
 
+   // Tiles that are reduced by half or more are drawn from the mip chain to prevent the bilinear filter from aliasing.
+
+   auto draw = [&](auto &Scanline) {
+      if ((mip_lod(transform) >= 1.0) and (draw_mipmapped(Scanline, SampleMethod, RenderBase, Raster, *Pattern.Bitmap,
+            get_mip_chain(Pattern), Pattern.SpreadMethod, Pattern.Opacity, transform, use_trilinear(Pattern)))) return;
+      drawBitmap(Scanline, SampleMethod, RenderBase, Raster, Pattern.Bitmap, Pattern.SpreadMethod, Pattern.Opacity, &transform);
+   };
+
    if (!State.mClipStack->empty()) {
       agg::alpha_mask_gray8 alpha_mask(State.mClipStack->top().m_renderer);
       agg::scanline_u8_am<agg::alpha_mask_gray8> masked_scanline(alpha_mask);
-      drawBitmap(masked_scanline, SampleMethod, RenderBase, Raster, Pattern.Bitmap, Pattern.SpreadMethod, Pattern.Opacity, &transform);
+      draw(masked_scanline);
    }
    else {
       agg::scanline_u8 scanline;
-      drawBitmap(scanline, SampleMethod, RenderBase, Raster, Pattern.Bitmap, Pattern.SpreadMethod, Pattern.Opacity, &transform);
+      draw(scanline);
    }
 }
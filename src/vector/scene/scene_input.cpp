@@ -1,5 +1,137 @@
 // Input event handling for VectorScene
 
+#include "input_history.h"
+
+//********************************************************************************************************************
+// Called by the renderer before the input boundaries of a frame are recorded.  The grid is only reset if the size of
+// the target bitmap has changed; otherwise the cells of the previous frame are retained and updated by add().
+
+void InputGrid::begin_frame(int pWidth, int pHeight)
+{
+   Generation++;
+   Next = 0;
+
+   if ((pWidth IS Width) and (pHeight IS Height) and (Columns)) return;
+
+   Width      = pWidth;
+   Height     = pHeight;
+   Columns    = std::clamp(Width / MIN_CELL, 1, MAX_CELLS);
+   Rows       = std::clamp(Height / MIN_CELL, 1, MAX_CELLS);
+   CellWidth  = double(std::max(Width, 1)) / Columns;
+   CellHeight = double(std::max(Height, 1)) / Rows;
+
+   for (auto &cell : Cells) cell.clear(); // Cell capacity is retained
+   Cells.resize(size_t(Columns) * Rows);
+   Large.clear();
+   Boundaries.clear();
+}
+
+//********************************************************************************************************************
+// Record the next boundary in drawing order.  If the boundary previously recorded at this position has the same
+// bounds, its cells are already correct and only the record is updated.
+
+void InputGrid::add(const InputBoundary &Boundary)
+{
+   const auto index = Next++;
+
+   if (index < Boundaries.size()) {
+      auto &previous = Boundaries[index];
+      if ((previous.bounds.left != Boundary.bounds.left) or (previous.bounds.top != Boundary.bounds.top) or
+          (previous.bounds.right != Boundary.bounds.right) or (previous.bounds.bottom != Boundary.bounds.bottom)) {
+         unlink(index, previous.bounds);
+         link(index, Boundary.bounds);
+      }
+      previous = Boundary;
+   }
+   else {
+      Boundaries.push_back(Boundary);
+      link(index, Boundary.bounds);
+   }
+}
+
+//********************************************************************************************************************
+// Called once the frame is drawn.  Boundaries that were not recorded again are removed.
+
+void InputGrid::end_frame()
+{
+   for (auto i = Next; i < Boundaries.size(); i++) unlink(i, Boundaries[i].bounds);
+   Boundaries.erase(Boundaries.begin() + Next, Boundaries.end());
+}
+
+//********************************************************************************************************************
+// Compute the range of cells covered by a boundary.  Boundaries that extend beyond the bitmap are clamped to the edge
+// cells, which is also where queries outside of the bitmap are directed.
+
+bool InputGrid::span(const TClipRectangle<double> &Bounds, int &X1, int &Y1, int &X2, int &Y2) const
+{
+   if ((!Columns) or (!Bounds.valid())) return false;
+   X1 = std::clamp(int(Bounds.left / CellWidth), 0, Columns - 1);
+   Y1 = std::clamp(int(Bounds.top / CellHeight), 0, Rows - 1);
+   X2 = std::clamp(int(Bounds.right / CellWidth), 0, Columns - 1);
+   Y2 = std::clamp(int(Bounds.bottom / CellHeight), 0, Rows - 1);
+   return true;
+}
+
+//********************************************************************************************************************
+
+void InputGrid::link(uint32_t Index, const TClipRectangle<double> &Bounds)
+{
+   auto insert = [Index](std::vector<uint32_t> &List) {
+      List.insert(std::lower_bound(List.begin(), List.end(), Index), Index);
+   };
+
+   int x1, y1, x2, y2;
+   if (!span(Bounds, x1, y1, x2, y2)) return;
+
+   if ((x2 - x1 + 1) * (y2 - y1 + 1) > LARGE_CELLS) insert(Large);
+   else {
+      for (int y=y1; y <= y2; y++) {
+         for (int x=x1; x <= x2; x++) insert(Cells[size_t(y) * Columns + x]);
+      }
+   }
+}
+
+//********************************************************************************************************************
+
+void InputGrid::unlink(uint32_t Index, const TClipRectangle<double> &Bounds)
+{
+   auto remove = [Index](std::vector<uint32_t> &List) {
+      auto it = std::lower_bound(List.begin(), List.end(), Index);
+      if ((it != List.end()) and (*it IS Index)) List.erase(it);
+   };
+
+   int x1, y1, x2, y2;
+   if (!span(Bounds, x1, y1, x2, y2)) return;
+
+   if ((x2 - x1 + 1) * (y2 - y1 + 1) > LARGE_CELLS) remove(Large);
+   else {
+      for (int y=y1; y <= y2; y++) {
+         for (int x=x1; x <= x2; x++) remove(Cells[size_t(y) * Columns + x]);
+      }
+   }
+}
+
+//********************************************************************************************************************
+// Return the boundaries that contain (X,Y), from the foreground to the background.
+
+InputGrid::Hits InputGrid::query(double X, double Y) const
+{
+   if (!Columns) return Hits(nullptr, nullptr, X, Y, 0);
+
+   const int cx = std::clamp(int(X / CellWidth), 0, Columns - 1);
+   const int cy = std::clamp(int(Y / CellHeight), 0, Rows - 1);
+   return Hits(this, &Cells[size_t(cy) * Columns + cx], X, Y, 0);
+}
+
+//********************************************************************************************************************
+// Return all boundaries registered by a vector, irrespective of position.  Used when a button lock is active.  The
+// grid is not required for this, so the boundaries are scanned directly.
+
+InputGrid::Hits InputGrid::query(OBJECTID Vector) const
+{
+   return Hits(this, nullptr, 0, 0, Vector);
+}
+
 //********************************************************************************************************************
 // Build a list of all child viewports that have a bounding box intersecting with (X,Y).  Transforms
 // are taken into account through use of BX1,BY1,BX2,BY2.  The list is sorted starting from the background to the
@@ -57,13 +189,14 @@ extVectorViewport * get_viewport_at_xy(extVectorScene *Scene, double X, double Y
 }
 
 //********************************************************************************************************************
-// Send input event(s) to client subscribers
+// Send input event(s) to client subscribers.  If a History of movement is provided (terminating with Event), it is sent
+// in place of Event to subscribers that include JTYPE::HISTORY in their mask.
 
-static void send_input_events(extVector *Vector, InputEvent *Event, bool Propagate = false)
+static void send_input_events(extVector *Vector, InputEvent *Event, bool Propagate = false, InputEvent *History = nullptr)
 {
    if (!Vector->InputSubscriptions) {
       if ((Propagate) and (Vector->Parent) and (Vector->Parent->Class->BaseClassID IS CLASSID::VECTOR)) {
-         send_input_events((extVector *)Vector->Parent, Event, true);
+         send_input_events((extVector *)Vector->Parent, Event, true, History);
       }
       return;
    }
@@ -80,15 +213,17 @@ static void send_input_events(extVector *Vector, InputEvent *Event, bool Propaga
          ERR result = ERR::Terminate;
          consumed = true;
 
+         auto events = ((History) and ((sub.Mask & JTYPE::HISTORY) != JTYPE::NIL)) ? History : Event;
+
          if (sub.Callback.isC()) {
             pf::SwitchContext ctx(sub.Callback.Context);
             auto callback = (ERR (*)(objVector *, InputEvent *, APTR))sub.Callback.Routine;
-            result = callback(Vector, Event, sub.Callback.Meta);
+            result = callback(Vector, events, sub.Callback.Meta);
          }
          else if (sub.Callback.isScript()) {
             sc::Call(sub.Callback, std::to_array<ScriptArg>({
                { "Vector", Vector, FDF_OBJECT },
-               { "InputEvent:Events", Event, FDF_STRUCT }
+               { "InputEvent:Events", events, FDF_STRUCT }
             }), result);
          }
 
@@ -102,7 +237,7 @@ static void send_input_events(extVector *Vector, InputEvent *Event, bool Propaga
 
    if ((!consumed) and (Event->Type IS JET::WHEEL)) {
       if ((Vector->Parent) and (Vector->Parent->Class->BaseClassID IS CLASSID::VECTOR)) {
-         send_input_events((extVector *)Vector->Parent, Event, true);
+         send_input_events((extVector *)Vector->Parent, Event, true, History);
       }
    }
 }
@@ -193,11 +328,8 @@ ERR scene_input_events(const InputEvent *Events, int Handle)
    // receives wheel events and button presses.
 
    for (auto input=Events; input; input=input->Next) {
-      if ((input->Flags & (JTYPE::ANCHORED|JTYPE::MOVEMENT)) != JTYPE::NIL) {
-         while ((input->Next) and ((input->Next->Flags & JTYPE::MOVEMENT) != JTYPE::NIL)) { // Consolidate movement
-            input = input->Next;
-         }
-      }
+      auto run = input; // First event of a consolidated movement series
+      input = input_history::consolidate(input);
 
       if ((input->OverID != Self->SurfaceID) and ((input->Flags & JTYPE::CROSSING) IS JTYPE::NIL)) {
          // Activity occurring on another surface may be reported to us in circumstances where our surface is modal.
@@ -251,13 +383,10 @@ ERR scene_input_events(const InputEvent *Events, int Handle)
 
                if (cursor IS PTC::NIL) cursor = PTC::DEFAULT;
                bool processed = false;
-               for (auto it = Self->InputBoundaries.rbegin(); it != Self->InputBoundaries.rend(); it++) {
-                  auto &bounds = *it;
+               for (const auto bounds : Self->InputLookup.query(input->X, input->Y)) {
 
                   if ((processed) and (bounds.cursor IS PTC::NIL)) continue;
 
-                  if (!bounds.bounds.hit_test(input->X, input->Y)) continue;
-
                   pf::ScopedObjectLock<extVector> lock(bounds.vector_id);
                   if (!lock.granted()) continue;
                   auto vector = lock.obj;
@@ -310,21 +439,19 @@ ERR scene_input_events(const InputEvent *Events, int Handle)
       else if ((input->Flags & (JTYPE::ANCHORED|JTYPE::MOVEMENT)) != JTYPE::NIL) {
          if (cursor IS PTC::NIL) cursor = PTC::DEFAULT;
          bool processed = false;
-         for (auto it = Self->InputBoundaries.rbegin(); it != Self->InputBoundaries.rend(); it++) {
-            auto &bounds = *it;
 
-            if ((processed) and (bounds.cursor IS PTC::NIL)) continue;
+         // When the user holds a mouse button over a vector, a 'button lock' will be held.  This causes all events to
+         // be captured by that vector until the button is released.  Otherwise, only the boundaries that contain
+         // the pointer are considered.
 
-            // When the user holds a mouse button over a vector, a 'button lock' will be held.  This causes all events to
-            // be captured by that vector until the button is released.
+         const bool in_bounds = !Self->ButtonLock;
+         const auto candidates = Self->ButtonLock ?
+            Self->InputLookup.query(Self->ButtonLock) :
+            Self->InputLookup.query(input->X, input->Y);
 
-            bool in_bounds = false;
-            if ((Self->ButtonLock) and (Self->ButtonLock IS bounds.vector_id));
-            else if ((Self->ButtonLock) and (Self->ButtonLock != bounds.vector_id)) continue;
-            else { // No button lock, perform a simple bounds check
-               in_bounds = bounds.bounds.hit_test(input->X, input->Y);
-               if (!in_bounds) continue;
-            }
+         for (const auto bounds : candidates) {
+
+            if ((processed) and (bounds.cursor IS PTC::NIL)) continue;
 
             pf::ScopedObjectLock<extVector> lock(bounds.vector_id);
             if (!lock.granted()) continue;
@@ -363,7 +490,16 @@ ERR scene_input_events(const InputEvent *Events, int Handle)
                   event.AbsY   = input->Y;
                   event.X      = tx;
                   event.Y      = ty;
-                  send_input_events(vector, &event);
+
+                  // Vectors that subscribe with JTYPE::HISTORY receive every position in the series, localised in
+                  // the same way.
+
+                  std::vector<InputEvent> history;
+                  if ((run != input) and ((vector->InputMask & JTYPE::HISTORY) != JTYPE::NIL)) {
+                     input_history::localise(run, input, event, Self->SurfaceID, vector->UID, invert, history);
+                  }
+
+                  send_input_events(vector, &event, false, history.empty() ? nullptr : history.data());
 
                   if ((Self->ActiveVector) and (Self->ActiveVector != vector->UID)) {
                      pf::ScopedObjectLock<extVector> lock(Self->ActiveVector);
@@ -0,0 +1,129 @@
+/*********************************************************************************************************************
+
+Benchmark for the management of filter bitmaps, as exercised by the "Shadows n=400" case of benchmark_filters.tiri:
+400 rectangles on a page, each with a blur and offset drop shadow filter.
+
+The buffer allocation and clearing that each scheme performs per frame is replayed without rasterisation or the
+effect kernels, so that the two can be compared where the framework is unavailable.
+
+  before: Each filter retains a page-sized SourceGraphic that is cleared over the page extent on every frame, plus two
+          region-sized bitmaps in its own bank.  None of these are released while the filter exists.
+  after:  The scene owns a single filter_bank.  Each filter borrows three region-sized bitmaps for the duration of its
+          pipeline and returns them once composited, so the bank depth tracks the deepest pipeline.
+
+Results recorded on the development host (x86-64, GCC 12, -O2, 20 frames):
+
+  Resolution   Scheme   Time/frame     KB held
+  1280x720     before   206.78 ms   1445125.0
+  1280x720     after      0.08 ms        19.2 (3 x 40x41 px)
+  1920x1080    before   538.20 ms   3251437.5
+  1920x1080    after      0.17 ms        42.9 (3 x 60x61 px)
+
+Usage: bench_filter_bank [frames]
+
+*********************************************************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+static constexpr int FILTERS = 400;
+static constexpr int PIPELINE_DEPTH = 3; // SourceGraphic, blur output, offset output
+
+struct Scenario {
+   int width, height;   // Page size
+   int region_width, region_height; // Filter region, including the 10% kernel margin
+};
+
+struct Result {
+   double ms_per_frame;
+   size_t bytes_held;
+};
+
+//********************************************************************************************************************
+// The rectangles are laid out in a grid that fills the page, each occupying 60% of its cell.  The filter region adds
+// the default 10% margin on each side.
+
+static Scenario make_scenario(int Width, int Height)
+{
+   const int cols = int(std::ceil(std::sqrt(FILTERS * double(Width) / Height)));
+   const int rows = int(std::ceil(double(FILTERS) / cols));
+   return { Width, Height, int(Width / cols * 0.6 * 1.4) + 1, int(Height / rows * 0.6 * 1.4) + 1 };
+}
+
+//********************************************************************************************************************
+
+static Result run_before(const Scenario &S, int Frames)
+{
+   const size_t page   = size_t(S.width) * S.height * 4;
+   const size_t region = size_t(S.region_width) * S.region_height * 4;
+
+   std::vector<std::vector<std::vector<uint8_t>>> filters(FILTERS);
+
+   auto start = std::chrono::steady_clock::now();
+   for (int f=0; f < Frames; f++) {
+      for (auto &bank : filters) {
+         if (bank.empty()) {
+            bank.resize(PIPELINE_DEPTH);
+            bank[0].resize(page);
+            for (int i=1; i < PIPELINE_DEPTH; i++) bank[i].resize(region);
+         }
+         memset(bank[0].data(), 0, page); // SourceGraphic is cleared over the page extent
+         for (int i=1; i < PIPELINE_DEPTH; i++) memset(bank[i].data(), 0, region);
+      }
+   }
+   auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+   size_t held = 0;
+   for (auto &bank : filters) for (auto &buffer : bank) held += buffer.size();
+   return { elapsed / Frames, held };
+}
+
+//********************************************************************************************************************
+
+static Result run_after(const Scenario &S, int Frames)
+{
+   const size_t region = size_t(S.region_width) * S.region_height * 4;
+
+   std::vector<std::vector<uint8_t>> bank;
+
+   auto start = std::chrono::steady_clock::now();
+   for (int f=0; f < Frames; f++) {
+      for (int filter=0; filter < FILTERS; filter++) {
+         if (bank.size() < PIPELINE_DEPTH) bank.resize(PIPELINE_DEPTH); // Borrowed, then returned after compositing
+         for (auto &buffer : bank) {
+            if (buffer.size() < region) buffer.resize(region);
+            memset(buffer.data(), 0, region);
+         }
+      }
+   }
+   auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+   size_t held = 0;
+   for (auto &buffer : bank) held += buffer.size();
+   return { elapsed / Frames, held };
+}
+
+//********************************************************************************************************************
+
+int main(int argc, char **argv)
+{
+   const int frames = (argc > 1) ? std::max(1, atoi(argv[1])) : 20;
+
+   printf("Resolution   Scheme   Time/frame     KB held\n");
+   for (auto [w, h] : { std::pair(1280, 720), std::pair(1920, 1080) }) {
+      auto s = make_scenario(w, h);
+      auto before = run_before(s, frames);
+      auto after  = run_after(s, frames);
+      printf("%4dx%-4d    before %8.2f ms  %10.1f\n", w, h, before.ms_per_frame, before.bytes_held / 1024.0);
+      printf("%4dx%-4d    after  %8.2f ms  %10.1f (%d x %dx%d px)\n", w, h, after.ms_per_frame,
+         after.bytes_held / 1024.0, PIPELINE_DEPTH, s.region_width, s.region_height);
+   }
+   return 0;
+}
@@ -0,0 +1,136 @@
+/*********************************************************************************************************************
+
+Tests and microbenchmarks for the SIMD span blenders in simd_blend.h.  Every kernel that is supported by the host CPU
+is compared against the scalar kernel for exact equality on random pixel data, for each supported channel layout and
+each combination of span options.  The time taken by each kernel to blend a 1920 pixel span is then reported.
+
+Usage: test_blend [-bench]
+
+*********************************************************************************************************************/
+
+#include "../../link/simd_blend.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace simd_blend;
+
+static const offsets glLayouts[][2] = {
+   { { 0, 1, 2, 3 }, { 0, 1, 2, 3 } }, // RGBA to RGBA
+   { { 0, 1, 2, 3 }, { 2, 1, 0, 3 } }, // RGBA to BGRA
+   { { 0, 1, 2, 3 }, { 3, 1, 2, 0 } }, // RGBA to AGBR
+   { { 0, 1, 2, 3 }, { 1, 2, 3, 0 } }, // RGBA to ARGB
+   { { 1, 2, 3, 0 }, { 1, 2, 3, 0 } }  // ARGB to ARGB
+};
+
+static const char *glLayoutNames[] = { "RGBA>RGBA", "RGBA>BGRA", "RGBA>AGBR", "RGBA>ARGB", "ARGB>ARGB" };
+static const char *glISANames[] = { "scalar", "sse2", "avx2", "neon" };
+
+static std::mt19937 glRandom(0x5eed);
+
+//********************************************************************************************************************
+// Random data is biased towards the alpha values that have special handling.
+
+static void fill_random(std::vector<uint8_t> &Data)
+{
+   std::uniform_int_distribution<int> dist(0, 255);
+   for (auto &v : Data) {
+      const int r = dist(glRandom);
+      v = (r < 32) ? 0 : (r < 64) ? 255 : dist(glRandom);
+   }
+}
+
+//********************************************************************************************************************
+
+static int test_kernel(ISA Isa, int Layout)
+{
+   auto reference = src_over(glLayouts[Layout][0], glLayouts[Layout][1], ISA::SCALAR);
+   auto kernel = src_over(glLayouts[Layout][0], glLayouts[Layout][1], Isa);
+   if ((!reference) or (!kernel)) return 1;
+
+   int failures = 0;
+   for (int options=0; options < 32; options++) {
+      for (uint32_t count : { 1u, 3u, 4u, 7u, 8u, 15u, 16u, 33u, 257u }) {
+         std::vector<uint8_t> src(count * 4), dest(count * 4), covers(count);
+         fill_random(src);
+         fill_random(dest);
+         fill_random(covers);
+
+         span s = {
+            .dest = nullptr, .src = src.data(), .covers = (options & 1) ? covers.data() : nullptr, .count = count,
+            .step = uint8_t((options & 2) ? 0 : 4), .cover = uint8_t(glRandom()), .cover_plus_one = bool(options & 4),
+            .skip_clear = bool(options & 8), .copy_empty = bool(options & 16), .copy_first = bool(count & 1)
+         };
+
+         auto expected = dest;
+         s.dest = expected.data();
+         reference(s);
+
+         s.dest = dest.data();
+         kernel(s);
+
+         if (dest != expected) {
+            if (!failures) printf("✗ %s %s failed with options 0x%x and %u pixels.\n", glISANames[int(Isa)], glLayoutNames[Layout], options, count);
+            failures++;
+         }
+      }
+   }
+   return failures;
+}
+
+//********************************************************************************************************************
+
+static void benchmark_kernel(ISA Isa, int Layout)
+{
+   constexpr uint32_t WIDTH = 1920;
+   constexpr int ROWS = 20000;
+
+   auto kernel = src_over(glLayouts[Layout][0], glLayouts[Layout][1], Isa);
+   std::vector<uint8_t> src(WIDTH * 4), dest(WIDTH * 4), covers(WIDTH);
+   fill_random(src);
+   fill_random(dest);
+   fill_random(covers);
+
+   span s = {
+      .dest = dest.data(), .src = src.data(), .covers = covers.data(), .count = WIDTH, .step = 4, .cover = 255,
+      .cover_plus_one = true, .skip_clear = true, .copy_empty = true, .copy_first = false
+   };
+
+   auto start = std::chrono::steady_clock::now();
+   for (int i=0; i < ROWS; i++) kernel(s);
+   auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+   printf("  %-7s %s  %7.3f ns/pixel\n", glISANames[int(Isa)], glLayoutNames[Layout], elapsed / (double(WIDTH) * ROWS));
+}
+
+//********************************************************************************************************************
+
+int main(int argc, char **argv)
+{
+   const bool bench = (argc > 1) and (std::string_view(argv[1]) == "-bench");
+
+   int failures = 0, total = 0;
+   for (auto isa : { ISA::SSE2, ISA::AVX2, ISA::NEON }) {
+      if (!isa_supported(isa)) continue;
+      for (int layout=0; layout < int(std::size(glLayouts)); layout++) {
+         total++;
+         if (test_kernel(isa, layout)) failures++;
+      }
+   }
+
+   if (bench) {
+      printf("Blending %s spans with coverage:\n", glLayoutNames[1]);
+      for (auto isa : { ISA::SCALAR, ISA::SSE2, ISA::AVX2, ISA::NEON }) {
+         if (isa_supported(isa)) benchmark_kernel(isa, 1);
+      }
+   }
+
+   if (failures) {
+      printf("✗ %d of %d kernels did not match the scalar implementation.\n", failures, total);
+      return -1;
+   }
+
+   printf("✓ %d kernels match the scalar implementation (best: %s).\n", total, glISANames[int(best_isa())]);
+   return 0;
+}
@@ -0,0 +1,96 @@
+/*********************************************************************************************************************
+
+Tests the invalidation of the mask bitmaps that VectorClip retains between frames.  A client is drawn through a clip,
+then the clip's paths are modified in ways that do not affect their geometry.  Each modification must be reflected in
+the next frame, rather than the mask from the previous frame being reused.
+
+Usage: test_clip_cache
+
+*********************************************************************************************************************/
+
+#include <kotuku/startup.h>
+#include <kotuku/modules/vector.h>
+#include <kotuku/modules/display.h>
+
+JUMPTABLE_VECTOR
+static OBJECTPTR modVector;
+
+using namespace pf;
+
+CSTRING ProgName = "ClipCache";
+
+static int glFailures = 0;
+
+//********************************************************************************************************************
+// The client is red and the background is black, so the red channel indicates whether the mask covers a pixel.
+
+static bool is_masked(objVectorScene *Scene, objBitmap *Bitmap, int X, int Y)
+{
+   acDraw(Scene);
+   auto pixel = ((uint32_t *)(Bitmap->Data + (Y * Bitmap->LineWidth)))[X];
+   return Bitmap->unpackRed(pixel) < 128;
+}
+
+static void check(bool Result, CSTRING Test)
+{
+   if (Result) printf("✓ %s\n", Test);
+   else {
+      printf("✗ %s\n", Test);
+      glFailures++;
+   }
+}
+
+//********************************************************************************************************************
+
+int main(int argc, CSTRING *argv)
+{
+   if (auto msg = init_kotuku(argc, argv)) {
+      printf("%s\n", msg);
+      return -1;
+   }
+
+   if (objModule::load("vector", &modVector, &VectorBase) != ERR::Okay) return -1;
+
+   auto bitmap = objBitmap::create::global({ fl::Width(64), fl::Height(64), fl::BitsPerPixel(32) });
+   auto scene  = objVectorScene::create::global({ fl::PageWidth(64), fl::PageHeight(64), fl::Bitmap(bitmap) });
+   auto view   = objVectorViewport::create::global({ fl::Owner(scene->UID), fl::X(0), fl::Y(0), fl::Width(64), fl::Height(64) });
+   auto clip   = objVectorClip::create::global({ fl::Owner(scene->UID), fl::Units(VUNIT::USERSPACE), fl::Flags(VCLF::APPLY_FILLS) });
+   if ((!bitmap) or (!scene) or (!view) or (!clip)) return -1;
+
+   // The clip covers the left half of the client.  Fills are applied so that the fill opacity affects the mask.
+
+   auto clip_path = objVectorRectangle::create::global({ fl::Owner(clip->Viewport->UID),
+      fl::X(0), fl::Y(0), fl::Width(32), fl::Height(64), fl::Fill("rgb(255,255,255)") });
+
+   objVectorRectangle::create::global({ fl::Owner(view->UID),
+      fl::X(0), fl::Y(0), fl::Width(64), fl::Height(64), fl::Fill("rgb(0,0,0)") });
+
+   auto client = objVectorRectangle::create::global({ fl::Owner(view->UID),
+      fl::X(0), fl::Y(0), fl::Width(64), fl::Height(64), fl::Fill("rgb(255,0,0)") });
+   client->setMask(clip);
+
+   check(!is_masked(scene, bitmap, 16, 32), "Client is drawn within the clip path");
+   check(is_masked(scene, bitmap, 48, 32), "Client is masked outside of the clip path");
+   check(!is_masked(scene, bitmap, 16, 32), "Mask is stable across frames");
+
+   clip_path->setVisibility(VIS::HIDDEN);
+   check(is_masked(scene, bitmap, 16, 32), "Hiding the clip path masks the client");
+
+   clip_path->setVisibility(VIS::VISIBLE);
+   check(!is_masked(scene, bitmap, 16, 32), "Showing the clip path reveals the client");
+
+   clip_path->setFillOpacity(0);
+   check(is_masked(scene, bitmap, 16, 32), "Clearing the fill opacity of the clip path masks the client");
+
+   clip_path->setFillOpacity(1.0);
+   check(!is_masked(scene, bitmap, 16, 32), "Restoring the fill opacity of the clip path reveals the client");
+
+   FreeResource(scene);
+   FreeResource(bitmap);
+
+   if (glFailures) printf("%d tests failed.\n", glFailures);
+
+   FreeResource(modVector);
+   close_kotuku();
+   return glFailures ? -1 : 0;
+}
@@ -0,0 +1,209 @@
+/*********************************************************************************************************************
+
+Stress test for the font glyph cache.  Text paths are generated from multiple threads that share the same font sizes,
+so that glyphs are loaded and read concurrently.  Each thread visits the test strings in a different order, and the
+results of every thread must match a single-threaded pass that is run after the threads have completed.
+
+Usage: test_glyph_threads [-threads n] [-iterations n]
+
+*********************************************************************************************************************/
+
+#include <kotuku/startup.h>
+#include <kotuku/modules/vector.h>
+#include <kotuku/strings.hpp>
+#include <thread>
+#include <atomic>
+
+JUMPTABLE_VECTOR
+static OBJECTPTR modVector;
+
+using namespace pf;
+
+CSTRING ProgName = "GlyphThreads";
+
+static int glTotalThreads = 8;
+static int glIterations = 20;
+
+static const int glSizes[] = { 11, 17, 23, 37 }; // Unusual sizes ensure that the glyph tables start empty
+
+static std::vector<std::string> glStrings;
+static std::vector<APTR> glHandles;
+static std::atomic<int> glErrors = 0;
+
+struct thread_results {
+   std::vector<double> widths;  // StringWidth() for each string and font handle
+   std::vector<double> bounds;  // Width of the VectorText path for each string
+};
+
+//********************************************************************************************************************
+// Builds strings from several unicode blocks, 16 characters per string.
+
+static void build_strings()
+{
+   static const std::pair<uint32_t, uint32_t> ranges[] = {
+      { 0x21, 0x7e }, { 0xa1, 0xff }, { 0x100, 0x17f }, { 0x391, 0x3c9 }, { 0x410, 0x44f }
+   };
+
+   for (auto &range : ranges) {
+      std::string str;
+      int count = 0;
+      for (auto unicode=range.first; unicode <= range.second; unicode++) {
+         if (unicode < 0x80) str.push_back(char(unicode));
+         else if (unicode < 0x800) {
+            str.push_back(char(0xc0 | (unicode>>6)));
+            str.push_back(char(0x80 | (unicode & 0x3f)));
+         }
+
+         if (++count IS 16) {
+            glStrings.push_back(str);
+            str.clear();
+            count = 0;
+         }
+      }
+      if (!str.empty()) glStrings.push_back(str);
+   }
+}
+
+//********************************************************************************************************************
+
+static void measure(objVectorText *Text, size_t Index, double &Bounds, double *Widths)
+{
+   for (size_t f=0; f < glHandles.size(); f++) {
+      Widths[f] = vec::StringWidth(glHandles[f], glStrings[Index].c_str(), -1);
+   }
+
+   double x, y, width, height;
+   Text->setString(glStrings[Index]);
+   if (Text->getBoundary(VBF::NIL, &x, &y, &width, &height) IS ERR::Okay) Bounds = width;
+   else Bounds = -1;
+}
+
+//********************************************************************************************************************
+
+static void thread_entry(int Index, objVectorText *Text, thread_results *Results)
+{
+   const size_t total = glStrings.size();
+   Results->widths.resize(total * glHandles.size());
+   Results->bounds.resize(total);
+
+   for (int i=0; i < glIterations; i++) {
+      for (size_t s=0; s < total; s++) {
+         const size_t n = (s + size_t(Index) * 7) % total;
+         double bounds, widths[std::size(glSizes)];
+         measure(Text, n, bounds, widths);
+
+         if (!i) {
+            Results->bounds[n] = bounds;
+            for (size_t f=0; f < glHandles.size(); f++) Results->widths[n * glHandles.size() + f] = widths[f];
+         }
+         else {
+            if (Results->bounds[n] != bounds) glErrors++;
+            for (size_t f=0; f < glHandles.size(); f++) {
+               if (Results->widths[n * glHandles.size() + f] != widths[f]) glErrors++;
+            }
+         }
+      }
+   }
+}
+
+//********************************************************************************************************************
+
+int main(int argc, CSTRING *argv)
+{
+   pf::Log log;
+   pf::vector<std::string> *args;
+
+   if (auto msg = init_kotuku(argc, argv)) {
+      printf("%s\n", msg);
+      return -1;
+   }
+
+   if ((CurrentTask()->get(FID_Parameters, args) IS ERR::Okay) and (args)) {
+      for (unsigned i=0; i < args->size(); i++) {
+         if (iequals(args[0][i], "-threads")) {
+            if (++i < args->size()) glTotalThreads = strtol(args[0][i].c_str(), nullptr, 0);
+            else break;
+         }
+         else if (iequals(args[0][i], "-iterations")) {
+            if (++i < args->size()) glIterations = strtol(args[0][i].c_str(), nullptr, 0);
+            else break;
+         }
+      }
+   }
+
+   if (objModule::load("vector", &modVector, &VectorBase) != ERR::Okay) return -1;
+
+   build_strings();
+
+   for (auto size : glSizes) {
+      APTR handle;
+      if (vec::GetFontHandle("Noto Sans", "Regular", 400, size, &handle) IS ERR::Okay) glHandles.push_back(handle);
+      else {
+         printf("Failed to load the font at size %d.\n", size);
+         return -1;
+      }
+   }
+
+   // Each thread has its own scene, but all threads share the same font sizes.
+
+   std::vector<objVectorScene *> scenes;
+   std::vector<objVectorText *> texts;
+   for (int t=0; t <= glTotalThreads; t++) {
+      auto scene = objVectorScene::create::global({ fl::PageWidth(800), fl::PageHeight(600) });
+      auto view  = objVectorViewport::create::global({ fl::Owner(scene->UID), fl::X(0), fl::Y(0), fl::Width(800), fl::Height(600) });
+      texts.push_back(objVectorText::create::global({
+         fl::Owner(view->UID), fl::X(10), fl::Y(40), fl::Face("Noto Sans"), fl::FontSize(glSizes[t % std::size(glSizes)]),
+         fl::String("")
+      }));
+      scenes.push_back(scene);
+   }
+
+   log.msg("Spawning %d threads...", glTotalThreads);
+
+   std::vector<thread_results> results(glTotalThreads);
+   std::vector<std::thread> threads;
+   for (int t=0; t < glTotalThreads; t++) {
+      threads.emplace_back(thread_entry, t, texts[t], &results[t]);
+   }
+
+   for (auto &thread : threads) thread.join();
+
+   // Verify the threaded results against a single-threaded pass.  Each text object uses the font size of its index,
+   // so path bounds can only be compared against the reference text object for threads that share its size.  The
+   // remaining threads are compared against each other.
+
+   const int sizes = int(std::size(glSizes));
+   int mismatches = glErrors;
+   for (size_t s=0; s < glStrings.size(); s++) {
+      std::vector<double> widths(glHandles.size());
+      double bounds;
+      measure(texts[glTotalThreads], s, bounds, widths.data());
+
+      for (int t=0; t < glTotalThreads; t++) {
+         for (size_t f=0; f < glHandles.size(); f++) {
+            if (results[t].widths[s * glHandles.size() + f] != widths[f]) mismatches++;
+         }
+
+         if (((t % sizes) IS (glTotalThreads % sizes)) and (results[t].bounds[s] != bounds)) mismatches++;
+      }
+   }
+
+   for (int t=0; t < glTotalThreads; t++) {
+      for (int u=t + sizes; u < glTotalThreads; u += sizes) {
+         if (results[t].bounds != results[u].bounds) mismatches++;
+      }
+   }
+
+   for (auto scene : scenes) FreeResource(scene);
+
+   int result = 0;
+   if (mismatches) {
+      printf("✗ %d mismatched results across %d threads.\n", mismatches, glTotalThreads);
+      result = -1;
+   }
+   else printf("✓ %d threads produced consistent glyph metrics for %d strings.\n", glTotalThreads, int(glStrings.size()));
+
+   FreeResource(modVector);
+   close_kotuku();
+   return result;
+}
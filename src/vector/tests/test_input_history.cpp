@@ -0,0 +1,121 @@
+/*********************************************************************************************************************
+
+Tests for the batching of pointer movement in scene/input_history.h, as used by scene_input_events().  A movement
+series is consolidated to its final event, and the history delivered to JTYPE::HISTORY subscribers contains every
+position over the scene's surface in the vector's coordinate space, with the original timestamps.
+
+Usage: test_input_history
+
+*********************************************************************************************************************/
+
+#include <kotuku/main.h>
+#include <kotuku/modules/core.h>
+#include <cstdio>
+#include "../scene/input_history.h"
+
+static constexpr OBJECTID SURFACE = 100;
+static constexpr OBJECTID OTHER   = 101;
+static constexpr OBJECTID VECTOR  = 500;
+
+static int glFailures = 0;
+
+static void check(bool Result, CSTRING Test)
+{
+   if (Result) printf("✓ %s\n", Test);
+   else {
+      printf("✗ %s\n", Test);
+      glFailures++;
+   }
+}
+
+// Stand-in for the inverted transform of a vector.
+
+struct translate {
+   double x, y;
+   void transform(double *X, double *Y) const { *X += x; *Y += y; }
+};
+
+static InputEvent movement(OBJECTID Over, double X, double Y, int64_t Timestamp)
+{
+   InputEvent event = {};
+   event.Type      = JET::ABS_XY;
+   event.Flags     = JTYPE::MOVEMENT;
+   event.Mask      = JTYPE::MOVEMENT;
+   event.OverID    = Over;
+   event.X         = X;
+   event.Y         = Y;
+   event.Timestamp = Timestamp;
+   return event;
+}
+
+static void link(std::vector<InputEvent> &Events)
+{
+   for (size_t i=0; i < Events.size(); i++) Events[i].Next = (i + 1 < Events.size()) ? &Events[i + 1] : nullptr;
+}
+
+//********************************************************************************************************************
+// A movement series ends at the first event that is not movement.
+
+static void test_consolidate()
+{
+   std::vector<InputEvent> events = {
+      movement(SURFACE, 1, 1, 10), movement(SURFACE, 2, 2, 20), movement(SURFACE, 3, 3, 30), movement(SURFACE, 4, 4, 40)
+   };
+   events[3].Type  = JET::LMB;
+   events[3].Flags = JTYPE::BUTTON;
+   events[3].Mask  = JTYPE::BUTTON;
+   link(events);
+
+   check(input_history::consolidate(&events[0]) IS &events[2], "A movement series is consolidated to its last event");
+   check(input_history::consolidate(&events[3]) IS &events[3], "A button event is not consolidated");
+}
+
+//********************************************************************************************************************
+// The history is localised with the vector's transform and keeps the timestamp of each event.  Positions that were
+// not over the scene's surface are skipped, and the final entry is the event that was dispatched for the series.
+
+static void test_localise()
+{
+   std::vector<InputEvent> events = {
+      movement(SURFACE, 10, 20, 1000), movement(OTHER, 11, 21, 1100), movement(SURFACE, 12, 22, 1200),
+      movement(SURFACE, 13, 23, 1300)
+   };
+   link(events);
+
+   auto last = input_history::consolidate(&events[0]);
+
+   InputEvent dispatched = *last;
+   dispatched.Next   = nullptr;
+   dispatched.OverID = VECTOR;
+   dispatched.AbsX   = last->X;
+   dispatched.AbsY   = last->Y;
+   dispatched.X      = last->X - 10;
+   dispatched.Y      = last->Y - 20;
+
+   std::vector<InputEvent> history;
+   input_history::localise(&events[0], last, dispatched, SURFACE, VECTOR, translate { -10, -20 }, history);
+
+   check(history.size() IS 3, "Events over other surfaces are excluded from the history");
+   if (history.size() != 3) return;
+
+   check((history[0].Timestamp IS 1000) and (history[1].Timestamp IS 1200) and (history[2].Timestamp IS 1300),
+      "History events keep their timestamps");
+   check((history[0].X IS 0) and (history[0].Y IS 0) and (history[1].X IS 2) and (history[1].Y IS 2),
+      "History positions are localised to the vector");
+   check((history[0].AbsX IS 10) and (history[1].AbsY IS 22), "History events retain the absolute position");
+   check((history[0].OverID IS VECTOR) and (history[1].OverID IS VECTOR), "History events are addressed to the vector");
+   check((history[2].X IS 3) and (history[2].Y IS 3), "The history terminates with the dispatched event");
+   check((history[0].Next IS &history[1]) and (history[1].Next IS &history[2]) and (!history[2].Next),
+      "The history is linked in order");
+}
+
+//********************************************************************************************************************
+
+int main(int argc, char **argv)
+{
+   test_consolidate();
+   test_localise();
+
+   if (glFailures) printf("%d tests failed.\n", glFailures);
+   return glFailures ? -1 : 0;
+}
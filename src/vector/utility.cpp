@@ -424,8 +424,27 @@ std::string weight_to_style(CSTRING Style, int Weight)
 }
 
 //********************************************************************************************************************
+// Returns the size that is closest to Size in terms of scale, from a list of candidates.
 
-ERR get_font(pf::Log &Log, CSTRING Family, CSTRING Style, int Weight, int Size, common_font **Handle)
+template <class T> static int nearest_size(int Size, const T &Candidates)
+{
+   int best = Size;
+   double best_ratio = DBL_MAX;
+   for (auto &entry : Candidates) {
+      int candidate;
+      if constexpr (std::is_arithmetic_v<std::decay_t<decltype(entry)>>) candidate = entry;
+      else candidate = entry.first;
+      const double ratio = std::abs(std::log(double(Size) / double(candidate)));
+      if (ratio < best_ratio) { best = candidate; best_ratio = ratio; }
+   }
+   return best;
+}
+
+//********************************************************************************************************************
+// If Bucket is true and the font is scalable, the returned instance may differ from the requested Size.  The client
+// is expected to scale the font's metrics and outlines by Size / ft_point::size in that case.
+
+ERR get_font(pf::Log &Log, CSTRING Family, CSTRING Style, int Weight, int Size, common_font **Handle, bool Bucket)
 {
    Log.branch("Family: %s, Style: %s, Weight: %d, Size: %d", Family, Style, Weight, Size);
 
@@ -535,7 +554,7 @@ ERR get_font(pf::Log &Log, CSTRING Family, CSTRING Style, int Weight, int Size,
                }
                else styles.try_emplace(style);
 
-               glFreetypeFonts.try_emplace(key, std::make_unique<freetype_font>(ftface, styles, metrics, meta));
+               glFreetypeFonts.try_emplace(key, std::make_unique<freetype_font>(ftface, std::move(styles), metrics, meta));
             }
             else return Log.warning(ERR::ResolvePath);
          }
@@ -543,8 +562,18 @@ ERR get_font(pf::Log &Log, CSTRING Family, CSTRING Style, int Weight, int Size,
          auto &font = *glFreetypeFonts[key];
          if (auto cache = font.style_cache.find(style); cache != font.style_cache.end()) {
             freetype_font::SIZE_CACHE &sz = cache->second;
+
+            if (Bucket) {
+               Size = nearest_size(std::clamp(Size, 1, 256), freetype_font::SIZE_BUCKETS);
+               if ((!sz.contains(Size)) and (sz.size() >= freetype_font::MAX_LIVE_SIZES)) {
+                  Size = nearest_size(Size, sz);
+               }
+            }
+
             if (auto size = sz.find(Size); size IS sz.end()) {
-               // New font size entry required
+               // New font size entry required.  Creating the size modifies the face.
+
+               const std::lock_guard face_lock(font.lock);
 
                if (font.metrics.contains(style)) {
                   auto new_size = sz.try_emplace(Size, font, font.metrics[style], Size);
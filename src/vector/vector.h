@@ -49,6 +49,7 @@ using namespace pf;
 //#include "agg_vcgen_markers_term.h"
 
 #include "../link/linear_rgb.h"
+#include "../link/simd_blend.h"
 #include "../link/unicode.h"
 
 #include <math.h>
@@ -202,6 +203,108 @@ public:
       vector_id(pV), cursor(pC), bounds(pBounds), x(p5), y(p6), pass_through(pPass) {};
 };
 
+//********************************************************************************************************************
+// Uniform grid over the input boundaries of a scene, so that pointer events are only tested against the boundaries that
+// share a cell with the pointer.  The grid covers the bitmap that the scene is drawn to and boundaries are linked into
+// its cells as they are recorded by the renderer.  A boundary that is unchanged since the previous frame keeps its
+// cells, so only the vectors that were marked dirty and redrawn at a new position cause cell updates.  Boundaries that
+// would span a large portion of the grid are kept in a separate list rather than being linked into every cell.
+//
+// Queries iterate over the grid in place, from the foreground to the background, and return each InputBoundary by
+// value.  An input handler may redraw the scene while a query is in progress; the iteration ends if that happens.
+
+class InputGrid {
+public:
+   class Hits;
+
+   std::vector<InputBoundary> Boundaries; // Drawing order.  Use add() to modify.
+
+   void begin_frame(int, int);
+   void add(const InputBoundary &);
+   void end_frame();
+   Hits query(double, double) const;
+   Hits query(OBJECTID) const;
+
+private:
+   static constexpr int MAX_CELLS   = 64;  // Maximum grid resolution on each axis
+   static constexpr int MIN_CELL    = 16;  // Minimum cell size, in pixels
+   static constexpr int LARGE_CELLS = 256; // Boundaries that span more cells than this are stored in Large
+
+   std::vector<std::vector<uint32_t>> Cells; // Each cell is sorted in drawing order
+   std::vector<uint32_t> Large;
+   double CellWidth = 1, CellHeight = 1;
+   int Width = 0, Height = 0;
+   int Columns = 0, Rows = 0;
+   uint32_t Next = 0;       // Index of the next boundary to be recorded by add()
+   uint32_t Generation = 0; // Incremented on each call to begin_frame()
+
+   bool span(const TClipRectangle<double> &, int &, int &, int &, int &) const;
+   void link(uint32_t, const TClipRectangle<double> &);
+   void unlink(uint32_t, const TClipRectangle<double> &);
+};
+
+// Range of the boundaries that match a query.  The cell and Large lists are both in drawing order, so they are merged
+// in reverse.  For a vector query the Boundaries are scanned directly.
+
+class InputGrid::Hits {
+public:
+   class iterator {
+   public:
+      iterator(const Hits *pHits) : mHits(pHits) {
+         if (mHits) {
+            mCell  = mHits->Cell ? int(mHits->Cell->size()) : 0;
+            mLarge = mHits->Cell ? int(mHits->Grid->Large.size()) : 0;
+            mScan  = mHits->Cell ? 0 : int(mHits->Grid->Boundaries.size());
+            advance();
+         }
+      }
+
+      InputBoundary operator*() const { return mHits->Grid->Boundaries[mIndex]; }
+      iterator & operator++() { advance(); return *this; }
+      bool operator!=(const iterator &Other) const { return mHits != Other.mHits; }
+
+   private:
+      const Hits *mHits;
+      int mCell = 0, mLarge = 0, mScan = 0;
+      uint32_t mIndex = 0;
+
+      void advance() {
+         auto &grid = *mHits->Grid;
+         if (grid.Generation != mHits->Generation) { mHits = nullptr; return; } // The scene was redrawn
+
+         while (mScan > 0) {
+            if (grid.Boundaries[--mScan].vector_id IS mHits->Vector) { mIndex = mScan; return; }
+         }
+
+         while ((mCell > 0) or (mLarge > 0)) {
+            if ((mLarge IS 0) or ((mCell > 0) and ((*mHits->Cell)[mCell-1] > grid.Large[mLarge-1]))) {
+               mIndex = (*mHits->Cell)[--mCell];
+            }
+            else mIndex = grid.Large[--mLarge];
+
+            if (grid.Boundaries[mIndex].bounds.hit_test(mHits->X, mHits->Y)) return;
+         }
+
+         mHits = nullptr;
+      }
+   };
+
+   iterator begin() const { return iterator(Grid ? this : nullptr); }
+   iterator end() const { return iterator(nullptr); }
+
+private:
+   friend class InputGrid;
+
+   Hits(const InputGrid *pGrid, const std::vector<uint32_t> *pCell, double pX, double pY, OBJECTID pVector) :
+      Grid(pGrid), Cell(pCell), X(pX), Y(pY), Vector(pVector), Generation(pGrid ? pGrid->Generation : 0) { }
+
+   const InputGrid *Grid; // Null if nothing can match
+   const std::vector<uint32_t> *Cell; // Null for a vector query
+   double X, Y;
+   OBJECTID Vector;
+   uint32_t Generation;
+};
+
 //********************************************************************************************************************
 
 class InputSubscription {
@@ -234,8 +337,10 @@ class filter_bitmap {
 public:
    objBitmap *Bitmap;
    std::vector<uint8_t> Data;
+   size_t Size; // Size of the buffer area that is in use
+   size_t Peak; // Largest buffer size requested since the last trim
 
-   filter_bitmap() : Bitmap(nullptr) { };
+   filter_bitmap() : Bitmap(nullptr), Size(0), Peak(0) { };
 
    ~filter_bitmap() {
       if (Bitmap) { FreeResource(Bitmap); Bitmap = nullptr; }
@@ -277,9 +382,9 @@ public:
       if (!Debug) {
          Bitmap->LineWidth = Clip.width() * Bitmap->BytesPerPixel;
 
-         if (Data.size() < Bitmap->LineWidth * Clip.height()) {
-            Data.resize(Bitmap->LineWidth * Clip.height());
-         }
+         Size = size_t(Bitmap->LineWidth) * size_t(Clip.height());
+         if (Data.size() < Size) Data.resize(Size);
+         if (Size > Peak) Peak = Size;
 
          Bitmap->Data = Data.data() - (Clip.left * Bitmap->BytesPerPixel) - (Clip.top * Bitmap->LineWidth);
          Bitmap->CreatorMeta = Data.data();
@@ -288,6 +393,123 @@ public:
       return Bitmap;
    }
 
+   // Clear the live area of the bitmap.  The buffer is exactly the size of the clip region, so this is a single
+   // contiguous operation.
+
+   void clear() {
+      if ((Bitmap->Flags & BMF::NO_DATA) != BMF::NIL) {
+         clearmem(Data.data(), Size);
+      }
+      else gfx::DrawRectangle(Bitmap, 0, 0, Bitmap->Width, Bitmap->Height, 0x00000000, BAF::FILL);
+   }
+};
+
+//********************************************************************************************************************
+// Pool of filter bitmaps that is shared by every filter rendered within a scene.  Bitmaps are borrowed for the
+// duration of a filter pipeline and returned once the output has been composited, so the pool only needs to be as
+// deep as the most complex pipeline and as large as the biggest filter region.  Buffers retain their capacity across
+// frames and are trimmed periodically if they are significantly larger than recent demand.
+
+class filter_bank {
+public:
+   std::vector<std::unique_ptr<filter_bitmap>> Bitmaps;
+   size_t Index = 0;      // Next free bitmap in the pool
+   size_t PeakIndex = 0;  // Deepest use of the pool since the last trim
+   size_t PeakBytes = 0;  // Largest amount of buffer memory in use since the last trim
+   int Frames = 0;        // Frames drawn since the last trim
+
+   static constexpr int TRIM_INTERVAL = 120; // Frames between trims
+
+   filter_bitmap * acquire() {
+      if (Index >= Bitmaps.size()) Bitmaps.emplace_back(std::make_unique<filter_bitmap>());
+      Index++;
+      if (Index > PeakIndex) PeakIndex = Index;
+      return Bitmaps[Index-1].get();
+   }
+
+   // Return all bitmaps acquired since Mark was taken.
+
+   void release(size_t Mark) {
+      size_t bytes = 0;
+      for (size_t i=0; i < Index; i++) bytes += Bitmaps[i]->Data.size();
+      if (bytes > PeakBytes) PeakBytes = bytes;
+      Index = Mark;
+   }
+
+   // Called once per frame, when no bitmaps are in use.
+
+   void end_frame() {
+      if (++Frames < TRIM_INTERVAL) return;
+
+      pf::Log log(__FUNCTION__);
+      log.detail("Filter bank peak: %d bitmaps, %" PRId64 " KB", int(PeakIndex), int64_t(PeakBytes>>10));
+
+      Bitmaps.resize(PeakIndex);
+      for (auto &bmp : Bitmaps) {
+         if (bmp->Data.size() > bmp->Peak * 2) {
+            bmp->Data.resize(bmp->Peak);
+            bmp->Data.shrink_to_fit();
+         }
+         bmp->Peak = 0;
+      }
+
+      Frames    = 0;
+      PeakIndex = 0;
+      PeakBytes = 0;
+   }
+};
+
+//********************************************************************************************************************
+// Cache of final filter output, keyed by filter and client vector.  Each entry is validated against a fingerprint of
+// the filter configuration, the client geometry and the generation counters of the client and scene definitions, so
+// a hit does not require the client to be rendered.  Output is only retained once a fingerprint has been seen on two
+// consecutive renders, so animated content does not pay for copies that will never be reused.
+
+class filter_cache {
+public:
+   struct entry {
+      uint64_t State  = 0;  // Fingerprint of the filter, its effects and the client
+      int LastUsed    = 0;  // Frame of the most recent lookup
+      bool Valid      = false; // True if Output reflects the current fingerprint
+      filter_bitmap Output;
+   };
+
+   ankerl::unordered_dense::map<uint64_t, std::unique_ptr<entry>> Entries;
+   size_t Bytes = 0; // Buffer memory held by valid entries
+   int Frame = 0;
+
+   static constexpr size_t BUDGET = 64 * 1024 * 1024; // Memory limit for cached output
+   static constexpr int EXPIRY = 120; // Frames before an unused entry is discarded
+
+   static inline uint64_t key(OBJECTID Filter, OBJECTID Vector) {
+      return (uint64_t(uint32_t(Filter))<<32) | uint32_t(Vector);
+   }
+
+   objBitmap * lookup(uint64_t Key, uint64_t State, bool &Store);
+   void settle(uint64_t Key, uint64_t State);
+   void store(uint64_t Key, objBitmap *Bitmap);
+   void end_frame();
+
+private:
+   void invalidate(entry &Entry);
+};
+
+//********************************************************************************************************************
+// Coverage buffer for drawing VectorText through cached glyph masks.  The buffer is aligned to the target bitmap so
+// that it can be used in place of a clip mask, and is retained by the scene for reuse between text objects and frames.
+// Only the pixels within Area are defined following a call to build_text_coverage().
+
+class glyph_coverage {
+public:
+   struct placement {
+      int x, y, width, height; // Target area of the mask
+      size_t offset;           // Location of the mask in the font's atlas
+   };
+
+   std::vector<uint8_t> Data;
+   std::vector<placement> Placements;
+   TClipRectangle<int> Area;
+   int Width = 0, Height = 0;
 };
 
 constexpr int TB_NOISE = 1;
@@ -335,6 +557,7 @@ class extVectorGradient : public objVectorGradient, public SceneDef {
    std::vector<GradientStop> Stops;  // An array of gradient stop colours.
    struct VectorMatrix *Matrices;
    class GradientColours *Colours;
+   class GradientCache *Cache; // Allocated on first use by the renderer
    std::string ColourMap;
    FRGB   Colour;
    RGB8   ColourRGB; // A cached conversion of the FRGB value
@@ -348,6 +571,8 @@ class extVectorGradient : public objVectorGradient, public SceneDef {
 class extVectorImage : public objVectorImage, public SceneDef {
    public:
    using create = pf::Create<extVectorImage>;
+
+   class MipChain *Mips; // Allocated on first use by the renderer
 };
 
 class extVectorPattern : public objVectorPattern, public SceneDef {
@@ -356,6 +581,7 @@ class extVectorPattern : public objVectorPattern, public SceneDef {
 
    struct VectorMatrix *Matrices;
    objBitmap *Bitmap;
+   class MipChain *Mips; // Allocated on first use by the renderer
 };
 
 class extVectorFilter : public objVectorFilter {
@@ -371,11 +597,10 @@ class extVectorFilter : public objVectorFilter {
    extFilterEffect *ActiveEffect;      // Current effect being processed by the pipeline.
    extFilterEffect *Effects;           // Pointer to the first effect in the chain.
    extFilterEffect *LastEffect;
-   std::vector<std::unique_ptr<filter_bitmap>> Bank;
    TClipRectangle<int> VectorClip;           // Clipping region of the vector client (reflects the vector bounds)
-   uint8_t BankIndex;
    double BoundWidth, BoundHeight; // Filter boundary, computed on acDraw()
    double TargetX, TargetY, TargetWidth, TargetHeight; // Target boundary, computed on acDraw()
+   uint32_t Generation; // Incremented when an effect is modified; invalidates cached output.
    bool Rendered;
    bool Disabled;
    bool ReqBkgd; // True if the filter requires a background bitmap for one or more effects.
@@ -387,12 +612,59 @@ class extFilterEffect : public objFilterEffect {
 
    extVectorFilter *Filter; // Direct reference to the parent filter
    uint16_t UsageCount;        // Total number of other effects utilising this effect to build a pipeline
+
+   // Effects must call modified() when a parameter changes, so that cached filter output is not reused.
+
+   inline void modified() { if (Filter) Filter->Generation++; }
 };
 
 class extPainter : public VectorPainter {
+};
+
+//********************************************************************************************************************
+// Flattened vertices of a fill or stroke outline in the local space of a vector.  When only the transform of a vector
+// changes, its rasterisers are refilled from these vertices instead of flattening curves and stroking the base path
+// again.  Outlines are captured on the second use of a base path, so that content that is generated once does not
+// hold a copy.
+
+class flat_path {
 public:
-   GRADIENT_TABLE *GradientTable;
-   double GradientAlpha;
+   std::vector<double> Coords;     // Interleaved (x,y) pairs
+   std::vector<uint8_t> Commands;  // AGG path command for each vertex
+   uint64_t Key = 0;   // Fingerprint of the stroke configuration, if any
+   double Scale = 0;   // Approximation scale that curves were flattened with.  Zero if nothing is captured.
+   bool Armed = false; // True if the base path has been rasterised once since it was generated
+
+   inline void reset() {
+      Coords.clear();
+      Commands.clear();
+      Scale = 0;
+      Armed = false;
+   }
+
+   // Flattening at a finer scale than necessary is harmless, so the capture is reusable until the vector is scaled
+   // up beyond a small tolerance, or scaled down enough for the vertex count to be wasteful.
+
+   inline bool valid(uint64_t pKey, double pScale) const {
+      return (Scale > 0) and (Key IS pKey) and (pScale <= Scale * 1.25) and (pScale >= Scale * 0.5);
+   }
+
+   template <class VertexSource> void capture(VertexSource &Source, uint64_t pKey, double pScale) {
+      Coords.clear();
+      Commands.clear();
+      Source.rewind(0);
+      double x, y;
+      unsigned cmd;
+      while (!agg::is_stop(cmd = Source.vertex(&x, &y))) {
+         Coords.push_back(x);
+         Coords.push_back(y);
+         Commands.push_back(uint8_t(cmd));
+      }
+      Key   = pKey;
+      Scale = pScale;
+   }
+
+   void rasterise(agg::rasterizer_scanline_aa<> &, const agg::trans_affine &) const;
 };
 
 class extVector : public objVector {
@@ -410,6 +682,7 @@ class extVector : public objVector {
    void   (*GeneratePath)(extVector *, agg::path_storage &);
    agg::rasterizer_scanline_aa<>     *StrokeRaster;
    agg::rasterizer_scanline_aa<>     *FillRaster;
+   flat_path FillOutline, StrokeOutline; // Cached outlines for transform-only updates of the rasterisers
    std::vector<FeedbackSubscription> *FeedbackSubscriptions;
    std::vector<InputSubscription>    *InputSubscriptions;
    std::vector<KeyboardSubscription> *KeyboardSubscriptions;
@@ -423,6 +696,7 @@ class extVector : public objVector {
    JTYPE InputMask;
    int   NumericID;
    int   PathLength;
+   uint32_t Generation; // Incremented when the vector or any of its children is modified
    VMF   MorphFlags;
    VFR   FillRule;
    VFR   ClipRule;
@@ -475,7 +749,10 @@ class extVectorScene : public objVectorScene {
    std::unordered_set<extVectorViewport *> PendingResizeMsgs;
    ankerl::unordered_dense::map<extVector *, JTYPE> InputSubscriptions;
    std::set<extVector *, TabOrderedVector> KeyboardSubscriptions;
-   std::vector<class InputBoundary> InputBoundaries; // Defined on the fly each time that the scene is rendered.  Used to manage input events and cursor changes.
+   filter_bank FilterBank; // Bitmaps shared by all filters rendered in this scene
+   filter_cache FilterCache; // Output of filters whose inputs have not changed between frames
+   glyph_coverage GlyphCoverage; // Work area for drawing text with glyph masks
+   InputGrid InputLookup; // Input boundaries recorded each time that the scene is rendered.  Used to manage input events and cursor changes.
    ankerl::unordered_dense::map<extVectorViewport *, ankerl::unordered_dense::map<extVector *, FUNCTION>> ResizeSubscriptions;
    OBJECTID ButtonLock; // The vector currently holding a button lock
    OBJECTID ActiveVector; // The most recent vector to have received an input movement event.
@@ -483,6 +760,7 @@ class extVectorScene : public objVectorScene {
    PTC Cursor; // Current cursor image
    bool RefreshCursor;
    bool ShareModified; // True if a shareable object has been modified (e.g. VectorGradient), requiring a redraw of any vectors that use it.
+   uint32_t DefGeneration; // Incremented whenever ShareModified is set
    uint8_t BufferCount; // Active tally of viewports that are buffered.
 };
 
@@ -552,12 +830,22 @@ class extVectorRectangle : public extVector {
 
 class GradientColours {
    public:
+      static constexpr size_t MAX_ALPHA_TABLES = 4;
+
       GradientColours(const std::vector<GradientStop> &, VCS, double, double);
       GradientColours(const std::array<FRGB, 256> &, double);
       GRADIENT_TABLE table;
       double resolution;
 
+      // Copies of the table with an opacity multiplier applied, most recently used first.  Vectors commonly share a
+      // gradient at a handful of opacity levels, so a small number of entries is sufficient.
+
+      std::vector<std::pair<double, std::unique_ptr<GRADIENT_TABLE>>> alpha_tables;
+
+      GRADIENT_TABLE * alpha_table(double Opacity, bool &Hit);
+
       void apply_resolution(double Resolution) {
+         alpha_tables.clear();
          resolution = 1.0 - Resolution;
 
          // For a given block of colours, compute the average colour and apply it to the entire block.
@@ -583,15 +871,88 @@ class GradientColours {
 };
 
 //********************************************************************************************************************
+// Render-time data that is retained by a VectorGradient.  Contour gradients require a distance transform of the
+// target path, which is expensive to compute and is therefore kept for the most recently used paths.  The transform
+// does not depend on X1 and X2 because they are applied when the gradient is sampled.
+
+namespace agg { class gradient_contour; }
+
+class GradientCache {
+   public:
+      static constexpr size_t MAX_CONTOURS = 4;
+
+      enum { TABLE_HITS, TABLE_MISSES, CONTOUR_HITS, CONTOUR_MISSES, END };
+
+      std::vector<std::pair<uint64_t, std::unique_ptr<agg::gradient_contour>>> contours; // Most recently used first
+      std::array<int, END> stats = { }; // Hit and miss counters, readable from the CacheStats field
+
+      GradientCache();
+      ~GradientCache();
+      agg::gradient_contour * get_contour(agg::path_storage &);
+};
+
+inline GradientCache * get_gradient_cache(extVectorGradient &Gradient)
+{
+   if (!Gradient.Cache) Gradient.Cache = new (std::nothrow) GradientCache;
+   return Gradient.Cache;
+}
+
+//********************************************************************************************************************
+// Reduced copies of a 32-bit image or pattern bitmap, used when the source is drawn at less than half of its size.
+// Each level is a 2:1 box-filtered reduction of the level above it, so sampling the nearest level with a small kernel
+// is both faster and free of the aliasing that results from sampling the full resolution source.  Levels are created
+// on demand and are discarded when the source bitmap is replaced or resized, or when the painter calls reset() to
+// signal that the content of the source has changed.
+
+class MipChain {
+   public:
+      static constexpr int MAX_LEVELS = 16;
+
+      struct level {
+         std::vector<uint32_t> data;
+         int width, height;
+      };
+
+      std::vector<level> levels; // levels[0] is half the size of the source
+      level blended;             // Scratch level for trilinear drawing
+      uint64_t key = 0;
+
+      void reset() { levels.clear(); key = 0; }
+      level * get(objBitmap &, int);
+      level * blend(objBitmap &, int, double);
+};
+
+template <class T> inline MipChain * get_mip_chain(T &Painter)
+{
+   if (!Painter.Mips) Painter.Mips = new (std::nothrow) MipChain;
+   return Painter.Mips;
+}
+
+//********************************************************************************************************************
+
+// An 8-bit mask rendered from a VectorClip for one of its client vectors.  Masks are retained by the VectorClip so that
+// they can be reused on subsequent frames if neither the clip paths nor the client's transform have changed.
+
+struct ClipMask {
+   std::vector<uint8_t> bitmap;
+   TClipRectangle<double> bounds; // The VectorClip's Bounds at the time that the mask was drawn
+   uint64_t key = 0;              // Identifies the client vector, its transform and the clip's settings
+   int generation = 0;            // Matches extVectorClip.Generation if the clip paths are unchanged
+   int width = 0, height = 0;
+};
 
 class extVectorClip : public objVectorClip, public SceneDef {
    public:
    static constexpr CLASSID CLASS_ID = CLASSID::VECTORCLIP;
    static constexpr CSTRING CLASS_NAME = "VectorClip";
+   static constexpr size_t MAX_MASKS = 8;
    using create = pf::Create<extVectorClip>;
 
+   std::vector<std::shared_ptr<ClipMask>> Masks; // Most recently used first
    TClipRectangle<double> Bounds;
    OBJECTID ViewportID;
+   int Generation = 0; // Incremented when the clip paths are found to be dirty or modified
+   uint32_t SeenGeneration = 0; // The Viewport's Generation when a mask was last drawn or reused
 };
 
 //********************************************************************************************************************
@@ -633,12 +994,14 @@ extern ERR init_wavefunctionfx(void);
 extern void apply_parent_transforms(extVector *, agg::trans_affine &);
 extern void apply_transition(extVectorTransition *, double, agg::trans_affine &);
 extern void apply_transition_xy(extVectorTransition *, double, double *, double *);
+extern bool build_text_coverage(extVector *, const TClipRectangle<int> &, glyph_coverage &);
 extern void calc_aspectratio(CSTRING, ARF, double, double, double, double, double &X, double &Y, double &, double &);
 extern void calc_full_boundary(extVector *, TClipRectangle<double> &, bool IncludeSiblings = true, bool IncludeTransforms = true, bool IncludeStrokes = false);
 extern void convert_to_aggpath(extVectorPath *, std::vector<PathCommand> &, agg::path_storage &);
 extern void debug_tree(extVector *, int &);
 extern void gen_vector_path(extVector *);
 extern void gen_vector_tree(extVector *);
+extern void gen_scene_paths(extVector *);
 extern GRADIENT_TABLE * get_fill_gradient_table(extPainter &, double);
 extern GRADIENT_TABLE * get_stroke_gradient_table(extVector &);
 extern objBitmap * get_source_graphic(extVectorFilter *);
@@ -689,6 +1052,12 @@ TClipRectangle<T> get_bounds(VertexSource &vs, const unsigned path_id = 0)
 
 static void mark_buffers_for_refresh(extVector *Vector)
 {
+   // Generations are maintained for the benefit of caches that depend on the content of a branch.
+
+   for (OBJECTPTR scan = Vector; (scan) and (scan->Class->BaseClassID IS CLASSID::VECTOR); scan = ((extVector *)scan)->Parent) {
+      ((extVector *)scan)->Generation++;
+   }
+
    if ((Vector->Scene) and (!((extVectorScene *)Vector->Scene)->BufferCount)) return;
 
    extVectorViewport *parent_view;
@@ -1227,6 +1596,7 @@ extern agg::gamma_lut<uint8_t, uint16_t, 8, 12> glGamma;
 extern double glDisplayVDPI, glDisplayHDPI, glDisplayDPI;
 
 extern void set_text_final_xy(extVectorText *);
+extern bool is_parallel_text(extVectorText *);
 
 namespace vec {
 extern ERR DrawPath(objBitmap * Bitmap, APTR Path, double StrokeWidth, OBJECTPTR StrokeStyle, OBJECTPTR FillStyle);
@@ -1271,5 +1641,8 @@ template <class T> TClipRectangle<T>::TClipRectangle(const class extVectorViewpo
 }
 
 inline void SceneDef::modified() {
-   if (HostScene) HostScene->ShareModified = true;
+   if (HostScene) {
+      HostScene->ShareModified = true;
+      HostScene->DefGeneration++;
+   }
 }
@@ -135,14 +135,12 @@ double CharWidth(APTR Handle, uint32_t Char, uint32_t KChar, double *Kerning)
 
    if (((common_font *)Handle)->type IS CF_FREETYPE) {
       auto pt = (freetype_font::ft_point *)Handle;
-      FT_Activate_Size(pt->ft_size);
 
       auto &cache = pt->get_glyph(Char);
       if (Kerning) {
          if (KChar) {
-            FT_Vector delta;
-            FT_Get_Kerning(pt->ft_size->face, FT_Get_Char_Index(pt->font->face, KChar), cache.glyph_index, FT_KERNING_DEFAULT, &delta);
-            *Kerning = int26p6_to_dbl(delta.x);
+            double ky;
+            pt->get_kerning(cache.glyph_index, pt->get_glyph(KChar).glyph_index, *Kerning, ky);
          }
          else *Kerning = 0;
       }
@@ -1214,11 +1212,8 @@ double StringWidth(APTR Handle, CSTRING String, int Chars)
 
    if ((!Handle) or (!String)) { log.warning(ERR::NullArgs); return 0; }
 
-   const std::lock_guard lock(glFontMutex);
-
    if (((common_font *)Handle)->type IS CF_FREETYPE) {
       auto pt = (freetype_font::ft_point *)Handle;
-      FT_Activate_Size(pt->ft_size);
 
       if (Chars IS -1) Chars = 0x7fffffff;
 
@@ -1237,10 +1232,10 @@ double StringWidth(APTR Handle, CSTRING String, int Chars)
             auto charlen = get_utf8(String, unicode, i);
             auto &glyph  = pt->get_glyph(unicode);
             len += glyph.adv_x;
-            if (prev_glyph) {;
-               FT_Vector delta;
-               FT_Get_Kerning(pt->ft_size->face, prev_glyph, glyph.glyph_index, FT_KERNING_DEFAULT, &delta);
-               len += int26p6_to_dbl(delta.x);
+            if (prev_glyph) {
+               double kx, ky;
+               pt->get_kerning(glyph.glyph_index, prev_glyph, kx, ky);
+               len += kx;
             }
             prev_glyph = glyph.glyph_index;
             i += charlen;
@@ -1250,7 +1245,10 @@ double StringWidth(APTR Handle, CSTRING String, int Chars)
       if (widest > len) return widest;
       else return len;
    }
-   else return fnt::StringWidth(((bmp_font *)Handle)->font, String, Chars);
+   else {
+      const std::lock_guard lock(glFontMutex);
+      return fnt::StringWidth(((bmp_font *)Handle)->font, String, Chars);
+   }
 }
 
 /*********************************************************************************************************************
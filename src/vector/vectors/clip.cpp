@@ -9,9 +9,10 @@ creating Vector shapes that are initialised to the VectorClip's #Viewport as chi
 Vector shapes can utilise a VectorClip by referring to it via the Vector's @Vector.Mask field.
 
 VectorClip objects must be owned by a @VectorScene.  It is valid for a VectorClip to be shared amongst multiple vector
-objects within the same scene.  If optimum drawing efficiency is required, we recommend that each VectorClip is
-referenced by one vector only.  This will reduce the frequency of path recomputation and redrawing of the clipping
-path.
+objects within the same scene.  The mask that is drawn for each vector is retained and reused on subsequent frames
+until the clipping paths or the vector's transform are modified.  Only the masks of the most recently drawn vectors
+are kept, so if optimum drawing efficiency is required, we recommend that each VectorClip is referenced by a small
+number of vectors.
 
 The SVG standard makes a distinction between clipping paths and masks.  Consequently, this distinction also exists
 in the VectorClip design, and by default VectorClip objects will operate in path clipping mode.  This means that
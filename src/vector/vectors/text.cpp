@@ -133,6 +133,16 @@ public:
    CharPos(double X1, double Y1, double X2, double Y2) : x1(X1), y1(Y1), x2(X2), y2(Y2) { }
 };
 
+//********************************************************************************************************************
+// Position of a glyph within the text path, prior to transformation.  Recorded for drawing the text with glyph masks.
+
+class GlyphPos {
+public:
+   uint32_t unicode;
+   double x, y;
+   GlyphPos(uint32_t Unicode, double X, double Y) : unicode(Unicode), x(X), y(Y) { }
+};
+
 //********************************************************************************************************************
 
 class TextLine : public std::string {
@@ -174,12 +184,14 @@ class extVectorText : public extVector {
    using create = pf::Create<extVectorText>;
 
    std::vector<TextLine> txLines;
+   std::vector<GlyphPos> txGlyphs; // Glyph positions for mask drawing.  Empty if the path cannot be drawn with masks.
    FUNCTION txValidateInput;
    FUNCTION txOnChange;
    double txInlineSize; // Enables word-wrapping
    double txX, txY;
    double txTextLength;
-   double txFontSize;  // Font size measured in pixels @ 72 DPI.  Should always be a whole number.
+   double txFontSize;  // Font size measured in pixels @ 72 DPI.
+   double txFontScale; // Scale from the metrics of txHandle to txFontSize, if the handle is a bucketed size.
    double txLetterSpacing; // SVG: Acts as a multiplier or fixed unit addition to the spacing of each glyph
    double txWidth; // Width of the text computed by path generation.  Not for client use as GetBoundary() can be used for that.
    double txStartOffset; // TODO
@@ -231,28 +243,6 @@ freetype_font::~freetype_font() {
 
 //********************************************************************************************************************
 
-inline void get_kerning_xy(FT_Face Face, int Glyph, int PrevGlyph, double &X, double &Y)
-{
-   FT_Vector delta;
-   if (!FT_Get_Kerning(Face, PrevGlyph, Glyph, FT_KERNING_DEFAULT, &delta)) {
-      X = int26p6_to_dbl(delta.x);
-      Y = int26p6_to_dbl(delta.y);
-   }
-   else {
-      X = 0;
-      Y = 0;
-   }
-}
-
-inline double get_kerning(FT_Face Face, int Glyph, int PrevGlyph)
-{
-   if ((not Glyph) or (not PrevGlyph)) return 0;
-
-   FT_Vector delta;
-   FT_Get_Kerning(Face, PrevGlyph, Glyph, FT_KERNING_DEFAULT, &delta);
-   return int26p6_to_dbl(delta.x);
-}
-
 inline void report_change(extVectorText *Self)
 {
    if (Self->txOnChange.isC()) {
@@ -271,12 +261,8 @@ inline void report_change(extVectorText *Self)
 
 static int string_width(extVectorText *Self, const std::string_view &String)
 {
-   const std::lock_guard lock(glFontMutex);
-
    auto pt = (freetype_font::ft_point *)Self->txHandle;
 
-   FT_Activate_Size(pt->ft_size);
-
    int len        = 0;
    int widest     = 0;
    int prev_glyph = 0;
@@ -291,8 +277,12 @@ static int string_width(extVectorText *Self, const std::string_view &String)
          uint32_t unicode;
          auto charlen = get_utf8(String, unicode, i);
          auto &glyph  = pt->get_glyph(unicode);
-         len += glyph.adv_x * Self->txLetterSpacing;
-         len += get_kerning(pt->font->face, glyph.glyph_index, prev_glyph);
+         len += glyph.adv_x * Self->txLetterSpacing * Self->txFontScale;
+         if (glyph.glyph_index) {
+            double kx, ky;
+            pt->get_kerning(glyph.glyph_index, prev_glyph, kx, ky);
+            len += kx * Self->txFontScale;
+         }
          prev_glyph = glyph.glyph_index;
          i += charlen;
       }
@@ -348,6 +338,7 @@ static ERR VECTORTEXT_DeleteLine(extVectorText *Self, struct vt::DeleteLine *Arg
 static ERR VECTORTEXT_Free(extVectorText *Self)
 {
    Self->txLines.~vector<TextLine>();
+   Self->txGlyphs.~vector<GlyphPos>();
    Self->txCursor.~TextCursor();
 
    if (Self->txHandle) {
@@ -414,6 +405,7 @@ static ERR VECTORTEXT_Init(extVectorText *Self)
 static ERR VECTORTEXT_NewObject(extVectorText *Self)
 {
    new (&Self->txLines) std::vector<TextLine>;
+   new (&Self->txGlyphs) std::vector<GlyphPos>;
    new (&Self->txCursor) TextCursor;
 
    strcopy("Regular", Self->txFontStyle, sizeof(Self->txFontStyle));
@@ -421,6 +413,7 @@ static ERR VECTORTEXT_NewObject(extVectorText *Self)
    Self->StrokeWidth  = 0.0;
    Self->txWeight     = DEFAULT_WEIGHT;
    Self->txFontSize   = 16; // Pixel units @ 72 DPI
+   Self->txFontScale  = 1.0;
    Self->txCharLimit  = 0x7fffffff;
    Self->txFamily     = strclone("Noto Sans");
    Self->Fill[0].Colour  = FRGB(1, 1, 1, 1);
@@ -540,7 +533,7 @@ static ERR TEXT_GET_Descent(extVectorText *Self, int *Value)
 
    if (Self->txHandle->type IS CF_BITMAP) *Value = Self->txBitmapFont->Gutter;
    else if (Self->txHandle->type IS CF_FREETYPE) {
-      *Value = ((freetype_font::ft_point *)Self->txHandle)->descent;
+      *Value = ((freetype_font::ft_point *)Self->txHandle)->descent * Self->txFontScale;
    }
    else *Value = 1;
    return ERR::Okay;
@@ -563,7 +556,7 @@ static ERR TEXT_GET_DisplayHeight(extVectorText *Self, int *Value)
 
    if (Self->txBitmapFont) *Value = Self->txBitmapFont->MaxHeight;
    else if (Self->txHandle->type IS CF_FREETYPE) {
-      *Value = ((freetype_font::ft_point *)Self->txHandle)->height;
+      *Value = ((freetype_font::ft_point *)Self->txHandle)->height * Self->txFontScale;
    }
    else *Value = 1;
    return ERR::Okay;
@@ -877,14 +870,12 @@ static ERR TEXT_SET_FontSize(extVectorText *Self, CSTRING Value)
    bool pct;
    auto size = read_unit(Value, pct);
 
-   // TODO: With respect to supporting sub-pixel point sizes and being cache-friendly, we could try caching fonts
-   // at pre-determined point sizes (4,6,8,10,12,14,20,30,40,50,60,...) and then use scaling to cater to other
-   // 'non-standard' sizes.  This would allow for hinting to remain effective when regular point sizes are being chosen.
+   // Scalable fonts are cached at the sizes in SIZE_BUCKETS, which allows hinting to remain effective for the
+   // standard sizes.  Other sizes, including sub-pixel sizes, are scaled from the nearest bucket (see reset_font()).
 
    if (size > 0) {
-      auto new_size = std::trunc(size);
-      if (Self->txFontSize IS new_size) return ERR::Okay;
-      Self->txFontSize = new_size;
+      if (Self->txFontSize IS size) return ERR::Okay;
+      Self->txFontSize = size;
       Self->txScaledFontSize = pct;
       if (Self->initialised()) return reset_font(Self);
       else return ERR::Okay;
@@ -1003,7 +994,7 @@ static ERR TEXT_GET_LineSpacing(extVectorText *Self, int *Value)
       return ERR::Okay;
    }
    else if (Self->txHandle->type IS CF_FREETYPE) {
-      *Value = ((freetype_font::ft_point *)Self->txHandle)->line_spacing;
+      *Value = ((freetype_font::ft_point *)Self->txHandle)->line_spacing * Self->txFontScale;
       return ERR::Okay;
    }
    else {
@@ -1420,6 +1411,15 @@ static void calc_caret_position(TextLine &Line, double FontSize, double PathScal
    Line.chars.emplace_back(cx1, cy1, cx2, cy2);
 }
 
+//********************************************************************************************************************
+// Returns true if the text path can be generated on a worker thread.  Loading the font, rendering bitmap fonts and
+// updating the cursor vector are all restricted to the main thread.
+
+extern bool is_parallel_text(extVectorText *Vector)
+{
+   return (Vector->txHandle) and (!Vector->txBitmapFont) and (!Vector->txCursor.vector);
+}
+
 //********************************************************************************************************************
 
 extern void set_text_final_xy(extVectorText *Vector)
@@ -1450,11 +1450,13 @@ static ERR reset_font(extVectorText *Vector, bool Force)
    if ((not Vector->initialised()) and (not Force)) return ERR::NotInitialised;
 
    pf::Log log;
-   if (auto error = get_font(log, Vector->txFamily, Vector->txFontStyle, Vector->txWeight, Vector->txFontSize, &Vector->txHandle); error IS ERR::Okay) {
+   if (auto error = get_font(log, Vector->txFamily, Vector->txFontStyle, Vector->txWeight, std::lround(Vector->txFontSize), &Vector->txHandle, true); error IS ERR::Okay) {
       if (Vector->txHandle->type IS CF_BITMAP) {
          Vector->txBitmapFont = ((bmp_font *)Vector->txHandle)->font;
          Vector->txFontSize = std::trunc(double(Vector->txBitmapFont->Height) * (DISPLAY_DPI / 72.0));
+         Vector->txFontScale = 1.0;
       }
+      else Vector->txFontScale = Vector->txFontSize / ((freetype_font::ft_point *)Vector->txHandle)->size;
       mark_dirty(Vector, RC::DIRTY);
       return ERR::Okay;
    }
@@ -1612,9 +1614,10 @@ static ERR text_input_events(extVector *Vector, const InputEvent *Events)
                else if (Self->txHandle->type IS CF_FREETYPE) {
                   auto pt = (freetype_font::ft_point *)Self->txHandle;
 
-                  double offset = pt->line_spacing * row;
-                  path.move_to(0, -pt->line_spacing + offset);
-                  path.line_to(Self->txWidth, -pt->line_spacing + offset);
+                  double line_spacing = pt->line_spacing * Self->txFontScale;
+                  double offset = line_spacing * row;
+                  path.move_to(0, -line_spacing + offset);
+                  path.line_to(Self->txWidth, -line_spacing + offset);
                   path.line_to(Self->txWidth, offset);
                   path.line_to(0, offset);
                   path.close_polygon();
@@ -6,62 +6,35 @@
 //   different point sizes.  Although it is possible to generate a single set of glyphs for a common point size and
 //   scale that as necessary, this produces demonstrably worse results for the user.
 //
-// * The fastest possible drawing process is to render the glyphs as cached textures.  This can be done in most
-//   situations if the VectorText transform is limited to scaling and we treat the glyphs as masks, which would allow
-//   gradient and pattern fills to work as expected.
+// * The fastest possible drawing process is to render the glyphs as cached textures.  If the VectorText transform is
+//   limited to uniform scaling and translation, the glyphs are rastered once to coverage masks in the font's atlas and
+//   composited to a mask for the fill.  This allows gradient and pattern fills to work as expected.  Text that is
+//   rotated, skewed, morphed or subject to a transition is drawn from its outline.
 
 //********************************************************************************************************************
-// Converts a Freetype glyph outline to an AGG path.  The size of the font must be preset in the FT_Outline object,
-// with a call to FT_Set_Char_Size()
-//
-// REQUIREMENT: The caller must have acquired a lock on glFontMutex.
+// Converts a Freetype glyph outline to an AGG path.
 
-freetype_font::glyph & freetype_font::ft_point::get_glyph(uint32_t Unicode)
+static void convert_outline(const FT_Outline &Outline, agg::path_storage &Path)
 {
    double x1, y1, x2, y2, x3, y3;
 
-   if (glyphs.contains(Unicode)) return glyphs[Unicode];
-
-   auto &path = glyphs[Unicode];
-
-   path.glyph_index = FT_Get_Char_Index(font->face, Unicode);
-
-   if (font->face->size->metrics.height != ft_size->metrics.height) {
-      FT_Set_Char_Size(font->face, 0, ft_size->metrics.height, 72, 72);
-   }
-
-   // Change the variable font metrics if necessary
-
-   if ((font->active_size != this) and (!axis.empty())) {
-      FT_Set_Var_Design_Coordinates(font->face, axis.size(), axis.data());
-      font->active_size = this;
-   }
-
-   // WARNING: FT_Load_Glyph leaks memory if you call it repeatedly for the same glyph (hence the importance of caching).
-
-   if (FT_Load_Glyph(font->face, path.glyph_index, font->glyph_flags)) return path;
-   path.adv_x = int26p6_to_dbl(font->face->glyph->advance.x);
-   path.adv_y = int26p6_to_dbl(font->face->glyph->advance.y);
-
-   const FT_Outline &outline = font->face->glyph->outline;
-
    int first = 0; // index of first point in contour
-   for (int n=0; n < outline.n_contours; n++) {
-      int last = outline.contours[n];  // index of last point in contour
-      FT_Vector *limit = outline.points + last;
+   for (int n=0; n < Outline.n_contours; n++) {
+      int last = Outline.contours[n];  // index of last point in contour
+      FT_Vector *limit = Outline.points + last;
 
-      FT_Vector v_start = outline.points[first];
-      FT_Vector v_last  = outline.points[last];
+      FT_Vector v_start = Outline.points[first];
+      FT_Vector v_last  = Outline.points[last];
       FT_Vector v_control = v_start;
-      FT_Vector *point = outline.points + first;
-      char *tags = outline.tags  + first;
+      FT_Vector *point = Outline.points + first;
+      char *tags = Outline.tags  + first;
       char tag   = FT_CURVE_TAG(tags[0]);
 
-      if (tag == FT_CURVE_TAG_CUBIC) return path; // A contour cannot start with a cubic control point!
+      if (tag == FT_CURVE_TAG_CUBIC) return; // A contour cannot start with a cubic control point!
 
       // check first point to determine origin
       if (tag == FT_CURVE_TAG_CONIC) { // first point is conic control.  Yes, this happens.
-         if (FT_CURVE_TAG(outline.tags[last]) == FT_CURVE_TAG_ON) { // start at last point if it is on the curve
+         if (FT_CURVE_TAG(Outline.tags[last]) == FT_CURVE_TAG_ON) { // start at last point if it is on the curve
             v_start = v_last;
             limit--;
          }
@@ -76,7 +49,7 @@ freetype_font::glyph & freetype_font::ft_point::get_glyph(uint32_t Unicode)
 
       x1 = int26p6_to_dbl(v_start.x);
       y1 = -int26p6_to_dbl(v_start.y);
-      path.path.move_to(x1, y1);
+      Path.move_to(x1, y1);
 
       while (point < limit) {
          point++;
@@ -87,7 +60,7 @@ freetype_font::glyph & freetype_font::ft_point::get_glyph(uint32_t Unicode)
             case FT_CURVE_TAG_ON: {  // emit a single line_to
                x1 = int26p6_to_dbl(point->x);
                y1 = -int26p6_to_dbl(point->y);
-               path.path.line_to(x1, y1);
+               Path.line_to(x1, y1);
                continue;
             }
 
@@ -111,11 +84,11 @@ freetype_font::glyph & freetype_font::ft_point::get_glyph(uint32_t Unicode)
                           y1 = -int26p6_to_dbl(v_control.y);
                           x2 = int26p6_to_dbl(vec.x);
                           y2 = -int26p6_to_dbl(vec.y);
-                          path.path.curve3(x1, y1, x2, y2);
+                          Path.curve3(x1, y1, x2, y2);
                           continue;
                       }
 
-                      if (tag != FT_CURVE_TAG_CONIC) return path;
+                      if (tag != FT_CURVE_TAG_CONIC) return;
 
                       v_middle.x = (v_control.x + vec.x) / 2;
                       v_middle.y = (v_control.y + vec.y) / 2;
@@ -124,7 +97,7 @@ freetype_font::glyph & freetype_font::ft_point::get_glyph(uint32_t Unicode)
                       y1 = -int26p6_to_dbl(v_control.y);
                       x2 = int26p6_to_dbl(v_middle.x);
                       y2 = -int26p6_to_dbl(v_middle.y);
-                      path.path.curve3(x1, y1, x2, y2);
+                      Path.curve3(x1, y1, x2, y2);
                       v_control = vec;
                       goto Do_Conic;
                   }
@@ -133,14 +106,14 @@ freetype_font::glyph & freetype_font::ft_point::get_glyph(uint32_t Unicode)
                   y1 = -int26p6_to_dbl(v_control.y);
                   x2 = int26p6_to_dbl(v_start.x);
                   y2 = -int26p6_to_dbl(v_start.y);
-                  path.path.curve3(x1, y1, x2, y2);
+                  Path.curve3(x1, y1, x2, y2);
                   goto _close;
             }
 
             default: { // FT_CURVE_TAG_CUBIC
                FT_Vector vec1, vec2;
 
-               if (point + 1 > limit || FT_CURVE_TAG(tags[1]) != FT_CURVE_TAG_CUBIC) return path;
+               if (point + 1 > limit || FT_CURVE_TAG(tags[1]) != FT_CURVE_TAG_CUBIC) return;
 
                vec1.x = point[0].x;
                vec1.y = point[0].y;
@@ -160,7 +133,7 @@ freetype_font::glyph & freetype_font::ft_point::get_glyph(uint32_t Unicode)
                   y2 = -int26p6_to_dbl(vec2.y);
                   x3 = int26p6_to_dbl(vec.x);
                   y3 = -int26p6_to_dbl(vec.y);
-                  path.path.curve4(x1, y1, x2, y2, x3, y3);
+                  Path.curve4(x1, y1, x2, y2, x3, y3);
                   continue;
                }
 
@@ -170,19 +143,206 @@ freetype_font::glyph & freetype_font::ft_point::get_glyph(uint32_t Unicode)
                y2 = -int26p6_to_dbl(vec2.y);
                x3 = int26p6_to_dbl(v_start.x);
                y3 = -int26p6_to_dbl(v_start.y);
-               path.path.curve4(x1, y1, x2, y2, x3, y3);
+               Path.curve4(x1, y1, x2, y2, x3, y3);
                goto _close;
             }
          } // switch
       } // while
 
-      path.path.close_polygon();
+      Path.close_polygon();
 
 _close:
       first = last + 1;
    }
+}
+
+//********************************************************************************************************************
+// Returns the glyph for a unicode character, loading it from the font face if it is not already cached.  Cached glyphs
+// are retrieved without locking.  Loading a new glyph locks the face, so concurrent loads are only serialised if they
+// share the same face.  A glyph is fully constructed before it is published to the table.
 
-   return path;
+freetype_font::glyph & freetype_font::ft_point::get_glyph(uint32_t Unicode)
+{
+   if (Unicode >= 0x110000) Unicode = 0xfffd;
+
+   if (auto glyph = glyphs.find(Unicode)) return *glyph;
+
+   const std::lock_guard lock(font->lock);
+
+   if (auto glyph = glyphs.find(Unicode)) return *glyph; // Another thread loaded the glyph while we were waiting
+
+   auto glyph = new freetype_font::glyph;
+
+   FT_Activate_Size(ft_size);
+
+   glyph->glyph_index = FT_Get_Char_Index(font->face, Unicode);
+
+   // Change the variable font metrics if necessary
+
+   if ((font->active_size != this) and (!axis.empty())) {
+      FT_Set_Var_Design_Coordinates(font->face, axis.size(), axis.data());
+      font->active_size = this;
+   }
+
+   // WARNING: FT_Load_Glyph leaks memory if you call it repeatedly for the same glyph (hence the importance of caching).
+
+   if (!FT_Load_Glyph(font->face, glyph->glyph_index, font->glyph_flags)) {
+      glyph->adv_x = int26p6_to_dbl(font->face->glyph->advance.x);
+      glyph->adv_y = int26p6_to_dbl(font->face->glyph->advance.y);
+      convert_outline(font->face->glyph->outline, glyph->path);
+   }
+
+   glyphs.insert(Unicode, glyph);
+   return *glyph;
+}
+
+//********************************************************************************************************************
+// Returns the kerning between two glyph indexes.  Faces without a kerning table do not require a lock.
+
+void freetype_font::ft_point::get_kerning(int Glyph, int PrevGlyph, double &X, double &Y)
+{
+   X = Y = 0;
+   if ((!PrevGlyph) or (!font->has_kerning)) return;
+
+   const std::lock_guard lock(font->lock);
+   FT_Activate_Size(ft_size);
+
+   FT_Vector delta;
+   if (!FT_Get_Kerning(font->face, PrevGlyph, Glyph, FT_KERNING_DEFAULT, &delta)) {
+      X = int26p6_to_dbl(delta.x);
+      Y = int26p6_to_dbl(delta.y);
+   }
+}
+
+//********************************************************************************************************************
+// Returns the coverage mask for a glyph at the given scale.  The SubPixel value combines the horizontal (bits 0 - 1) and
+// vertical (bits 2 - 3) offsets of the glyph origin in quarter pixels.  Scales are quantised so that minor rounding
+// differences do not create duplicate masks.
+//
+// REQUIREMENT: The caller must have acquired the font's lock.
+
+const freetype_font::glyph_mask & freetype_font::ft_point::get_mask(uint32_t Unicode, double Scale, int SubPixel)
+{
+   const uint32_t scale_key = uint32_t(std::lround(Scale * 4096.0));
+   const uint64_t key = (uint64_t(scale_key)<<32) | (uint64_t(Unicode)<<4) | uint64_t(SubPixel);
+
+   if (auto it = masks.find(key); it != masks.end()) return it->second;
+
+   auto &glyph = get_glyph(Unicode);
+   auto &mask = masks[key];
+   mask = { 0, 0, 0, 0, atlas.size() };
+
+   const double scale = double(scale_key) / 4096.0;
+   agg::trans_affine transform(scale, 0, 0, scale, double(SubPixel & 3) * 0.25, double(SubPixel>>2) * 0.25);
+   freetype_font::glyph_reader reader(glyph.path, scale);
+   agg::conv_transform<freetype_font::glyph_reader, agg::trans_affine> path(reader, transform);
+
+   double x1, y1, x2, y2;
+   if (!agg::bounding_rect_single(path, 0, &x1, &y1, &x2, &y2)) return mask;
+
+   mask.x      = int(std::floor(x1));
+   mask.y      = int(std::floor(y1));
+   mask.width  = int(std::ceil(x2)) - mask.x + 1;
+   mask.height = int(std::ceil(y2)) - mask.y + 1;
+
+   atlas.resize(mask.offset + size_t(mask.width) * mask.height);
+   transform.translate(-mask.x, -mask.y);
+
+   agg::rendering_buffer buffer(atlas.data() + mask.offset, mask.width, mask.height, mask.width);
+   agg::pixfmt_gray8 pixf(buffer);
+   agg::renderer_base<agg::pixfmt_gray8> rb(pixf);
+   agg::renderer_scanline_aa_solid<agg::renderer_base<agg::pixfmt_gray8>> solid(rb);
+   agg::rasterizer_scanline_aa<> raster;
+   agg::scanline_u8 sl;
+
+   solid.color(agg::gray8(0xff, 0xff));
+   raster.add_path(path);
+   agg::render_scanlines(raster, sl, solid);
+   return mask;
+}
+
+//********************************************************************************************************************
+// Composites the glyph masks of a VectorText object to the Coverage buffer, limited to the Clip region.  This is only
+// possible if the text was generated without per-character transforms and the final transform is limited to uniform
+// scaling and translation.  Returns false if the text must be drawn from its outline instead.
+//
+// Glyph origins are snapped to the nearest quarter pixel.  Overlapping glyphs are combined additively.
+
+bool build_text_coverage(extVector *Vector, const TClipRectangle<int> &Clip, glyph_coverage &Coverage)
+{
+   constexpr double MAX_MASK_SIZE = 256; // Larger glyphs are left to the rasterizer so that the atlas is not flooded
+
+   auto text = (extVectorText *)Vector;
+   if ((text->txGlyphs.empty()) or (text->Morph) or (text->AppendPath)) return false;
+   if ((!text->txHandle) or (text->txHandle->type != CF_FREETYPE)) return false;
+
+   const auto &t = text->Transform;
+   if ((t.shx != 0) or (t.shy != 0) or (t.sx <= 0) or (std::abs(t.sx - t.sy) > 1e-6)) return false;
+
+   const double scale = t.sx;
+   if (text->txFontSize * scale > MAX_MASK_SIZE) return false;
+
+   auto &pt = *(freetype_font::ft_point *)text->txHandle;
+
+   const std::lock_guard lock(pt.font->lock);
+
+   if (pt.atlas.size() > freetype_font::ft_point::MAX_ATLAS) {
+      pt.masks.clear();
+      pt.atlas.clear();
+   }
+
+   auto &area = Coverage.Area;
+   area = { Clip.right, Clip.bottom, Clip.left, Clip.top };
+   Coverage.Placements.clear();
+
+   for (auto &pos : text->txGlyphs) {
+      const double x = t.tx + pos.x * scale;
+      const double y = t.ty + pos.y * scale;
+      int ix = int(std::floor(x)), iy = int(std::floor(y));
+      int sx = int((x - ix) * 4.0 + 0.5), sy = int((y - iy) * 4.0 + 0.5);
+      if (sx IS 4) { ix++; sx = 0; }
+      if (sy IS 4) { iy++; sy = 0; }
+
+      auto &mask = pt.get_mask(pos.unicode, scale * text->txFontScale, sx | (sy<<2));
+      if (!mask.width) continue;
+
+      glyph_coverage::placement place = { ix + mask.x, iy + mask.y, mask.width, mask.height, mask.offset };
+      if ((place.x >= Clip.right) or (place.y >= Clip.bottom)) continue;
+      if ((place.x + place.width <= Clip.left) or (place.y + place.height <= Clip.top)) continue;
+
+      area.expanding({ place.x, place.y, place.x + place.width, place.y + place.height });
+      Coverage.Placements.push_back(place);
+   }
+
+   area.shrinking(Clip);
+   if (!area.valid()) return true;
+
+   if ((Coverage.Width < Clip.right) or (Coverage.Height < Clip.bottom)) {
+      Coverage.Width  = std::max(Coverage.Width, Clip.right);
+      Coverage.Height = std::max(Coverage.Height, Clip.bottom);
+      Coverage.Data.resize(size_t(Coverage.Width) * Coverage.Height);
+   }
+
+   const int stride = Coverage.Width;
+   for (int y=area.top; y < area.bottom; y++) {
+      clearmem(Coverage.Data.data() + size_t(y) * stride + area.left, area.width());
+   }
+
+   for (auto &place : Coverage.Placements) {
+      const int x1 = std::max(place.x, area.left), x2 = std::min(place.x + place.width, area.right);
+      const int y1 = std::max(place.y, area.top), y2 = std::min(place.y + place.height, area.bottom);
+
+      for (int y=y1; y < y2; y++) {
+         auto src  = pt.atlas.data() + place.offset + size_t(y - place.y) * place.width + (x1 - place.x);
+         auto dest = Coverage.Data.data() + size_t(y) * stride + x1;
+         for (int x=x1; x < x2; x++, src++, dest++) {
+            const int value = *dest + *src;
+            *dest = value > 0xff ? 0xff : value;
+         }
+      }
+   }
+
+   return true;
 }
 
 //********************************************************************************************************************
@@ -198,6 +358,7 @@ static void generate_text(extVectorText *Vector, agg::path_storage &Path)
    }
 
    auto &lines = Vector->txLines;
+   Vector->txGlyphs.clear();
    if (lines.empty()) return;
 
    if (Vector->txBitmapFont) {
@@ -246,18 +407,11 @@ static void generate_text(extVectorText *Vector, agg::path_storage &Path)
       }
    }
 
-   const std::lock_guard lock(glFontMutex);
+   // The font instance is hinted for the nearest bucket size, so glyph outlines and metrics are scaled by font_scale
+   // to reach the client's font size.
 
    auto &pt = *(freetype_font::ft_point *)Vector->txHandle;
-
-   // Freetype seems to be happier when the DPI is maintained at its native 72, and we get font results
-   // that match Chrome's output.  It also means that 1:1 metrics don't need to be converted to 96 DPI
-   // point sizes.
-
-   FT_Activate_Size(pt.ft_size);
-   if (pt.font->face->size->metrics.height != dbl_to_int26p6(Vector->txFontSize)) {
-      FT_Set_Char_Size(pt.font->face, 0, dbl_to_int26p6(Vector->txFontSize), 72, 72);
-   }
+   const double font_scale = Vector->txFontScale;
 
    if (morph) {
       // The scale_char transform is applied to each character to ensure that it is scaled to the path correctly.
@@ -290,7 +444,7 @@ static void generate_text(extVectorText *Vector, agg::path_storage &Path)
 
             if (unicode > 0x20) char_index++; // Index for transitions only increases if a glyph is being drawn
 
-            agg::trans_affine transform(scale_char); // The initial transform scales the char to the path.
+            agg::trans_affine transform(agg::trans_affine_scaling(font_scale) * scale_char); // The initial transform scales the char to the path.
 
             if (Vector->Transition) { // Apply any special transitions to transform early.
                apply_transition(Vector->Transition, double(char_index) / double(total_chars), transform);
@@ -299,8 +453,8 @@ static void generate_text(extVectorText *Vector, agg::path_storage &Path)
             auto &glyph = pt.get_glyph(unicode);
 
             double kx, ky;
-            get_kerning_xy(pt.font->face, glyph.glyph_index, prev_glyph_index, kx, ky);
-            start_x += kx;
+            pt.get_kerning(glyph.glyph_index, prev_glyph_index, kx, ky);
+            start_x += kx * font_scale;
 
             double char_width = glyph.adv_x * std::abs(transform.sx); //transform.scale();
 
@@ -349,7 +503,8 @@ static void generate_text(extVectorText *Vector, agg::path_storage &Path)
             if (unicode > 0x20) {
                transform.rotate(angle); // Rotate the character in accordance with its position on the path angle.
                transform.translate(tx, ty); // Move the character to its correct position on the path.
-               agg::conv_transform<agg::path_storage, agg::trans_affine> trans_char(glyph.path, transform);
+               freetype_font::glyph_reader reader(glyph.path, font_scale);
+               agg::conv_transform<freetype_font::glyph_reader, agg::trans_affine> trans_char(reader, transform);
                Path.concat_path(trans_char);
             }
 
@@ -405,7 +560,7 @@ static void generate_text(extVectorText *Vector, agg::path_storage &Path)
 
                if ((dx + word_width) * std::abs(transform.sx) >= Vector->txInlineSize) {
                   dx = 0;
-                  dy += pt.line_spacing;
+                  dy += pt.line_spacing * font_scale;
                }
             }
 
@@ -414,33 +569,36 @@ static void generate_text(extVectorText *Vector, agg::path_storage &Path)
             auto &glyph = pt.get_glyph(unicode);
 
             double kx, ky;
-            get_kerning_xy(pt.font->face, glyph.glyph_index, prev_glyph_index, kx, ky);
-            dx += kx;
+            pt.get_kerning(glyph.glyph_index, prev_glyph_index, kx, ky);
+            dx += kx * font_scale;
 
-            double char_width = glyph.adv_x * std::abs(transform.sx); // transform.scale();
+            double char_width = glyph.adv_x * font_scale * std::abs(transform.sx); // transform.scale();
 
             transform.translate(dx, dy);
-            agg::conv_transform<agg::path_storage, agg::trans_affine> trans_char(glyph.path, transform);
+            freetype_font::glyph_reader reader(glyph.path, font_scale);
+            agg::conv_transform<freetype_font::glyph_reader, agg::trans_affine> trans_char(reader, agg::trans_affine_scaling(font_scale) * transform);
             Path.concat_path(trans_char);
 
+            if ((unicode > 0x20) and (!Vector->Transition)) Vector->txGlyphs.emplace_back(unicode, dx, dy);
+
             if (Vector->txCursor.vector) {
-               calc_caret_position(line, transform, pt.ascent);
+               calc_caret_position(line, transform, pt.ascent * font_scale);
 
                if (!*str) { // Last character reached, add a final cursor entry past the character position.
                   transform.translate(char_width, 0);
-                  calc_caret_position(line, transform, pt.ascent);
+                  calc_caret_position(line, transform, pt.ascent * font_scale);
                }
             }
 
             dx += char_width;
-            dy += glyph.adv_y + ky;
+            dy += (glyph.adv_y + ky) * font_scale;
 
             prev_glyph_index = glyph.glyph_index;
          }
 
          if (dx > longest_line_width) longest_line_width = dx;
          dx = 0;
-         dy += pt.line_spacing;
+         dy += pt.line_spacing * font_scale;
       }
 
       Vector->txWidth = longest_line_width;
@@ -450,8 +608,8 @@ static void generate_text(extVectorText *Vector, agg::path_storage &Path)
 
    // Text paths are always oriented around (0,0) and are transformed later
 
-   Vector->Bounds = { 0.0, double(-pt.ascent), Vector->txWidth, 1.0 };
-   if (Vector->txLines.size() > 1) Vector->Bounds.bottom += (Vector->txLines.size() - 1) * pt.line_spacing;
+   Vector->Bounds = { 0.0, -pt.ascent * font_scale, Vector->txWidth, 1.0 };
+   if (Vector->txLines.size() > 1) Vector->Bounds.bottom += (Vector->txLines.size() - 1) * pt.line_spacing * font_scale;
 
    // If debugging the above boundary calculation, use this for verification of the true values (bear in
    // mind it will provide tighter numbers, which is normal).
@@ -288,10 +288,7 @@ static ERR VECTOR_Free(extVector *Self)
    if (Self->StrokeString) { FreeResource(Self->StrokeString); Self->StrokeString = nullptr; }
    if (Self->FilterString) { FreeResource(Self->FilterString); Self->FilterString = nullptr; }
 
-   if (Self->Fill[0].GradientTable) { delete Self->Fill[0].GradientTable; Self->Fill[0].GradientTable = nullptr; }
-   if (Self->Fill[1].GradientTable) { delete Self->Fill[1].GradientTable; Self->Fill[1].GradientTable = nullptr; }
-   if (Self->Stroke.GradientTable)  { delete Self->Stroke.GradientTable; Self->Stroke.GradientTable = nullptr; }
-   if (Self->DashArray)             { delete Self->DashArray; Self->DashArray = nullptr; }
+   if (Self->DashArray) { delete Self->DashArray; Self->DashArray = nullptr; }
 
    // Patch the nearest vectors that are linked to this one.
    if (Self->Next) Self->Next->Prev = Self->Prev;
@@ -320,6 +317,9 @@ static ERR VECTOR_Free(extVector *Self)
       scene->InputSubscriptions.erase(Self);
       scene->KeyboardSubscriptions.erase(Self);
 
+      // The content of the parent branch has changed
+      if ((Self->Parent) and (Self->Parent->Class->BaseClassID IS CLASSID::VECTOR)) mark_buffers_for_refresh((extVector *)Self->Parent);
+
       if (scene->ActiveVector IS Self->UID) {
          if (scene->Cursor != PTC::DEFAULT) {
             pf::ScopedObjectLock<objSurface> surface(scene->SurfaceID);
@@ -880,6 +880,9 @@ vector.  The original events are transferred with some modifications - `X`, `Y`,
 the vector's coordinate system, and `CROSSED_IN` and `CROSSED_OUT` events are triggered during passage through
 the clipping area.
 
+Movement is coalesced so that only the most recent position of each series is received.  Include `HISTORY` in the
+`Mask` to receive every position as a linked batch of events, ending with the most recent.
+
 It is a pre-requisite that the associated @VectorScene has been linked to a @Surface.
 
 To remove an existing subscription, call this method again with the same `Callback` and an empty `Mask`.
@@ -1380,6 +1383,7 @@ static ERR VECTOR_SET_Fill(extVector *Self, CSTRING Value)
 
    if (!Value) {
       Self->Fill[0].reset();
+      mark_buffers_for_refresh(Self);
       return ERR::Okay;
    }
 